@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    A named group of measurements.
+
+    Each benchmark is created as a static object, which registers itself so that
+    the Benchmarks app can find and run it.
+*/
+class Benchmark
+{
+public:
+    Benchmark (const String& benchmarkName, const String& benchmarkCategory)
+        : name (benchmarkName), category (benchmarkCategory)
+    {
+        getAllBenchmarks().add (this);
+    }
+
+    virtual ~Benchmark()
+    {
+        getAllBenchmarks().removeFirstMatchingValue (this);
+    }
+
+    /** Runs all the measurements, calling printResult() for each one. */
+    virtual void run() = 0;
+
+    static Array<Benchmark*>& getAllBenchmarks()
+    {
+        static Array<Benchmark*> benchmarks;
+        return benchmarks;
+    }
+
+    const String name, category;
+
+protected:
+    /** Calls a function repeatedly for at least the given time, and returns the average
+        time taken by each call, in seconds.
+    */
+    template <typename Function>
+    static double measure (Function&& function, double minimumSeconds = 0.25)
+    {
+        function(); // warm up
+
+        int64 numCalls = 0;
+        const auto start = Time::getHighResolutionTicks();
+        const auto minimumTicks = Time::secondsToHighResolutionTicks (minimumSeconds);
+        int64 elapsed = 0;
+
+        do
+        {
+            function();
+            ++numCalls;
+            elapsed = Time::getHighResolutionTicks() - start;
+        }
+        while (elapsed < minimumTicks);
+
+        return Time::highResolutionTicksToSeconds (elapsed) / (double) numCalls;
+    }
+
+    /** Prints a single result. */
+    void printResult (const String& description, double value, const String& units) const
+    {
+        std::cout << (name + " / " + description).paddedRight (' ', 60)
+                  << String (value, 2).paddedLeft (' ', 12) << " " << units << std::endl;
+    }
+};
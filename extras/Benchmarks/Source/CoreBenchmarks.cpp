@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+#include "Benchmark.h"
+
+//==============================================================================
+/** A copy of the hot paths of the ListenerList that was used before listeners were stored in
+    immutable snapshots, so that the benchmark can show the difference between the two.
+
+    Every call takes the array's lock and registers an iterator that add() and remove() can adjust.
+*/
+template <typename ListenerClass, typename ArrayType = Array<ListenerClass*>>
+class PreviousListenerList
+{
+public:
+    PreviousListenerList() = default;
+    ~PreviousListenerList() { clear(); }
+
+    void add (ListenerClass* listenerToAdd)
+    {
+        initialiseIfNeeded();
+        listeners->addIfNotAlreadyThere (listenerToAdd);
+    }
+
+    void remove (ListenerClass* listenerToRemove)
+    {
+        if (! initialised())
+            return;
+
+        const ScopedLockType lock (listeners->getLock());
+
+        if (const auto index = listeners->removeFirstMatchingValue (listenerToRemove); index >= 0)
+        {
+            for (auto* it : *iterators)
+            {
+                if (index < it->end)
+                    --it->end;
+
+                if (index <= it->index)
+                    --it->index;
+            }
+        }
+    }
+
+    void clear()
+    {
+        if (! initialised())
+            return;
+
+        const ScopedLockType lock { listeners->getLock() };
+
+        listeners->clear();
+
+        for (auto* it : *iterators)
+            it->end = 0;
+    }
+
+    template <typename... MethodArgs, typename... Args>
+    void call (void (ListenerClass::*callbackFunction) (MethodArgs...), Args&&... args)
+    {
+        if (! initialised())
+            return;
+
+        const auto localListeners = listeners;
+        const ScopedLockType lock { localListeners->getLock() };
+
+        Iterator it{};
+        it.end = localListeners->size();
+
+        iterators->push_back (&it);
+
+        const ScopeGuard scope { [i = iterators, &it]
+        {
+            i->erase (std::remove (i->begin(), i->end(), &it), i->end());
+        } };
+
+        for (; it.index < it.end; ++it.index)
+            (localListeners->getUnchecked (it.index)->*callbackFunction) (args...);
+    }
+
+private:
+    using ScopedLockType = typename ArrayType::ScopedLockType;
+
+    struct Iterator
+    {
+        int index{};
+        int end{};
+    };
+
+    enum class State
+    {
+        uninitialised,
+        initialising,
+        initialised
+    };
+
+    bool initialised() const noexcept { return state == State::initialised; }
+
+    void initialiseIfNeeded() noexcept
+    {
+        if (initialised())
+            return;
+
+        auto expected = State::uninitialised;
+
+        if (state.compare_exchange_strong (expected, State::initialising))
+        {
+            listeners = std::make_shared<ArrayType>();
+            iterators = std::make_shared<std::vector<Iterator*>>();
+            state = State::initialised;
+            return;
+        }
+
+        while (! initialised())
+            std::this_thread::yield();
+    }
+
+    std::shared_ptr<ArrayType> listeners;
+    std::shared_ptr<std::vector<Iterator*>> iterators;
+    std::atomic<State> state { State::uninitialised };
+};
+
+//==============================================================================
+/** Measures calling the listeners in a ListenerList, ThreadSafeListenerList or ConcurrentListenerList, both
+    from a single thread and from several threads at once, and adding and removing them.
+    Each measurement is repeated with the previous implementation for comparison.
+*/
+class ListenerListBenchmark final : public Benchmark
+{
+public:
+    ListenerListBenchmark() : Benchmark ("ListenerList", "Core") {}
+
+    void run() override
+    {
+        runForListType<ListenerList<Listener>> ("ListenerList");
+        runForListType<PreviousListenerList<Listener>> ("ListenerList (previous)");
+        runForListType<ThreadSafeListenerList<Listener>> ("ThreadSafeListenerList");
+        runForListType<PreviousListenerList<Listener, Array<Listener*, CriticalSection>>> ("ThreadSafeListenerList (previous)");
+        runForListType<ConcurrentListenerList<Listener>> ("ConcurrentListenerList");
+
+        for (int numThreads : { 2, 4 })
+        {
+            runConcurrently<ThreadSafeListenerList<Listener>> ("ThreadSafeListenerList", numThreads);
+            runConcurrently<PreviousListenerList<Listener, Array<Listener*, CriticalSection>>> ("ThreadSafeListenerList (previous)", numThreads);
+            runConcurrently<ConcurrentListenerList<Listener>> ("ConcurrentListenerList", numThreads);
+        }
+    }
+
+private:
+    struct Listener
+    {
+        // Several threads call the same listeners at once in the concurrent measurements
+        void callback() { numCalls.fetch_add (1, std::memory_order_relaxed); }
+        std::atomic<int> numCalls { 0 };
+    };
+
+    template <typename ListType>
+    void runForListType (const String& typeName)
+    {
+        for (int numListeners : { 1, 10, 100 })
+        {
+            ListType list;
+            std::vector<Listener> listeners ((size_t) numListeners);
+
+            for (auto& l : listeners)
+                list.add (&l);
+
+            const auto callSeconds = measure ([&]
+            {
+                for (int i = 0; i < 1000; ++i)
+                    list.call (&Listener::callback);
+            });
+
+            printResult (typeName + ", " + String (numListeners) + " listeners",
+                         callSeconds * 1.0e9 / 1000, "ns per call");
+
+            Listener extra;
+
+            const auto addRemoveSeconds = measure ([&]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    list.add (&extra);
+                    list.remove (&extra);
+                }
+            });
+
+            printResult (typeName + ", " + String (numListeners) + " listeners, add and remove",
+                         addRemoveSeconds * 1.0e9 / 1000, "ns");
+        }
+    }
+
+    template <typename ListType>
+    void runConcurrently (const String& typeName, int numThreads)
+    {
+        ListType list;
+        std::vector<Listener> listeners (10);
+
+        for (auto& l : listeners)
+            list.add (&l);
+
+        constexpr int callsPerThread = 200000;
+        std::vector<std::thread> threads;
+
+        const auto start = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back ([&list]
+            {
+                for (int j = 0; j < callsPerThread; ++j)
+                    list.call (&Listener::callback);
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+        printResult (typeName + ", 10 listeners, " + String (numThreads) + " threads",
+                     numThreads * callsPerThread / seconds / 1.0e6, "million calls/s");
+    }
+};
+
+static ListenerListBenchmark listenerListBenchmark;
@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+#include "Benchmark.h"
+
+#if JUCE_LINUX
+ #include <sys/eventfd.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+/** Measures the rate at which messages posted from other threads can be delivered. */
+class CallAsyncBenchmark final : public Benchmark
+{
+public:
+    CallAsyncBenchmark() : Benchmark ("CallAsync", "Events") {}
+
+    void run() override
+    {
+        constexpr int messagesPerThread = 200000;
+
+        for (int numThreads : { 1, 2, 4, 8 })
+        {
+            std::atomic<int> numDelivered { 0 };
+            std::vector<std::thread> producers;
+
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+                producers.emplace_back ([&numDelivered]
+                {
+                    for (int j = 0; j < messagesPerThread; ++j)
+                        MessageManager::callAsync ([&numDelivered] { ++numDelivered; });
+                });
+            }
+
+            const auto total = numThreads * messagesPerThread;
+
+            while (numDelivered < total)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            for (auto& producer : producers)
+                producer.join();
+
+            printResult (String (numThreads) + (numThreads == 1 ? " producer" : " producers"),
+                         total / seconds / 1.0e6, "million messages/s");
+        }
+    }
+};
+
+static CallAsyncBenchmark callAsyncBenchmark;
+
+//==============================================================================
+/** Measures triggering a large number of AsyncUpdaters and delivering their updates,
+    as happens when many components are updated at once.
+*/
+class AsyncUpdaterBenchmark final : public Benchmark
+{
+public:
+    AsyncUpdaterBenchmark() : Benchmark ("AsyncUpdater", "Events") {}
+
+    void run() override
+    {
+        for (int numUpdaters : { 100, 1000, 10000 })
+        {
+            std::vector<std::unique_ptr<CountingUpdater>> updaters;
+            int numDelivered = 0;
+
+            for (int i = 0; i < numUpdaters; ++i)
+                updaters.push_back (std::make_unique<CountingUpdater> (numDelivered));
+
+            const auto seconds = measure ([&]
+            {
+                numDelivered = 0;
+
+                for (auto& updater : updaters)
+                    updater->triggerAsyncUpdate();
+
+                while (numDelivered < numUpdaters)
+                    MessageManager::getInstance()->runDispatchLoopUntil (0);
+            });
+
+            printResult (String (numUpdaters) + " updaters", seconds * 1.0e9 / numUpdaters, "ns per update");
+        }
+    }
+
+private:
+    struct CountingUpdater final : public AsyncUpdater
+    {
+        explicit CountingUpdater (int& counter) : numDelivered (counter) {}
+
+        void handleAsyncUpdate() override   { ++numDelivered; }
+
+        int& numDelivered;
+    };
+};
+
+static AsyncUpdaterBenchmark asyncUpdaterBenchmark;
+
+//==============================================================================
+/** Measures the cost of starting, restarting and stopping timers, and of running
+    them, when there are thousands of them.
+*/
+class TimerBenchmark final : public Benchmark
+{
+public:
+    TimerBenchmark() : Benchmark ("Timers", "Events") {}
+
+    void run() override
+    {
+        constexpr int numTimers = 10000;
+
+        Random random (1);
+        std::vector<std::unique_ptr<CountingTimer>> timers;
+
+        for (int i = 0; i < numTimers; ++i)
+            timers.push_back (std::make_unique<CountingTimer> (10 + random.nextInt (990)));
+
+        const auto startAndStop = measure ([&]
+        {
+            for (auto& timer : timers)
+                timer->startTimer (timer->interval);
+
+            for (auto& timer : timers)
+                timer->stopTimer();
+        });
+
+        printResult (String (numTimers) + " timers, start and stop", startAndStop * 1.0e9 / numTimers, "ns per timer");
+
+        for (auto& timer : timers)
+            timer->startTimer (timer->interval);
+
+        const auto restart = measure ([&]
+        {
+            for (auto& timer : timers)
+                timer->startTimer (timer->interval);
+        });
+
+        printResult (String (numTimers) + " timers, restart", restart * 1.0e9 / numTimers, "ns per timer");
+
+        int64 numCallbacks = 0;
+        const auto start = Time::getHighResolutionTicks();
+        MessageManager::getInstance()->runDispatchLoopUntil (2000);
+        const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+        for (auto& timer : timers)
+        {
+            numCallbacks += timer->numCallbacks;
+            timer->stopTimer();
+        }
+
+        printResult (String (numTimers) + " timers, running", (double) numCallbacks / seconds, "callbacks/s");
+    }
+
+private:
+    struct CountingTimer final : public Timer
+    {
+        explicit CountingTimer (int intervalMs) : interval (intervalMs) {}
+
+        void timerCallback() override   { ++numCallbacks; }
+
+        const int interval;
+        int64 numCallbacks = 0;
+    };
+};
+
+static TimerBenchmark timerBenchmark;
+
+#if JUCE_LINUX
+//==============================================================================
+/** Measures the time taken to handle one ready file descriptor, with different
+    numbers of other descriptors registered with the event loop.
+*/
+class EventLoopBenchmark final : public Benchmark
+{
+public:
+    EventLoopBenchmark() : Benchmark ("EventLoop", "Events") {}
+
+    void run() override
+    {
+        for (int numFds : { 1, 10, 100, 1000 })
+        {
+            std::vector<int> fds;
+
+            for (int i = 0; i < numFds; ++i)
+            {
+                fds.push_back (eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK));
+
+                LinuxEventLoop::registerFdCallback (fds.back(), [] (int fd)
+                {
+                    uint64_t value;
+                    [[maybe_unused]] auto numBytes = read (fd, &value, sizeof (value));
+                });
+            }
+
+            int next = 0;
+
+            const auto seconds = measure ([&]
+            {
+                const uint64_t value = 1;
+                [[maybe_unused]] auto numBytes = write (fds[(size_t) next], &value, sizeof (value));
+                next = (next + 1) % numFds;
+
+                MessageManager::getInstance()->runDispatchLoopUntil (0);
+            });
+
+            printResult (String (numFds) + " registered", seconds * 1.0e6, "us per event");
+
+            const auto registerSeconds = measure ([&]
+            {
+                for (auto fd : fds)
+                    LinuxEventLoop::unregisterFdCallback (fd);
+
+                for (auto fd : fds)
+                    LinuxEventLoop::registerFdCallback (fd, [] (int) {});
+            });
+
+            printResult (String (numFds) + " registered (add and remove)", registerSeconds * 1.0e6 / numFds, "us per fd");
+
+            for (auto fd : fds)
+            {
+                LinuxEventLoop::unregisterFdCallback (fd);
+                close (fd);
+            }
+        }
+    }
+};
+
+static EventLoopBenchmark eventLoopBenchmark;
+#endif
+
+//==============================================================================
+/** Measures the round-trip time and throughput of an InterprocessConnection, over
+    each of the transports that it supports.
+*/
+class InterprocessConnectionBenchmark final : public Benchmark
+{
+public:
+    InterprocessConnectionBenchmark() : Benchmark ("InterprocessConnection", "Events") {}
+
+    void run() override
+    {
+        for (auto useSharedMemory : { false, true })
+        {
+            const String transport (useSharedMemory ? "shared memory" : "pipe");
+            const auto name = "benchmark_" + String::toHexString (Random::getSystemRandom().nextInt64());
+
+            Client client;
+            Echo echo;
+
+            const auto connected = useSharedMemory ? (client.createSharedMemory (name, -1, true) && echo.connectToSharedMemory (name, -1))
+                                                   : (client.createPipe (name, -1, true) && echo.connectToPipe (name, -1));
+
+            if (! connected)
+            {
+                printResult (transport + " (unavailable)", 0, "");
+                continue;
+            }
+
+            const auto roundTripSeconds = measure ([&]
+            {
+                client.sendAndWait (MemoryBlock (16));
+            });
+
+            printResult (transport + " round trip (16 bytes)", roundTripSeconds * 1.0e6, "us");
+
+            const MemoryBlock block (65536);
+
+            const auto blockSeconds = measure ([&]
+            {
+                client.sendAndWait (block);
+            });
+
+            printResult (transport + " round trip (64 KB)", 2.0 * (double) block.getSize() / blockSeconds / 1.0e6, "MB/s");
+        }
+    }
+
+private:
+    struct Echo final : public InterprocessConnection
+    {
+        Echo() : InterprocessConnection (false) {}
+        ~Echo() override    { disconnect(); }
+
+        void connectionMade() override {}
+        void connectionLost() override {}
+        void messageReceived (const MemoryBlock& message) override   { sendMessage (message); }
+    };
+
+    struct Client final : public InterprocessConnection
+    {
+        Client() : InterprocessConnection (false) {}
+        ~Client() override  { disconnect(); }
+
+        void sendAndWait (const MemoryBlock& message)
+        {
+            sendMessage (message);
+            replyReceived.wait();
+        }
+
+        void connectionMade() override {}
+        void connectionLost() override {}
+        void messageDataReceived (const void*, size_t) override      { replyReceived.signal(); }
+        void messageReceived (const MemoryBlock&) override {}
+
+        WaitableEvent replyReceived;
+    };
+};
+
+static InterprocessConnectionBenchmark interprocessConnectionBenchmark;
@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/** Measures the span functions used by the software renderer, for each instruction set. */
+class PixelSpanBenchmark final : public Benchmark
+{
+public:
+    PixelSpanBenchmark() : Benchmark ("PixelSpanFunctions", "Graphics") {}
+
+    void run() override
+    {
+        constexpr int numPixels = 1024;
+        const auto colour = Colour (0x80405060).getPixelARGB();
+
+        std::vector<uint8> dest (numPixels * 4, 0x40);
+        std::vector<PixelARGB> source (numPixels, colour), table (1025, colour);
+        std::vector<uint8> image (66 * 66 * 4, 0x80);
+        std::vector<RenderingHelpers::PixelSpanFunctions::BilinearSample> samples;
+
+        for (int i = 0; i < numPixels; ++i)
+            samples.push_back ({ image.data() + (i % 64) * 4 + ((i / 64) % 64) * 66 * 4, i & 255, (i * 7) & 255 });
+
+        for (auto* functions : RenderingHelpers::PixelSpanFunctions::getAllAvailable())
+        {
+            const String suffix = String (" (") + functions->name + ")";
+
+            report ("Solid colour blend" + suffix, numPixels, [&]
+            {
+                functions->blendColour (dest.data(), colour, numPixels, true);
+            });
+
+            report ("Image blend" + suffix, numPixels, [&]
+            {
+                functions->blendPixels (dest.data(), source.data(), numPixels, 200, true);
+            });
+
+            report ("Linear gradient" + suffix, numPixels, [&]
+            {
+                functions->generateLinearGradient (source.data(), table.data(), 1024, 10, 3000, 1000, numPixels);
+                functions->blendPixels (dest.data(), source.data(), numPixels, 256, true);
+            });
+
+            report ("Radial gradient" + suffix, numPixels, [&]
+            {
+                functions->generateRadialGradient (source.data(), table.data(), 1024, 500.0, 400.0, 250000.0, 2.048, 0, numPixels);
+                functions->blendPixels (dest.data(), source.data(), numPixels, 256, true);
+            });
+
+            report ("Bilinear image" + suffix, numPixels, [&]
+            {
+                functions->interpolatePixels (source.data(), samples.data(), numPixels, 66 * 4);
+                functions->blendPixels (dest.data(), source.data(), numPixels, 256, true);
+            });
+        }
+    }
+
+private:
+    template <typename Function>
+    void report (const String& description, int numPixels, Function&& function)
+    {
+        printResult (description, (double) numPixels / measure (function) / 1.0e6, "Mpixels/s");
+    }
+};
+
+static PixelSpanBenchmark pixelSpanBenchmark;
+
+//==============================================================================
+/** Measures whole fills through a Graphics context using the software renderer. */
+class SoftwareRendererFillBenchmark final : public Benchmark
+{
+public:
+    SoftwareRendererFillBenchmark() : Benchmark ("SoftwareRenderer", "Graphics") {}
+
+    void run() override
+    {
+        for (auto format : { Image::ARGB, Image::RGB })
+        {
+            const String suffix = format == Image::ARGB ? " (ARGB)" : " (RGB)";
+            Image target (format, size, size, true, SoftwareImageType());
+
+            Image source (Image::ARGB, size, size, true, SoftwareImageType());
+            {
+                Graphics g (source);
+                g.setGradientFill ({ Colours::red.withAlpha (0.8f), 0.0f, 0.0f, Colours::blue.withAlpha (0.3f), (float) size, (float) size, false });
+                g.fillAll();
+            }
+
+            report ("Solid colour" + suffix, target, [] (Graphics& g)
+            {
+                g.setColour (Colours::green.withAlpha (0.5f));
+                g.fillRect (0, 0, size, size);
+            });
+
+            report ("Linear gradient" + suffix, target, [] (Graphics& g)
+            {
+                g.setGradientFill ({ Colours::red, 0.0f, 0.0f, Colours::blue.withAlpha (0.5f), (float) size, 100.0f, false });
+                g.fillRect (0, 0, size, size);
+            });
+
+            report ("Radial gradient" + suffix, target, [] (Graphics& g)
+            {
+                g.setGradientFill ({ Colours::red, size * 0.5f, size * 0.5f, Colours::blue.withAlpha (0.5f), 0.0f, 0.0f, true });
+                g.fillRect (0, 0, size, size);
+            });
+
+            report ("Image" + suffix, target, [&source] (Graphics& g)
+            {
+                g.drawImageAt (source, 0, 0);
+            });
+
+            report ("Transformed image" + suffix, target, [&source] (Graphics& g)
+            {
+                g.setImageResamplingQuality (Graphics::mediumResamplingQuality);
+                g.drawImageTransformed (source, AffineTransform::rotation (0.1f, size * 0.5f, size * 0.5f)
+                                                                .scaled (1.1f, 1.1f, size * 0.5f, size * 0.5f));
+            });
+        }
+    }
+
+private:
+    static constexpr int size = 1024;
+
+    template <typename Function>
+    void report (const String& description, Image& target, Function&& function)
+    {
+        const auto seconds = measure ([&]
+        {
+            Graphics g (target);
+            function (g);
+        });
+
+        printResult (description, (double) (size * size) / seconds / 1.0e6, "Mpixels/s");
+    }
+};
+
+static SoftwareRendererFillBenchmark softwareRendererFillBenchmark;
+
+//==============================================================================
+/** Measures paths that are rebuilt and drawn on every repaint, with and without the path cache. */
+class PathCacheBenchmark final : public Benchmark
+{
+public:
+    PathCacheBenchmark() : Benchmark ("PathCache", "Graphics") {}
+
+    void run() override
+    {
+        const auto originalLimit = LowLevelGraphicsSoftwareRenderer::getPathCacheStatistics().maxNumBytes;
+        Image target (Image::ARGB, 512, 512, true, SoftwareImageType());
+
+        const auto drawKnob = [] (Graphics& g)
+        {
+            Path track;
+            track.addCentredArc (128.0f, 128.0f, 100.0f, 100.0f, 0.0f, -2.4f, 2.4f, true);
+            g.strokePath (track, PathStrokeType (8.0f, PathStrokeType::curved, PathStrokeType::rounded));
+
+            Path thumb;
+            thumb.addEllipse (100.0f, 100.0f, 56.0f, 56.0f);
+            g.fillPath (thumb);
+        };
+
+        const auto drawWaveform = [] (Graphics& g)
+        {
+            Path wave;
+            wave.startNewSubPath (0.0f, 256.0f);
+
+            for (int i = 1; i < 1024; ++i)
+                wave.quadraticTo ((float) i * 0.5f - 0.25f, 256.0f, (float) i * 0.5f, 256.0f + 200.0f * std::sin ((float) i * 0.05f));
+
+            g.strokePath (wave, PathStrokeType (1.5f));
+        };
+
+        for (auto limit : { (size_t) 0, originalLimit })
+        {
+            LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (limit);
+            const String suffix = limit == 0 ? " (uncached)" : " (cached)";
+
+            report ("Knob" + suffix, target, drawKnob);
+            report ("1k-point waveform" + suffix, target, drawWaveform);
+        }
+
+        LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (originalLimit);
+    }
+
+private:
+    template <typename Function>
+    void report (const String& description, Image& target, Function&& function)
+    {
+        const auto seconds = measure ([&]
+        {
+            Graphics g (target);
+            function (g);
+        });
+
+        printResult (description, seconds * 1.0e6, "us");
+    }
+};
+
+static PathCacheBenchmark pathCacheBenchmark;
+
+//==============================================================================
+/** Measures drawing glyphs that are too large for the glyph atlas, so that every glyph is
+    fetched from the GlyphCache, and the cost of the cache lookup on its own.
+*/
+class GlyphCacheBenchmark final : public Benchmark
+{
+public:
+    GlyphCacheBenchmark() : Benchmark ("GlyphCache", "Graphics") {}
+
+    void run() override
+    {
+        const Font font (FontOptions (120.0f));
+        GlyphArrangement glyphs;
+        glyphs.addLineOfText (font, "Glyphs", 0.0f, 150.0f);
+
+        const auto numGlyphs = jmax (1, glyphs.getNumGlyphs());
+        const auto glyphNumber = glyphs.getNumGlyphs() > 0 ? glyphs.getGlyph (0).getGlyphIndex() : 0;
+
+        const auto lookupSeconds = measure ([&]
+        {
+            for (int i = 0; i < 100; ++i)
+                ignoreUnused (RenderingHelpers::GlyphCache::getInstance().get (font, glyphNumber));
+        });
+
+        printResult ("Lookup", lookupSeconds * 1.0e9 / 100.0, "ns");
+
+        Image target (Image::ARGB, 1024, 256, true, SoftwareImageType());
+
+        const auto drawSeconds = measure ([&]
+        {
+            Graphics g (target);
+            g.setColour (Colours::black);
+            glyphs.draw (g);
+        });
+
+        printResult ("Large glyphs", drawSeconds * 1.0e6 / (double) numGlyphs, "us per glyph");
+    }
+};
+
+static GlyphCacheBenchmark glyphCacheBenchmark;
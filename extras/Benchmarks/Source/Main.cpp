@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    constexpr auto helpOption = "--help|-h";
+    constexpr auto listOption = "--list|-l";
+    constexpr auto categoryOption = "--category|-c";
+    constexpr auto nameOption = "--name|-n";
+
+    ArgumentList args (argc, argv);
+
+    if (args.containsOption (helpOption))
+    {
+        std::cout << argv[0]
+                  << " [" << helpOption << "]"
+                  << " [" << listOption << "]"
+                  << " [" << categoryOption << "=category]"
+                  << " [" << nameOption << "=name]"
+                  << std::endl;
+        return 0;
+    }
+
+    if (args.containsOption (listOption))
+    {
+        for (auto* benchmark : Benchmark::getAllBenchmarks())
+            std::cout << benchmark->category << " / " << benchmark->name << std::endl;
+
+        return 0;
+    }
+
+    const ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto category = args.getValueForOption (categoryOption);
+    const auto name = args.getValueForOption (nameOption);
+
+    for (auto* benchmark : Benchmark::getAllBenchmarks())
+    {
+        if ((category.isEmpty() || benchmark->category.equalsIgnoreCase (category))
+             && (name.isEmpty() || benchmark->name.equalsIgnoreCase (name)))
+        {
+            benchmark->run();
+        }
+    }
+
+    return 0;
+}
@@ -1962,6 +1962,8 @@ public:
 
     void didReceiveMemoryWarning()
     {
+        ImageCache::handleMemoryPressure (ImageCache::MemoryPressure::critical);
+
         if (auto ptr = processorHolder.get())
             if (auto* processor = ptr->get())
                 processor->memoryWarningReceived();
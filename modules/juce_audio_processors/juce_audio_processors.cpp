@@ -72,6 +72,8 @@
 #include "format_types/juce_AudioUnitPluginFormat.mm"
 #include "scanning/juce_KnownPluginList.cpp"
 #include "scanning/juce_PluginDirectoryScanner.cpp"
+#include "scanning/juce_PluginScanCache.cpp"
+#include "scanning/juce_ParallelPluginScanner.cpp"
 #include "scanning/juce_PluginListComponent.cpp"
 #include "utilities/juce_ParameterAttachments.cpp"
 #include "utilities/juce_AudioProcessorValueTreeState.cpp"
@@ -76,6 +76,8 @@
 #include "format_types/juce_VST3PluginFormat.h"
 #include "format_types/juce_VSTPluginFormat.h"
 #include "scanning/juce_PluginDirectoryScanner.h"
+#include "scanning/juce_PluginScanCache.h"
+#include "scanning/juce_ParallelPluginScanner.h"
 #include "scanning/juce_PluginListComponent.h"
 #include "utilities/juce_ParameterAttachments.h"
 #include "utilities/juce_AudioProcessorValueTreeState.h"
@@ -0,0 +1,790 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace ParallelPluginScannerHelpers
+{
+    // A worker sends a reply with this request ID when it has started up.
+    enum { readyRequestID = 0, maxLaunchFailures = 3 };
+
+    static MemoryBlock createReply (int requestID, const OwnedArray<PluginDescription>& types)
+    {
+        XmlElement xml ("TYPES");
+
+        for (auto* type : types)
+            xml.addChildElement (type->createXml().release());
+
+        MemoryOutputStream out;
+        out.writeInt (requestID);
+        out.writeString (xml.toString (XmlElement::TextFormat().singleLine().withoutHeader()));
+        return out.getMemoryBlock();
+    }
+
+    static Array<PluginDescription> readTypes (MemoryInputStream& in)
+    {
+        Array<PluginDescription> types;
+
+        if (auto xml = parseXML (in.readString()))
+        {
+            for (auto* e : xml->getChildIterator())
+            {
+                PluginDescription type;
+
+                if (type.loadFromXml (*e))
+                    types.add (type);
+            }
+        }
+
+        return types;
+    }
+}
+
+//==============================================================================
+class ParallelPluginScanner::Worker final : private ChildProcessCoordinator
+{
+public:
+    explicit Worker (WaitableEvent& eventToSignal)
+        : event (eventToSignal)
+    {
+        // The worker is always built with this module's PluginScannerWorker, which can connect
+        // to shared memory. This lets a worker that crashes be noticed straight away, rather
+        // than after the pipe's ping timeout.
+        setUseSharedMemory (true);
+    }
+
+    ~Worker() override
+    {
+        // The worker terminates itself if it's still busy when it's disconnected
+        killWorkerProcess();
+    }
+
+    bool launch (const Options& options)
+    {
+        return launchWorkerProcess (options.workerExecutable, options.commandLineUniqueID, 0, 0);
+    }
+
+    void start (const Job& newJob)
+    {
+        {
+            const std::lock_guard lock (mutex);
+            result.reset();
+            ++requestID;
+        }
+
+        job = newJob;
+        startTime = Time::getMillisecondCounter();
+
+        MemoryOutputStream out;
+        out.writeInt (requestID);
+        out.writeString (job->format->getName());
+        out.writeString (job->fileOrIdentifier);
+
+        if (! sendMessageToWorker (out.getMemoryBlock()))
+            handleConnectionLost();
+    }
+
+    enum class State
+    {
+        busy,
+        finished,
+        failedToStart,
+        crashed,
+        timedOut
+    };
+
+    State getState (int timeoutMs, Array<PluginDescription>& types)
+    {
+        const std::lock_guard lock (mutex);
+
+        if (result.has_value())
+        {
+            types = std::move (*result);
+            result.reset();
+            return State::finished;
+        }
+
+        const auto hasTimedOut = Time::getMillisecondCounter() - startTime > (uint32) timeoutMs;
+
+        if (! (connectionLost || hasTimedOut))
+            return State::busy;
+
+        if (! ready)
+            return State::failedToStart;
+
+        return connectionLost ? State::crashed : State::timedOut;
+    }
+
+    bool hasLostConnection()
+    {
+        const std::lock_guard lock (mutex);
+        return connectionLost;
+    }
+
+    std::optional<Job> job;
+
+private:
+    void handleMessageFromWorker (const MemoryBlock& message) override
+    {
+        MemoryInputStream in (message, false);
+        const auto replyID = in.readInt();
+
+        {
+            const std::lock_guard lock (mutex);
+
+            if (replyID == ParallelPluginScannerHelpers::readyRequestID)
+                ready = true;
+            else if (replyID == requestID)
+                result = ParallelPluginScannerHelpers::readTypes (in);
+            else
+                return;
+        }
+
+        event.signal();
+    }
+
+    void handleConnectionLost() override
+    {
+        {
+            const std::lock_guard lock (mutex);
+            connectionLost = true;
+        }
+
+        event.signal();
+    }
+
+    WaitableEvent& event;
+    uint32 startTime = 0;
+
+    std::mutex mutex;
+    int requestID = ParallelPluginScannerHelpers::readyRequestID;
+    std::optional<Array<PluginDescription>> result;
+    bool ready = false, connectionLost = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+//==============================================================================
+ParallelPluginScanner::ParallelPluginScanner (KnownPluginList& listToAddResultsTo,
+                                              PluginScanCache& cacheToUse,
+                                              const Options& optionsToUse)
+    : list (listToAddResultsTo),
+      cache (cacheToUse),
+      options (optionsToUse)
+{
+}
+
+ParallelPluginScanner::ParallelPluginScanner (KnownPluginList& listToAddResultsTo,
+                                              PluginScanCache& cacheToUse)
+    : ParallelPluginScanner (listToAddResultsTo, cacheToUse, Options{})
+{
+}
+
+ParallelPluginScanner::~ParallelPluginScanner()
+{
+    workers.clear();
+}
+
+void ParallelPluginScanner::addFilesToScan (AudioPluginFormat& format, const StringArray& filesOrIdentifiers)
+{
+    for (auto& fileOrIdentifier : filesOrIdentifiers)
+        jobs.push_back ({ &format, fileOrIdentifier });
+}
+
+void ParallelPluginScanner::addDirectoriesToScan (AudioPluginFormat& format,
+                                                  const FileSearchPath& directoriesToSearch,
+                                                  bool recursive)
+{
+    auto directories = directoriesToSearch;
+    directories.removeRedundantPaths();
+    addFilesToScan (format, format.searchPathsForPlugins (directories, recursive));
+}
+
+void ParallelPluginScanner::cancel() noexcept
+{
+    cancelled = true;
+    workerEvent.signal();
+}
+
+StringArray ParallelPluginScanner::getFilesBeingScanned() const
+{
+    const ScopedLock sl (resultLock);
+    return filesBeingScanned;
+}
+
+StringArray ParallelPluginScanner::getFailedFiles() const
+{
+    const ScopedLock sl (resultLock);
+    return failedFiles;
+}
+
+String ParallelPluginScanner::getLastError() const
+{
+    const ScopedLock sl (resultLock);
+    return lastError;
+}
+
+void ParallelPluginScanner::setLastError (const String& error)
+{
+    const ScopedLock sl (resultLock);
+    lastError = error;
+}
+
+//==============================================================================
+bool ParallelPluginScanner::scan()
+{
+    {
+        const ScopedLock sl (resultLock);
+        failedFiles.clear();
+        lastError.clear();
+    }
+
+    const auto jobsToScan = std::exchange (jobs, {});
+    size_t nextJob = 0;
+    numJobsFinished = 0;
+    numJobsToScan = (int) jobsToScan.size();
+    numLaunchFailures = 0;
+    progress = 0.0f;
+
+    workers.resize ((size_t) jmax (1, options.numWorkers));
+
+    while (! cancelled)
+    {
+        auto anyWorkerFinished = false;
+
+        for (auto& worker : workers)
+            if (worker != nullptr && worker->job.has_value())
+                anyWorkerFinished = checkWorker (worker) || anyWorkerFinished;
+
+        if (numLaunchFailures >= ParallelPluginScannerHelpers::maxLaunchFailures)
+        {
+            setLastError (TRANS ("Couldn't launch a worker process to scan the plugins"));
+            break;
+        }
+
+        for (auto& worker : workers)
+            if (! remoteJobs.empty() && (worker == nullptr || ! worker->job.has_value()))
+                startNextRemoteJob (worker);
+
+        updateFilesBeingScanned();
+
+        // Files that can be dealt with here are handled one at a time, in between
+        // checking on the workers, so that the workers are kept busy
+        if (nextJob < jobsToScan.size())
+        {
+            const auto& job = jobsToScan[nextJob++];
+
+            if (! scanLocally (job))
+                remoteJobs.push_back (job);
+
+            continue;
+        }
+
+        const auto anyWorkerBusy = std::any_of (workers.begin(), workers.end(), [] (const auto& w)
+        {
+            return w != nullptr && w->job.has_value();
+        });
+
+        if (remoteJobs.empty() && ! anyWorkerBusy)
+            break;
+
+        if (! anyWorkerFinished)
+            workerEvent.wait (20);
+    }
+
+    workers.clear();
+    remoteJobs.clear();
+    updateFilesBeingScanned();
+    list.scanFinished();
+
+    const auto succeeded = ! cancelled && getLastError().isEmpty();
+    cancelled = false;
+    return succeeded;
+}
+
+bool ParallelPluginScanner::scanLocally (const Job& job)
+{
+    auto& format = *job.format;
+    const auto& fileOrIdentifier = job.fileOrIdentifier;
+
+    if (list.getBlacklistedFiles().contains (fileOrIdentifier))
+    {
+        ++numJobsFinished;
+        progress = (float) numJobsFinished / (float) numJobsToScan;
+        return true;
+    }
+
+    if (const auto cached = cache.find (format.getName(), fileOrIdentifier))
+    {
+        // Files that crashed are only scanned again once they're removed from the blacklist
+        if (cached->outcome == PluginScanCache::Outcome::typesFound
+             || cached->outcome == PluginScanCache::Outcome::noTypesFound)
+        {
+            finishJob (job, *cached);
+            return true;
+        }
+    }
+
+    OwnedArray<PluginDescription> found;
+
+    if (! format.findAllTypesForFileWithoutLoading (found, fileOrIdentifier))
+    {
+        if (! format.isTrivialToScan())
+            return false;
+
+        format.findAllTypesForFile (found, fileOrIdentifier);
+    }
+
+    PluginScanCache::Entry entry;
+    entry.outcome = found.isEmpty() ? PluginScanCache::Outcome::noTypesFound
+                                    : PluginScanCache::Outcome::typesFound;
+
+    for (auto* type : found)
+        entry.types.add (*type);
+
+    cache.add (format.getName(), fileOrIdentifier, entry);
+    finishJob (job, entry);
+    return true;
+}
+
+bool ParallelPluginScanner::startNextRemoteJob (std::unique_ptr<Worker>& worker)
+{
+    // A plugin may have left something running that crashed the worker after it finished
+    if (worker != nullptr && worker->hasLostConnection())
+        worker.reset();
+
+    if (worker == nullptr)
+    {
+        worker = std::make_unique<Worker> (workerEvent);
+
+        if (! worker->launch (options))
+        {
+            worker.reset();
+            ++numLaunchFailures;
+            return false;
+        }
+    }
+
+    worker->start (remoteJobs.front());
+    remoteJobs.pop_front();
+    return true;
+}
+
+bool ParallelPluginScanner::checkWorker (std::unique_ptr<Worker>& worker)
+{
+    Array<PluginDescription> types;
+    const auto state = worker->getState (options.timeoutMs, types);
+
+    if (state == Worker::State::busy)
+        return false;
+
+    const auto job = *worker->job;
+    worker->job.reset();
+
+    if (state == Worker::State::failedToStart)
+    {
+        // The file never reached the worker, so it can be tried again with a new one
+        remoteJobs.push_front (job);
+        worker.reset();
+        ++numLaunchFailures;
+        return true;
+    }
+
+    numLaunchFailures = 0;
+
+    PluginScanCache::Entry entry;
+
+    if (state == Worker::State::finished)
+    {
+        entry.outcome = types.isEmpty() ? PluginScanCache::Outcome::noTypesFound
+                                        : PluginScanCache::Outcome::typesFound;
+        entry.types = std::move (types);
+    }
+    else
+    {
+        entry.outcome = state == Worker::State::crashed ? PluginScanCache::Outcome::crashed
+                                                          : PluginScanCache::Outcome::timedOut;
+        worker.reset();
+    }
+
+    cache.add (job.format->getName(), job.fileOrIdentifier, entry);
+    finishJob (job, entry);
+    return true;
+}
+
+void ParallelPluginScanner::finishJob (const Job& job, const PluginScanCache::Entry& entry)
+{
+    for (auto& type : entry.types)
+        list.addType (type);
+
+    if (entry.outcome == PluginScanCache::Outcome::crashed
+         || entry.outcome == PluginScanCache::Outcome::timedOut)
+    {
+        list.addToBlacklist (job.fileOrIdentifier);
+    }
+
+    if (entry.outcome != PluginScanCache::Outcome::typesFound)
+    {
+        const ScopedLock sl (resultLock);
+        failedFiles.add (job.fileOrIdentifier);
+    }
+
+    ++numJobsFinished;
+    progress = (float) numJobsFinished / (float) numJobsToScan;
+
+    if (onFileScanned != nullptr)
+        onFileScanned (job.format->getName(), job.fileOrIdentifier, entry.outcome);
+}
+
+void ParallelPluginScanner::updateFilesBeingScanned()
+{
+    StringArray files;
+
+    for (auto& worker : workers)
+        if (worker != nullptr && worker->job.has_value())
+            files.add (worker->job->fileOrIdentifier);
+
+    const ScopedLock sl (resultLock);
+    filesBeingScanned.swapWith (files);
+}
+
+//==============================================================================
+PluginScannerWorker::PluginScannerWorker (AudioPluginFormatManager& formatManagerToUse)
+    : formatManager (formatManagerToUse)
+{
+}
+
+PluginScannerWorker::~PluginScannerWorker()
+{
+    cancelPendingUpdate();
+}
+
+bool PluginScannerWorker::initialiseFromCommandLine (const String& commandLine, const String& commandLineUniqueID)
+{
+    return ChildProcessWorker::initialiseFromCommandLine (commandLine, commandLineUniqueID);
+}
+
+void PluginScannerWorker::handleConnectionMade()
+{
+    MemoryOutputStream out;
+    out.writeInt (ParallelPluginScannerHelpers::readyRequestID);
+    sendMessageToCoordinator (out.getMemoryBlock());
+}
+
+void PluginScannerWorker::handleMessageFromCoordinator (const MemoryBlock& message)
+{
+    {
+        const ScopedLock sl (requestLock);
+        pendingRequests.add (message);
+    }
+
+    triggerAsyncUpdate();
+}
+
+void PluginScannerWorker::handleConnectionLost()
+{
+    hostLost = true;
+
+    // If a plugin has hung while it's being scanned, the message thread will never get
+    // the chance to shut down, so the process has to end here instead
+    if (scanning)
+        Process::terminate();
+
+    triggerAsyncUpdate();
+}
+
+void PluginScannerWorker::handleAsyncUpdate()
+{
+    while (! hostLost)
+    {
+        MemoryBlock request;
+
+        {
+            const ScopedLock sl (requestLock);
+
+            if (pendingRequests.isEmpty())
+                return;
+
+            request = pendingRequests.removeAndReturn (0);
+        }
+
+        scanFile (request);
+    }
+
+    if (onHostLost != nullptr)
+        onHostLost();
+    else
+        JUCEApplicationBase::quit();
+}
+
+void PluginScannerWorker::scanFile (const MemoryBlock& request)
+{
+    MemoryInputStream in (request, false);
+    const auto requestID = in.readInt();
+    const auto formatName = in.readString();
+    const auto fileOrIdentifier = in.readString();
+
+    OwnedArray<PluginDescription> found;
+
+    for (auto* format : formatManager.getFormats())
+    {
+        if (format->getName() == formatName)
+        {
+            scanning = true;
+
+            if (hostLost)
+            {
+                scanning = false;
+                return;
+            }
+
+            format->findAllTypesForFile (found, fileOrIdentifier);
+            scanning = false;
+            break;
+        }
+    }
+
+    sendMessageToCoordinator (ParallelPluginScannerHelpers::createReply (requestID, found));
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelPluginScannerTests final : public UnitTest
+{
+public:
+    ParallelPluginScannerTests()
+        : UnitTest ("ParallelPluginScanner", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        const TemporaryFile tempDir;
+        const auto dir = tempDir.getFile();
+        dir.createDirectory();
+
+        for (int i = 0; i < 12; ++i)
+            dir.getChildFile ("load" + String (i) + ".test").replaceWithText ("load " + String (i % 4));
+
+        for (int i = 0; i < 4; ++i)
+            dir.getChildFile ("info" + String (i) + ".test").replaceWithText ("info " + String (i + 1));
+
+        const FileSearchPath searchPath (dir.getFullPathName());
+
+        // The unit test runner can't act as a PluginScannerWorker, so these tests use
+        // files that can be scanned without launching a worker process
+        beginTest ("Scanning gives the same results as PluginDirectoryScanner");
+        {
+            TestFormat serialFormat (true);
+            KnownPluginList serialList;
+            PluginDirectoryScanner serialScanner (serialList, serialFormat, searchPath, false, File());
+            String nameOfPluginBeingScanned;
+
+            while (serialScanner.scanNextFile (true, nameOfPluginBeingScanned))
+            {}
+
+            TestFormat format (true);
+            KnownPluginList list;
+            PluginScanCache cache;
+            ParallelPluginScanner scanner (list, cache, getOptions());
+            scanner.addDirectoriesToScan (format, searchPath, false);
+
+            expect (scanner.scan());
+            expect (scanner.getLastError().isEmpty());
+            expectEquals (scanner.getProgress(), 1.0f);
+            expectEquals (list.getNumTypes(), 18 + 10);
+            expect (getIdentifiers (list) == getIdentifiers (serialList));
+            expect (sorted (scanner.getFailedFiles()) == sorted (serialScanner.getFailedFiles()));
+            expectEquals (format.numFilesLoaded.load(), serialFormat.numFilesLoaded.load() - 4);
+            expectEquals (cache.getNumEntries(), 16);
+        }
+
+        beginTest ("Unchanged files are taken from the cache");
+        {
+            PluginScanCache cache;
+            KnownPluginList firstList;
+
+            {
+                TestFormat format (true);
+                ParallelPluginScanner scanner (firstList, cache, getOptions());
+                scanner.addDirectoriesToScan (format, searchPath, false);
+                expect (scanner.scan());
+            }
+
+            TestFormat format (true);
+            KnownPluginList list;
+            std::map<String, PluginScanCache::Outcome> outcomes;
+
+            ParallelPluginScanner scanner (list, cache, getOptions());
+            scanner.onFileScanned = [&] (const String&, const String& file, PluginScanCache::Outcome outcome)
+            {
+                outcomes[file] = outcome;
+            };
+
+            scanner.addDirectoriesToScan (format, searchPath, false);
+            expect (scanner.scan());
+            expectEquals (format.numFilesLoaded.load(), 0);
+            expectEquals ((int) outcomes.size(), 16);
+            expect (getIdentifiers (list) == getIdentifiers (firstList));
+
+            const auto changed = dir.getChildFile ("load3.test");
+            changed.replaceWithText ("load 1\n");
+
+            KnownPluginList rescannedList;
+            ParallelPluginScanner rescanner (rescannedList, cache, getOptions());
+            rescanner.addDirectoriesToScan (format, searchPath, false);
+            expect (rescanner.scan());
+            expectEquals (format.numFilesLoaded.load(), 1);
+            expectEquals (rescannedList.getNumTypes(), list.getNumTypes() - 2);
+            expectEquals (cache.find (format.getName(), changed.getFullPathName())->types.size(), 1);
+        }
+
+        beginTest ("Blacklisted files are skipped");
+        {
+            TestFormat format (true);
+            KnownPluginList list;
+            PluginScanCache cache;
+            list.addToBlacklist (dir.getChildFile ("load2.test").getFullPathName());
+
+            ParallelPluginScanner scanner (list, cache, getOptions());
+            scanner.addDirectoriesToScan (format, searchPath, false);
+            expect (scanner.scan());
+            expectEquals (format.numFilesLoaded.load(), 11);
+            expect (list.getTypeForFile (dir.getChildFile ("load2.test").getFullPathName()) == nullptr);
+        }
+    }
+
+private:
+    /*  Each file holds either "load N", for a file that has to be loaded to find its
+        N types, or "info N", for a file whose N types can be found without loading it.
+    */
+    struct TestFormat final : public AudioPluginFormat
+    {
+        explicit TestFormat (bool trivialToScan)  : isTrivial (trivialToScan) {}
+
+        String getName() const override     { return "ScannerTest"; }
+
+        void findAllTypesForFile (OwnedArray<PluginDescription>& results, const String& file) override
+        {
+            ++numFilesLoaded;
+
+            if (! addTypes (results, file, "load"))
+                addTypes (results, file, "info");
+        }
+
+        bool findAllTypesForFileWithoutLoading (OwnedArray<PluginDescription>& results, const String& file) override
+        {
+            return addTypes (results, file, "info");
+        }
+
+        bool fileMightContainThisPluginType (const String& file) override                       { return file.endsWith (".test"); }
+        String getNameOfPluginFromIdentifier (const String& file) override                      { return File (file).getFileNameWithoutExtension(); }
+        bool pluginNeedsRescanning (const PluginDescription&) override                          { return false; }
+        bool doesPluginStillExist (const PluginDescription&) override                           { return true; }
+        bool canScanForPlugins() const override                                                 { return true; }
+        bool isTrivialToScan() const override                                                   { return isTrivial; }
+        FileSearchPath getDefaultLocationsToSearch() override                                   { return {}; }
+        bool requiresUnblockedMessageThreadDuringCreation (const PluginDescription&) const override { return false; }
+
+        StringArray searchPathsForPlugins (const FileSearchPath& directories, bool, bool) override
+        {
+            StringArray results;
+
+            for (int i = 0; i < directories.getNumPaths(); ++i)
+                for (const auto& file : directories[i].findChildFiles (File::findFiles, false, "*.test"))
+                    results.add (file.getFullPathName());
+
+            return results;
+        }
+
+        void createPluginInstance (const PluginDescription&, double, int, PluginCreationCallback callback) override
+        {
+            callback (nullptr, "Not supported");
+        }
+
+        bool addTypes (OwnedArray<PluginDescription>& results, const String& file, StringRef kind) const
+        {
+            const auto tokens = StringArray::fromTokens (File (file).loadFileAsString(), false);
+
+            if (tokens[0] != kind)
+                return false;
+
+            for (int i = 0; i < tokens[1].getIntValue(); ++i)
+            {
+                auto type = std::make_unique<PluginDescription>();
+                type->name = File (file).getFileNameWithoutExtension() + "_" + String (i);
+                type->pluginFormatName = getName();
+                type->fileOrIdentifier = file;
+                type->uniqueId = i + 1;
+                results.add (std::move (type));
+            }
+
+            return true;
+        }
+
+        const bool isTrivial;
+        std::atomic<int> numFilesLoaded { 0 };
+    };
+
+    static ParallelPluginScanner::Options getOptions()
+    {
+        return ParallelPluginScanner::Options{}.withNumWorkers (4);
+    }
+
+    static StringArray sorted (StringArray strings)
+    {
+        strings.sort (false);
+        return strings;
+    }
+
+    static StringArray getIdentifiers (const KnownPluginList& list)
+    {
+        StringArray result;
+
+        for (const auto& type : list.getTypes())
+            result.add (type.createIdentifierString() + " " + type.name);
+
+        return sorted (result);
+    }
+};
+
+static ParallelPluginScannerTests parallelPluginScannerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Scans plugin files using several worker processes at the same time, and adds
+    the types it finds to a KnownPluginList.
+
+    Each file that needs to be loaded is scanned in one of the worker processes, so
+    if a plugin crashes or hangs while it's being scanned, only that worker is
+    affected. The worker is replaced, the file is added to the list's blacklist, and
+    the scan carries on with the other files.
+
+    Before a file is sent to a worker, the scanner tries to avoid loading it at all:
+
+    - If the PluginScanCache has an entry for the file and the file hasn't changed
+      since, the cached types are added to the list. Files that are cached as having
+      crashed or timed out are skipped while they're still on the list's blacklist,
+      so removing a file from the blacklist makes it get scanned again.
+    - If the format can find the file's types without loading it, for example from a
+      VST3's moduleinfo.json, those types are used.
+    - If the format says that it's trivial to scan, the file is scanned in this process.
+
+    Any files that are already on the list's blacklist are skipped.
+
+    The workers are launched by running an executable with a special command line,
+    and this executable must create a PluginScannerWorker when it starts, in the same
+    way as ChildProcessWorker is used. By default, the app's own executable is launched,
+    so an app can do something like this in its JUCEApplication::initialise() method:
+
+    @code
+    void initialise (const String& commandLine) override
+    {
+        auto worker = std::make_unique<PluginScannerWorker> (formatManager);
+
+        if (worker->initialiseFromCommandLine (commandLine))
+        {
+            scannerWorker = std::move (worker);
+            return;
+        }
+
+        // ..carry on starting up normally..
+    }
+    @endcode
+
+    @see PluginScannerWorker, PluginScanCache, PluginDirectoryScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  ParallelPluginScanner
+{
+public:
+    //==============================================================================
+    /** The default ID that's used to recognise the command line of a worker process. */
+    static constexpr const char* defaultCommandLineUniqueID = "juceScanPlugins";
+
+    /** Settings that control how the worker processes are launched and used. */
+    struct Options
+    {
+        /** The executable to launch for each worker process. This must create a
+            PluginScannerWorker when it starts.
+        */
+        [[nodiscard]] Options withWorkerExecutable (const File& newWorkerExecutable) const
+        {
+            return withMember (*this, &Options::workerExecutable, newWorkerExecutable);
+        }
+
+        /** The ID that the worker's PluginScannerWorker::initialiseFromCommandLine()
+            uses to recognise its command line.
+        */
+        [[nodiscard]] Options withCommandLineUniqueID (const String& newCommandLineUniqueID) const
+        {
+            return withMember (*this, &Options::commandLineUniqueID, newCommandLineUniqueID);
+        }
+
+        /** The maximum number of worker processes to run at once. */
+        [[nodiscard]] Options withNumWorkers (int newNumWorkers) const
+        {
+            return withMember (*this, &Options::numWorkers, newNumWorkers);
+        }
+
+        /** How long a worker may take to scan a single file. If it takes longer, the
+            worker is shut down and the file is treated as if it had crashed.
+        */
+        [[nodiscard]] Options withTimeoutMs (int newTimeoutMs) const
+        {
+            return withMember (*this, &Options::timeoutMs, newTimeoutMs);
+        }
+
+        File workerExecutable { File::getSpecialLocation (File::currentExecutableFile) };
+        String commandLineUniqueID { defaultCommandLineUniqueID };
+        int numWorkers = SystemStats::getNumCpus();
+        int timeoutMs = 30000;
+    };
+
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param listToAddResultsTo   the list that the types that are found get added to, and
+                                    whose blacklist is used to skip files
+        @param cacheToUse           the cache that's used to skip unchanged files, and which
+                                    is updated with the results of the scan
+        @param options              the settings to use for the worker processes
+    */
+    ParallelPluginScanner (KnownPluginList& listToAddResultsTo,
+                           PluginScanCache& cacheToUse,
+                           const Options& options);
+
+    /** Creates a scanner that uses the default Options. */
+    ParallelPluginScanner (KnownPluginList& listToAddResultsTo,
+                           PluginScanCache& cacheToUse);
+
+    /** Destructor. This shuts down any worker processes that are still running. */
+    ~ParallelPluginScanner();
+
+    //==============================================================================
+    /** Adds some files or identifiers to the list of things to scan.
+        @see AudioPluginFormat::searchPathsForPlugins
+    */
+    void addFilesToScan (AudioPluginFormat& format, const StringArray& filesOrIdentifiers);
+
+    /** Searches some directories for files that might contain plugins of the given format,
+        and adds them to the list of things to scan.
+    */
+    void addDirectoriesToScan (AudioPluginFormat& format, const FileSearchPath& directoriesToSearch, bool recursive);
+
+    /** Scans all the files that have been added, and clears the list of files to scan.
+
+        This blocks until all the files have been scanned, so it should be called on a
+        background thread if possible.
+
+        Returns false if the scan was cancelled, or if the worker processes couldn't be
+        launched, in which case getLastError() describes the problem.
+    */
+    bool scan();
+
+    /** Makes scan() return as soon as possible. This can be called from any thread. */
+    void cancel() noexcept;
+
+    /** Returns the proportion of the files that have been scanned, between 0 and 1. */
+    float getProgress() const noexcept                  { return progress; }
+
+    /** Returns the files that are currently being scanned by the worker processes. */
+    StringArray getFilesBeingScanned() const;
+
+    /** Returns the files that were scanned by the last call to scan(), but which didn't
+        contain any plugins, or which crashed or timed out.
+    */
+    StringArray getFailedFiles() const;
+
+    /** Returns a description of the reason that the last call to scan() failed. */
+    String getLastError() const;
+
+    /** Called on the scanning thread after each file has been dealt with, whether it was
+        scanned or its entry in the cache was used.
+    */
+    std::function<void (const String& formatName, const String& fileOrIdentifier, PluginScanCache::Outcome)> onFileScanned;
+
+private:
+    //==============================================================================
+    struct Job
+    {
+        AudioPluginFormat* format = nullptr;
+        String fileOrIdentifier;
+    };
+
+    class Worker;
+
+    bool scanLocally (const Job&);
+    bool startNextRemoteJob (std::unique_ptr<Worker>&);
+    bool checkWorker (std::unique_ptr<Worker>&);
+    void finishJob (const Job&, const PluginScanCache::Entry&);
+    void updateFilesBeingScanned();
+    void setLastError (const String&);
+
+    KnownPluginList& list;
+    PluginScanCache& cache;
+    const Options options;
+
+    std::vector<Job> jobs;
+    std::deque<Job> remoteJobs;
+    std::vector<std::unique_ptr<Worker>> workers;
+    WaitableEvent workerEvent;
+    int numJobsToScan = 0, numJobsFinished = 0, numLaunchFailures = 0;
+
+    mutable CriticalSection resultLock;
+    StringArray filesBeingScanned, failedFiles;
+    String lastError;
+
+    std::atomic<float> progress { 0.0f };
+    std::atomic<bool> cancelled { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelPluginScanner)
+};
+
+//==============================================================================
+/**
+    Scans plugin files for a ParallelPluginScanner in a worker process.
+
+    Create one of these when your app starts, and call initialiseFromCommandLine()
+    to find out whether the app was launched as a worker. If it was, keep the
+    object alive: it'll scan the files that the scanner asks it to until the
+    scanner shuts it down.
+
+    @see ParallelPluginScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  PluginScannerWorker  : private ChildProcessWorker,
+                                       private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a worker that will use a format manager to scan files.
+        The format manager must contain the same formats as the ones that are being
+        scanned, and mustn't be deleted before the worker.
+    */
+    explicit PluginScannerWorker (AudioPluginFormatManager& formatManagerToUse);
+
+    /** Destructor. */
+    ~PluginScannerWorker() override;
+
+    //==============================================================================
+    /** Checks whether the command line is one that was used to launch a worker, and
+        if so, connects to the scanner.
+
+        @param commandLine          the command line that the app was launched with
+        @param commandLineUniqueID  the ID that was passed to ParallelPluginScanner::Options
+        @returns true if the app is a worker and has connected to its scanner
+    */
+    bool initialiseFromCommandLine (const String& commandLine,
+                                    const String& commandLineUniqueID = ParallelPluginScanner::defaultCommandLineUniqueID);
+
+    /** Called on the message thread when the scanner disconnects or goes away.
+        If this isn't set, the worker calls JUCEApplicationBase::quit().
+    */
+    std::function<void()> onHostLost;
+
+private:
+    //==============================================================================
+    void handleConnectionMade() override;
+    void handleMessageFromCoordinator (const MemoryBlock&) override;
+    void handleConnectionLost() override;
+    void handleAsyncUpdate() override;
+    void scanFile (const MemoryBlock&);
+
+    AudioPluginFormatManager& formatManager;
+
+    CriticalSection requestLock;
+    Array<MemoryBlock> pendingRequests;
+    std::atomic<bool> hostLost { false }, scanning { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginScannerWorker)
+};
+
+} // namespace juce
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+static const char* getOutcomeName (PluginScanCache::Outcome outcome)
+{
+    switch (outcome)
+    {
+        case PluginScanCache::Outcome::typesFound:      return "typesFound";
+        case PluginScanCache::Outcome::noTypesFound:    return "noTypesFound";
+        case PluginScanCache::Outcome::crashed:         return "crashed";
+        case PluginScanCache::Outcome::timedOut:        return "timedOut";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+static std::optional<PluginScanCache::Outcome> getOutcomeForName (const String& name)
+{
+    for (auto outcome : { PluginScanCache::Outcome::typesFound,
+                          PluginScanCache::Outcome::noTypesFound,
+                          PluginScanCache::Outcome::crashed,
+                          PluginScanCache::Outcome::timedOut })
+    {
+        if (name == getOutcomeName (outcome))
+            return outcome;
+    }
+
+    return {};
+}
+
+//==============================================================================
+PluginScanCache::PluginScanCache()  = default;
+PluginScanCache::~PluginScanCache() = default;
+
+std::optional<PluginScanCache::Fingerprint> PluginScanCache::getFingerprint (const String& fileOrIdentifier)
+{
+    if (! File::isAbsolutePath (fileOrIdentifier))
+        return {};
+
+    const File file (fileOrIdentifier);
+
+    if (file.existsAsFile())
+        return Fingerprint { file.getSize(), file.getLastModificationTime().toMilliseconds() };
+
+    if (! file.isDirectory())
+        return {};
+
+    Fingerprint result { 0, file.getLastModificationTime().toMilliseconds() };
+
+    for (const auto& entry : RangedDirectoryIterator (file, true, "*", File::findFilesAndDirectories))
+    {
+        result.size += entry.getFileSize();
+        result.modificationTime = jmax (result.modificationTime, entry.getModificationTime().toMilliseconds());
+    }
+
+    return result;
+}
+
+std::optional<PluginScanCache::Entry> PluginScanCache::find (const String& formatName, const String& fileOrIdentifier) const
+{
+    const auto fingerprint = getFingerprint (fileOrIdentifier);
+
+    if (! fingerprint.has_value())
+        return {};
+
+    const ScopedLock sl (lock);
+    const auto iter = entries.find ({ formatName, fileOrIdentifier });
+
+    if (iter == entries.end() || ! (iter->second.fingerprint == *fingerprint))
+        return {};
+
+    return iter->second.entry;
+}
+
+void PluginScanCache::add (const String& formatName, const String& fileOrIdentifier, const Entry& entry)
+{
+    if (const auto fingerprint = getFingerprint (fileOrIdentifier))
+    {
+        const ScopedLock sl (lock);
+        entries[{ formatName, fileOrIdentifier }] = { *fingerprint, entry };
+    }
+}
+
+void PluginScanCache::remove (const String& formatName, const String& fileOrIdentifier)
+{
+    const ScopedLock sl (lock);
+    entries.erase ({ formatName, fileOrIdentifier });
+}
+
+void PluginScanCache::clear()
+{
+    const ScopedLock sl (lock);
+    entries.clear();
+}
+
+int PluginScanCache::getNumEntries() const
+{
+    const ScopedLock sl (lock);
+    return (int) entries.size();
+}
+
+//==============================================================================
+std::unique_ptr<XmlElement> PluginScanCache::createXml() const
+{
+    auto xml = std::make_unique<XmlElement> ("PLUGINSCANCACHE");
+
+    const ScopedLock sl (lock);
+
+    for (const auto& [key, stored] : entries)
+    {
+        auto* e = xml->createNewChildElement ("FILE");
+        e->setAttribute ("format", key.first);
+        e->setAttribute ("file", key.second);
+        e->setAttribute ("size", String (stored.fingerprint.size));
+        e->setAttribute ("modified", String (stored.fingerprint.modificationTime));
+        e->setAttribute ("outcome", getOutcomeName (stored.entry.outcome));
+
+        for (const auto& type : stored.entry.types)
+            e->addChildElement (type.createXml().release());
+    }
+
+    return xml;
+}
+
+void PluginScanCache::recreateFromXml (const XmlElement& xml)
+{
+    const ScopedLock sl (lock);
+    entries.clear();
+
+    if (! xml.hasTagName ("PLUGINSCANCACHE"))
+        return;
+
+    for (auto* e : xml.getChildWithTagNameIterator ("FILE"))
+    {
+        const auto outcome = getOutcomeForName (e->getStringAttribute ("outcome"));
+
+        if (! outcome.has_value())
+            continue;
+
+        StoredEntry stored;
+        stored.fingerprint.size = e->getStringAttribute ("size").getLargeIntValue();
+        stored.fingerprint.modificationTime = e->getStringAttribute ("modified").getLargeIntValue();
+        stored.entry.outcome = *outcome;
+
+        for (auto* typeXml : e->getChildIterator())
+        {
+            PluginDescription type;
+
+            if (type.loadFromXml (*typeXml))
+                stored.entry.types.add (type);
+        }
+
+        entries[{ e->getStringAttribute ("format"), e->getStringAttribute ("file") }] = stored;
+    }
+}
+
+bool PluginScanCache::loadFromFile (const File& file)
+{
+    if (auto xml = parseXML (file))
+    {
+        recreateFromXml (*xml);
+        return true;
+    }
+
+    return false;
+}
+
+bool PluginScanCache::saveToFile (const File& file) const
+{
+    return createXml()->writeTo (file);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PluginScanCacheTests final : public UnitTest
+{
+public:
+    PluginScanCacheTests()
+        : UnitTest ("PluginScanCache", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        const TemporaryFile tempDir;
+        const auto dir = tempDir.getFile();
+        dir.createDirectory();
+
+        const auto plugin = dir.getChildFile ("plugin.test");
+        plugin.replaceWithText ("abcd");
+        const auto path = plugin.getFullPathName();
+
+        beginTest ("An unchanged file is found in the cache");
+        {
+            PluginScanCache cache;
+            expect (! cache.find ("Test", path).has_value());
+
+            cache.add ("Test", path, createEntry (path, 2));
+            expectEquals (cache.getNumEntries(), 1);
+
+            const auto found = cache.find ("Test", path);
+            expect (found.has_value());
+            expect (found->outcome == PluginScanCache::Outcome::typesFound);
+            expectEquals (found->types.size(), 2);
+            expectEquals (found->types[1].name, String ("type1"));
+
+            expect (! cache.find ("Other", path).has_value());
+
+            cache.remove ("Test", path);
+            expect (! cache.find ("Test", path).has_value());
+        }
+
+        beginTest ("Identifiers that aren't absolute paths aren't cached");
+        {
+            PluginScanCache cache;
+            cache.add ("Test", "plugin.test", createEntry (path, 1));
+            cache.add ("Test", dir.getChildFile ("missing.test").getFullPathName(), createEntry (path, 1));
+            expectEquals (cache.getNumEntries(), 0);
+        }
+
+        beginTest ("Changing a file's modification time makes it miss the cache");
+        {
+            PluginScanCache cache;
+            cache.add ("Test", path, createEntry (path, 1));
+            expect (cache.find ("Test", path).has_value());
+
+            expect (plugin.setLastModificationTime (plugin.getLastModificationTime() - RelativeTime::hours (1)));
+            expect (! cache.find ("Test", path).has_value());
+
+            cache.add ("Test", path, createEntry (path, 1));
+            expect (cache.find ("Test", path).has_value());
+        }
+
+        beginTest ("Changing a file's size makes it miss the cache");
+        {
+            PluginScanCache cache;
+            cache.add ("Test", path, createEntry (path, 1));
+
+            const auto modificationTime = plugin.getLastModificationTime();
+            plugin.replaceWithText ("abcdefgh");
+            plugin.setLastModificationTime (modificationTime);
+
+            expect (! cache.find ("Test", path).has_value());
+        }
+
+        beginTest ("Changing a file inside a bundle makes the bundle miss the cache");
+        {
+            const auto bundle = dir.getChildFile ("bundle.test");
+            const auto binary = bundle.getChildFile ("Contents").getChildFile ("binary");
+            binary.create();
+            binary.replaceWithText ("abcd");
+
+            PluginScanCache cache;
+            cache.add ("Test", bundle.getFullPathName(), createEntry (bundle.getFullPathName(), 1));
+            expect (cache.find ("Test", bundle.getFullPathName()).has_value());
+
+            binary.appendText ("efgh");
+            expect (! cache.find ("Test", bundle.getFullPathName()).has_value());
+        }
+
+        beginTest ("Entries are kept when the cache is saved and reloaded");
+        {
+            const auto other = dir.getChildFile ("other.test");
+            other.replaceWithText ("efgh");
+
+            PluginScanCache cache;
+            cache.add ("Test", path, createEntry (path, 3));
+            cache.add ("Test", other.getFullPathName(), { PluginScanCache::Outcome::crashed, {} });
+
+            const auto cacheFile = dir.getChildFile ("cache.xml");
+            expect (cache.saveToFile (cacheFile));
+
+            PluginScanCache reloaded;
+            expect (reloaded.loadFromFile (cacheFile));
+            expectEquals (reloaded.getNumEntries(), 2);
+
+            const auto found = reloaded.find ("Test", path);
+            expect (found.has_value());
+            expect (found->outcome == PluginScanCache::Outcome::typesFound);
+            expectEquals (found->types.size(), 3);
+
+            for (int i = 0; i < found->types.size(); ++i)
+                expect (found->types[i].isDuplicateOf (createEntry (path, 3).types[i]));
+
+            const auto crashed = reloaded.find ("Test", other.getFullPathName());
+            expect (crashed.has_value());
+            expect (crashed->outcome == PluginScanCache::Outcome::crashed);
+            expect (crashed->types.isEmpty());
+
+            // The reloaded entries still check the files' fingerprints
+            other.appendText ("ijkl");
+            expect (! reloaded.find ("Test", other.getFullPathName()).has_value());
+
+            expect (! reloaded.loadFromFile (dir.getChildFile ("missing.xml")));
+        }
+    }
+
+private:
+    static PluginScanCache::Entry createEntry (const String& path, int numTypes)
+    {
+        PluginScanCache::Entry entry;
+        entry.outcome = PluginScanCache::Outcome::typesFound;
+
+        for (int i = 0; i < numTypes; ++i)
+        {
+            PluginDescription type;
+            type.name = "type" + String (i);
+            type.pluginFormatName = "Test";
+            type.fileOrIdentifier = path;
+            type.uniqueId = i + 1;
+            entry.types.add (type);
+        }
+
+        return entry;
+    }
+};
+
+static PluginScanCacheTests pluginScanCacheTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Remembers the results of scanning plugin files, so that files which haven't
+    changed don't need to be scanned again.
+
+    Each entry is identified by a format name and a file, and records the types that
+    were found in the file, or the reason why none were found. Along with this, the
+    file's size and modification time are stored, and find() will ignore any entry
+    whose file has changed since then. For a bundle, the total size of the files
+    inside it and the latest of their modification times are used, so that updating
+    the binary inside a bundle is noticed.
+
+    Only identifiers that are absolute file paths can be stored, so this won't
+    remember things like AudioUnit component IDs.
+
+    The cache can be saved as XML, or written to a file, to keep the results
+    between runs of the app.
+
+    @see ParallelPluginScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  PluginScanCache
+{
+public:
+    //==============================================================================
+    /** Creates an empty cache. */
+    PluginScanCache();
+
+    /** Destructor. */
+    ~PluginScanCache();
+
+    //==============================================================================
+    /** The result of scanning a file. */
+    enum class Outcome
+    {
+        typesFound,         /**< The file was scanned, and contained some plugin types. */
+        noTypesFound,       /**< The file was scanned, but didn't contain any plugin types. */
+        crashed,            /**< The process that was scanning the file crashed. */
+        timedOut            /**< The file took too long to scan. */
+    };
+
+    /** An entry in the cache. */
+    struct Entry
+    {
+        Outcome outcome = Outcome::noTypesFound;
+        Array<PluginDescription> types;
+    };
+
+    //==============================================================================
+    /** Returns the stored entry for a file, or nullopt if there isn't one, or if the
+        file has changed since the entry was added.
+    */
+    std::optional<Entry> find (const String& formatName, const String& fileOrIdentifier) const;
+
+    /** Adds or replaces the entry for a file, along with its current size and
+        modification time. If the identifier isn't a file path, this does nothing.
+    */
+    void add (const String& formatName, const String& fileOrIdentifier, const Entry& entry);
+
+    /** Removes the entry for a file. */
+    void remove (const String& formatName, const String& fileOrIdentifier);
+
+    /** Removes all the entries. */
+    void clear();
+
+    /** Returns the number of entries in the cache. */
+    int getNumEntries() const;
+
+    //==============================================================================
+    /** Creates some XML that can be used to store the contents of the cache. */
+    std::unique_ptr<XmlElement> createXml() const;
+
+    /** Replaces the contents of the cache with some XML that was created by createXml(). */
+    void recreateFromXml (const XmlElement& xml);
+
+    /** Replaces the contents of the cache with the XML stored in a file.
+        Returns false if the file couldn't be read.
+    */
+    bool loadFromFile (const File& file);
+
+    /** Writes the contents of the cache to a file as XML.
+        Returns false if the file couldn't be written.
+    */
+    bool saveToFile (const File& file) const;
+
+private:
+    //==============================================================================
+    struct Fingerprint
+    {
+        int64 size = 0, modificationTime = 0;
+
+        bool operator== (const Fingerprint& other) const noexcept
+        {
+            return size == other.size && modificationTime == other.modificationTime;
+        }
+    };
+
+    struct StoredEntry
+    {
+        Fingerprint fingerprint;
+        Entry entry;
+    };
+
+    using Key = std::pair<String, String>;
+
+    static std::optional<Fingerprint> getFingerprint (const String& fileOrIdentifier);
+
+    std::map<Key, StoredEntry> entries;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginScanCache)
+};
+
+} // namespace juce
@@ -38,6 +38,11 @@ namespace juce
 AudioPluginFormat::AudioPluginFormat() {}
 AudioPluginFormat::~AudioPluginFormat() {}
 
+bool AudioPluginFormat::findAllTypesForFileWithoutLoading (OwnedArray<PluginDescription>&, const String&)
+{
+    return false;
+}
+
 std::unique_ptr<AudioPluginInstance> AudioPluginFormat::createInstanceFromDescription (const PluginDescription& desc,
                                                                                        double initialSampleRate,
                                                                                        int initialBufferSize)
@@ -67,6 +67,20 @@ public:
     virtual void findAllTypesForFile (OwnedArray<PluginDescription>& results,
                                       const String& fileOrIdentifier) = 0;
 
+    /** Tries to create descriptions for the plugin types in a file without loading any
+        of its code, e.g. by reading a metadata file that's stored alongside the binary.
+
+        This is safe to call for files that might crash when they're loaded, so a scanner
+        can try it before going to the trouble of launching a separate process to call
+        findAllTypesForFile().
+
+        Returns false if the descriptions couldn't be found this way, in which case
+        findAllTypesForFile() must be used instead. The default implementation always
+        returns false.
+    */
+    virtual bool findAllTypesForFileWithoutLoading (OwnedArray<PluginDescription>& results,
+                                                    const String& fileOrIdentifier);
+
     /** Tries to recreate a type from a previously generated PluginDescription.
         @see AudioPluginFormatManager::createInstance
     */
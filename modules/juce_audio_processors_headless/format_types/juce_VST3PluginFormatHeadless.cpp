@@ -56,13 +56,8 @@ void VST3PluginFormatHeadless::findAllTypesForFile (OwnedArray<PluginDescription
     if (! fileMightContainThisPluginType (fileOrIdentifier))
         return;
 
-    if (const auto fast = DescriptionLister::findDescriptionsFast (File (fileOrIdentifier)); ! fast.empty())
-    {
-        for (const auto& d : fast)
-            results.add (new PluginDescription (d));
-
+    if (findAllTypesForFileWithoutLoading (results, fileOrIdentifier))
         return;
-    }
 
     for (const auto& file : getLibraryPaths (*this, fileOrIdentifier))
     {
@@ -89,6 +84,19 @@ void VST3PluginFormatHeadless::findAllTypesForFile (OwnedArray<PluginDescription
     }
 }
 
+bool VST3PluginFormatHeadless::findAllTypesForFileWithoutLoading (OwnedArray<PluginDescription>& results, const String& fileOrIdentifier)
+{
+    if (! fileMightContainThisPluginType (fileOrIdentifier))
+        return false;
+
+    const auto fast = DescriptionLister::findDescriptionsFast (File (fileOrIdentifier));
+
+    for (const auto& d : fast)
+        results.add (new PluginDescription (d));
+
+    return ! fast.empty();
+}
+
 void VST3PluginFormatHeadless::createARAFactoryAsync (const PluginDescription& description, ARAFactoryCreationCallback callback)
 {
     if (! description.hasARAExtension)
@@ -46,6 +46,10 @@
 
 #include "juce_audio_processors_headless.h"
 
+#if JUCE_LINUX
+ #include <juce_events/native/juce_SharedMemory_linux.h>
+#endif
+
 #include <juce_audio_processors_headless/processors/juce_AudioProcessorListener.cpp>
 #include <juce_audio_processors_headless/utilities/juce_AAXClientExtensions.cpp>
 #include <juce_audio_processors_headless/utilities/juce_VST2ClientExtensions.cpp>
@@ -71,3 +75,4 @@
 #include <juce_audio_processors_headless/format_types/juce_VSTPluginFormatHeadless.cpp>
 #include <juce_audio_processors_headless/format_types/juce_ARAHosting.cpp>
 #include <juce_audio_processors_headless/format/juce_AudioPluginFormatManager.cpp>
+#include <juce_audio_processors_headless/processors/juce_OutOfProcessPluginInstance.cpp>
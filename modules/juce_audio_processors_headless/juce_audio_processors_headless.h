@@ -162,3 +162,4 @@
 #include <juce_audio_processors_headless/format_types/juce_VSTPluginFormatHeadless.h>
 #include <juce_audio_processors_headless/format_types/juce_ARAHosting.h>
 #include <juce_audio_processors_headless/format/juce_AudioPluginFormatManager.h>
+#include <juce_audio_processors_headless/processors/juce_OutOfProcessPluginInstance.h>
@@ -0,0 +1,1955 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace OutOfProcessPluginHelpers
+{
+    enum class MessageType : int32
+    {
+        reply,
+        createInstance,
+        prepare,
+        release,
+        reset,
+        setNonRealtime,
+        getState,
+        setState,
+        setCurrentProgram,
+        changeProgramName,
+        getParameterText,
+        getParameterValueForText,
+        checkBusesLayout,
+        latencyChanged,
+        programChanged
+    };
+
+    //==============================================================================
+    /*  The shared memory that holds the parameter values is laid out as a ControlHeader
+        followed by a ParameterSlot for each parameter.
+    */
+    struct ParameterSlot
+    {
+        std::atomic<float> hostValue { 0.0f };
+        std::atomic<uint32> hostValueChanged { 0 };
+        std::atomic<float> pluginValue { 0.0f };
+        std::atomic<uint32> pluginValueChanged { 0 };
+    };
+
+    struct ControlHeader
+    {
+        static constexpr uint32 magicValue = 0x4f4f5043;
+
+        ParameterSlot& getSlot (int index) noexcept     { return reinterpret_cast<ParameterSlot*> (this + 1)[index]; }
+
+        static size_t getSizeNeeded (int numParameters) noexcept
+        {
+            return sizeof (ControlHeader) + sizeof (ParameterSlot) * (size_t) numParameters;
+        }
+
+        uint32 magic = magicValue;
+        int32 numParameters = 0;
+        alignas (64) std::atomic<uint32> hostChangesPending { 0 };
+        alignas (64) std::atomic<uint32> pluginChangesPending { 0 };
+    };
+
+    /*  The shared memory that's used for processing is laid out as an AudioHeader, followed
+        by the incoming and outgoing MIDI, and then the audio channels.
+
+        The host increments jobSequence when it has written a block for the worker to
+        process, and the worker sets doneSequence to the same value when it has finished.
+    */
+    struct AudioHeader
+    {
+        static constexpr uint32 magicValue = 0x4f4f5041;
+
+        enum Flags : uint32
+        {
+            bypassed    = 1,
+            hasPosition = 2
+        };
+
+        uint32 magic = magicValue;
+        int32 numChannels = 0, maxBlockSize = 0, midiBufferSize = 0;
+
+        alignas (64) std::atomic<uint32> jobSequence { 0 };
+        alignas (64) std::atomic<uint32> doneSequence { 0 };
+
+        alignas (64) int32 numSamples = 0;
+        int32 numMidiInBytes = 0, numMidiOutBytes = 0;
+        uint32 flags = 0;
+        AudioPlayHead::PositionInfo position;
+    };
+
+    static_assert (std::atomic<uint32>::is_always_lock_free && std::atomic<float>::is_always_lock_free,
+                   "The values in shared memory must be lock-free to work between processes");
+    static_assert (std::is_trivially_copyable_v<AudioPlayHead::PositionInfo>);
+
+    /*  The sizes that decide where everything is in the audio memory. The worker writes them
+        into the AudioHeader so that the host can check them, but each side keeps its own copy
+        to work from, so that the other process can't change them.
+    */
+    struct AudioLayout
+    {
+        size_t getChannelStride() const noexcept
+        {
+            return ((size_t) maxBlockSize + 15) & ~(size_t) 15;
+        }
+
+        size_t getChannelDataOffset() const noexcept
+        {
+            return (sizeof (AudioHeader) + 2 * (size_t) midiBufferSize + 63) & ~(size_t) 63;
+        }
+
+        size_t getSizeNeeded() const noexcept
+        {
+            return getChannelDataOffset() + sizeof (float) * getChannelStride() * (size_t) numChannels;
+        }
+
+        uint8* getMidiIn (AudioHeader& header) const noexcept     { return reinterpret_cast<uint8*> (&header + 1); }
+        uint8* getMidiOut (AudioHeader& header) const noexcept    { return getMidiIn (header) + midiBufferSize; }
+
+        float* getChannel (AudioHeader& header, int index) const noexcept
+        {
+            jassert (isPositiveAndBelow (index, numChannels));
+
+            return reinterpret_cast<float*> (reinterpret_cast<uint8*> (&header) + getChannelDataOffset())
+                     + getChannelStride() * (size_t) index;
+        }
+
+        void writeTo (AudioHeader& header) const noexcept
+        {
+            header.numChannels = numChannels;
+            header.maxBlockSize = maxBlockSize;
+            header.midiBufferSize = midiBufferSize;
+        }
+
+        /*  Checks that a block of memory that the worker has created is laid out as expected. */
+        bool matches (const AudioHeader& header, size_t regionSize) const noexcept
+        {
+            return header.magic == AudioHeader::magicValue
+                && header.numChannels == numChannels
+                && header.maxBlockSize == maxBlockSize
+                && header.midiBufferSize == midiBufferSize
+                && regionSize >= getSizeNeeded();
+        }
+
+        int numChannels = 0, maxBlockSize = 0, midiBufferSize = 0;
+    };
+
+    //==============================================================================
+   #if JUCE_LINUX
+    using SharedMemoryRegion = detail::SharedMemoryRegion;
+    using Futex = detail::Futex;
+   #else
+    // Out-of-process plugins are only supported on Linux, so these just fail
+    struct SharedMemoryRegion
+    {
+        static std::unique_ptr<SharedMemoryRegion> create (const String&, size_t, bool)   { return {}; }
+        static std::unique_ptr<SharedMemoryRegion> open (const String&, size_t)           { return {}; }
+
+        void removeName() {}
+        String getName() const              { return {}; }
+        void* getData() const noexcept      { return nullptr; }
+        size_t getSize() const noexcept     { return 0; }
+    };
+
+    struct Futex
+    {
+        static void wait (std::atomic<uint32>& value, uint32 expectedValue, double timeoutMs)
+        {
+            const auto endTime = Time::getMillisecondCounterHiRes() + timeoutMs;
+
+            while (value.load() == expectedValue && Time::getMillisecondCounterHiRes() < endTime)
+                Thread::yield();
+        }
+
+        static void wake (std::atomic<uint32>&) {}
+    };
+   #endif
+
+    //==============================================================================
+    static void writeChannelSet (OutputStream& out, const AudioChannelSet& set)
+    {
+        const auto types = set.getChannelTypes();
+        out.writeInt (types.size());
+
+        for (auto type : types)
+            out.writeInt ((int) type);
+    }
+
+    static AudioChannelSet readChannelSet (InputStream& in)
+    {
+        AudioChannelSet set;
+
+        for (int i = jlimit (0, 1024, in.readInt()); --i >= 0;)
+            set.addChannel ((AudioChannelSet::ChannelType) in.readInt());
+
+        return set;
+    }
+
+    static void writeBusesLayout (OutputStream& out, const AudioProcessor::BusesLayout& layout)
+    {
+        for (auto* buses : { &layout.inputBuses, &layout.outputBuses })
+        {
+            out.writeInt (buses->size());
+
+            for (auto& set : *buses)
+                writeChannelSet (out, set);
+        }
+    }
+
+    static AudioProcessor::BusesLayout readBusesLayout (InputStream& in)
+    {
+        AudioProcessor::BusesLayout layout;
+
+        for (auto* buses : { &layout.inputBuses, &layout.outputBuses })
+            for (int i = jlimit (0, 1024, in.readInt()); --i >= 0;)
+                buses->add (readChannelSet (in));
+
+        return layout;
+    }
+
+    static void writeMemory (OutputStream& out, const MemoryBlock& block)
+    {
+        out.writeInt ((int) block.getSize());
+        out << block;
+    }
+
+    static MemoryBlock readMemory (InputStream& in)
+    {
+        MemoryBlock block;
+        in.readIntoMemoryBlock (block, jmax (0, in.readInt()));
+        return block;
+    }
+
+    //==============================================================================
+    /*  MIDI is passed through shared memory as a sequence of records, each containing
+        the sample position and size of an event followed by its data, padded to a
+        multiple of 4 bytes.
+    */
+    static int writeMidi (const MidiBuffer& midi, uint8* dest, int maxBytes) noexcept
+    {
+        int numBytes = 0;
+
+        for (const auto metadata : midi)
+        {
+            const auto recordSize = (int) ((2 * sizeof (int32) + (size_t) metadata.numBytes + 3) & ~(size_t) 3);
+
+            if (numBytes + recordSize > maxBytes)
+            {
+                jassertfalse; // There's too much MIDI to fit in the buffer - see Options::withMidiBufferSize()
+                break;
+            }
+
+            const int32 header[] { metadata.samplePosition, metadata.numBytes };
+            std::memcpy (dest + numBytes, header, sizeof (header));
+            std::memcpy (dest + numBytes + sizeof (header), metadata.data, (size_t) metadata.numBytes);
+            numBytes += recordSize;
+        }
+
+        return numBytes;
+    }
+
+    /*  The number of bytes is clamped to the size of the buffer, as it comes from the
+        other process.
+    */
+    static void readMidi (const uint8* source, int numBytes, int bufferSize, MidiBuffer& dest, int sampleOffset) noexcept
+    {
+        numBytes = jlimit (0, bufferSize, numBytes);
+
+        for (int position = 0; position + (int) (2 * sizeof (int32)) <= numBytes;)
+        {
+            int32 header[2];
+            std::memcpy (header, source + position, sizeof (header));
+
+            const auto dataSize = header[1];
+
+            if (dataSize <= 0 || dataSize > numBytes - position - (int) sizeof (header))
+                break;
+
+            dest.addEvent (source + position + sizeof (header), dataSize, header[0] + sampleOffset);
+            position += (int) ((sizeof (header) + (size_t) dataSize + 3) & ~(size_t) 3);
+        }
+    }
+
+    //==============================================================================
+    struct ParameterInfo
+    {
+        String parameterID, name, label;
+        float defaultValue = 0, value = 0;
+        int numSteps = 0;
+        bool discrete = false, boolean = false, automatable = true, meta = false, inverted = false;
+        AudioProcessorParameter::Category category = AudioProcessorParameter::genericParameter;
+    };
+
+    struct BusInfo
+    {
+        String name;
+        AudioChannelSet layout;
+        bool enabled = false;
+    };
+
+    struct SharedPlayHead final : public AudioPlayHead
+    {
+        Optional<PositionInfo> getPosition() const override     { return position; }
+
+        Optional<PositionInfo> position;
+    };
+}
+
+using namespace OutOfProcessPluginHelpers;
+
+//==============================================================================
+/*  A block of shared memory that the worker creates with a random name, which the host
+    removes as soon as it has opened it.
+*/
+struct OutOfProcessPluginInstance::SharedRegion
+{
+    static std::unique_ptr<SharedRegion> create (size_t numBytes)
+    {
+        for (int attempt = 0; attempt < 10; ++attempt)
+        {
+            const auto name = "/juce_plugin_" + String::toHexString (Random::getSystemRandom().nextInt64());
+
+            if (auto region = SharedMemoryRegion::create (name, numBytes, true))
+                return std::make_unique<SharedRegion> (std::move (region));
+        }
+
+        return {};
+    }
+
+    static std::unique_ptr<SharedRegion> open (const String& name, size_t minimumSize)
+    {
+        auto region = SharedMemoryRegion::open (name, minimumSize);
+
+        if (region == nullptr)
+            return {};
+
+        region->removeName();
+        return std::make_unique<SharedRegion> (std::move (region));
+    }
+
+    explicit SharedRegion (std::unique_ptr<SharedMemoryRegion> r)  : region (std::move (r)) {}
+
+    template <typename Header>
+    Header& getHeader() const noexcept      { return *static_cast<Header*> (region->getData()); }
+
+    String getName() const                  { return region->getName(); }
+    size_t getSize() const noexcept         { return region->getSize(); }
+
+private:
+    std::unique_ptr<SharedMemoryRegion> region;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedRegion)
+};
+
+//==============================================================================
+struct OutOfProcessPluginInstance::Details
+{
+    static Details fromInstance (AudioPluginInstance& instance)
+    {
+        Details d;
+        d.description = instance.getPluginDescription();
+
+        for (auto isInput : { true, false })
+        {
+            for (int i = 0; i < instance.getBusCount (isInput); ++i)
+            {
+                auto* bus = instance.getBus (isInput, i);
+                (isInput ? d.inputBuses : d.outputBuses).add ({ bus->getName(), bus->getLastEnabledLayout(), bus->isEnabled() });
+            }
+        }
+
+        d.latency = instance.getLatencySamples();
+        d.tailLengthSeconds = instance.getTailLengthSeconds();
+        d.acceptsMidi = instance.acceptsMidi();
+        d.producesMidi = instance.producesMidi();
+        d.isMidiEffect = instance.isMidiEffect();
+
+        for (int i = 0; i < instance.getNumPrograms(); ++i)
+            d.programNames.add (instance.getProgramName (i));
+
+        d.currentProgram = instance.getCurrentProgram();
+
+        for (auto* p : instance.getParameters())
+        {
+            ParameterInfo info;
+
+            if (auto* hosted = dynamic_cast<HostedAudioProcessorParameter*> (p))
+                info.parameterID = hosted->getParameterID();
+
+            info.name = p->getName (1024);
+            info.label = p->getLabel();
+            info.defaultValue = p->getDefaultValue();
+            info.value = p->getValue();
+            info.numSteps = p->getNumSteps();
+            info.discrete = p->isDiscrete();
+            info.boolean = p->isBoolean();
+            info.automatable = p->isAutomatable();
+            info.meta = p->isMetaParameter();
+            info.inverted = p->isOrientationInverted();
+            info.category = p->getCategory();
+            d.parameters.add (info);
+        }
+
+        if (auto* bypass = instance.getBypassParameter())
+            d.bypassParameterIndex = bypass->getParameterIndex();
+
+        return d;
+    }
+
+    void writeTo (OutputStream& out) const
+    {
+        out.writeString (description.createXml()->toString());
+
+        for (auto* buses : { &inputBuses, &outputBuses })
+        {
+            out.writeInt (buses->size());
+
+            for (auto& bus : *buses)
+            {
+                out.writeString (bus.name);
+                writeChannelSet (out, bus.layout);
+                out.writeBool (bus.enabled);
+            }
+        }
+
+        out.writeInt (latency);
+        out.writeDouble (tailLengthSeconds);
+        out.writeBool (acceptsMidi);
+        out.writeBool (producesMidi);
+        out.writeBool (isMidiEffect);
+
+        out.writeInt (programNames.size());
+
+        for (auto& programName : programNames)
+            out.writeString (programName);
+
+        out.writeInt (currentProgram);
+
+        out.writeInt (parameters.size());
+
+        for (auto& p : parameters)
+        {
+            out.writeString (p.parameterID);
+            out.writeString (p.name);
+            out.writeString (p.label);
+            out.writeFloat (p.defaultValue);
+            out.writeFloat (p.value);
+            out.writeInt (p.numSteps);
+            out.writeBool (p.discrete);
+            out.writeBool (p.boolean);
+            out.writeBool (p.automatable);
+            out.writeBool (p.meta);
+            out.writeBool (p.inverted);
+            out.writeInt ((int) p.category);
+        }
+
+        out.writeInt (bypassParameterIndex);
+        out.writeString (controlRegionName);
+    }
+
+    static Details readFrom (InputStream& in)
+    {
+        Details d;
+
+        if (auto xml = parseXML (in.readString()))
+            d.description.loadFromXml (*xml);
+
+        for (auto* buses : { &d.inputBuses, &d.outputBuses })
+        {
+            for (int i = jlimit (0, 1024, in.readInt()); --i >= 0;)
+            {
+                BusInfo bus;
+                bus.name = in.readString();
+                bus.layout = readChannelSet (in);
+                bus.enabled = in.readBool();
+                buses->add (bus);
+            }
+        }
+
+        d.latency = in.readInt();
+        d.tailLengthSeconds = in.readDouble();
+        d.acceptsMidi = in.readBool();
+        d.producesMidi = in.readBool();
+        d.isMidiEffect = in.readBool();
+
+        for (int i = jmax (0, in.readInt()); --i >= 0 && ! in.isExhausted();)
+            d.programNames.add (in.readString());
+
+        d.currentProgram = in.readInt();
+
+        for (int i = jmax (0, in.readInt()); --i >= 0 && ! in.isExhausted();)
+        {
+            ParameterInfo p;
+            p.parameterID = in.readString();
+            p.name = in.readString();
+            p.label = in.readString();
+            p.defaultValue = in.readFloat();
+            p.value = in.readFloat();
+            p.numSteps = in.readInt();
+            p.discrete = in.readBool();
+            p.boolean = in.readBool();
+            p.automatable = in.readBool();
+            p.meta = in.readBool();
+            p.inverted = in.readBool();
+            p.category = (AudioProcessorParameter::Category) in.readInt();
+            d.parameters.add (p);
+        }
+
+        d.bypassParameterIndex = in.readInt();
+        d.controlRegionName = in.readString();
+        return d;
+    }
+
+    BusesProperties getBusesProperties() const
+    {
+        BusesProperties properties;
+
+        for (auto& bus : inputBuses)
+            properties.addBus (true, bus.name, bus.layout, bus.enabled);
+
+        for (auto& bus : outputBuses)
+            properties.addBus (false, bus.name, bus.layout, bus.enabled);
+
+        return properties;
+    }
+
+    PluginDescription description;
+    Array<BusInfo> inputBuses, outputBuses;
+    int latency = 0;
+    double tailLengthSeconds = 0;
+    bool acceptsMidi = false, producesMidi = false, isMidiEffect = false;
+    StringArray programNames;
+    int currentProgram = 0;
+    Array<ParameterInfo> parameters;
+    int bypassParameterIndex = -1;
+    String controlRegionName;
+};
+
+//==============================================================================
+struct OutOfProcessPluginInstance::Connection final : public ChildProcessCoordinator
+{
+    ~Connection() override
+    {
+        killWorkerProcess();
+    }
+
+    /*  Sends a request to the worker, and waits for the reply. The payload function is
+        called to write the body of the request to a stream.
+    */
+    template <typename WritePayload>
+    bool sendRequest (MessageType type, WritePayload&& writePayload, MemoryBlock& reply, int timeoutMs)
+    {
+        const ScopedLock sl (requestLock);
+
+        MemoryOutputStream out;
+        out.writeInt ((int) type);
+        out.writeInt (++lastRequestID);
+        writePayload (out);
+
+        {
+            const ScopedLock rl (replyLock);
+            pendingRequestID = lastRequestID;
+            replyArrived = false;
+            replyReceived.reset();
+        }
+
+        if (lost || ! sendMessageToWorker (out.getMemoryBlock()))
+            return false;
+
+        replyReceived.wait (timeoutMs);
+
+        const ScopedLock rl (replyLock);
+        pendingRequestID = 0;
+
+        if (! replyArrived)
+            return false;
+
+        reply = std::move (replyData);
+        return true;
+    }
+
+    /*  Sends a message to the worker that doesn't need a reply. */
+    template <typename WritePayload>
+    bool sendNotification (MessageType type, WritePayload&& writePayload)
+    {
+        MemoryOutputStream out;
+        out.writeInt ((int) type);
+        out.writeInt (0);
+        writePayload (out);
+
+        return ! lost && sendMessageToWorker (out.getMemoryBlock());
+    }
+
+    void setOwner (OutOfProcessPluginInstance* newOwner)
+    {
+        const ScopedLock sl (ownerLock);
+        owner = newOwner;
+    }
+
+    std::atomic<bool> lost { false };
+
+private:
+    void handleMessageFromWorker (const MemoryBlock& message) override
+    {
+        MemoryInputStream in (message, false);
+        const auto type = in.readInt();
+        const auto requestID = in.readInt();
+
+        if (type == (int) MessageType::reply)
+        {
+            const ScopedLock sl (replyLock);
+
+            if (requestID == pendingRequestID)
+            {
+                replyData.replaceAll (addBytesToPointer (message.getData(), in.getPosition()),
+                                      message.getSize() - (size_t) in.getPosition());
+                replyArrived = true;
+                replyReceived.signal();
+            }
+
+            return;
+        }
+
+        const ScopedLock sl (ownerLock);
+
+        if (owner != nullptr)
+            owner->handleWorkerMessage (in, type);
+    }
+
+    void handleConnectionLost() override
+    {
+        lost = true;
+        replyReceived.signal();
+
+        const ScopedLock sl (ownerLock);
+
+        if (owner != nullptr)
+        {
+            owner->workerLost = true;
+            owner->triggerAsyncUpdate();
+        }
+    }
+
+    CriticalSection requestLock, replyLock, ownerLock;
+    int lastRequestID = 0, pendingRequestID = 0;
+    bool replyArrived = false;
+    MemoryBlock replyData;
+    WaitableEvent replyReceived { true };
+    OutOfProcessPluginInstance* owner = nullptr;
+};
+
+//==============================================================================
+class OutOfProcessPluginInstance::ProxyParameter final : public Parameter
+{
+public:
+    ProxyParameter (OutOfProcessPluginInstance& o, int index, const ParameterInfo& parameterInfo)
+        : owner (o), parameterIndex (index), info (parameterInfo), value (parameterInfo.value)
+    {
+    }
+
+    float getValue() const override                 { return value; }
+
+    void setValue (float newValue) override
+    {
+        value = newValue;
+        owner.setParameterFromHost (parameterIndex, newValue);
+    }
+
+    void setValueFromPlugin (float newValue)
+    {
+        if (! approximatelyEqual (value.exchange (newValue), newValue))
+            sendValueChangedMessageToListeners (newValue);
+    }
+
+    String getText (float normalisedValue, int maximumStringLength) const override
+    {
+        MemoryBlock reply;
+
+        if (owner.connection->sendRequest (MessageType::getParameterText,
+                                           [&] (OutputStream& out)
+                                           {
+                                               out.writeInt (parameterIndex);
+                                               out.writeFloat (normalisedValue);
+                                               out.writeInt (maximumStringLength);
+                                           },
+                                           reply, textRequestTimeoutMs))
+        {
+            return MemoryInputStream (reply, false).readString();
+        }
+
+        return Parameter::getText (normalisedValue, maximumStringLength);
+    }
+
+    float getValueForText (const String& text) const override
+    {
+        MemoryBlock reply;
+
+        if (owner.connection->sendRequest (MessageType::getParameterValueForText,
+                                           [&] (OutputStream& out)
+                                           {
+                                               out.writeInt (parameterIndex);
+                                               out.writeString (text);
+                                           },
+                                           reply, textRequestTimeoutMs))
+        {
+            return MemoryInputStream (reply, false).readFloat();
+        }
+
+        return Parameter::getValueForText (text);
+    }
+
+    String getParameterID() const override          { return info.parameterID; }
+    float getDefaultValue() const override          { return info.defaultValue; }
+    String getName (int maximumLength) const override { return info.name.substring (0, maximumLength); }
+    String getLabel() const override                { return info.label; }
+    int getNumSteps() const override                { return info.numSteps; }
+    bool isDiscrete() const override                { return info.discrete; }
+    bool isBoolean() const override                 { return info.boolean; }
+    bool isAutomatable() const override             { return info.automatable; }
+    bool isMetaParameter() const override           { return info.meta; }
+    bool isOrientationInverted() const override     { return info.inverted; }
+    Category getCategory() const override           { return info.category; }
+
+private:
+    static constexpr int textRequestTimeoutMs = 500;
+
+    OutOfProcessPluginInstance& owner;
+    const int parameterIndex;
+    const ParameterInfo info;
+    std::atomic<float> value;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProxyParameter)
+};
+
+//==============================================================================
+std::unique_ptr<OutOfProcessPluginInstance> OutOfProcessPluginInstance::create (const PluginDescription& desc,
+                                                                                double initialSampleRate,
+                                                                                int initialBufferSize,
+                                                                                String& errorMessage)
+{
+    return create (desc, initialSampleRate, initialBufferSize, errorMessage, Options{});
+}
+
+std::unique_ptr<OutOfProcessPluginInstance> OutOfProcessPluginInstance::create (const PluginDescription& desc,
+                                                                                double initialSampleRate,
+                                                                                int initialBufferSize,
+                                                                                String& errorMessage,
+                                                                                const Options& options)
+{
+   #if ! JUCE_LINUX
+    ignoreUnused (desc, initialSampleRate, initialBufferSize, options);
+    errorMessage = "Out-of-process plugins aren't supported on this platform";
+    return {};
+   #else
+    auto connection = std::make_unique<Connection>();
+
+    if (! connection->launchWorkerProcess (options.workerExecutable, options.commandLineUniqueID, 0, 0))
+    {
+        errorMessage = "Couldn't launch the worker process";
+        return {};
+    }
+
+    MemoryBlock reply;
+
+    if (! connection->sendRequest (MessageType::createInstance,
+                                   [&] (OutputStream& out)
+                                   {
+                                       out.writeString (desc.createXml()->toString());
+                                       out.writeDouble (initialSampleRate);
+                                       out.writeInt (initialBufferSize);
+                                   },
+                                   reply, options.timeoutMs))
+    {
+        errorMessage = connection->lost ? "The worker process quit while creating the plugin"
+                                        : "The worker process didn't respond";
+        return {};
+    }
+
+    MemoryInputStream in (reply, false);
+
+    if (! in.readBool())
+    {
+        errorMessage = in.readString();
+        return {};
+    }
+
+    const auto details = Details::readFrom (in);
+    auto controlRegion = SharedRegion::open (details.controlRegionName, ControlHeader::getSizeNeeded (details.parameters.size()));
+
+    if (controlRegion == nullptr || controlRegion->getHeader<ControlHeader>().magic != ControlHeader::magicValue)
+    {
+        errorMessage = "Couldn't share memory with the worker process";
+        return {};
+    }
+
+    return std::unique_ptr<OutOfProcessPluginInstance> (new OutOfProcessPluginInstance (std::move (connection),
+                                                                                        std::move (controlRegion),
+                                                                                        details, options));
+   #endif
+}
+
+OutOfProcessPluginInstance::OutOfProcessPluginInstance (std::unique_ptr<Connection> c,
+                                                        std::unique_ptr<SharedRegion> control,
+                                                        const Details& details,
+                                                        const Options& o)
+    : AudioPluginInstance (details.getBusesProperties()),
+      connection (std::move (c)),
+      controlRegion (std::move (control)),
+      options (o),
+      description (details.description),
+      pluginAcceptsMidi (details.acceptsMidi),
+      pluginProducesMidi (details.producesMidi),
+      pluginIsMidiEffect (details.isMidiEffect),
+      tailLengthSeconds (details.tailLengthSeconds),
+      bypassParameterIndex (details.bypassParameterIndex),
+      pluginLatency (details.latency),
+      programNames (details.programNames),
+      currentProgram (details.currentProgram)
+{
+    for (int i = 0; i < details.parameters.size(); ++i)
+    {
+        auto parameter = std::make_unique<ProxyParameter> (*this, i, details.parameters.getReference (i));
+        proxyParameters.add (parameter.get());
+        addHostedParameter (std::move (parameter));
+    }
+
+    updateLatency();
+    connection->setOwner (this);
+    startTimerHz (30);
+}
+
+OutOfProcessPluginInstance::~OutOfProcessPluginInstance()
+{
+    stopTimer();
+    connection->setOwner (nullptr);
+    cancelPendingUpdate();
+    connection.reset();
+}
+
+bool OutOfProcessPluginInstance::isWorkerRunning() const noexcept
+{
+    return ! workerLost;
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::fillInPluginDescription (PluginDescription& desc) const
+{
+    desc = description;
+}
+
+const String OutOfProcessPluginInstance::getName() const                { return description.name; }
+double OutOfProcessPluginInstance::getTailLengthSeconds() const         { return tailLengthSeconds; }
+bool OutOfProcessPluginInstance::acceptsMidi() const                    { return pluginAcceptsMidi; }
+bool OutOfProcessPluginInstance::producesMidi() const                   { return pluginProducesMidi; }
+bool OutOfProcessPluginInstance::isMidiEffect() const                   { return pluginIsMidiEffect; }
+bool OutOfProcessPluginInstance::hasEditor() const                      { return false; }
+AudioProcessorEditor* OutOfProcessPluginInstance::createEditor()        { return nullptr; }
+
+AudioProcessorParameter* OutOfProcessPluginInstance::getBypassParameter() const
+{
+    return getParameters()[bypassParameterIndex];
+}
+
+bool OutOfProcessPluginInstance::isBusesLayoutSupported (const BusesLayout& layout) const
+{
+    MemoryBlock reply;
+
+    return connection->sendRequest (MessageType::checkBusesLayout,
+                                    [&] (OutputStream& out) { writeBusesLayout (out, layout); },
+                                    reply, options.timeoutMs)
+        && MemoryInputStream (reply, false).readBool();
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    const AudioLayout layout { jmax (getTotalNumInputChannels(), getTotalNumOutputChannels()),
+                               maximumExpectedSamplesPerBlock,
+                               options.midiBufferSize };
+
+    std::unique_ptr<SharedRegion> newRegion;
+    MemoryBlock reply;
+
+    if (connection->sendRequest (MessageType::prepare,
+                                 [&] (OutputStream& out)
+                                 {
+                                     out.writeDouble (sampleRate);
+                                     out.writeInt (maximumExpectedSamplesPerBlock);
+                                     out.writeBool (isNonRealtime());
+                                     out.writeInt (options.midiBufferSize);
+                                     writeBusesLayout (out, getBusesLayout());
+                                 },
+                                 reply, options.timeoutMs))
+    {
+        MemoryInputStream in (reply, false);
+
+        if (in.readBool())
+        {
+            const auto regionName = in.readString();
+            pluginLatency = in.readInt();
+            newRegion = SharedRegion::open (regionName, sizeof (AudioHeader));
+
+            if (newRegion != nullptr && ! layout.matches (newRegion->getHeader<AudioHeader>(), newRegion->getSize()))
+                newRegion.reset();
+        }
+    }
+
+    {
+        const ScopedLock sl (getCallbackLock());
+        audioRegion = std::move (newRegion);
+
+        if (audioRegion != nullptr)
+        {
+            maxBlockSize = layout.maxBlockSize;
+            numSharedChannels = layout.numChannels;
+        }
+        else
+        {
+            maxBlockSize = numSharedChannels = 0;
+        }
+
+        lastJobSubmitted = 0;
+        previousBlockSize = 0;
+        previousBlockSubmitted = false;
+
+        pipelineOutput.setSize (numSharedChannels, maxBlockSize);
+        pipelineOutput.clear();
+        pipelineOutputSize = maxBlockSize;
+        pipelineMidi.clear();
+        pipelineMidi.ensureSize ((size_t) options.midiBufferSize);
+        scratchMidi.ensureSize ((size_t) options.midiBufferSize);
+    }
+
+    updateLatency();
+}
+
+void OutOfProcessPluginInstance::releaseResources()
+{
+    {
+        const ScopedLock sl (getCallbackLock());
+        audioRegion.reset();
+        maxBlockSize = numSharedChannels = 0;
+    }
+
+    MemoryBlock reply;
+    connection->sendRequest (MessageType::release, [] (OutputStream&) {}, reply, options.timeoutMs);
+    updateLatency();
+}
+
+void OutOfProcessPluginInstance::reset()
+{
+    connection->sendNotification (MessageType::reset, [] (OutputStream&) {});
+}
+
+void OutOfProcessPluginInstance::setNonRealtime (bool isNonRealtime) noexcept
+{
+    AudioPluginInstance::setNonRealtime (isNonRealtime);
+    connection->sendNotification (MessageType::setNonRealtime, [&] (OutputStream& out) { out.writeBool (isNonRealtime); });
+}
+
+void OutOfProcessPluginInstance::updateLatency()
+{
+    setLatencySamples (pluginLatency + (options.pipelined ? maxBlockSize : 0));
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi)
+{
+    process (buffer, midi, false);
+}
+
+void OutOfProcessPluginInstance::processBlockBypassed (AudioBuffer<float>& buffer, MidiBuffer& midi)
+{
+    process (buffer, midi, true);
+}
+
+void OutOfProcessPluginInstance::process (AudioBuffer<float>& buffer, MidiBuffer& midi, bool bypassed)
+{
+    // The block is bigger than the size given to prepareToPlay()
+    jassert (audioRegion == nullptr || buffer.getNumSamples() <= maxBlockSize);
+
+    if (audioRegion == nullptr || workerLost || buffer.getNumSamples() > maxBlockSize)
+    {
+        buffer.clear();
+        midi.clear();
+        return;
+    }
+
+    if (options.pipelined)
+        processPipelined (buffer, midi, bypassed);
+    else
+        processSynchronously (buffer, midi, bypassed);
+}
+
+void OutOfProcessPluginInstance::processSynchronously (AudioBuffer<float>& buffer, MidiBuffer& midi, bool bypassed)
+{
+    const auto numSamples = buffer.getNumSamples();
+
+    if (submitBlock (buffer, midi, bypassed) && waitForBlock (numSamples))
+    {
+        midi.clear();
+        readOutput (buffer, midi, numSamples);
+        return;
+    }
+
+    buffer.clear();
+    midi.clear();
+}
+
+void OutOfProcessPluginInstance::processPipelined (AudioBuffer<float>& buffer, MidiBuffer& midi, bool bypassed)
+{
+    const auto numSamples = buffer.getNumSamples();
+
+    // Collect the output of the previous block, or use silence if it wasn't processed in time
+    if (previousBlockSize > 0)
+    {
+        if (previousBlockSubmitted && waitForBlock (previousBlockSize))
+        {
+            auto& header = audioRegion->getHeader<AudioHeader>();
+            const AudioLayout layout { numSharedChannels, maxBlockSize, options.midiBufferSize };
+
+            for (int i = 0; i < numSharedChannels; ++i)
+                pipelineOutput.copyFrom (i, pipelineOutputSize, layout.getChannel (header, i), previousBlockSize);
+
+            readMidi (layout.getMidiOut (header), header.numMidiOutBytes, layout.midiBufferSize,
+                      pipelineMidi, pipelineOutputSize);
+        }
+        else
+        {
+            pipelineOutput.clear (pipelineOutputSize, previousBlockSize);
+        }
+
+        pipelineOutputSize += previousBlockSize;
+    }
+
+    previousBlockSize = numSamples;
+    previousBlockSubmitted = submitBlock (buffer, midi, bypassed);
+
+    // Return the oldest samples in the pipeline, and move the rest along
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        if (i < numSharedChannels)
+            buffer.copyFrom (i, 0, pipelineOutput, i, 0, numSamples);
+        else
+            buffer.clear (i, 0, numSamples);
+    }
+
+    pipelineOutputSize -= numSamples;
+
+    for (int i = 0; i < numSharedChannels; ++i)
+    {
+        auto* data = pipelineOutput.getWritePointer (i);
+        std::memmove (data, data + numSamples, sizeof (float) * (size_t) pipelineOutputSize);
+    }
+
+    midi.clear();
+    midi.addEvents (pipelineMidi, 0, numSamples, 0);
+    scratchMidi.clear();
+    scratchMidi.addEvents (pipelineMidi, numSamples, -1, -numSamples);
+    pipelineMidi.swapWith (scratchMidi);
+}
+
+bool OutOfProcessPluginInstance::submitBlock (const AudioBuffer<float>& buffer, const MidiBuffer& midi, bool bypassed)
+{
+    auto& header = audioRegion->getHeader<AudioHeader>();
+
+    // If the worker hasn't finished the last block yet, there's nothing that can be done with this one
+    if (workerLost || header.doneSequence.load (std::memory_order_acquire) != lastJobSubmitted)
+        return false;
+
+    const auto numSamples = buffer.getNumSamples();
+    const AudioLayout layout { numSharedChannels, maxBlockSize, options.midiBufferSize };
+
+    for (int i = 0; i < numSharedChannels; ++i)
+    {
+        if (i < buffer.getNumChannels())
+            std::memcpy (layout.getChannel (header, i), buffer.getReadPointer (i), sizeof (float) * (size_t) numSamples);
+        else
+            zeromem (layout.getChannel (header, i), sizeof (float) * (size_t) numSamples);
+    }
+
+    header.numSamples = numSamples;
+    header.numMidiInBytes = writeMidi (midi, layout.getMidiIn (header), layout.midiBufferSize);
+    header.numMidiOutBytes = 0;
+    header.flags = bypassed ? (uint32) AudioHeader::bypassed : 0;
+
+    if (auto* hostPlayHead = getPlayHead())
+    {
+        if (auto position = hostPlayHead->getPosition())
+        {
+            header.position = *position;
+            header.flags |= AudioHeader::hasPosition;
+        }
+    }
+
+    header.jobSequence.store (++lastJobSubmitted, std::memory_order_release);
+    Futex::wake (header.jobSequence);
+    return true;
+}
+
+bool OutOfProcessPluginInstance::waitForBlock (int numSamples)
+{
+    auto& header = audioRegion->getHeader<AudioHeader>();
+    const auto waitIndefinitely = isNonRealtime();
+    const auto timeoutMs = options.processTimeoutMs >= 0 ? (double) options.processTimeoutMs
+                                                         : numSamples * 1000.0 / jmax (1.0, getSampleRate());
+    const auto startTime = Time::getMillisecondCounterHiRes();
+    const auto numSpins = SystemStats::getNumCpus() > 1 ? 2000 : 0;
+
+    for (int spin = 0;; ++spin)
+    {
+        const auto done = header.doneSequence.load (std::memory_order_acquire);
+
+        if (done == lastJobSubmitted)
+            return true;
+
+        if (workerLost)
+            return false;
+
+        if (spin < numSpins)
+            continue;
+
+        const auto remainingMs = timeoutMs - (Time::getMillisecondCounterHiRes() - startTime);
+
+        if (! waitIndefinitely && remainingMs <= 0)
+            return false;
+
+        Futex::wait (header.doneSequence, done, waitIndefinitely ? 100.0 : remainingMs);
+    }
+}
+
+void OutOfProcessPluginInstance::readOutput (AudioBuffer<float>& buffer, MidiBuffer& midi, int numSamples)
+{
+    auto& header = audioRegion->getHeader<AudioHeader>();
+    const AudioLayout layout { numSharedChannels, maxBlockSize, options.midiBufferSize };
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        if (i < numSharedChannels)
+            buffer.copyFrom (i, 0, layout.getChannel (header, i), numSamples);
+        else
+            buffer.clear (i, 0, numSamples);
+    }
+
+    readMidi (layout.getMidiOut (header), header.numMidiOutBytes, layout.midiBufferSize, midi, 0);
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::setParameterFromHost (int index, float newValue)
+{
+    auto& header = controlRegion->getHeader<ControlHeader>();
+    auto& slot = header.getSlot (index);
+
+    slot.hostValue.store (newValue, std::memory_order_relaxed);
+    slot.hostValueChanged.store (1, std::memory_order_release);
+    header.hostChangesPending.store (1, std::memory_order_release);
+}
+
+void OutOfProcessPluginInstance::timerCallback()
+{
+    auto& header = controlRegion->getHeader<ControlHeader>();
+
+    if (header.pluginChangesPending.exchange (0, std::memory_order_acquire) == 0)
+        return;
+
+    for (int i = 0; i < proxyParameters.size(); ++i)
+    {
+        auto& slot = header.getSlot (i);
+
+        if (slot.pluginValueChanged.exchange (0, std::memory_order_acquire) != 0)
+            proxyParameters.getUnchecked (i)->setValueFromPlugin (slot.pluginValue.load (std::memory_order_relaxed));
+    }
+}
+
+void OutOfProcessPluginInstance::handleWorkerMessage (MemoryInputStream& in, int type)
+{
+    if (type == (int) MessageType::latencyChanged)
+    {
+        pluginLatency = in.readInt();
+        triggerAsyncUpdate();
+    }
+    else if (type == (int) MessageType::programChanged)
+    {
+        currentProgram = in.readInt();
+    }
+}
+
+void OutOfProcessPluginInstance::handleAsyncUpdate()
+{
+    updateLatency();
+
+    if (workerLost && ! workerLostNotified.exchange (true))
+    {
+        stopTimer();
+        NullCheckedInvocation::invoke (onWorkerLost);
+    }
+}
+
+//==============================================================================
+int OutOfProcessPluginInstance::getNumPrograms()                            { return programNames.size(); }
+int OutOfProcessPluginInstance::getCurrentProgram()                         { return currentProgram; }
+const String OutOfProcessPluginInstance::getProgramName (int index)         { return programNames[index]; }
+
+void OutOfProcessPluginInstance::setCurrentProgram (int index)
+{
+    MemoryBlock reply;
+
+    if (connection->sendRequest (MessageType::setCurrentProgram,
+                                 [&] (OutputStream& out) { out.writeInt (index); },
+                                 reply, options.timeoutMs))
+    {
+        currentProgram = MemoryInputStream (reply, false).readInt();
+    }
+}
+
+void OutOfProcessPluginInstance::changeProgramName (int index, const String& newName)
+{
+    if (isPositiveAndBelow (index, programNames.size()))
+    {
+        programNames.set (index, newName);
+        connection->sendNotification (MessageType::changeProgramName, [&] (OutputStream& out)
+        {
+            out.writeInt (index);
+            out.writeString (newName);
+        });
+    }
+}
+
+void OutOfProcessPluginInstance::getState (MemoryBlock& destData, bool currentProgramOnly)
+{
+    MemoryBlock reply;
+
+    if (connection->sendRequest (MessageType::getState,
+                                 [&] (OutputStream& out) { out.writeBool (currentProgramOnly); },
+                                 reply, options.timeoutMs))
+    {
+        MemoryInputStream in (reply, false);
+        destData = readMemory (in);
+    }
+}
+
+bool OutOfProcessPluginInstance::setState (const void* data, int sizeInBytes, bool currentProgramOnly)
+{
+    MemoryBlock reply;
+
+    return connection->sendRequest (MessageType::setState,
+                                    [&] (OutputStream& out)
+                                    {
+                                        out.writeBool (currentProgramOnly);
+                                        writeMemory (out, MemoryBlock (data, (size_t) jmax (0, sizeInBytes)));
+                                    },
+                                    reply, options.timeoutMs)
+        && MemoryInputStream (reply, false).readBool();
+}
+
+void OutOfProcessPluginInstance::getStateInformation (MemoryBlock& destData)                       { getState (destData, false); }
+void OutOfProcessPluginInstance::getCurrentProgramStateInformation (MemoryBlock& destData)         { getState (destData, true); }
+void OutOfProcessPluginInstance::setStateInformation (const void* data, int sizeInBytes)               { setState (data, sizeInBytes, false); }
+void OutOfProcessPluginInstance::setCurrentProgramStateInformation (const void* data, int sizeInBytes) { setState (data, sizeInBytes, true); }
+
+//==============================================================================
+struct OutOfProcessPluginWorker::Session final : private AudioProcessorListener,
+                                                 private Thread,
+                                                 private Timer
+{
+    using SharedRegion = OutOfProcessPluginInstance::SharedRegion;
+
+    Session (OutOfProcessPluginWorker& o,
+             std::unique_ptr<AudioPluginInstance> newInstance,
+             std::unique_ptr<SharedRegion> control)
+        : Thread ("Out-of-process plugin"),
+          instance (std::move (newInstance)),
+          controlRegion (std::move (control)),
+          owner (o)
+    {
+        new (&getControlHeader()) ControlHeader();
+        getControlHeader().numParameters = instance->getParameters().size();
+
+        for (int i = 0; i < getControlHeader().numParameters; ++i)
+            new (&getControlHeader().getSlot (i)) ParameterSlot();
+
+        instance->addListener (this);
+        startTimerHz (30);
+    }
+
+    ~Session() override
+    {
+        stopTimer();
+        stopProcessing();
+        instance->removeListener (this);
+        instance->releaseResources();
+    }
+
+    static std::unique_ptr<Session> create (OutOfProcessPluginWorker& owner,
+                                            std::unique_ptr<AudioPluginInstance> newInstance)
+    {
+        auto control = SharedRegion::create (ControlHeader::getSizeNeeded (newInstance->getParameters().size()));
+
+        if (control == nullptr)
+            return {};
+
+        return std::make_unique<Session> (owner, std::move (newInstance), std::move (control));
+    }
+
+    bool prepare (double sampleRate, int maxBlockSize, bool nonRealtime,
+                  int midiBufferSize, const AudioProcessor::BusesLayout& layout)
+    {
+        stopProcessing();
+        instance->releaseResources();
+
+        if (! instance->setBusesLayout (layout) || maxBlockSize <= 0 || midiBufferSize < 0)
+            return false;
+
+        audioLayout = { jmax (instance->getTotalNumInputChannels(), instance->getTotalNumOutputChannels()),
+                        maxBlockSize,
+                        midiBufferSize };
+        audioRegion = SharedRegion::create (audioLayout.getSizeNeeded());
+
+        if (audioRegion == nullptr)
+            return false;
+
+        auto& header = *new (&getAudioHeader()) AudioHeader();
+        audioLayout.writeTo (header);
+
+        channels.clear();
+
+        for (int i = 0; i < audioLayout.numChannels; ++i)
+            channels.push_back (audioLayout.getChannel (header, i));
+
+        midi.ensureSize ((size_t) midiBufferSize);
+        lastJob = 0;
+
+        instance->setNonRealtime (nonRealtime);
+        instance->setProcessingPrecision (AudioProcessor::singlePrecision);
+        instance->setPlayHead (&playHead);
+        instance->setRateAndBufferSizeDetails (sampleRate, maxBlockSize);
+        instance->prepareToPlay (sampleRate, maxBlockSize);
+
+        if (! startRealtimeThread (RealtimeOptions{}.withApproximateAudioProcessingTime (maxBlockSize, sampleRate)))
+            startThread (Priority::highest);
+
+        return true;
+    }
+
+    void release()
+    {
+        stopProcessing();
+        instance->releaseResources();
+    }
+
+    void stopProcessing()
+    {
+        if (audioRegion == nullptr)
+            return;
+
+        signalThreadShouldExit();
+        Futex::wake (getAudioHeader().jobSequence);
+        stopThread (10000);
+        audioRegion.reset();
+    }
+
+    /*  Copies the values of any parameters that have changed since they were last reported to
+        the host, which will pick them up on its next timer callback.
+    */
+    void reportParameterValues()
+    {
+        auto& header = getControlHeader();
+        const auto& parameters = instance->getParameters();
+
+        for (int i = 0; i < jmin (parameters.size(), (int) header.numParameters); ++i)
+            reportParameterValue (i, parameters.getUnchecked (i)->getValue());
+    }
+
+    /*  Tells the host if the plugin's latency or current program has changed. */
+    void sendChangesToHost()
+    {
+        if (const auto latency = instance->getLatencySamples(); latency != reportedLatency)
+        {
+            reportedLatency = latency;
+            sendNotification (MessageType::latencyChanged, latency);
+        }
+
+        if (const auto program = instance->getCurrentProgram(); program != reportedProgram)
+        {
+            reportedProgram = program;
+            sendNotification (MessageType::programChanged, program);
+        }
+    }
+
+    std::unique_ptr<AudioPluginInstance> instance;
+    std::unique_ptr<SharedRegion> controlRegion, audioRegion;
+
+private:
+    ControlHeader& getControlHeader() const noexcept    { return controlRegion->getHeader<ControlHeader>(); }
+    AudioHeader& getAudioHeader() const noexcept        { return audioRegion->getHeader<AudioHeader>(); }
+
+    void run() override
+    {
+        auto& header = getAudioHeader();
+
+        while (! threadShouldExit())
+        {
+            const auto job = header.jobSequence.load (std::memory_order_acquire);
+
+            if (job == lastJob)
+            {
+                Futex::wait (header.jobSequence, job, 100.0);
+                continue;
+            }
+
+            lastJob = job;
+            processJob (header);
+
+            header.doneSequence.store (job, std::memory_order_release);
+            Futex::wake (header.doneSequence);
+        }
+    }
+
+    void processJob (AudioHeader& header)
+    {
+        const ScopedLock sl (instance->getCallbackLock());
+
+        applyHostParameterChanges();
+
+        const auto numSamples = jlimit (0, audioLayout.maxBlockSize, header.numSamples);
+        buffer.setDataToReferTo (channels.data(), (int) channels.size(), numSamples);
+
+        midi.clear();
+        readMidi (audioLayout.getMidiIn (header), header.numMidiInBytes, audioLayout.midiBufferSize, midi, 0);
+
+        if ((header.flags & AudioHeader::hasPosition) != 0)
+            playHead.position = header.position;
+        else
+            playHead.position = {};
+
+        if (instance->isSuspended())
+        {
+            buffer.clear();
+            midi.clear();
+        }
+        else if ((header.flags & AudioHeader::bypassed) != 0)
+        {
+            instance->processBlockBypassed (buffer, midi);
+        }
+        else
+        {
+            instance->processBlock (buffer, midi);
+        }
+
+        header.numMidiOutBytes = writeMidi (midi, audioLayout.getMidiOut (header), audioLayout.midiBufferSize);
+    }
+
+    void applyHostParameterChanges()
+    {
+        auto& header = getControlHeader();
+
+        if (header.hostChangesPending.exchange (0, std::memory_order_acquire) == 0)
+            return;
+
+        const auto& parameters = instance->getParameters();
+
+        for (int i = 0; i < jmin (parameters.size(), (int) header.numParameters); ++i)
+        {
+            auto& slot = header.getSlot (i);
+
+            if (slot.hostValueChanged.exchange (0, std::memory_order_acquire) != 0)
+            {
+                const auto newValue = slot.hostValue.load (std::memory_order_relaxed);
+                parameters.getUnchecked (i)->setValue (newValue);
+                slot.pluginValue.store (newValue, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void reportParameterValue (int index, float newValue)
+    {
+        auto& header = getControlHeader();
+
+        if (! isPositiveAndBelow (index, (int) header.numParameters))
+            return;
+
+        auto& slot = header.getSlot (index);
+
+        if (approximatelyEqual (slot.pluginValue.exchange (newValue, std::memory_order_relaxed), newValue))
+            return;
+
+        slot.pluginValueChanged.store (1, std::memory_order_release);
+        header.pluginChangesPending.store (1, std::memory_order_release);
+    }
+
+    // Parameter changes made while the plugin isn't processing are applied on the message thread
+    void timerCallback() override
+    {
+        if (audioRegion == nullptr)
+            applyHostParameterChanges();
+    }
+
+    void audioProcessorParameterChanged (AudioProcessor*, int index, float newValue) override
+    {
+        reportParameterValue (index, newValue);
+    }
+
+    void audioProcessorChanged (AudioProcessor*, const ChangeDetails& details) override
+    {
+        if (details.latencyChanged || details.programChanged)
+            owner.triggerAsyncUpdate();
+    }
+
+    void sendNotification (MessageType type, int value)
+    {
+        MemoryOutputStream out;
+        out.writeInt ((int) type);
+        out.writeInt (0);
+        out.writeInt (value);
+        owner.sendMessageToCoordinator (out.getMemoryBlock());
+    }
+
+    OutOfProcessPluginWorker& owner;
+    SharedPlayHead playHead;
+    AudioLayout audioLayout;
+    std::vector<float*> channels;
+    AudioBuffer<float> buffer;
+    MidiBuffer midi;
+    uint32 lastJob = 0;
+    int reportedLatency = instance->getLatencySamples(), reportedProgram = instance->getCurrentProgram();
+};
+
+//==============================================================================
+OutOfProcessPluginWorker::OutOfProcessPluginWorker (AudioPluginFormatManager& formatManagerToUse)
+    : formatManager (formatManagerToUse)
+{
+}
+
+OutOfProcessPluginWorker::~OutOfProcessPluginWorker()
+{
+    cancelPendingUpdate();
+    session.reset();
+}
+
+bool OutOfProcessPluginWorker::initialiseFromCommandLine (const String& commandLine, const String& commandLineUniqueID)
+{
+   #if JUCE_LINUX
+    return ChildProcessWorker::initialiseFromCommandLine (commandLine, commandLineUniqueID);
+   #else
+    ignoreUnused (commandLine, commandLineUniqueID);
+    return false;
+   #endif
+}
+
+void OutOfProcessPluginWorker::handleMessageFromCoordinator (const MemoryBlock& message)
+{
+    {
+        const ScopedLock sl (requestLock);
+        pendingRequests.add (message);
+    }
+
+    triggerAsyncUpdate();
+}
+
+void OutOfProcessPluginWorker::handleConnectionLost()
+{
+    hostLost = true;
+    triggerAsyncUpdate();
+}
+
+void OutOfProcessPluginWorker::handleAsyncUpdate()
+{
+    if (hostLost)
+    {
+        session.reset();
+
+        if (onHostLost != nullptr)
+            onHostLost();
+        else
+            JUCEApplicationBase::quit();
+
+        return;
+    }
+
+    Array<MemoryBlock> requests;
+
+    {
+        const ScopedLock sl (requestLock);
+        requests.swapWith (pendingRequests);
+    }
+
+    for (auto& request : requests)
+        handleRequest (request);
+
+    if (session != nullptr)
+        session->sendChangesToHost();
+}
+
+void OutOfProcessPluginWorker::handleRequest (const MemoryBlock& request)
+{
+    MemoryInputStream in (request, false);
+    const auto type = (MessageType) in.readInt();
+    const auto requestID = in.readInt();
+
+    if (type == MessageType::createInstance)
+    {
+        PluginDescription description;
+
+        if (auto xml = parseXML (in.readString()))
+            description.loadFromXml (*xml);
+
+        const auto sampleRate = in.readDouble();
+        const auto blockSize = in.readInt();
+
+        formatManager.createPluginInstanceAsync (description, sampleRate, blockSize,
+                                                 [ref = WeakReference<OutOfProcessPluginWorker> (this), requestID]
+                                                 (std::unique_ptr<AudioPluginInstance> instance, const String& error)
+                                                 {
+                                                     if (auto* worker = ref.get())
+                                                         worker->instanceCreated (std::move (instance), error, requestID);
+                                                 });
+        return;
+    }
+
+    if (session == nullptr)
+        return;
+
+    auto& instance = *session->instance;
+
+    MemoryOutputStream reply;
+    reply.writeInt ((int) MessageType::reply);
+    reply.writeInt (requestID);
+
+    switch (type)
+    {
+        case MessageType::prepare:
+        {
+            const auto sampleRate = in.readDouble();
+            const auto maxBlockSize = in.readInt();
+            const auto nonRealtime = in.readBool();
+            const auto midiBufferSize = in.readInt();
+            const auto layout = readBusesLayout (in);
+            const auto prepared = session->prepare (sampleRate, maxBlockSize, nonRealtime, midiBufferSize, layout);
+
+            reply.writeBool (prepared);
+
+            if (prepared)
+            {
+                reply.writeString (session->audioRegion->getName());
+                reply.writeInt (instance.getLatencySamples());
+            }
+
+            break;
+        }
+
+        case MessageType::release:
+            session->release();
+            break;
+
+        case MessageType::reset:
+        {
+            const ScopedLock sl (instance.getCallbackLock());
+            instance.reset();
+            return;
+        }
+
+        case MessageType::setNonRealtime:
+            instance.setNonRealtime (in.readBool());
+            return;
+
+        case MessageType::getState:
+        {
+            MemoryBlock state;
+
+            if (in.readBool())
+                instance.getCurrentProgramStateInformation (state);
+            else
+                instance.getStateInformation (state);
+
+            writeMemory (reply, state);
+            break;
+        }
+
+        case MessageType::setState:
+        {
+            const auto currentProgramOnly = in.readBool();
+            const auto state = readMemory (in);
+
+            if (currentProgramOnly)
+                instance.setCurrentProgramStateInformation (state.getData(), (int) state.getSize());
+            else
+                instance.setStateInformation (state.getData(), (int) state.getSize());
+
+            session->reportParameterValues();
+            reply.writeBool (true);
+            break;
+        }
+
+        case MessageType::setCurrentProgram:
+            instance.setCurrentProgram (in.readInt());
+            session->reportParameterValues();
+            reply.writeInt (instance.getCurrentProgram());
+            break;
+
+        case MessageType::changeProgramName:
+        {
+            const auto index = in.readInt();
+            instance.changeProgramName (index, in.readString());
+            return;
+        }
+
+        case MessageType::getParameterText:
+        {
+            auto* parameter = instance.getParameters()[in.readInt()];
+            const auto value = in.readFloat();
+            const auto maximumLength = in.readInt();
+
+            reply.writeString (parameter != nullptr ? parameter->getText (value, maximumLength) : String());
+            break;
+        }
+
+        case MessageType::getParameterValueForText:
+        {
+            auto* parameter = instance.getParameters()[in.readInt()];
+            const auto text = in.readString();
+
+            reply.writeFloat (parameter != nullptr ? parameter->getValueForText (text) : 0.0f);
+            break;
+        }
+
+        case MessageType::checkBusesLayout:
+            reply.writeBool (instance.checkBusesLayoutSupported (readBusesLayout (in)));
+            break;
+
+        case MessageType::reply:
+        case MessageType::createInstance:
+        case MessageType::latencyChanged:
+        case MessageType::programChanged:
+        default:
+            return;
+    }
+
+    sendMessageToCoordinator (reply.getMemoryBlock());
+}
+
+void OutOfProcessPluginWorker::instanceCreated (std::unique_ptr<AudioPluginInstance> instance, const String& error, int requestID)
+{
+    MemoryOutputStream reply;
+    reply.writeInt ((int) MessageType::reply);
+    reply.writeInt (requestID);
+
+    auto errorMessage = error;
+
+    if (instance != nullptr)
+    {
+        session.reset();
+        session = Session::create (*this, std::move (instance));
+
+        if (session == nullptr)
+            errorMessage = "Couldn't create shared memory for the plugin";
+    }
+    else if (errorMessage.isEmpty())
+    {
+        errorMessage = "Couldn't create the plugin";
+    }
+
+    reply.writeBool (session != nullptr);
+
+    if (session != nullptr)
+    {
+        auto details = OutOfProcessPluginInstance::Details::fromInstance (*session->instance);
+        details.controlRegionName = session->controlRegion->getName();
+        details.writeTo (reply);
+    }
+    else
+    {
+        reply.writeString (errorMessage);
+    }
+
+    sendMessageToCoordinator (reply.getMemoryBlock());
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct OutOfProcessPluginInstanceTests final : public UnitTest
+{
+    OutOfProcessPluginInstanceTests()
+        : UnitTest ("OutOfProcessPluginInstance", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        const AudioLayout layout { 3, 100, 256 };
+
+       #if JUCE_LINUX
+        beginTest ("The audio header is shared between two mappings");
+        {
+            const auto regionName = "/juce_plugin_test_" + String::toHexString (Random::getSystemRandom().nextInt64());
+            auto created = SharedMemoryRegion::create (regionName, layout.getSizeNeeded(), true);
+            expect (created != nullptr);
+
+            if (created == nullptr)
+                return;
+
+            auto& writerHeader = *new (created->getData()) AudioHeader();
+            layout.writeTo (writerHeader);
+
+            auto opened = SharedMemoryRegion::open (regionName, sizeof (AudioHeader));
+            expect (opened != nullptr);
+
+            if (opened == nullptr)
+                return;
+
+            opened->removeName();
+            created->releaseName();
+
+            auto& readerHeader = *static_cast<AudioHeader*> (opened->getData());
+            expect (layout.matches (readerHeader, opened->getSize()));
+
+            for (int i = 0; i < layout.numChannels; ++i)
+                FloatVectorOperations::fill (layout.getChannel (writerHeader, i), (float) i + 1.0f, layout.maxBlockSize);
+
+            for (int i = 0; i < layout.numChannels; ++i)
+            {
+                const auto* channel = layout.getChannel (readerHeader, i);
+                expectEquals (channel[0], (float) i + 1.0f);
+                expectEquals (channel[layout.maxBlockSize - 1], (float) i + 1.0f);
+            }
+
+            MidiBuffer midiIn;
+            midiIn.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 5);
+            writerHeader.numMidiInBytes = writeMidi (midiIn, layout.getMidiIn (writerHeader), layout.midiBufferSize);
+            writerHeader.jobSequence.store (1, std::memory_order_release);
+
+            expect (readerHeader.jobSequence.load (std::memory_order_acquire) == 1);
+
+            MidiBuffer received;
+            readMidi (layout.getMidiIn (readerHeader), readerHeader.numMidiInBytes, layout.midiBufferSize, received, 0);
+            expectEquals (received.getNumEvents(), 1);
+            expectEquals (received.getFirstEventTime(), 5);
+
+            expect (SharedMemoryRegion::open (regionName, 0) == nullptr);
+        }
+       #endif
+
+        beginTest ("A header that doesn't match the expected layout is rejected");
+        {
+            auto header = std::make_unique<AudioHeader>();
+            layout.writeTo (*header);
+
+            expect (layout.matches (*header, layout.getSizeNeeded()));
+            expect (! layout.matches (*header, layout.getSizeNeeded() - 1));
+
+            for (auto* field : { &header->numChannels, &header->maxBlockSize, &header->midiBufferSize })
+            {
+                const auto original = *field;
+                *field = original * 1000;
+                expect (! layout.matches (*header, layout.getSizeNeeded() * 1000));
+                *field = original;
+            }
+
+            header->magic = ControlHeader::magicValue;
+            expect (! layout.matches (*header, layout.getSizeNeeded()));
+        }
+
+        beginTest ("MIDI round trip");
+        {
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+            source.addEvent (MidiMessage::controllerEvent (2, 7, 64), 17);
+
+            const uint8 sysexData[] { 1, 2, 3, 4, 5 };
+            source.addEvent (MidiMessage::createSysExMessage (sysexData, (int) sizeof (sysexData)), 31);
+            source.addEvent (MidiMessage::noteOff (1, 60), 99);
+
+            HeapBlock<uint8> buffer (256, true);
+            const auto numBytes = writeMidi (source, buffer, 256);
+            expect (numBytes > 0 && numBytes % 4 == 0);
+
+            MidiBuffer dest;
+            readMidi (buffer, numBytes, 256, dest, 10);
+            expectEquals (dest.getNumEvents(), source.getNumEvents());
+
+            auto sourceIter = source.begin();
+
+            for (const auto metadata : dest)
+            {
+                const auto expected = *sourceIter++;
+                expectEquals (metadata.samplePosition, expected.samplePosition + 10);
+                expectEquals (metadata.numBytes, expected.numBytes);
+                expect (std::memcmp (metadata.data, expected.data, (size_t) expected.numBytes) == 0);
+            }
+        }
+
+        beginTest ("MIDI sizes from the other process are clamped");
+        {
+            MidiBuffer source;
+
+            for (int i = 0; i < 6; ++i)
+                source.addEvent (MidiMessage::noteOn (1, 60 + i, (uint8) 100), i);
+
+            // Each of these events takes 12 bytes, so only five fit in 64
+            HeapBlock<uint8> buffer (128, true);
+            const auto numBytes = writeMidi (source, buffer, 128);
+            expectEquals (numBytes, 72);
+
+            MidiBuffer dest;
+            readMidi (buffer, numBytes, 64, dest, 0);
+            expectEquals (dest.getNumEvents(), 5);
+
+            dest.clear();
+            readMidi (buffer, std::numeric_limits<int>::max(), 64, dest, 0);
+            expectEquals (dest.getNumEvents(), 5);
+
+            dest.clear();
+            readMidi (buffer, -1, 64, dest, 0);
+            expectEquals (dest.getNumEvents(), 0);
+
+            // A record that claims to be bigger than the buffer ends the sequence
+            const int32 corruptRecord[] { 0, 1000 };
+            std::memcpy (buffer + 24, corruptRecord, sizeof (corruptRecord));
+
+            dest.clear();
+            readMidi (buffer, numBytes, 128, dest, 0);
+            expectEquals (dest.getNumEvents(), 2);
+        }
+    }
+};
+
+static OutOfProcessPluginInstanceTests outOfProcessPluginInstanceTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,365 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioPluginInstance that runs a plugin in a separate worker process.
+
+    If the plugin crashes or hangs, only the worker process is affected: the
+    instance carries on producing silence, isWorkerRunning() returns false, and
+    the onWorkerLost callback is called.
+
+    The worker is launched by running an executable with a special command line,
+    and this executable must create an OutOfProcessPluginWorker when it starts,
+    in the same way as ChildProcessWorker is used. By default, the host's own
+    executable is launched, so an app that hosts plugins this way just needs to
+    do something like this in its JUCEApplication::initialise() method:
+
+    @code
+    void initialise (const String& commandLine) override
+    {
+        auto worker = std::make_unique<OutOfProcessPluginWorker> (formatManager);
+
+        if (worker->initialiseFromCommandLine (commandLine))
+        {
+            pluginWorker = std::move (worker);
+            return;
+        }
+
+        // ..carry on starting up normally..
+    }
+    @endcode
+
+    Audio and MIDI are passed to the worker through shared memory, and the worker
+    processes each block on a realtime thread of its own. By default, processBlock()
+    waits for the worker to finish the block before returning. In pipelined mode,
+    it instead hands over the block and returns the output of the previous one,
+    which adds one block of latency, but means that the worker runs at the same time
+    as the rest of the host's audio callback. When several plugins are hosted in
+    pipelined mode, they can all run in parallel on different cores.
+
+    Parameters, programs, state and bus layouts are forwarded to the plugin in the
+    worker. Parameter changes made by the host are passed to the plugin at the start
+    of the next block that it processes, or straight away if the plugin isn't
+    playing. The plugin's editor isn't available.
+
+    This is currently only supported on Linux.
+
+    @see OutOfProcessPluginWorker, ChildProcessCoordinator
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginInstance final  : public AudioPluginInstance,
+                                                    private AsyncUpdater,
+                                                    private Timer
+{
+public:
+    //==============================================================================
+    /** The default ID that's used to recognise the command line of a worker process. */
+    static constexpr const char* defaultCommandLineUniqueID = "juceOutOfProcessPlugin";
+
+    /** Settings that control how the worker process is launched and used. */
+    struct Options
+    {
+        /** The executable to launch as the worker process. This must create an
+            OutOfProcessPluginWorker when it starts.
+        */
+        [[nodiscard]] Options withWorkerExecutable (const File& newWorkerExecutable) const
+        {
+            return withMember (*this, &Options::workerExecutable, newWorkerExecutable);
+        }
+
+        /** The ID that the worker's OutOfProcessPluginWorker::initialiseFromCommandLine()
+            uses to recognise its command line.
+        */
+        [[nodiscard]] Options withCommandLineUniqueID (const String& newCommandLineUniqueID) const
+        {
+            return withMember (*this, &Options::commandLineUniqueID, newCommandLineUniqueID);
+        }
+
+        /** How long to wait for the worker to create the plugin, or to reply to any other
+            request such as preparing to play or getting the plugin's state.
+        */
+        [[nodiscard]] Options withTimeoutMs (int newTimeoutMs) const
+        {
+            return withMember (*this, &Options::timeoutMs, newTimeoutMs);
+        }
+
+        /** How long processBlock() may wait for the worker to process a block. If the
+            worker takes longer, the block is replaced with silence.
+
+            A negative value sets the timeout to the duration of the block that's being
+            processed. When the plugin is in non-realtime mode, processBlock() always waits
+            for as long as the worker takes.
+        */
+        [[nodiscard]] Options withProcessTimeoutMs (int newProcessTimeoutMs) const
+        {
+            return withMember (*this, &Options::processTimeoutMs, newProcessTimeoutMs);
+        }
+
+        /** If true, processBlock() returns the output of the previous block rather than
+            waiting for the current one. This adds the maximum block size to the latency
+            that the plugin reports.
+        */
+        [[nodiscard]] Options withPipelining (bool shouldPipeline) const
+        {
+            return withMember (*this, &Options::pipelined, shouldPipeline);
+        }
+
+        /** The number of bytes of MIDI that can be passed to or from the plugin in each block.
+            Any events that don't fit are dropped.
+        */
+        [[nodiscard]] Options withMidiBufferSize (int newMidiBufferSize) const
+        {
+            return withMember (*this, &Options::midiBufferSize, newMidiBufferSize);
+        }
+
+        File workerExecutable { File::getSpecialLocation (File::currentExecutableFile) };
+        String commandLineUniqueID { defaultCommandLineUniqueID };
+        int timeoutMs = 10000;
+        int processTimeoutMs = -1;
+        bool pipelined = false;
+        int midiBufferSize = 65536;
+    };
+
+    //==============================================================================
+    /** Launches a worker process, and asks it to create an instance of the plugin.
+
+        This blocks until the plugin has been created, which may take a while, so it
+        should be called on a background thread if possible.
+
+        @returns the new instance, or nullptr if the worker couldn't be launched or the
+                 plugin couldn't be created, in which case errorMessage is set to a
+                 description of the problem
+    */
+    static std::unique_ptr<OutOfProcessPluginInstance> create (const PluginDescription& description,
+                                                               double initialSampleRate,
+                                                               int initialBufferSize,
+                                                               String& errorMessage,
+                                                               const Options& options);
+
+    /** Launches a worker process using the default Options, and asks it to create an
+        instance of the plugin.
+    */
+    static std::unique_ptr<OutOfProcessPluginInstance> create (const PluginDescription& description,
+                                                               double initialSampleRate,
+                                                               int initialBufferSize,
+                                                               String& errorMessage);
+
+    /** Destructor. This shuts down the worker process. */
+    ~OutOfProcessPluginInstance() override;
+
+    //==============================================================================
+    /** Returns false if the worker process has crashed, hung or quit. */
+    bool isWorkerRunning() const noexcept;
+
+    /** Called on the message thread if the worker process crashes, hangs or quits.
+        After this, the instance will only produce silence.
+    */
+    std::function<void()> onWorkerLost;
+
+    //==============================================================================
+    /** @internal */
+    void fillInPluginDescription (PluginDescription&) const override;
+    /** @internal */
+    const String getName() const override;
+    /** @internal */
+    void prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void processBlock (AudioBuffer<float>&, MidiBuffer&) override;
+    /** @internal */
+    void processBlockBypassed (AudioBuffer<float>&, MidiBuffer&) override;
+    using AudioProcessor::processBlock;
+    using AudioProcessor::processBlockBypassed;
+    /** @internal */
+    void reset() override;
+    /** @internal */
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+    /** @internal */
+    double getTailLengthSeconds() const override;
+    /** @internal */
+    bool acceptsMidi() const override;
+    /** @internal */
+    bool producesMidi() const override;
+    /** @internal */
+    bool isMidiEffect() const override;
+    /** @internal */
+    AudioProcessorParameter* getBypassParameter() const override;
+    /** @internal */
+    bool isBusesLayoutSupported (const BusesLayout&) const override;
+    /** @internal */
+    bool hasEditor() const override;
+    /** @internal */
+    AudioProcessorEditor* createEditor() override;
+    /** @internal */
+    int getNumPrograms() override;
+    /** @internal */
+    int getCurrentProgram() override;
+    /** @internal */
+    void setCurrentProgram (int) override;
+    /** @internal */
+    const String getProgramName (int) override;
+    /** @internal */
+    void changeProgramName (int, const String&) override;
+    /** @internal */
+    void getStateInformation (MemoryBlock&) override;
+    /** @internal */
+    void setStateInformation (const void*, int) override;
+    /** @internal */
+    void getCurrentProgramStateInformation (MemoryBlock&) override;
+    /** @internal */
+    void setCurrentProgramStateInformation (const void*, int) override;
+
+private:
+    //==============================================================================
+    struct Connection;
+    struct Details;
+    struct SharedRegion;
+    class ProxyParameter;
+
+    OutOfProcessPluginInstance (std::unique_ptr<Connection>, std::unique_ptr<SharedRegion>, const Details&, const Options&);
+
+    void process (AudioBuffer<float>&, MidiBuffer&, bool bypassed);
+    void processSynchronously (AudioBuffer<float>&, MidiBuffer&, bool bypassed);
+    void processPipelined (AudioBuffer<float>&, MidiBuffer&, bool bypassed);
+    bool submitBlock (const AudioBuffer<float>&, const MidiBuffer&, bool bypassed);
+    bool waitForBlock (int numSamples);
+    void readOutput (AudioBuffer<float>&, MidiBuffer&, int numSamples);
+    void setParameterFromHost (int index, float newValue);
+    bool setState (const void*, int, bool currentProgramOnly);
+    void getState (MemoryBlock&, bool currentProgramOnly);
+    void updateLatency();
+    void handleWorkerMessage (MemoryInputStream&, int type);
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    std::unique_ptr<Connection> connection;
+    std::unique_ptr<SharedRegion> controlRegion, audioRegion;
+    const Options options;
+
+    PluginDescription description;
+    bool pluginAcceptsMidi = false, pluginProducesMidi = false, pluginIsMidiEffect = false;
+    double tailLengthSeconds = 0;
+    int bypassParameterIndex = -1;
+    std::atomic<int> pluginLatency { 0 };
+    StringArray programNames;
+    std::atomic<int> currentProgram { 0 };
+    Array<ProxyParameter*> proxyParameters;
+
+    // Audio thread state. The sizes of the shared audio memory are kept here, rather than
+    // read back from it, so that the worker can't change them.
+    int maxBlockSize = 0, numSharedChannels = 0;
+    uint32 lastJobSubmitted = 0;
+    int previousBlockSize = 0;
+    bool previousBlockSubmitted = false;
+    AudioBuffer<float> pipelineOutput;
+    int pipelineOutputSize = 0;
+    MidiBuffer pipelineMidi, scratchMidi;
+
+    std::atomic<bool> workerLost { false }, workerLostNotified { false };
+
+    friend class OutOfProcessPluginWorker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginInstance)
+};
+
+//==============================================================================
+/**
+    Runs plugins for OutOfProcessPluginInstance objects in a worker process.
+
+    Create one of these when your app starts, and call initialiseFromCommandLine()
+    to find out whether the app was launched as a worker. If it was, keep the
+    object alive: it'll create the plugin that the host asks for, and process
+    audio with it until the host goes away.
+
+    @see OutOfProcessPluginInstance
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginWorker  : private ChildProcessWorker,
+                                            private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a worker that will use a format manager to create plugins.
+        The format manager must not be deleted before the worker.
+    */
+    explicit OutOfProcessPluginWorker (AudioPluginFormatManager& formatManagerToUse);
+
+    /** Destructor. */
+    ~OutOfProcessPluginWorker() override;
+
+    //==============================================================================
+    /** Checks whether the command line is one that was used to launch a worker, and
+        if so, connects to the host.
+
+        @param commandLine          the command line that the app was launched with
+        @param commandLineUniqueID  the ID that was passed to OutOfProcessPluginInstance::Options
+        @returns true if the app is a worker and has connected to its host
+    */
+    bool initialiseFromCommandLine (const String& commandLine,
+                                    const String& commandLineUniqueID = OutOfProcessPluginInstance::defaultCommandLineUniqueID);
+
+    /** Called on the message thread when the host disconnects or goes away.
+        If this isn't set, the worker calls JUCEApplicationBase::quit().
+    */
+    std::function<void()> onHostLost;
+
+private:
+    //==============================================================================
+    struct Session;
+
+    void handleMessageFromCoordinator (const MemoryBlock&) override;
+    void handleConnectionLost() override;
+    void handleAsyncUpdate() override;
+    void handleRequest (const MemoryBlock&);
+    void instanceCreated (std::unique_ptr<AudioPluginInstance>, const String& error, int requestID);
+
+    AudioPluginFormatManager& formatManager;
+    std::unique_ptr<Session> session;
+
+    CriticalSection requestLock;
+    Array<MemoryBlock> pendingRequests;
+    std::atomic<bool> hostLost { false };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (OutOfProcessPluginWorker)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginWorker)
+};
+
+} // namespace juce
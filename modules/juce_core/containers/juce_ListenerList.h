@@ -53,8 +53,14 @@ namespace juce
     If the ListenerList is cleared or deleted during a callback, it is guaranteed that no more
     listeners will be called.
 
+    Calling the listeners never takes a lock or allocates any memory. Each call iterates over an
+    immutable snapshot of the list, and adding or removing a listener publishes a new snapshot
+    instead, so changes to the list are more expensive than calls. Snapshots that are no longer
+    in use are deleted the next time the list is changed.
+
     It is NOT safe to make concurrent calls to the listeners without a mutex. If you need this
-    functionality, either use a LightweightListenerList or a ThreadSafeListenerList.
+    functionality, either use a LightweightListenerList, a ThreadSafeListenerList, or a
+    ConcurrentListenerList.
 
     When calling listeners the iteration can be escaped early by using a "BailOutChecker".
     A BailOutChecker is a type that has a public member function with the following signature:
@@ -62,12 +68,13 @@ namespace juce
     This function will be called before making a call to each listener.
     For an example see the DummyBailOutChecker.
 
-    @see LightweightListenerList, ThreadSafeListenerList
+    @see LightweightListenerList, ThreadSafeListenerList, ConcurrentListenerList
 
     @tags{Core}
 */
 template <typename ListenerClass,
-          typename ArrayType = Array<ListenerClass*>>
+          typename ArrayType = Array<ListenerClass*>,
+          bool allowConcurrentCalls = false>
 class ListenerList
 {
 public:
@@ -76,7 +83,13 @@ public:
     ListenerList() = default;
 
     /** Destructor. */
-    ~ListenerList() { clear(); }
+    ~ListenerList()
+    {
+        clear();
+
+        if (auto* state = sharedState.load (std::memory_order_acquire))
+            state->release();
+    }
 
     //==============================================================================
     /** Adds a listener to the list.
@@ -90,12 +103,29 @@ public:
     */
     void add (ListenerClass* listenerToAdd)
     {
-        initialiseIfNeeded();
+        auto& state = getSharedState();
 
-        if (listenerToAdd != nullptr)
-            listeners->addIfNotAlreadyThere (listenerToAdd);
-        else
+        if (listenerToAdd == nullptr)
+        {
             jassertfalse; // Listeners can't be null pointers!
+            return;
+        }
+
+        const ScopedLockType lock (state.listeners.getLock());
+
+        if (! state.listeners.addIfNotAlreadyThere (listenerToAdd))
+            return;
+
+        auto* snapshot = new Snapshot();
+
+        if (const auto* current = state.current.load (std::memory_order_relaxed))
+        {
+            snapshot->reserve (current->size() + 1);
+            snapshot->assign (current->begin(), current->end());
+        }
+
+        snapshot->push_back ({ listenerToAdd, new Entry() });
+        state.publish (snapshot);
     }
 
     /** Removes a listener from the list.
@@ -108,22 +138,35 @@ public:
     {
         jassert (listenerToRemove != nullptr); // Listeners can't be null pointers!
 
-        if (! initialised())
-            return;
+        auto* state = sharedState.load (std::memory_order_acquire);
 
-        const ScopedLockType lock (listeners->getLock());
+        if (state == nullptr)
+            return;
 
-        if (const auto index = listeners->removeFirstMatchingValue (listenerToRemove); index >= 0)
         {
-            for (auto* it : *iterators)
-            {
-                if (index < it->end)
-                    --it->end;
+            const ScopedLockType lock (state->listeners.getLock());
+
+            if (state->listeners.removeFirstMatchingValue (listenerToRemove) < 0)
+                return;
+
+            const auto& current = *state->current.load (std::memory_order_relaxed);
+            auto* snapshot = current.size() > 1 ? new Snapshot() : nullptr;
+
+            if (snapshot != nullptr)
+                snapshot->reserve (current.size() - 1);
 
-                if (index <= it->index)
-                    --it->index;
+            for (const auto& slot : current)
+            {
+                if (slot.listener == listenerToRemove)
+                    state->retire (slot.entry);
+                else
+                    snapshot->push_back (slot);
             }
+
+            state->publish (snapshot);
         }
+
+        waitForCallsOnOtherThreads (*state);
     }
 
     /** Adds a listener that will be automatically removed again when the Guard is destroyed.
@@ -139,10 +182,14 @@ public:
     }
 
     /** Returns the number of registered listeners. */
-    [[nodiscard]] int size() const noexcept                                { return ! initialised() ? 0 : listeners->size(); }
+    [[nodiscard]] int size() const noexcept
+    {
+        const auto* state = sharedState.load (std::memory_order_acquire);
+        return state == nullptr ? 0 : state->listeners.size();
+    }
 
     /** Returns true if no listeners are registered, false otherwise. */
-    [[nodiscard]] bool isEmpty() const noexcept                            { return ! initialised() || listeners->isEmpty(); }
+    [[nodiscard]] bool isEmpty() const noexcept                            { return size() == 0; }
 
     /** Clears the list.
 
@@ -151,22 +198,33 @@ public:
     */
     void clear()
     {
-        if (! initialised())
+        auto* state = sharedState.load (std::memory_order_acquire);
+
+        if (state == nullptr)
             return;
 
-        const ScopedLockType lock { listeners->getLock() };
+        {
+            const ScopedLockType lock (state->listeners.getLock());
 
-        listeners->clear();
+            state->listeners.clear();
+
+            if (const auto* current = state->current.load (std::memory_order_relaxed))
+            {
+                for (const auto& slot : *current)
+                    state->retire (slot.entry);
 
-        for (auto* it : *iterators)
-            it->end = 0;
+                state->publish (nullptr);
+            }
+        }
+
+        waitForCallsOnOtherThreads (*state);
     }
 
     /** Returns true if the specified listener has been added to the list. */
     [[nodiscard]] bool contains (ListenerClass* listener) const noexcept
     {
-        return initialised()
-            && listeners->contains (listener);
+        const auto* state = sharedState.load (std::memory_order_acquire);
+        return state != nullptr && state->listeners.contains (listener);
     }
 
     /** Returns the raw array of listeners.
@@ -180,8 +238,7 @@ public:
     */
     [[nodiscard]] const ArrayType& getListeners() const noexcept
     {
-        const_cast<ListenerList*> (this)->initialiseIfNeeded();
-        return *listeners;
+        return const_cast<ListenerList*> (this)->getSharedState().listeners;
     }
 
     //==============================================================================
@@ -229,18 +286,15 @@ public:
                                const BailOutCheckerType& bailOutChecker,
                                Callback&& callback)
     {
-        if (! initialised())
-            return;
+        auto* state = sharedState.load (std::memory_order_acquire);
 
-        const auto localListeners = listeners;
-        const ScopedLockType lock { localListeners->getLock() };
+        if (state == nullptr)
+            return;
 
        #if JUCE_ASSERTIONS_ENABLED_OR_LOGGED
+        if constexpr (! isThreadSafe)
         {
-            // Keep a reference to the mutex to protect against the case where this list gets deleted
-            // during a callback.
-            auto localMutexPtr = callCheckedExcludingMutex;
-            const ScopedTryLock callCheckedExcludingLock (*localMutexPtr);
+            const ScopedTryLock callCheckedExcludingLock (state->callCheckedExcludingMutex);
 
             // If you hit this assertion it means you're trying to call the listeners from multiple
             // threads concurrently. If you need to do this either use a LightweightListenerList, for a
@@ -250,27 +304,38 @@ public:
         }
        #endif
 
-        Iterator it{};
-        it.end = localListeners->size();
+        // This keeps the snapshot and its entries alive, even if the list is changed or
+        // deleted by one of the callbacks
+        const ScopedCall scopedCall (*state);
 
-        iterators->push_back (&it);
+        // Unless concurrent calls have been asked for, a thread safe list holds its lock for the
+        // whole call, so that a listener removed by another thread, or by a callback, can be
+        // deleted as soon as remove() returns
+        std::optional<ScopedLockType> lock;
 
-        const ScopeGuard scope { [i = iterators, &it]
-        {
-            i->erase (std::remove (i->begin(), i->end(), &it), i->end());
-        } };
+        if constexpr (! allowConcurrentCalls)
+            lock.emplace (state->listeners.getLock());
+
+        const auto numRemovalsAtStart = state->numRemovals.load (std::memory_order_relaxed);
+        const auto* snapshot = state->current.load (std::memory_order_acquire);
+
+        if (snapshot == nullptr)
+            return;
 
-        for (; it.index < it.end; ++it.index)
+        for (const auto& slot : *snapshot)
         {
             if (bailOutChecker.shouldBailOut())
                 return;
 
-            auto* listener = localListeners->getUnchecked (it.index);
+            if (slot.listener == listenerToExclude)
+                continue;
 
-            if (listener == listenerToExclude)
+            // The flags only need to be checked once something has been removed during this call
+            if (state->numRemovals.load (std::memory_order_relaxed) != numRemovalsAtStart
+                 && slot.entry->removed.load (std::memory_order_relaxed))
                 continue;
 
-            callback (*listener);
+            callback (*slot.listener);
         }
     }
 
@@ -343,68 +408,264 @@ public:
     };
 
     //==============================================================================
-    using ThisType      = ListenerList<ListenerClass, ArrayType>;
+    using ThisType      = ListenerList<ListenerClass, ArrayType, allowConcurrentCalls>;
     using ListenerType  = ListenerClass;
 
 private:
     //==============================================================================
     using ScopedLockType = typename ArrayType::ScopedLockType;
 
+    // Lists that use a real lock can be called from several threads at once, so their counters
+    // need to be updated atomically. Otherwise, the calls are serialised by the caller and
+    // plain loads and stores are enough.
+    static constexpr bool isThreadSafe = ! std::is_same_v<ScopedLockType, DummyCriticalSection::ScopedLockType>;
+
+    // Calls can only overlap if the array's lock can be shared between threads
+    static_assert (isThreadSafe || ! allowConcurrentCalls,
+                   "A ListenerList that allows concurrent calls must use a thread safe array type");
+
+    template <typename Value>
+    static Value addToCounter (std::atomic<Value>& counter, Value delta) noexcept
+    {
+        if constexpr (isThreadSafe)
+        {
+            return counter.fetch_add (delta) + delta;
+        }
+        else
+        {
+            const auto result = (Value) (counter.load (std::memory_order_relaxed) + delta);
+            counter.store (result, std::memory_order_relaxed);
+            return result;
+        }
+    }
+
     //==============================================================================
-    using SharedListeners = std::shared_ptr<ArrayType>;
-    SharedListeners listeners;
+    // Each listener has an Entry that's shared between all the snapshots containing it. Removing
+    // the listener sets its flag, so that calls still iterating an older snapshot will skip it.
+    struct Entry
+    {
+        std::atomic<bool> removed { false };
+    };
 
-    struct Iterator
+    struct Slot
     {
-        int index{};
-        int end{};
+        ListenerClass* listener;
+        Entry* entry;
     };
 
-    using SafeIterators = std::vector<Iterator*>;
-    using SharedIterators = std::shared_ptr<SafeIterators>;
-    SharedIterators iterators;
+    using Snapshot = std::vector<Slot>;
 
-    enum class State
+    /*  Snapshots and entries that have been replaced can't be deleted while a call might still
+        be using them, so they're retired into the list for the current epoch instead. Each call
+        is counted against the epoch in which it started, and the epoch only moves on once all
+        the calls from the epoch before it have finished. At that point, nothing can refer to
+        the items retired two epochs ago, so they're deleted.
+    */
+    struct SharedState
     {
-        uninitialised,
-        initialising,
-        initialised
-    };
+        SharedState() = default;
+
+        ~SharedState()
+        {
+            if (auto* snapshot = current.load (std::memory_order_relaxed))
+            {
+                for (const auto& slot : *snapshot)
+                    delete slot.entry;
+
+                delete snapshot;
+            }
 
-    std::atomic<State> state { State::uninitialised };
+            for (auto& r : retired)
+                r.deleteAll();
+        }
 
-    inline bool initialised() const noexcept { return state == State::initialised; }
+        void release() noexcept
+        {
+            if (addToCounter (refCount, -1) == 0)
+                delete this;
+        }
 
-    inline void initialiseIfNeeded() noexcept
+        // These must only be called while holding the lock
+        void retire (Entry* entry)
+        {
+            entry->removed.store (true, std::memory_order_relaxed);
+            numRemovals.store (numRemovals.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            retired[epoch.load (std::memory_order_relaxed) & 1].entries.push_back (entry);
+        }
+
+        void publish (Snapshot* snapshot)
+        {
+            if (auto* old = current.exchange (snapshot))
+                retired[epoch.load (std::memory_order_relaxed) & 1].snapshots.push_back (old);
+
+            collectGarbage();
+        }
+
+        void collectGarbage()
+        {
+            const auto e = epoch.load (std::memory_order_relaxed);
+
+            if (numCalls[(e + 1) & 1].load() != 0)
+                return;
+
+            retired[(e + 1) & 1].deleteAll();
+            epoch.store (e + 1);
+        }
+
+        struct Retired
+        {
+            void deleteAll()
+            {
+                for (auto* s : snapshots)
+                    delete s;
+
+                for (auto* e : entries)
+                    delete e;
+
+                snapshots.clear();
+                entries.clear();
+            }
+
+            std::vector<Snapshot*> snapshots;
+            std::vector<Entry*> entries;
+        };
+
+        ArrayType listeners;
+        std::atomic<Snapshot*> current { nullptr };
+        std::atomic<uint32> epoch { 0 }, numRemovals { 0 };
+        std::atomic<int> numCalls[2] { 0, 0 };
+        std::atomic<int> refCount { 1 };
+        Retired retired[2];
+
+       #if JUCE_ASSERTIONS_ENABLED_OR_LOGGED
+        CriticalSection callCheckedExcludingMutex;
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE (SharedState)
+    };
+
+    //==============================================================================
+    class ScopedCall
     {
-        if (initialised())
-            return;
+    public:
+        explicit ScopedCall (SharedState& s) noexcept
+            : state (s)
+        {
+            addToCounter (state.refCount, 1);
+
+            if constexpr (isThreadSafe)
+            {
+                // A writer may move the epoch on between reading it and registering this call,
+                // in which case the call has to be registered against the new epoch instead
+                for (;;)
+                {
+                    epoch = state.epoch.load();
+                    ++state.numCalls[epoch & 1];
+
+                    if (state.epoch.load() == epoch)
+                        break;
+
+                    --state.numCalls[epoch & 1];
+                }
+            }
+            else
+            {
+                epoch = state.epoch.load (std::memory_order_relaxed);
+                addToCounter (state.numCalls[epoch & 1], 1);
+            }
 
-        auto expected = State::uninitialised;
+            if constexpr (allowConcurrentCalls)
+                previous = std::exchange (getActiveCalls(), this);
+        }
 
-        if (state.compare_exchange_strong (expected, State::initialising))
+        ~ScopedCall()
         {
-            static_assert (std::is_nothrow_constructible_v<ArrayType>,
-                           "Any ListenerList ArrayType must have a noexcept default constructor");
+            if constexpr (allowConcurrentCalls)
+                getActiveCalls() = previous;
 
-            static_assert (std::is_nothrow_constructible_v<SafeIterators>,
-                           "Please notify the JUCE team if you encounter this assertion");
+            addToCounter (state.numCalls[epoch & 1], -1);
+            state.release();
+        }
 
-            listeners = std::make_shared<ArrayType>();
-            iterators = std::make_shared<SafeIterators>();
-            state = State::initialised;
-            return;
+        static bool isActiveOnThisThread (const SharedState& s) noexcept
+        {
+            for (auto* call = getActiveCalls(); call != nullptr; call = call->previous)
+                if (&call->state == &s)
+                    return true;
+
+            return false;
+        }
+
+    private:
+        static ScopedCall*& getActiveCalls() noexcept
+        {
+            thread_local ScopedCall* activeCalls = nullptr;
+            return activeCalls;
         }
 
-        while (! initialised())
-            std::this_thread::yield();
+        SharedState& state;
+        uint32 epoch = 0;
+        ScopedCall* previous = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCall)
+    };
+
+    //==============================================================================
+    // After a listener has been removed from a list that allows concurrent calls, calls on other
+    // threads may still be about to call it. Unless this thread is inside one of this list's
+    // callbacks, in which case waiting could deadlock, this waits until the epoch has moved on
+    // twice, which means that all the calls that were in progress have finished. Other thread safe
+    // lists don't need to wait, because their calls hold the lock that was taken to remove it.
+    void waitForCallsOnOtherThreads (SharedState& state)
+    {
+        if constexpr (allowConcurrentCalls)
+        {
+            if (ScopedCall::isActiveOnThisThread (state))
+                return;
+
+            // Any calls that start after this point will see the new snapshot
+            if (state.numCalls[0].load() == 0 && state.numCalls[1].load() == 0)
+                return;
+
+            const auto target = state.epoch.load() + 2;
+            const auto isDone = [&] { return (int32) (state.epoch.load() - target) >= 0; };
+
+            while (! isDone())
+            {
+                {
+                    const ScopedLockType lock (state.listeners.getLock());
+                    state.collectGarbage();
+                }
+
+                if (! isDone())
+                    std::this_thread::yield();
+            }
+        }
+        else
+        {
+            ignoreUnused (state);
+        }
     }
 
-   #if JUCE_ASSERTIONS_ENABLED_OR_LOGGED
-    // using a shared_ptr helps keep the size of this class down to prevent excessive stack sizes
-    // due to objects that contain a ListenerList being created on the stack
-    std::shared_ptr<CriticalSection> callCheckedExcludingMutex = std::make_shared<CriticalSection>();
-   #endif
+    SharedState& getSharedState()
+    {
+        if (auto* state = sharedState.load (std::memory_order_acquire))
+            return *state;
+
+        auto* newState = new SharedState();
+        SharedState* expected = nullptr;
+
+        if (sharedState.compare_exchange_strong (expected, newState, std::memory_order_acq_rel))
+            return *newState;
+
+        delete newState;
+        return *expected;
+    }
+
+    // This is allocated the first time it's needed, which keeps the size of this class down to
+    // prevent excessive stack sizes due to objects that contain a ListenerList being created on
+    // the stack
+    std::atomic<SharedState*> sharedState { nullptr };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE (ListenerList)
@@ -414,13 +675,39 @@ private:
 /**
     A thread safe version of the ListenerList class.
 
-    @see ListenerList, LightweightListenerList
+    The list's lock is held while the listeners are being called, so calls made from different
+    threads happen one at a time, and once remove() or clear() has returned, on any thread or from
+    inside a callback, the removed listeners can safely be deleted.
+
+    @see ListenerList, LightweightListenerList, ConcurrentListenerList
 
     @tags{Core}
 */
 template <typename ListenerClass>
 using ThreadSafeListenerList = ListenerList<ListenerClass, Array<ListenerClass*, CriticalSection>>;
 
+//==============================================================================
+/**
+    A version of the ThreadSafeListenerList that lets the listeners be called from several threads
+    at the same time.
+
+    Calls don't take the list's lock, so they don't wait for each other, and listeners can be
+    added or removed from any thread while calls are in progress.
+
+    When a listener is removed, or the list is cleared, from outside one of the list's own
+    callbacks, the method waits for any calls that are in progress on other threads to finish
+    before returning, so a removed listener can safely be deleted straight away. When this is
+    done from inside a callback, the listener won't be called again by that thread, but it may
+    still be in the middle of being called by other threads, so it mustn't be deleted until
+    you know that those calls have finished.
+
+    @see ListenerList, ThreadSafeListenerList, LightweightListenerList
+
+    @tags{Core}
+*/
+template <typename ListenerClass>
+using ConcurrentListenerList = ListenerList<ListenerClass, Array<ListenerClass*, CriticalSection>, true>;
+
 //==============================================================================
 /**
     A lightweight version of the ListenerList that doesn't provide any guarantees when mutating the
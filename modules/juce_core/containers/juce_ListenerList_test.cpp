@@ -517,6 +517,196 @@ public:
 
             expect (threadPool.removeAllJobs (false, 30'000));
         }
+
+        beginTest ("ThreadSafeListenerList calls from different threads don't overlap");
+        {
+            struct Listener {};
+
+            ThreadSafeListenerList<Listener> listeners;
+            Listener listener1, listener2;
+            listeners.add (&listener1);
+            listeners.add (&listener2);
+
+            std::atomic<int> numInside { 0 };
+            std::atomic<bool> sawConcurrentCall { false };
+
+            auto task = [&]
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    listeners.call ([&] (Listener&)
+                    {
+                        if (++numInside > 1)
+                            sawConcurrentCall = true;
+
+                        std::this_thread::yield();
+                        --numInside;
+                    });
+                }
+            };
+
+            std::thread thread1 { task }, thread2 { task };
+            thread1.join();
+            thread2.join();
+
+            expect (! sawConcurrentCall);
+        }
+
+        beginTest ("ThreadSafeListenerList listener removed from a callback isn't being called by other threads");
+        {
+            struct Listener
+            {
+                std::atomic<bool> isInCallback { false };
+            };
+
+            ThreadSafeListenerList<Listener> listeners;
+            Listener remover;
+            auto removed = std::make_unique<Listener>();
+            listeners.add (removed.get());
+            listeners.add (&remover);
+
+            WaitableEvent otherThreadIsInCallback;
+
+            std::thread otherThread { [&]
+            {
+                listeners.call ([&] (Listener& l)
+                {
+                    if (&l != removed.get())
+                        return;
+
+                    l.isInCallback = true;
+                    otherThreadIsInCallback.signal();
+                    Thread::sleep (50);
+                    l.isInCallback = false;
+                });
+            } };
+
+            otherThreadIsInCallback.wait (5'000);
+            bool wasBeingCalled = true;
+
+            listeners.callExcluding (removed.get(), [&] (Listener&)
+            {
+                listeners.remove (removed.get());
+                wasBeingCalled = removed->isInCallback;
+                removed.reset();
+            });
+
+            otherThread.join();
+
+            expect (! wasBeingCalled);
+            expect (listeners.size() == 1);
+        }
+
+        beginTest ("ConcurrentListenerList can be called concurrently");
+        {
+            struct Listener
+            {
+                void callback() { ++numCalls; }
+                std::atomic<int> numCalls { 0 };
+            };
+
+            ConcurrentListenerList<Listener> listeners;
+            Listener listener1, listener2;
+            listeners.add (&listener1);
+            listeners.add (&listener2);
+
+            std::atomic<int> numInside { 0 };
+            std::atomic<bool> sawConcurrentCall { false };
+            WaitableEvent bothInside { true };
+
+            auto task = [&]
+            {
+                listeners.call ([&] (Listener& l)
+                {
+                    if (&l != &listener1)
+                        return;
+
+                    if (++numInside == 2)
+                    {
+                        sawConcurrentCall = true;
+                        bothInside.signal();
+                    }
+
+                    bothInside.wait (5'000);
+                });
+            };
+
+            std::thread thread1 { task }, thread2 { task };
+            thread1.join();
+            thread2.join();
+
+            expect (sawConcurrentCall);
+        }
+
+        beginTest ("ConcurrentListenerList::remove waits for calls on other threads");
+        {
+            struct Listener
+            {
+                void callback()
+                {
+                    isInCallback = true;
+                    Thread::sleep (1);
+                    isInCallback = false;
+                }
+
+                std::atomic<bool> isInCallback { false };
+            };
+
+            ConcurrentListenerList<Listener> listeners;
+            std::vector<std::unique_ptr<Listener>> toRemove;
+
+            for (int i = 0; i < 20; ++i)
+            {
+                toRemove.push_back (std::make_unique<Listener>());
+                listeners.add (toRemove.back().get());
+            }
+
+            std::atomic<bool> shouldStop { false };
+
+            std::thread caller { [&]
+            {
+                while (! shouldStop)
+                    listeners.call (&Listener::callback);
+            } };
+
+            bool wasCalledAfterRemoval = false;
+
+            for (auto& listener : toRemove)
+            {
+                Thread::sleep (1);
+                listeners.remove (listener.get());
+                wasCalledAfterRemoval |= listener->isInCallback.load();
+            }
+
+            shouldStop = true;
+            caller.join();
+
+            expect (! wasCalledAfterRemoval);
+            expect (listeners.isEmpty());
+        }
+
+        beginTest ("ConcurrentListenerList can remove a listener from a callback");
+        {
+            struct Listener { void callback() {} };
+
+            ConcurrentListenerList<Listener> listeners;
+            Listener listener1, listener2;
+            listeners.add (&listener1);
+            listeners.add (&listener2);
+
+            int numCalls = 0;
+
+            listeners.call ([&] (Listener& l)
+            {
+                ++numCalls;
+                listeners.remove (&listener1);
+                listeners.remove (&listener2);
+                listeners.add (&l);
+            });
+
+            expect (numCalls == 1);
+            expect (listeners.size() == 1);
+        }
     }
 
 private:
@@ -0,0 +1,1337 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct JSONDocument::Node
+{
+    enum Flags : uint8
+    {
+        isKey           = 1,
+        isPropertyValue = 2
+    };
+
+    Type type;
+    uint8 flags;
+    uint32 count;   // the number of children of an array or object, or the length of a string
+
+    union
+    {
+        int64 intValue;
+        double doubleValue;
+        const char* text;
+        size_t numDescendants;
+    };
+
+    bool isContainer() const noexcept        { return type == Type::array || type == Type::object; }
+    const Node* getNextSibling() const noexcept { return this + 1 + (isContainer() ? numDescendants : 0); }
+};
+
+//==============================================================================
+namespace JSONDocumentHelpers
+{
+    struct CharacterMasks
+    {
+        uint64 whitespace = 0, operators = 0, quotes = 0, backslashes = 0, controls = 0, nonAscii = 0;
+    };
+
+   #if JUCE_CORE_USE_SSE2_INTRINSICS
+    static CharacterMasks classifyBlock (const uint8* block) noexcept
+    {
+        CharacterMasks result;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (block + i * 16));
+            const auto shift = i * 16;
+
+            const auto toMask = [shift] (__m128i m) { return (uint64) (uint32) _mm_movemask_epi8 (m) << shift; };
+            const auto equals = [&v] (char c)       { return _mm_cmpeq_epi8 (v, _mm_set1_epi8 (c)); };
+
+            // OR-ing with 0x20 maps '[' and ']' onto '{' and '}'
+            const auto lowered = _mm_or_si128 (v, _mm_set1_epi8 (0x20));
+
+            result.whitespace  |= toMask (_mm_or_si128 (_mm_or_si128 (equals (' '),  equals ('\t')),
+                                                         _mm_or_si128 (equals ('\n'), equals ('\r'))));
+            result.operators   |= toMask (_mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (lowered, _mm_set1_epi8 ('{')),
+                                                                      _mm_cmpeq_epi8 (lowered, _mm_set1_epi8 ('}'))),
+                                                         _mm_or_si128 (equals (':'), equals (','))));
+            result.quotes      |= toMask (equals ('"'));
+            result.backslashes |= toMask (equals ('\\'));
+            result.controls    |= toMask (_mm_cmpeq_epi8 (_mm_max_epu8 (v, _mm_set1_epi8 (0x1f)), _mm_set1_epi8 (0x1f)));
+            result.nonAscii    |= toMask (v);
+        }
+
+        return result;
+    }
+   #elif JUCE_CORE_USE_NEON_INTRINSICS
+    static uint64 toBitMask (uint8x16_t lanes) noexcept
+    {
+        alignas (16) static const uint8 bits[] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        const auto masked = vandq_u8 (lanes, vld1q_u8 (bits));
+        return (uint64) vaddv_u8 (vget_low_u8 (masked)) | ((uint64) vaddv_u8 (vget_high_u8 (masked)) << 8);
+    }
+
+    static CharacterMasks classifyBlock (const uint8* block) noexcept
+    {
+        CharacterMasks result;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto v = vld1q_u8 (block + i * 16);
+            const auto shift = i * 16;
+
+            const auto toMask = [shift] (uint8x16_t m) { return toBitMask (m) << shift; };
+            const auto equals = [&v] (char c)          { return vceqq_u8 (v, vdupq_n_u8 ((uint8) c)); };
+
+            // OR-ing with 0x20 maps '[' and ']' onto '{' and '}'
+            const auto lowered = vorrq_u8 (v, vdupq_n_u8 (0x20));
+
+            result.whitespace  |= toMask (vorrq_u8 (vorrq_u8 (equals (' '),  equals ('\t')),
+                                                    vorrq_u8 (equals ('\n'), equals ('\r'))));
+            result.operators   |= toMask (vorrq_u8 (vorrq_u8 (vceqq_u8 (lowered, vdupq_n_u8 ('{')),
+                                                              vceqq_u8 (lowered, vdupq_n_u8 ('}'))),
+                                                    vorrq_u8 (equals (':'), equals (','))));
+            result.quotes      |= toMask (equals ('"'));
+            result.backslashes |= toMask (equals ('\\'));
+            result.controls    |= toMask (vcleq_u8 (v, vdupq_n_u8 (0x1f)));
+            result.nonAscii    |= toMask (vcgeq_u8 (v, vdupq_n_u8 (0x80)));
+        }
+
+        return result;
+    }
+   #else
+    static CharacterMasks classifyBlock (const uint8* block) noexcept
+    {
+        CharacterMasks result;
+
+        for (int i = 0; i < 64; ++i)
+        {
+            const auto c = block[i];
+            const auto bit = (uint64) 1 << i;
+
+            switch (c)
+            {
+                case ' ': case '\t': case '\n': case '\r':
+                    result.whitespace |= bit;
+                    break;
+
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    result.operators |= bit;
+                    break;
+
+                case '"':   result.quotes |= bit; break;
+                case '\\':  result.backslashes |= bit; break;
+                default:    break;
+            }
+
+            if (c < 0x20)   result.controls |= bit;
+            if (c >= 0x80)  result.nonAscii |= bit;
+        }
+
+        return result;
+    }
+   #endif
+
+    static int countTrailingZeros (uint64 n) noexcept
+    {
+        jassert (n != 0);
+
+       #if JUCE_MSVC
+        unsigned long index = 0;
+
+        #if JUCE_64BIT
+         _BitScanForward64 (&index, n);
+         return (int) index;
+        #else
+         if (_BitScanForward (&index, (unsigned long) n))
+             return (int) index;
+
+         _BitScanForward (&index, (unsigned long) (n >> 32));
+         return (int) index + 32;
+        #endif
+       #else
+        return __builtin_ctzll (n);
+       #endif
+    }
+
+    /*  Returns a mask in which each bit is the XOR of all the bits at or below that
+        position in the input, which turns a mask of quote characters into a mask of
+        the bytes that are inside strings.
+    */
+    static uint64 prefixXor (uint64 n) noexcept
+    {
+        n ^= n << 1;
+        n ^= n << 2;
+        n ^= n << 4;
+        n ^= n << 8;
+        n ^= n << 16;
+        n ^= n << 32;
+        return n;
+    }
+
+    /*  Given a mask of backslashes, returns a mask of the characters that are escaped by
+        them. A run of backslashes escapes the character after it only if it has an odd
+        length, and runs may continue from the previous block, so the state is carried in
+        escapeCarry. Subtracting the backslashes from the odd bits makes any run that starts
+        on an even bit ripple through and invert the alternating pattern, which separates
+        the runs that start on even and odd bits without a loop.
+    */
+    static uint64 findEscapedCharacters (uint64 backslashes, uint64& escapeCarry) noexcept
+    {
+        if (backslashes == 0)
+        {
+            auto escaped = escapeCarry;
+            escapeCarry = 0;
+            return escaped;
+        }
+
+        constexpr uint64 oddBits = 0xaaaaaaaaaaaaaaaaULL;
+
+        const auto potentialEscapes = backslashes & ~escapeCarry;
+        const auto maybeEscaped = potentialEscapes << 1;
+        const auto escapeAndTerminalCodes = ((maybeEscaped | oddBits) - potentialEscapes) ^ oddBits;
+        const auto escaped = escapeAndTerminalCodes ^ (backslashes | escapeCarry);
+        const auto escapes = escapeAndTerminalCodes & backslashes;
+
+        escapeCarry = escapes >> 63;
+        return escaped;
+    }
+
+    static bool isValidUTF8 (const uint8* data, size_t numBytes) noexcept
+    {
+        size_t i = 0;
+
+        while (i < numBytes)
+        {
+            // skip quickly over runs of ASCII
+            if (i + 8 <= numBytes)
+            {
+                uint64 word;
+                memcpy (&word, data + i, sizeof (word));
+
+                if ((word & 0x8080808080808080ULL) == 0)
+                {
+                    i += 8;
+                    continue;
+                }
+            }
+
+            const auto c = data[i];
+
+            if (c < 0x80)
+            {
+                ++i;
+                continue;
+            }
+
+            const auto numExtraBytes = c >= 0xc2 && c <= 0xdf ? 1
+                                     : c >= 0xe0 && c <= 0xef ? 2
+                                     : c >= 0xf0 && c <= 0xf4 ? 3 : 0;
+
+            if (numExtraBytes == 0 || i + (size_t) numExtraBytes >= numBytes)
+                return false;
+
+            auto codePoint = (uint32) (c & (0x3f >> numExtraBytes));
+
+            for (int j = 1; j <= numExtraBytes; ++j)
+            {
+                const auto next = data[i + (size_t) j];
+
+                if ((next & 0xc0) != 0x80)
+                    return false;
+
+                codePoint = (codePoint << 6) | (uint32) (next & 0x3f);
+            }
+
+            if ((numExtraBytes == 2 && (codePoint < 0x800 || (codePoint >= 0xd800 && codePoint <= 0xdfff)))
+                 || (numExtraBytes == 3 && (codePoint < 0x10000 || codePoint > 0x10ffff)))
+                return false;
+
+            i += (size_t) numExtraBytes + 1;
+        }
+
+        return true;
+    }
+
+    static bool isDelimiter (char c) noexcept
+    {
+        switch (c)
+        {
+            case ' ': case '\t': case '\n': case '\r':
+            case '{': case '}': case '[': case ']': case ':': case ',': case '"':
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    static bool isDigit (char c) noexcept    { return c >= '0' && c <= '9'; }
+}
+
+//==============================================================================
+struct JSONDocument::Pimpl
+{
+    struct ParseError
+    {
+        const char* message;
+        size_t position;
+    };
+
+    MemoryBlock ownedData;
+    String ownedText;
+    std::vector<Node> nodes;
+
+    const char* text = nullptr;
+    size_t numBytes = 0;
+    bool containsNonAscii = false;
+
+    std::vector<HeapBlock<char>> stringStorage;
+    char* nextFreeStorage = nullptr;
+    size_t storageSpaceLeft = 0;
+
+    void clear()
+    {
+        nodes.clear();
+        stringStorage.clear();
+        nextFreeStorage = nullptr;
+        storageSpaceLeft = 0;
+        text = nullptr;
+        numBytes = 0;
+    }
+
+    //==============================================================================
+    Result parse (const void* data, size_t size)
+    {
+        nodes.clear();
+        stringStorage.clear();
+        nextFreeStorage = nullptr;
+        storageSpaceLeft = 0;
+        text = static_cast<const char*> (data);
+        numBytes = size;
+
+        try
+        {
+            if (numBytes > (size_t) std::numeric_limits<uint32>::max())
+                throw ParseError { "Document is too large", 0 };
+
+            std::vector<uint32> structuralIndex;
+            buildStructuralIndex (structuralIndex);
+            buildNodes (structuralIndex);
+        }
+        catch (const ParseError& error)
+        {
+            auto description = getErrorDescription (error);
+            clear();
+            return Result::fail (description);
+        }
+
+        return Result::ok();
+    }
+
+    String getErrorDescription (const ParseError& error) const
+    {
+        int line = 1, column = 1;
+
+        for (size_t i = 0; i < error.position && i < numBytes; ++i)
+        {
+            if (text[i] == '\n')
+            {
+                ++line;
+                column = 1;
+            }
+            else if ((text[i] & 0xc0) != 0x80)
+            {
+                ++column;
+            }
+        }
+
+        return String (line) + ":" + String (column) + ": error: " + error.message;
+    }
+
+    //==============================================================================
+    void buildStructuralIndex (std::vector<uint32>& result)
+    {
+        using namespace JSONDocumentHelpers;
+
+        result.clear();
+        result.reserve (numBytes / 8 + 16);
+
+        const auto* data = reinterpret_cast<const uint8*> (text);
+        uint64 escapeCarry = 0, inStringCarry = 0, scalarCarry = 0, nonAscii = 0;
+        uint8 lastBlock[64];
+
+        for (size_t blockStart = 0; blockStart < numBytes; blockStart += 64)
+        {
+            auto* block = data + blockStart;
+
+            if (numBytes - blockStart < 64)
+            {
+                memset (lastBlock, ' ', sizeof (lastBlock));
+                memcpy (lastBlock, block, numBytes - blockStart);
+                block = lastBlock;
+            }
+
+            const auto masks = classifyBlock (block);
+            nonAscii |= masks.nonAscii;
+
+            const auto escaped = findEscapedCharacters (masks.backslashes, escapeCarry);
+            const auto quotes = masks.quotes & ~escaped;
+            const auto inString = prefixXor (quotes) ^ inStringCarry;
+            inStringCarry = (uint64) ((int64) inString >> 63);
+
+            if (const auto badControls = masks.controls & inString)
+                throw ParseError { "Unescaped control character in string", blockStart + (size_t) countTrailingZeros (badControls) };
+
+            // Anything that isn't whitespace, an operator or a quote is part of a literal or
+            // number, and we only need to record where each of those begins.
+            const auto scalars = ~(masks.whitespace | masks.operators | masks.quotes);
+            const auto scalarStarts = scalars & ~((scalars << 1) | scalarCarry);
+            scalarCarry = scalars >> 63;
+
+            auto structurals = ((masks.operators | scalarStarts) & ~inString) | quotes;
+
+            while (structurals != 0)
+            {
+                result.push_back ((uint32) (blockStart + (size_t) countTrailingZeros (structurals)));
+                structurals &= structurals - 1;
+            }
+        }
+
+        if (inStringCarry != 0)
+            throw ParseError { "Unexpected EOF in string constant", numBytes };
+
+        containsNonAscii = nonAscii != 0;
+    }
+
+    //==============================================================================
+    char* allocateStringStorage (size_t size)
+    {
+        if (size > storageSpaceLeft)
+        {
+            const auto blockSize = jmax (size, (size_t) 65536);
+            stringStorage.emplace_back (blockSize);
+            nextFreeStorage = stringStorage.back().get();
+            storageSpaceLeft = blockSize;
+        }
+
+        auto* result = nextFreeStorage;
+        nextFreeStorage += size;
+        storageSpaceLeft -= size;
+        return result;
+    }
+
+    void releaseUnusedStringStorage (size_t size) noexcept
+    {
+        nextFreeStorage -= size;
+        storageSpaceLeft += size;
+    }
+
+    static int parseHexDigits (const char* s)
+    {
+        int result = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto digit = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) s[i]);
+
+            if (digit < 0)
+                return -1;
+
+            result = (result << 4) | digit;
+        }
+
+        return result;
+    }
+
+    void parseString (size_t openQuote, size_t closeQuote, Node& node)
+    {
+        const auto* start = text + openQuote + 1;
+        const auto length = closeQuote - openQuote - 1;
+
+        if (containsNonAscii && ! JSONDocumentHelpers::isValidUTF8 (reinterpret_cast<const uint8*> (start), length))
+            throw ParseError { "Invalid UTF-8 in string constant", openQuote };
+
+        node.type = Type::string;
+
+        auto* firstEscape = static_cast<const char*> (memchr (start, '\\', length));
+
+        if (firstEscape == nullptr)
+        {
+            node.text = start;
+            node.count = (uint32) length;
+            return;
+        }
+
+        // Decoding can only make the string shorter, so this is always enough space
+        auto* dest = allocateStringStorage (length);
+        node.text = dest;
+
+        auto* end = start + length;
+        auto* s = start;
+
+        while (s < end)
+        {
+            auto* nextEscape = s == firstEscape ? s : static_cast<const char*> (memchr (s, '\\', (size_t) (end - s)));
+
+            if (nextEscape == nullptr)
+                nextEscape = end;
+
+            memcpy (dest, s, (size_t) (nextEscape - s));
+            dest += nextEscape - s;
+            s = nextEscape;
+
+            if (s == end)
+                break;
+
+            // a backslash can't be the last character, because it would have escaped the closing quote
+            jassert (s + 1 < end);
+            const auto errorPosition = (size_t) (s - text);
+
+            switch (s[1])
+            {
+                case '"':   *dest++ = '"';  s += 2; break;
+                case '\\':  *dest++ = '\\'; s += 2; break;
+                case '/':   *dest++ = '/';  s += 2; break;
+                case 'b':   *dest++ = '\b'; s += 2; break;
+                case 'f':   *dest++ = '\f'; s += 2; break;
+                case 'n':   *dest++ = '\n'; s += 2; break;
+                case 'r':   *dest++ = '\r'; s += 2; break;
+                case 't':   *dest++ = '\t'; s += 2; break;
+
+                case 'u':
+                {
+                    const auto firstCodeUnit = end - s >= 6 ? parseHexDigits (s + 2) : -1;
+
+                    if (firstCodeUnit < 0)
+                        throw ParseError { "Invalid hex character", errorPosition };
+
+                    auto codePoint = (juce_wchar) firstCodeUnit;
+                    s += 6;
+
+                    if (CharacterFunctions::isHighSurrogate (codePoint))
+                    {
+                        const auto secondCodeUnit = end - s >= 6 && s[0] == '\\' && s[1] == 'u' ? parseHexDigits (s + 2) : -1;
+
+                        if (secondCodeUnit < 0 || ! CharacterFunctions::isLowSurrogate ((juce_wchar) secondCodeUnit))
+                            throw ParseError { "Expected UTF-16 low surrogate", (size_t) (s - text) };
+
+                        codePoint = (juce_wchar) (0x10000 + ((firstCodeUnit - 0xd800) << 10) + (secondCodeUnit - 0xdc00));
+                        s += 6;
+                    }
+                    else if (! CharacterFunctions::isNonSurrogateCodePoint (codePoint))
+                    {
+                        throw ParseError { "Invalid UTF-16 escape sequence", errorPosition };
+                    }
+
+                    CharPointer_UTF8 writer (dest);
+                    writer.write (codePoint);
+                    dest = writer.getAddress();
+                    break;
+                }
+
+                default:
+                    throw ParseError { "Invalid escape sequence", errorPosition };
+            }
+        }
+
+        node.count = (uint32) (dest - node.text);
+        releaseUnusedStringStorage (length - node.count);
+    }
+
+    size_t parseNumber (size_t position, Node& node) const
+    {
+        using JSONDocumentHelpers::isDigit;
+
+        auto p = position;
+        const bool isNegative = text[p] == '-';
+
+        if (isNegative)
+            ++p;
+
+        const auto digitsStart = p;
+
+        if (p >= numBytes || ! isDigit (text[p]))
+            throw ParseError { "Syntax error in number", position };
+
+        if (text[p] == '0')
+            ++p;
+        else
+            while (p < numBytes && isDigit (text[p]))
+                ++p;
+
+        const auto numIntegerDigits = p - digitsStart;
+        bool isFloatingPoint = false;
+
+        if (p < numBytes && text[p] == '.')
+        {
+            if (++p >= numBytes || ! isDigit (text[p]))
+                throw ParseError { "Syntax error in number", p };
+
+            while (p < numBytes && isDigit (text[p]))
+                ++p;
+
+            isFloatingPoint = true;
+        }
+
+        if (p < numBytes && (text[p] == 'e' || text[p] == 'E'))
+        {
+            if (++p < numBytes && (text[p] == '+' || text[p] == '-'))
+                ++p;
+
+            if (p >= numBytes || ! isDigit (text[p]))
+                throw ParseError { "Syntax error in number", p };
+
+            while (p < numBytes && isDigit (text[p]))
+                ++p;
+
+            isFloatingPoint = true;
+        }
+
+        if (! isFloatingPoint && numIntegerDigits <= 19)
+        {
+            uint64 magnitude = 0;
+
+            for (auto i = digitsStart; i < p; ++i)
+                magnitude = magnitude * 10 + (uint64) (text[i] - '0');
+
+            const auto limit = (uint64) std::numeric_limits<int64>::max() + (isNegative ? 1 : 0);
+
+            if (magnitude <= limit)
+            {
+                node.type = Type::integer;
+                node.intValue = isNegative ? (int64) (0 - magnitude) : (int64) magnitude;
+                return p;
+            }
+        }
+
+        node.type = Type::floatingPoint;
+
+       #if defined (__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // from_chars is exact and doesn't need a null-terminated copy, but it fails instead
+        // of returning infinity or zero for out-of-range values, so those use the slow path
+        if (std::from_chars (text + position, text + p, node.doubleValue).ec == std::errc())
+            return p;
+       #endif
+
+        char buffer[64];
+        const auto length = p - position;
+        String longNumber;
+        const char* number = buffer;
+
+        if (length < sizeof (buffer))
+        {
+            memcpy (buffer, text + position, length);
+            buffer[length] = 0;
+        }
+        else
+        {
+            longNumber = String (text + position, length);
+            number = longNumber.toRawUTF8();
+        }
+
+        CharPointer_ASCII numberText (number);
+        node.doubleValue = CharacterFunctions::readDoubleValue (numberText);
+        return p;
+    }
+
+    size_t parseScalar (size_t position, Node& node) const
+    {
+        const auto matches = [&] (const char* literal, size_t length)
+        {
+            return numBytes - position >= length && memcmp (text + position, literal, length) == 0;
+        };
+
+        size_t end = 0;
+
+        switch (text[position])
+        {
+            case 't':
+                if (! matches ("true", 4))
+                    throw ParseError { "Syntax error", position };
+
+                node.type = Type::boolean;
+                node.intValue = 1;
+                end = position + 4;
+                break;
+
+            case 'f':
+                if (! matches ("false", 5))
+                    throw ParseError { "Syntax error", position };
+
+                node.type = Type::boolean;
+                node.intValue = 0;
+                end = position + 5;
+                break;
+
+            case 'n':
+                if (! matches ("null", 4))
+                    throw ParseError { "Syntax error", position };
+
+                node.type = Type::null;
+                node.intValue = 0;
+                end = position + 4;
+                break;
+
+            case '-':
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                end = parseNumber (position, node);
+                break;
+
+            default:
+                throw ParseError { "Syntax error", position };
+        }
+
+        if (end < numBytes && ! JSONDocumentHelpers::isDelimiter (text[end]))
+            throw ParseError { "Syntax error", end };
+
+        return end;
+    }
+
+    //==============================================================================
+    void buildNodes (const std::vector<uint32>& index)
+    {
+        enum class Expecting { value, propertyName, commaOrEnd };
+
+        // JSON is typically about a third structural characters, so this avoids most reallocation
+        nodes.reserve (index.size() / 2 + 1);
+
+        std::vector<size_t> openContainers;
+        auto expecting = Expecting::value;
+        size_t next = 0;
+        const auto numTokens = index.size();
+
+        const auto addNode = [this, &openContainers] (Type type, uint8 flags) -> Node&
+        {
+            if (! openContainers.empty())
+            {
+                auto& parent = nodes[openContainers.back()];
+
+                // the properties of objects are counted when their names are added
+                if (parent.type == Type::object)
+                    flags |= Node::isPropertyValue;
+                else
+                    ++parent.count;
+            }
+
+            nodes.push_back ({});
+            auto& node = nodes.back();
+            node.type = type;
+            node.flags = flags;
+            node.count = 0;
+            node.numDescendants = 0;
+            return node;
+        };
+
+        for (;;)
+        {
+            switch (expecting)
+            {
+                case Expecting::value:
+                {
+                    if (next >= numTokens)
+                        throw ParseError { "Unexpected EOF", numBytes };
+
+                    const auto position = (size_t) index[next++];
+                    const auto c = text[position];
+
+                    if (c == '{' || c == '[')
+                    {
+                        const auto isObject = (c == '{');
+                        addNode (isObject ? Type::object : Type::array, 0);
+
+                        if (next < numTokens && text[index[next]] == (isObject ? '}' : ']'))
+                        {
+                            ++next;
+                            expecting = Expecting::commaOrEnd;
+                        }
+                        else
+                        {
+                            openContainers.push_back (nodes.size() - 1);
+                            expecting = isObject ? Expecting::propertyName : Expecting::value;
+                        }
+
+                        break;
+                    }
+
+                    if (c == '"')
+                    {
+                        parseString (position, (size_t) index[next++], addNode (Type::string, 0));
+                    }
+                    else
+                    {
+                        if (c == '}' || c == ']' || c == ':' || c == ',')
+                            throw ParseError { "Syntax error", position };
+
+                        parseScalar (position, addNode (Type::null, 0));
+                    }
+
+                    expecting = Expecting::commaOrEnd;
+                    break;
+                }
+
+                case Expecting::propertyName:
+                {
+                    if (next >= numTokens)
+                        throw ParseError { "Unexpected EOF in object declaration", numBytes };
+
+                    const auto position = (size_t) index[next++];
+
+                    if (text[position] != '"')
+                        throw ParseError { "Expected a property name in double-quotes", position };
+
+                    auto& parent = nodes[openContainers.back()];
+                    ++parent.count;
+
+                    nodes.push_back ({});
+                    auto& key = nodes.back();
+                    key.flags = Node::isKey;
+                    parseString (position, (size_t) index[next++], key);
+
+                    if (next >= numTokens || text[index[next]] != ':')
+                        throw ParseError { "Expected ':'", next < numTokens ? (size_t) index[next] : numBytes };
+
+                    ++next;
+                    expecting = Expecting::value;
+                    break;
+                }
+
+                case Expecting::commaOrEnd:
+                {
+                    if (openContainers.empty())
+                    {
+                        if (next < numTokens)
+                            throw ParseError { "Unexpected text after the end of the document", (size_t) index[next] };
+
+                        return;
+                    }
+
+                    const auto containerIndex = openContainers.back();
+                    const auto isObject = nodes[containerIndex].type == Type::object;
+
+                    if (next >= numTokens)
+                        throw ParseError { isObject ? "Unexpected EOF in object declaration"
+                                                    : "Unexpected EOF in array declaration", numBytes };
+
+                    const auto position = (size_t) index[next++];
+                    const auto c = text[position];
+
+                    if (c == ',')
+                    {
+                        expecting = isObject ? Expecting::propertyName : Expecting::value;
+                    }
+                    else if (c == (isObject ? '}' : ']'))
+                    {
+                        nodes[containerIndex].numDescendants = nodes.size() - containerIndex - 1;
+                        openContainers.pop_back();
+                    }
+                    else
+                    {
+                        throw ParseError { isObject ? "Expected ',' or '}'" : "Expected ',' or ']'", position };
+                    }
+
+                    break;
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    static var toVar (const Node& node)
+    {
+        switch (node.type)
+        {
+            case Type::boolean:         return var (node.intValue != 0);
+            case Type::floatingPoint:   return var (node.doubleValue);
+            case Type::string:          return var (String::fromUTF8 (node.text, (int) node.count));
+
+            case Type::integer:
+            {
+                // Use the same representation as JSON::parse()
+                const auto magnitude = node.intValue < 0 ? (uint64) 0 - (uint64) node.intValue
+                                                         : (uint64) node.intValue;
+
+                return (magnitude >> 31) != 0 ? var (node.intValue) : var ((int) node.intValue);
+            }
+
+            case Type::array:
+            {
+                Array<var> result;
+                result.ensureStorageAllocated ((int) node.count);
+
+                for (auto child : Value (&node))
+                    result.add (toVar (*child.node));
+
+                return result;
+            }
+
+            case Type::object:
+            {
+                auto* object = new DynamicObject();
+                var result (object);
+                auto& properties = object->getProperties();
+
+                for (auto child : Value (&node))
+                {
+                    const auto& key = child.node[-1];
+
+                    if (key.count > 0)
+                        properties.set (Identifier (String::fromUTF8 (key.text, (int) key.count)), toVar (*child.node));
+                }
+
+                return result;
+            }
+
+            case Type::null:
+            case Type::invalid:
+            default:
+                return {};
+        }
+    }
+};
+
+//==============================================================================
+JSONDocument::JSONDocument() : pimpl (std::make_unique<Pimpl>()) {}
+JSONDocument::~JSONDocument() = default;
+
+JSONDocument::JSONDocument (JSONDocument&&) noexcept = default;
+JSONDocument& JSONDocument::operator= (JSONDocument&&) noexcept = default;
+
+Result JSONDocument::parse (const void* utf8Data, size_t numBytes)
+{
+    if (pimpl == nullptr)
+        pimpl = std::make_unique<Pimpl>();
+
+    pimpl->ownedData.reset();
+    pimpl->ownedText = {};
+    return pimpl->parse (utf8Data, numBytes);
+}
+
+Result JSONDocument::parse (MemoryBlock utf8Data)
+{
+    if (pimpl == nullptr)
+        pimpl = std::make_unique<Pimpl>();
+
+    pimpl->ownedText = {};
+    pimpl->ownedData = std::move (utf8Data);
+    return pimpl->parse (pimpl->ownedData.getData(), pimpl->ownedData.getSize());
+}
+
+Result JSONDocument::parse (const String& text)
+{
+    if (pimpl == nullptr)
+        pimpl = std::make_unique<Pimpl>();
+
+    pimpl->ownedData.reset();
+    pimpl->ownedText = text;
+    return pimpl->parse (pimpl->ownedText.toRawUTF8(), pimpl->ownedText.getNumBytesAsUTF8());
+}
+
+Result JSONDocument::parse (InputStream& input)
+{
+    MemoryBlock data;
+    input.readIntoMemoryBlock (data);
+    return parse (std::move (data));
+}
+
+void JSONDocument::clear()
+{
+    if (pimpl != nullptr)
+    {
+        pimpl->clear();
+        pimpl->ownedData.reset();
+        pimpl->ownedText = {};
+    }
+}
+
+JSONDocument::Value JSONDocument::getRoot() const noexcept
+{
+    if (pimpl == nullptr || pimpl->nodes.empty())
+        return {};
+
+    return Value (pimpl->nodes.data());
+}
+
+var JSONDocument::toVar() const
+{
+    return getRoot().toVar();
+}
+
+//==============================================================================
+JSONDocument::Type JSONDocument::Value::getType() const noexcept
+{
+    return node != nullptr ? node->type : Type::invalid;
+}
+
+bool JSONDocument::Value::getBool (bool defaultValue) const noexcept
+{
+    return isBool() ? node->intValue != 0 : defaultValue;
+}
+
+int64 JSONDocument::Value::getInt64 (int64 defaultValue) const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return node->intValue;
+        case Type::floatingPoint:   return (int64) node->doubleValue;
+        case Type::invalid:
+        case Type::null:
+        case Type::boolean:
+        case Type::string:
+        case Type::array:
+        case Type::object:          break;
+    }
+
+    return defaultValue;
+}
+
+double JSONDocument::Value::getDouble (double defaultValue) const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return (double) node->intValue;
+        case Type::floatingPoint:   return node->doubleValue;
+        case Type::invalid:
+        case Type::null:
+        case Type::boolean:
+        case Type::string:
+        case Type::array:
+        case Type::object:          break;
+    }
+
+    return defaultValue;
+}
+
+std::string_view JSONDocument::Value::getStringView() const noexcept
+{
+    return isString() ? std::string_view (node->text, node->count) : std::string_view();
+}
+
+String JSONDocument::Value::toString() const
+{
+    return isString() ? String::fromUTF8 (node->text, (int) node->count) : String();
+}
+
+int JSONDocument::Value::size() const noexcept
+{
+    return isArray() || isObject() ? (int) node->count : 0;
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (int index) const noexcept
+{
+    if (! isPositiveAndBelow (index, size()))
+        return {};
+
+    auto i = begin();
+
+    while (--index >= 0)
+        ++i;
+
+    return *i;
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (std::string_view propertyName) const noexcept
+{
+    if (isObject())
+        for (auto child : *this)
+            if (child.getName() == propertyName)
+                return child;
+
+    return {};
+}
+
+std::string_view JSONDocument::Value::getName() const noexcept
+{
+    if (node != nullptr && (node->flags & Node::isPropertyValue) != 0)
+        return { node[-1].text, node[-1].count };
+
+    return {};
+}
+
+var JSONDocument::Value::toVar() const
+{
+    return node != nullptr ? Pimpl::toVar (*node) : var();
+}
+
+JSONDocument::Value::Iterator JSONDocument::Value::begin() const noexcept
+{
+    if (size() == 0)
+        return {};
+
+    auto* endNode = node + 1 + node->numDescendants;
+    auto* first = node + (isObject() ? 2 : 1);
+    return { first, endNode };
+}
+
+JSONDocument::Value::Iterator JSONDocument::Value::end() const noexcept
+{
+    if (size() == 0)
+        return {};
+
+    auto* endNode = node + 1 + node->numDescendants;
+    return { endNode, endNode };
+}
+
+JSONDocument::Value::Iterator& JSONDocument::Value::Iterator::operator++() noexcept
+{
+    node = node->getNextSibling();
+
+    if (node != endNode && (node->flags & Node::isKey) != 0)
+        ++node;
+
+    return *this;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONDocumentTests final : public UnitTest
+{
+public:
+    JSONDocumentTests()
+        : UnitTest ("JSONDocument", UnitTestCategories::json)
+    {}
+
+    static String createRandomString (Random& r)
+    {
+        juce_wchar buffer[40] = { 0 };
+
+        for (int i = r.nextInt (numElementsInArray (buffer) - 1); --i >= 0;)
+        {
+            switch (r.nextInt (4))
+            {
+                case 0:   buffer[i] = (juce_wchar) (1 + r.nextInt (0x7f)); break;
+                case 1:   buffer[i] = r.nextBool() ? '\\' : '"'; break;
+                case 2:   buffer[i] = (juce_wchar) (1 + r.nextInt (0x1f)); break;
+
+                default:
+                    do
+                    {
+                        buffer[i] = (juce_wchar) (1 + r.nextInt (0x10ffff - 1));
+                    }
+                    while (! CharPointer_UTF16::canRepresent (buffer[i]));
+
+                    break;
+            }
+        }
+
+        return CharPointer_UTF32 (buffer);
+    }
+
+    static var createRandomVar (Random& r, int depth)
+    {
+        switch (r.nextInt (depth > 3 ? 6 : 8))
+        {
+            case 0:     return {};
+            case 1:     return r.nextInt();
+            case 2:     return r.nextInt64();
+            case 3:     return r.nextBool();
+            case 4:     return (r.nextDouble() - 0.5) * std::pow (10.0, r.nextInt (40) - 20);
+            case 5:     return createRandomString (r);
+
+            case 6:
+            {
+                Array<var> result;
+
+                for (int i = r.nextInt (30); --i >= 0;)
+                    result.add (createRandomVar (r, depth + 1));
+
+                return result;
+            }
+
+            case 7:
+            {
+                auto o = new DynamicObject();
+
+                for (int i = r.nextInt (30); --i >= 0;)
+                {
+                    auto name = createRandomString (r);
+
+                    if (name.isNotEmpty())
+                        o->setProperty (name, createRandomVar (r, depth + 1));
+                }
+
+                return o;
+            }
+
+            default:
+                return {};
+        }
+    }
+
+    void expectParseFails (const String& text)
+    {
+        JSONDocument doc;
+        const auto result = doc.parse (text);
+        expect (result.failed(), "Expected failure: " + text);
+        expect (! doc.getRoot().isValid());
+    }
+
+    void runTest() override
+    {
+        beginTest ("Matches JSON::parse");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto v = createRandomVar (r, 0);
+                const auto text = JSON::toString (v, r.nextBool());
+
+                JSONDocument doc;
+                const auto result = doc.parse (text);
+                expect (result.wasOk(), result.getErrorMessage());
+
+                expectEquals (JSON::toString (doc.toVar()), JSON::toString (JSON::fromString (text)));
+            }
+        }
+
+        beginTest ("Escapes across block boundaries");
+        {
+            for (int offset = 0; offset < 140; ++offset)
+            {
+                for (int numBackslashes = 0; numBackslashes < 6; ++numBackslashes)
+                {
+                    const auto expected = String::repeatedString ("x", offset)
+                                        + String::repeatedString ("\\", numBackslashes) + "\"end";
+                    const auto text = "[\"" + String::repeatedString ("x", offset)
+                                    + String::repeatedString ("\\\\", numBackslashes) + "\\\"end\", 1]";
+
+                    JSONDocument doc;
+                    expect (doc.parse (text).wasOk());
+                    expectEquals (doc.getRoot()[0].toString(), expected);
+                    expectEquals (doc.getRoot()[1].getInt64(), (int64) 1);
+                }
+            }
+        }
+
+        beginTest ("Values");
+        {
+            JSONDocument doc;
+            expect (doc.parse (R"({ "a": [1, -2, 3.5, 1e3, 9223372036854775807, -9223372036854775808, 18446744073709551616],
+                                    "b": { "c": true, "d": null, "": "empty" },
+                                    "e": "caf\u00e9 \ud83d\ude00",
+                                    "f": [] })").wasOk());
+
+            const auto root = doc.getRoot();
+            expect (root.isObject());
+            expectEquals (root.size(), 4);
+
+            const auto a = root["a"];
+            expect (a.isArray());
+            expect (a.getName() == "a");
+            expectEquals (a.size(), 7);
+            expect (a[0].isInt() && a[0].getInt64() == 1);
+            expect (a[1].isInt() && a[1].getInt64() == -2);
+            expect (a[2].isDouble() && exactlyEqual (a[2].getDouble(), 3.5));
+            expect (a[3].isDouble() && exactlyEqual (a[3].getDouble(), 1000.0));
+            expect (a[4].isInt() && a[4].getInt64() == std::numeric_limits<int64>::max());
+            expect (a[5].isInt() && a[5].getInt64() == std::numeric_limits<int64>::min());
+            expect (a[6].isDouble());
+            expect (! a[7].isValid());
+
+            expect (root["b"]["c"].getBool());
+            expect (root["b"]["d"].isNull());
+            expectEquals (root["b"][""].toString(), String ("empty"));
+            expect (! root["b"]["missing"].isValid());
+            expectEquals (root["e"].toString(), String (CharPointer_UTF8 ("caf\xc3\xa9 \xf0\x9f\x98\x80")));
+            expect (root["f"].isArray() && root["f"].size() == 0);
+
+            StringArray names;
+
+            for (auto child : root)
+                names.add (String (child.getName().data(), child.getName().size()));
+
+            expectEquals (names.joinIntoString (","), String ("a,b,e,f"));
+
+            int64 total = 0;
+
+            for (auto item : a)
+                if (item.isInt() && isPositiveAndBelow (item.getInt64(), (int64) 100))
+                    total += item.getInt64();
+
+            expectEquals (total, (int64) 1);
+
+            expect (doc.parse ("  \"just a string\"  ").wasOk());
+            expectEquals (doc.getRoot().toString(), String ("just a string"));
+            expect (doc.parse ("-0.5e-2").wasOk());
+            expect (exactlyEqual (doc.getRoot().getDouble(), -0.005));
+        }
+
+        beginTest ("Errors");
+        {
+            expectParseFails ("");
+            expectParseFails ("   ");
+            expectParseFails ("[1,]");
+            expectParseFails ("[1 2]");
+            expectParseFails ("{\"a\" 1}");
+            expectParseFails ("{\"a\": 1,}");
+            expectParseFails ("{a: 1}");
+            expectParseFails ("[\"abc]");
+            expectParseFails ("[tru]");
+            expectParseFails ("[truex]");
+            expectParseFails ("[nul]");
+            expectParseFails ("[-]");
+            expectParseFails ("[1.]");
+            expectParseFails ("[1e]");
+            expectParseFails ("[01]");
+            expectParseFails ("[1x]");
+            expectParseFails ("{} {}");
+            expectParseFails ("['single']");
+            expectParseFails ("[\"\\x\"]");
+            expectParseFails ("[\"\\ud800\"]");
+            expectParseFails ("[\"\\udc00\"]");
+            expectParseFails ("[\"\\u12\"]");
+            expectParseFails ("[\"a\x01\"]");
+            expectParseFails ("[");
+            expectParseFails ("{\"a\":");
+
+            JSONDocument doc;
+            const char invalidUTF8[] = "[\"\xff\"]";
+            expect (doc.parse (invalidUTF8, sizeof (invalidUTF8) - 1).failed());
+
+            expectEquals (doc.parse ("[1,\n  2,]").getErrorMessage(), String ("2:5: error: Syntax error"));
+        }
+    }
+};
+
+static JSONDocumentTests jsonDocumentTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A fast, read-only representation of a parsed JSON document.
+
+    Parsing JSON with JSON::parse() creates a var for every value and a DynamicObject
+    for every object, which makes it relatively slow and memory-hungry for large
+    documents. A JSONDocument instead parses the text into a single flat array of
+    compact nodes, and any strings that don't contain escape sequences are referenced
+    directly in the source text rather than being copied.
+
+    Parsing happens in two passes. The first pass classifies the text in 64-byte
+    blocks using SSE2 or NEON instructions where available, to build an index of all
+    the structural characters that lie outside strings. The second pass walks this
+    index to build the nodes, so it never has to look at the contents of strings or
+    whitespace one character at a time.
+
+    The values in the document can be inspected in place with the Value class, or
+    converted to a var with toVar() if you need to use them with other var-based APIs.
+
+    e.g.
+    @code
+    JSONDocument doc;
+
+    if (auto result = doc.parse (jsonText); result.wasOk())
+    {
+        for (auto preset : doc.getRoot()["presets"])
+            DBG (preset["name"].toString() << ": " << preset["gain"].getDouble());
+    }
+    @endcode
+
+    Unlike JSON::parse(), this only accepts strictly valid JSON as described by
+    RFC 8259: strings must be double-quoted, only the standard escape sequences are
+    allowed, trailing commas and trailing content are rejected, and the text must be
+    valid UTF-8. A document may consist of a single primitive value.
+
+    @see JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document. */
+    JSONDocument();
+
+    /** Destructor. */
+    ~JSONDocument();
+
+    /** Move constructor. */
+    JSONDocument (JSONDocument&&) noexcept;
+
+    /** Move assignment operator. */
+    JSONDocument& operator= (JSONDocument&&) noexcept;
+
+    //==============================================================================
+    /** Parses a block of UTF-8 JSON text, replacing any previous contents of the document.
+
+        To avoid copying, the document refers directly to the memory that you pass in,
+        so this memory must remain valid and unchanged for as long as the document,
+        or any of the Values obtained from it, are in use.
+
+        @returns a Result indicating whether the text was parsed successfully, and if
+                 not, the line and column where the problem was found
+    */
+    Result parse (const void* utf8Data, size_t numBytes);
+
+    /** Parses a block of UTF-8 JSON text which will be owned by the document. */
+    Result parse (MemoryBlock utf8Data);
+
+    /** Parses some JSON text.
+        The document keeps a reference to the string's data rather than copying it.
+    */
+    Result parse (const String& text);
+
+    /** Reads and parses the entire contents of a stream. */
+    Result parse (InputStream& input);
+
+    /** Clears the document. */
+    void clear();
+
+    //==============================================================================
+    /** The types of value that a JSON document can contain. */
+    enum class Type : uint8
+    {
+        invalid,        /**< Returned for Values that don't refer to anything in a document. */
+        null,
+        boolean,
+        integer,        /**< A number without a fractional part or exponent that fits into an int64. */
+        floatingPoint,
+        string,
+        array,
+        object
+    };
+
+private:
+    struct Node;
+
+public:
+    //==============================================================================
+    /** A lightweight reference to one of the values in a JSONDocument.
+
+        Values are cheap to copy, and remain valid for as long as the document they
+        came from is unchanged. Accessing a child that doesn't exist returns an invalid
+        Value, so lookups can be chained without any checking:
+        @code
+        auto gain = doc.getRoot()["settings"]["gain"].getDouble (1.0);
+        @endcode
+    */
+    class JUCE_API  Value
+    {
+    public:
+        /** Creates an invalid Value. */
+        Value() = default;
+
+        /** Returns the type of this value. */
+        Type getType() const noexcept;
+
+        bool isValid() const noexcept       { return node != nullptr; }
+        bool isNull() const noexcept        { return getType() == Type::null; }
+        bool isBool() const noexcept        { return getType() == Type::boolean; }
+        bool isInt() const noexcept         { return getType() == Type::integer; }
+        bool isDouble() const noexcept      { return getType() == Type::floatingPoint; }
+        bool isNumber() const noexcept      { return isInt() || isDouble(); }
+        bool isString() const noexcept      { return getType() == Type::string; }
+        bool isArray() const noexcept       { return getType() == Type::array; }
+        bool isObject() const noexcept      { return getType() == Type::object; }
+
+        /** Returns the value of a boolean, or the default value if this isn't a boolean. */
+        bool getBool (bool defaultValue = false) const noexcept;
+
+        /** Returns the value of a number as an integer, or the default value if this isn't a number. */
+        int64 getInt64 (int64 defaultValue = 0) const noexcept;
+
+        /** Returns the value of a number as a double, or the default value if this isn't a number. */
+        double getDouble (double defaultValue = 0.0) const noexcept;
+
+        /** Returns the UTF-8 content of a string, with any escape sequences decoded.
+            If this isn't a string, the result will be empty.
+        */
+        std::string_view getStringView() const noexcept;
+
+        /** Returns the content of a string, or an empty string if this isn't a string. */
+        String toString() const;
+
+        /** Returns the number of elements in an array or properties in an object. */
+        int size() const noexcept;
+
+        /** Returns one of the elements of an array, or one of the property values of an object.
+            Note that because the document is stored as a flat list, this has to skip over any
+            preceding elements, so if you need to visit all the elements it's much more efficient
+            to use begin() and end().
+        */
+        Value operator[] (int index) const noexcept;
+
+        /** Returns the value of a named property of an object. */
+        Value operator[] (std::string_view propertyName) const noexcept;
+
+        /** Returns the value of a named property of an object. */
+        Value operator[] (const char* propertyName) const noexcept   { return operator[] (std::string_view (propertyName)); }
+
+        /** If this is the value of one of an object's properties, this returns the property name. */
+        std::string_view getName() const noexcept;
+
+        /** Creates a var containing a deep copy of this value.
+            Objects are converted to DynamicObjects. Because a var can't represent an
+            empty property name, any properties with empty names are skipped.
+        */
+        var toVar() const;
+
+        //==============================================================================
+        /** Iterates the elements of an array or the property values of an object. */
+        struct Iterator
+        {
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = Value;
+            using reference         = Value;
+            using pointer           = void;
+            using iterator_category = std::forward_iterator_tag;
+
+            Value operator*() const noexcept                            { return Value (node); }
+            Iterator& operator++() noexcept;
+            bool operator== (const Iterator& other) const noexcept      { return node == other.node; }
+            bool operator!= (const Iterator& other) const noexcept      { return node != other.node; }
+
+            const Node* node = nullptr;
+            const Node* endNode = nullptr;
+        };
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+
+    private:
+        friend class JSONDocument;
+        explicit Value (const Node* n) noexcept : node (n) {}
+
+        const Node* node = nullptr;
+    };
+
+    //==============================================================================
+    /** Returns the top-level value of the document, or an invalid Value if the document is empty. */
+    Value getRoot() const noexcept;
+
+    /** Creates a var containing a deep copy of the whole document. */
+    var toVar() const;
+
+private:
+    //==============================================================================
+    struct Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONDocument)
+};
+
+} // namespace juce
@@ -252,6 +252,232 @@ private:
     };
 };
 
+//==============================================================================
+/**
+    Allows writing an object of arbitrary type directly to a stream as JSON.
+
+    This produces the same structure as calling ToVar::convert() and then passing the
+    result to JSON::writeToStream(), but without building the intermediate var, so it's
+    much faster and uses much less memory when writing large data sets.
+
+    The type passed to write must be set up for serialisation in exactly the same way as
+    for ToVar. For details of what this entails, see the docs for SerialisationTraits.
+
+    @see ToVar, JSONWriter
+
+    @tags{Core}
+*/
+class ToJSON
+{
+public:
+    using Options = ToVarOptions;
+
+    /** Attempts to write the argument as a single value using the given JSONWriter.
+
+        Returns true if the conversion succeeds. If it fails, some of the value may already
+        have been written, so the writer's output should be discarded.
+    */
+    template <typename T>
+    static bool write (JSONWriter& writer, const T& t, const Options& options = {})
+    {
+        return Visitor::convert (writer, t, options);
+    }
+
+    /** Attempts to write the argument to a stream as a JSON document.
+
+        Returns true if the conversion succeeds. If it fails, some of the document may
+        already have been written, so the contents of the stream should be discarded.
+    */
+    template <typename T>
+    static bool writeToStream (OutputStream& output,
+                               const T& t,
+                               const Options& options = {},
+                               const JSON::FormatOptions& formatOptions = {})
+    {
+        JSONWriter writer (output, formatOptions);
+        return write (writer, t, options);
+    }
+
+    /** Attempts to convert the argument to a JSON string.
+
+        This will return a non-null optional if conversion succeeds, or nullopt if conversion fails.
+    */
+    template <typename T>
+    static std::optional<String> toString (const T& t,
+                                           const Options& options = {},
+                                           const JSON::FormatOptions& formatOptions = {})
+    {
+        MemoryOutputStream mo { 1024 };
+
+        if (writeToStream (mo, t, options, formatOptions))
+            return mo.toUTF8();
+
+        return std::nullopt;
+    }
+
+private:
+    class Visitor
+    {
+    public:
+        template <typename T>
+        static bool convert (JSONWriter& writer, const T& t, const Options& options)
+        {
+            constexpr auto fallbackVersion = detail::ForwardingSerialisationTraits<T>::marshallingVersion;
+            const auto versionToUse = options.getExplicitVersion()
+                                             .value_or (fallbackVersion);
+
+            if (versionToUse > fallbackVersion)
+            {
+                // The requested explicit version is higher than the declared version of the type.
+                return false;
+            }
+
+            Visitor visitor { writer, versionToUse, options.getVersionIncluded() };
+            detail::doSave (visitor, t);
+            return visitor.finish();
+        }
+
+        std::optional<int> getVersion() const { return version; }
+
+        template <typename... Ts>
+        void operator() (Ts&&... ts)
+        {
+            (visit (std::forward<Ts> (ts)), ...);
+        }
+
+    private:
+        // These mirror the states that ToVar's intermediate var can be in
+        enum class State
+        {
+            empty,      // nothing has been written yet, equivalent to a void var
+            primitive,  // a single value has been written
+            object,
+            array,
+            failed
+        };
+
+        Visitor (JSONWriter& w, const std::optional<int>& explicitVersion, bool includeVersion)
+            : writer (w), version (explicitVersion), versionIncluded (includeVersion)
+        {
+            if (version.has_value() && versionIncluded)
+            {
+                writer.beginObject();
+                writer.writePropertyName ("__version__");
+                writer.writeInt (*version);
+                state = State::object;
+            }
+        }
+
+        bool finish()
+        {
+            switch (state)
+            {
+                case State::empty:      writer.writeNull(); return true;
+                case State::primitive:  return true;
+                case State::object:     writer.endObject(); return true;
+                case State::array:      writer.endArray(); return true;
+                case State::failed:     break;
+            }
+
+            return false;
+        }
+
+        template <typename T>
+        void visit (const T& t)
+        {
+            if constexpr (std::is_integral_v<T>)
+                push ([&] { writer.writeInt ((int64) t); return true; });
+            else if constexpr (std::is_floating_point_v<T>)
+                push ([&] { writer.writeDouble ((double) t); return true; });
+            else
+                push ([&] { return convert (t); });
+        }
+
+        template <typename T>
+        void visit (const Named<T>& named)
+        {
+            if (state == State::empty)
+            {
+                writer.beginObject();
+                state = State::object;
+            }
+
+            if (state != State::object)
+            {
+                // Serialisation failure! This may be caused by archiving a primitive or
+                // SerialisationSize, and then attempting to archive a named pair to the same
+                // archive instance.
+                // When using named pairs, *all* items serialised with a particular archiver must be
+                // named pairs.
+                jassert (state == State::failed);
+
+                state = State::failed;
+                return;
+            }
+
+            writer.writePropertyName (String (named.name.data(), named.name.size()));
+
+            if (! convert (named.value))
+                state = State::failed;
+        }
+
+        template <typename T>
+        void visit (const SerialisationSize<T>&)
+        {
+            if (state == State::empty)
+            {
+                writer.beginArray();
+                state = State::array;
+            }
+            else
+            {
+                push ([&] { writer.beginArray(); writer.endArray(); return true; });
+            }
+        }
+
+        void visit (const bool& t)
+        {
+            push ([&] { writer.writeBool (t); return true; });
+        }
+
+        void visit (const String& t)
+        {
+            push ([&] { writer.writeString (t); return true; });
+        }
+
+        void visit (const var& t)
+        {
+            push ([&] { writer.writeVar (t); return true; });
+        }
+
+        template <typename T>
+        bool convert (const T& t)
+        {
+            return Visitor::convert (writer, t, Options{}.withVersionIncluded (versionIncluded));
+        }
+
+        template <typename WriteValue>
+        void push (WriteValue&& writeValue)
+        {
+            if (state != State::empty && state != State::array)
+            {
+                state = State::failed;
+                return;
+            }
+
+            if (! writeValue())
+                state = State::failed;
+            else if (state == State::empty)
+                state = State::primitive;
+        }
+
+        JSONWriter& writer;
+        std::optional<int> version;
+        bool versionIncluded = true;
+        State state = State::empty;
+    };
+};
+
 //==============================================================================
 /**
     Allows converting a var to an object of arbitrary type.
@@ -509,6 +509,52 @@ public:
                              JSONUtils::makeObject ({ { "eventId", 404 }, { "payload", payload } }));
         }
 
+        beginTest ("ToJSON");
+        {
+            expectToJSONMatchesToVar (false);
+            expectToJSONMatchesToVar (1);
+            expectToJSONMatchesToVar (5.0f);
+            expectToJSONMatchesToVar (String ("hello \"world\"\n"));
+            expectToJSONMatchesToVar (std::vector<int> { 1, 2, 3 });
+            expectToJSONMatchesToVar (std::vector<int>{});
+            expectToJSONMatchesToVar (TypeWithExternalUnifiedSerialisation { 7,
+                                                                             "hello world",
+                                                                             { 5, 6, 7 },
+                                                                             { { "foo", 4 }, { "bar", 5 } } });
+            expectToJSONMatchesToVar (TypeWithInternalUnifiedSerialisation { 7.89,
+                                                                             4.321f,
+                                                                             "custom string",
+                                                                             { "foo", "bar", "baz" } });
+            expectToJSONMatchesToVar (TypeWithExternalSplitSerialisation { "string", { 1, 2, 3 } });
+            expectToJSONMatchesToVar (TypeWithInternalSplitSerialisation { "string", { 16, 32, 48 } });
+
+            expectToJSONMatchesToVar (TypeWithBrokenObjectSerialisation { 1, 2 });
+            expectToJSONMatchesToVar (TypeWithBrokenPrimitiveSerialisation { 1, 2 });
+            expectToJSONMatchesToVar (TypeWithBrokenArraySerialisation {});
+            expectToJSONMatchesToVar (TypeWithBrokenNestedSerialisation {});
+            expectToJSONMatchesToVar (TypeWithBrokenDynamicSerialisation { std::vector<TypeWithBrokenObjectSerialisation> (10) });
+
+            for (const auto& options : { ToVar::Options{},
+                                         ToVar::Options{}.withVersionIncluded (false),
+                                         ToVar::Options{}.withExplicitVersion (4),
+                                         ToVar::Options{}.withExplicitVersion (1),
+                                         ToVar::Options{}.withExplicitVersion (std::nullopt) })
+            {
+                expectToJSONMatchesToVar (TypeWithVersionedSerialisation { 1, 2, 3, 4 }, options);
+            }
+
+            expectToJSONMatchesToVar (TypeWithRawVarLast { 200,
+                                                           "success",
+                                                           JSONUtils::makeObject ({ { "status", 123.456 },
+                                                                                    { "message", "failure" },
+                                                                                    { "extended", true } }) });
+            expectToJSONMatchesToVar (TypeWithInnerVar { 404, JSONUtils::makeObject ({ { "foo", 1 }, { "bar", 2 } }) });
+
+            const TypeWithInternalUnifiedSerialisation value { 1.5, 2.0f, "text", { "a" } };
+            expectEquals (ToJSON::toString (value, {}, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none)).value_or (String()),
+                          String (R"({"__version__":5,"a":1.5,"b":2.0,"c":"text","d":["a"]})"));
+        }
+
         beginTest ("FromVar");
         {
             expect (FromVar::convert<bool> (JSON::fromString ("false")) == false);
@@ -607,6 +653,18 @@ public:
     }
 
 private:
+    template <typename T>
+    void expectToJSONMatchesToVar (const T& t, const ToVar::Options& options = {})
+    {
+        const auto text = ToJSON::toString (t, options);
+        const auto converted = ToVar::convert (t, options);
+
+        expect (text.has_value() == converted.has_value());
+
+        if (text.has_value() && converted.has_value())
+            expectDeepEqual (JSON::fromString (*text), converted);
+    }
+
     void expectDeepEqual (const std::optional<var>& a, const std::optional<var>& b)
     {
         const auto text = a.has_value() && b.has_value()
@@ -0,0 +1,571 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONWriter::JSONWriter (OutputStream& destination, const JSON::FormatOptions& formatOptions)
+    : output (destination), format (formatOptions)
+{
+}
+
+JSONWriter::~JSONWriter() = default;
+
+int JSONWriter::getCurrentIndent() const noexcept
+{
+    return format.getIndentLevel() + JSONFormatter::indentSize * scopes.size();
+}
+
+void JSONWriter::writeSeparator (Scope& scope)
+{
+    if (! scope.isEmpty)
+    {
+        output << ',';
+
+        if (format.getSpacing() == JSON::Spacing::singleLine)
+            output << ' ';
+    }
+
+    if (format.getSpacing() == JSON::Spacing::multiLine)
+    {
+        output << newLine;
+        JSONFormatter::writeSpaces (output, getCurrentIndent());
+    }
+
+    scope.isEmpty = false;
+}
+
+void JSONWriter::prepareForValue()
+{
+    if (scopes.isEmpty())
+    {
+        // A JSON document can only contain one top-level value!
+        jassert (! hasWrittenTopLevelValue);
+        hasWrittenTopLevelValue = true;
+        return;
+    }
+
+    auto& scope = scopes.getReference (scopes.size() - 1);
+
+    if (scope.isObject)
+    {
+        // Values inside an object must be preceded by a call to writePropertyName()
+        jassert (expectingPropertyValue);
+        expectingPropertyValue = false;
+        return;
+    }
+
+    writeSeparator (scope);
+}
+
+void JSONWriter::endScope (bool isObject)
+{
+    // The end call doesn't match the begin call!
+    jassert (! scopes.isEmpty() && scopes.getLast().isObject == isObject);
+
+    // An object's last property name is missing its value
+    jassert (! expectingPropertyValue);
+
+    const auto scope = scopes.removeAndReturn (scopes.size() - 1);
+
+    // DynamicObject::writeAsJSON() always puts the closing brace of an object on a new
+    // line, but arrays only do that when they have some content
+    if (format.getSpacing() == JSON::Spacing::multiLine && (isObject || ! scope.isEmpty))
+    {
+        output << newLine;
+        JSONFormatter::writeSpaces (output, getCurrentIndent());
+    }
+
+    output << (isObject ? '}' : ']');
+}
+
+//==============================================================================
+void JSONWriter::beginObject()
+{
+    prepareForValue();
+    output << '{';
+    scopes.add ({ true, true });
+}
+
+void JSONWriter::endObject()
+{
+    endScope (true);
+}
+
+void JSONWriter::beginArray()
+{
+    prepareForValue();
+    output << '[';
+    scopes.add ({ false, true });
+}
+
+void JSONWriter::endArray()
+{
+    endScope (false);
+}
+
+void JSONWriter::writePropertyName (StringRef name)
+{
+    // Property names can only be written inside an object, and each must be followed by a value
+    jassert (! scopes.isEmpty() && scopes.getLast().isObject && ! expectingPropertyValue);
+
+    if (scopes.isEmpty())
+        return;
+
+    writeSeparator (scopes.getReference (scopes.size() - 1));
+
+    output << '"';
+    writeEscapedString (name);
+    output << "\":";
+
+    if (format.getSpacing() != JSON::Spacing::none)
+        output << ' ';
+
+    expectingPropertyValue = true;
+}
+
+//==============================================================================
+void JSONWriter::writeNull()
+{
+    prepareForValue();
+    output.write ("null", 4);
+}
+
+void JSONWriter::writeBool (bool value)
+{
+    prepareForValue();
+
+    if (value)
+        output.write ("true", 4);
+    else
+        output.write ("false", 5);
+}
+
+void JSONWriter::writeInt (int64 value)
+{
+    prepareForValue();
+
+    char buffer[24];
+    auto* end = buffer + numElementsInArray (buffer);
+    auto* start = end;
+    auto magnitude = value < 0 ? (uint64) 0 - (uint64) value : (uint64) value;
+
+    do
+    {
+        *--start = (char) ('0' + (int) (magnitude % 10));
+        magnitude /= 10;
+    }
+    while (magnitude != 0);
+
+    if (value < 0)
+        *--start = '-';
+
+    output.write (start, (size_t) (end - start));
+}
+
+#if defined (__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+// Produces the same text as serialiseDouble(), which JSON::writeToStream() uses, but
+// without going through an ostream and a String. Returns nullptr if it doesn't fit.
+static char* writeDoubleToBuffer (char* buffer, char* bufferEnd, double value, int maxDecimalPlaces) noexcept
+{
+    const auto absValue = std::abs (value);
+    const auto useScientific = absValue >= 1.0e6 || absValue <= 1.0e-5;
+
+    const auto numDecimalPlaces = [&]
+    {
+        if (useScientific)
+            return maxDecimalPlaces > 0 ? maxDecimalPlaces : 15;
+
+        if (exactlyEqual ((double) (int) value, value))
+            return 1;
+
+        if (maxDecimalPlaces > 0)
+            return maxDecimalPlaces;
+
+        if (absValue < 1.0e-4) return 20;
+        if (absValue < 1.0e-3) return 19;
+        if (absValue < 1.0e-2) return 18;
+        if (absValue < 1.0e-1) return 17;
+        if (absValue < 1.0)    return 16;
+        if (absValue < 1.0e1)  return 15;
+        if (absValue < 1.0e2)  return 14;
+        if (absValue < 1.0e3)  return 13;
+        if (absValue < 1.0e4)  return 12;
+        if (absValue < 1.0e5)  return 11;
+        return 10;
+    }();
+
+    const auto result = std::to_chars (buffer, bufferEnd, value,
+                                       useScientific ? std::chars_format::scientific : std::chars_format::fixed,
+                                       numDecimalPlaces);
+
+    if (result.ec != std::errc())
+        return nullptr;
+
+    // Now trim the text in the same way as reduceLengthOfFloatString()
+    auto* end = result.ptr;
+    auto* exponent = std::find (buffer, end, 'e');
+    auto* mantissaEnd = exponent;
+    auto* point = std::find (buffer, exponent, '.');
+
+    if (point != exponent)
+    {
+        while (mantissaEnd > point + 1 && mantissaEnd[-1] == '0')
+            --mantissaEnd;
+
+        // keep a zero after the point, so that the value is still read back as a double
+        if (mantissaEnd == point + 1 && mantissaEnd != exponent)
+            ++mantissaEnd;
+    }
+
+    auto* out = mantissaEnd;
+
+    if (exponent != end)
+    {
+        auto* digits = exponent + 1;
+        const auto isNegative = digits != end && *digits == '-';
+
+        if (digits != end && (*digits == '-' || *digits == '+'))
+            ++digits;
+
+        while (digits != end && *digits == '0')
+            ++digits;
+
+        if (digits != end)
+        {
+            *out++ = 'e';
+
+            if (isNegative)
+                *out++ = '-';
+
+            out = std::copy (digits, end, out);
+        }
+    }
+
+    return out;
+}
+#endif
+
+void JSONWriter::writeDouble (double value)
+{
+    prepareForValue();
+
+    if (! juce_isfinite (value))
+    {
+        output.write ("null", 4);
+        return;
+    }
+
+   #if defined (__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    char buffer[64];
+
+    if (auto* end = writeDoubleToBuffer (buffer, buffer + numElementsInArray (buffer), value, format.getMaxDecimalPlaces()))
+    {
+        output.write (buffer, (size_t) (end - buffer));
+        return;
+    }
+   #endif
+
+    output << serialiseDouble (value, format.getMaxDecimalPlaces());
+}
+
+void JSONWriter::writeString (StringRef value)
+{
+    prepareForValue();
+    output << '"';
+    writeEscapedString (value);
+    output << '"';
+}
+
+void JSONWriter::writeVar (const var& value)
+{
+    prepareForValue();
+    JSON::writeToStream (output, value, format.withIndentLevel (getCurrentIndent()));
+}
+
+void JSONWriter::writeEscapedString (StringRef text)
+{
+   #if JUCE_STRING_UTF_TYPE == 8
+    if (format.getEncoding() == JSON::Encoding::utf8)
+    {
+        // Write runs of characters that don't need escaping in a single call
+        const char* runStart = text.text.getAddress();
+
+        for (auto* p = runStart;; ++p)
+        {
+            const auto c = (uint8) *p;
+
+            if (c >= 0x20 && c != '"' && c != '\\')
+                continue;
+
+            if (p != runStart)
+                output.write (runStart, (size_t) (p - runStart));
+
+            runStart = p + 1;
+
+            switch (c)
+            {
+                case 0:     return;
+                case '"':   output.write ("\\\"", 2); break;
+                case '\\':  output.write ("\\\\", 2); break;
+                case '\b':  output.write ("\\b", 2); break;
+                case '\f':  output.write ("\\f", 2); break;
+                case '\t':  output.write ("\\t", 2); break;
+                case '\r':  output.write ("\\r", 2); break;
+                case '\n':  output.write ("\\n", 2); break;
+                default:    JSONFormatter::writeEscapedChar (output, (unsigned short) c); break;
+            }
+        }
+    }
+   #endif
+
+    JSONFormatter::writeString (output, text.text, format.getEncoding());
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONWriterTests final : public UnitTest
+{
+public:
+    JSONWriterTests()
+        : UnitTest ("JSONWriter", UnitTestCategories::json)
+    {}
+
+    static String createRandomString (Random& r)
+    {
+        juce_wchar buffer[30] = { 0 };
+
+        for (int i = r.nextInt (numElementsInArray (buffer) - 1); --i >= 0;)
+        {
+            switch (r.nextInt (4))
+            {
+                case 0:   buffer[i] = (juce_wchar) (1 + r.nextInt (0x1f)); break;
+                case 1:   buffer[i] = r.nextBool() ? '\\' : '"'; break;
+                case 2:   buffer[i] = (juce_wchar) (0x20 + r.nextInt (0x60)); break;
+
+                default:
+                    do
+                    {
+                        buffer[i] = (juce_wchar) (1 + r.nextInt (0x10ffff - 1));
+                    }
+                    while (! CharPointer_UTF16::canRepresent (buffer[i]));
+
+                    break;
+            }
+        }
+
+        return CharPointer_UTF32 (buffer);
+    }
+
+    static var createRandomVar (Random& r, int depth)
+    {
+        switch (r.nextInt (depth > 3 ? 6 : 8))
+        {
+            case 0:     return {};
+            case 1:     return r.nextInt();
+            case 2:     return r.nextInt64();
+            case 3:     return r.nextBool();
+            case 4:     return (r.nextDouble() - 0.5) * std::pow (10.0, r.nextInt (40) - 20);
+            case 5:     return createRandomString (r);
+
+            case 6:
+            {
+                Array<var> result;
+
+                for (int i = r.nextInt (10); --i >= 0;)
+                    result.add (createRandomVar (r, depth + 1));
+
+                return result;
+            }
+
+            case 7:
+            {
+                auto o = new DynamicObject();
+
+                for (int i = r.nextInt (10); --i >= 0;)
+                {
+                    auto name = createRandomString (r);
+
+                    if (name.isNotEmpty())
+                        o->setProperty (name, createRandomVar (r, depth + 1));
+                }
+
+                return o;
+            }
+
+            default:
+                return {};
+        }
+    }
+
+    // Writes a var using the individual writer calls rather than writeVar()
+    static void writeVarIncrementally (JSONWriter& writer, const var& v)
+    {
+        if (auto* array = v.getArray())
+        {
+            writer.beginArray();
+
+            for (auto& item : *array)
+                writeVarIncrementally (writer, item);
+
+            writer.endArray();
+        }
+        else if (auto* object = v.getDynamicObject())
+        {
+            writer.beginObject();
+
+            for (auto& property : object->getProperties())
+            {
+                writer.writePropertyName (property.name.toString());
+                writeVarIncrementally (writer, property.value);
+            }
+
+            writer.endObject();
+        }
+        else if (v.isVoid())        writer.writeNull();
+        else if (v.isBool())        writer.writeBool ((bool) v);
+        else if (v.isInt() || v.isInt64())  writer.writeInt ((int64) v);
+        else if (v.isString())      writer.writeString (v.toString());
+        else if (v.isDouble())      writer.writeDouble ((double) v);
+        else                        writer.writeVar (v);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Output matches JSON::writeToStream");
+        {
+            auto r = getRandom();
+
+            const JSON::FormatOptions formats[] { JSON::FormatOptions{},
+                                                  JSON::FormatOptions{}.withSpacing (JSON::Spacing::singleLine),
+                                                  JSON::FormatOptions{}.withSpacing (JSON::Spacing::none),
+                                                  JSON::FormatOptions{}.withEncoding (JSON::Encoding::ascii),
+                                                  JSON::FormatOptions{}.withIndentLevel (4) };
+
+            for (int i = 0; i < 100; ++i)
+            {
+                const auto v = createRandomVar (r, 0);
+
+                for (auto& format : formats)
+                {
+                    MemoryOutputStream mo;
+
+                    {
+                        JSONWriter writer (mo, format);
+                        writeVarIncrementally (writer, v);
+                        expect (writer.isComplete());
+                    }
+
+                    expectEquals (mo.toUTF8(), JSON::toString (v, format));
+                }
+            }
+        }
+
+        beginTest ("Empty containers");
+        {
+            MemoryOutputStream mo;
+            JSONWriter writer (mo, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none));
+            writer.beginArray();
+            writer.beginArray();
+            writer.endArray();
+            writer.beginObject();
+            writer.endObject();
+            writer.endArray();
+            expectEquals (mo.toUTF8(), String ("[[],{}]"));
+        }
+
+        beginTest ("Numbers");
+        {
+            const auto writeNumber = [] (auto fn)
+            {
+                MemoryOutputStream mo;
+                JSONWriter writer (mo);
+                fn (writer);
+                return mo.toUTF8();
+            };
+
+            expectEquals (writeNumber ([] (auto& w) { w.writeInt (0); }), String ("0"));
+            expectEquals (writeNumber ([] (auto& w) { w.writeInt (-42); }), String ("-42"));
+            expectEquals (writeNumber ([] (auto& w) { w.writeInt (std::numeric_limits<int64>::max()); }), String ("9223372036854775807"));
+            expectEquals (writeNumber ([] (auto& w) { w.writeInt (std::numeric_limits<int64>::min()); }), String ("-9223372036854775808"));
+            expectEquals (writeNumber ([] (auto& w) { w.writeDouble (std::numeric_limits<double>::infinity()); }), String ("null"));
+            expectEquals (writeNumber ([] (auto& w) { w.writeDouble (std::numeric_limits<double>::quiet_NaN()); }), String ("null"));
+
+            const auto integral = JSON::fromString (writeNumber ([] (auto& w) { w.writeDouble (3.0); }));
+            expect (integral.isDouble() && exactlyEqual ((double) integral, 3.0));
+        }
+
+        beginTest ("Doubles match JSON::writeToStream");
+        {
+            auto r = getRandom();
+
+            const JSON::FormatOptions formats[] { JSON::FormatOptions{},
+                                                  JSON::FormatOptions{}.withMaxDecimalPlaces (0),
+                                                  JSON::FormatOptions{}.withMaxDecimalPlaces (3),
+                                                  JSON::FormatOptions{}.withMaxDecimalPlaces (25) };
+
+            const auto writeDouble = [] (double d, const JSON::FormatOptions& format)
+            {
+                MemoryOutputStream mo;
+                JSONWriter writer (mo, format);
+                writer.writeDouble (d);
+                return mo.toUTF8();
+            };
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const auto d = i < 20 ? (double) (i - 10) * 0.5
+                                      : (r.nextDouble() - 0.5) * std::pow (10.0, r.nextInt (600) - 300);
+
+                for (auto& format : formats)
+                    expectEquals (writeDouble (d, format), JSON::toString (d, format));
+
+                // With enough decimal places, every value should read back exactly
+                JSONDocument doc;
+                const auto text = writeDouble (d, formats[3]);
+                expect (doc.parse (text).wasOk());
+                expect (exactlyEqual (doc.getRoot().getDouble(), d), text);
+            }
+        }
+    }
+};
+
+static JSONWriterTests jsonWriterTests;
+
+#endif
+
+} // namespace juce
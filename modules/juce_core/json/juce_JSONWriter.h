@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON directly to an OutputStream, one value at a time.
+
+    JSON::writeToStream() needs the complete data set to be built as a var first,
+    which can be slow and use a lot of memory when exporting large amounts of data.
+    A JSONWriter instead writes each value as soon as you give it, so nothing needs
+    to be held in memory apart from the stack of currently open arrays and objects.
+
+    e.g.
+    @code
+    JSONWriter writer (outputStream);
+
+    writer.beginObject();
+    writer.writePropertyName ("name");
+    writer.writeString ("preset 1");
+    writer.writePropertyName ("levels");
+    writer.beginArray();
+
+    for (auto level : levels)
+        writer.writeDouble (level);
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    The layout follows the spacing and encoding in the FormatOptions, and matches the
+    output of JSON::writeToStream(), including the maximum number of decimal places used
+    for floating-point numbers. Non-finite numbers are written as null.
+
+    It's up to the caller to produce a well-formed document: each begin call must be
+    matched by an end call, and each value inside an object must be preceded by a call to
+    writePropertyName(). Mistakes will trigger an assertion in debug builds.
+
+    @see JSON, ToJSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer that sends its output to the given stream.
+        The stream must remain valid for the lifetime of the writer.
+    */
+    explicit JSONWriter (OutputStream& destination,
+                         const JSON::FormatOptions& formatOptions = JSON::FormatOptions{});
+
+    /** Destructor. */
+    ~JSONWriter();
+
+    //==============================================================================
+    /** Starts writing an object. Each property must be written as a call to
+        writePropertyName() followed by a value, and the object must be finished
+        with a call to endObject().
+    */
+    void beginObject();
+
+    /** Finishes the object that was started by the last call to beginObject(). */
+    void endObject();
+
+    /** Starts writing an array, which must be finished with a call to endArray(). */
+    void beginArray();
+
+    /** Finishes the array that was started by the last call to beginArray(). */
+    void endArray();
+
+    /** Writes the name of the next property in the current object.
+        This must be followed by exactly one value.
+    */
+    void writePropertyName (StringRef name);
+
+    //==============================================================================
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes a boolean value. */
+    void writeBool (bool value);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value. */
+    void writeDouble (double value);
+
+    /** Writes a string value, escaping any characters as required. */
+    void writeString (StringRef value);
+
+    /** Writes the contents of a var, in the same way as JSON::writeToStream(). */
+    void writeVar (const var& value);
+
+    //==============================================================================
+    /** Returns true once a single complete value has been written. */
+    bool isComplete() const noexcept        { return hasWrittenTopLevelValue && scopes.isEmpty(); }
+
+    /** Returns the stream that the writer is using. */
+    OutputStream& getOutputStream() const noexcept  { return output; }
+
+private:
+    //==============================================================================
+    struct Scope
+    {
+        bool isObject, isEmpty;
+    };
+
+    OutputStream& output;
+    const JSON::FormatOptions format;
+    Array<Scope> scopes;
+    bool expectingPropertyValue = false, hasWrittenTopLevelValue = false;
+
+    void writeSeparator (Scope&);
+    void prepareForValue();
+    void endScope (bool isObject);
+    void writeEscapedString (StringRef);
+    int getCurrentIndent() const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONWriter)
+};
+
+} // namespace juce
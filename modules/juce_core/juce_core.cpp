@@ -53,6 +53,18 @@
 #include <locale>
 #include <thread>
 
+#if __has_include (<charconv>)
+ #include <charconv>
+#endif
+
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_CORE_USE_SSE2_INTRINSICS 1
+ #include <emmintrin.h>
+#elif JUCE_ARM && (defined (__aarch64__) || defined (_M_ARM64))
+ #define JUCE_CORE_USE_NEON_INTRINSICS 1
+ #include <arm_neon.h>
+#endif
+
 #if ! (JUCE_ANDROID || JUCE_BSD)
  #include <sys/timeb.h>
  #include <cwctype>
@@ -164,6 +176,7 @@
 #include "zip/juce_zlib.h"
 #include "network/juce_NamedPipe.cpp"
 #include "network/juce_Socket.cpp"
+#include "network/juce_SocketEventMultiplexer.cpp"
 #include "network/juce_IPAddress.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
 #include "streams/juce_FileInputSource.cpp"
@@ -193,11 +206,16 @@
 #include "containers/juce_Variant.cpp"
 #include "json/juce_JSON.cpp"
 #include "json/juce_JSONUtils.cpp"
+#include "json/juce_JSONDocument.cpp"
+#include "json/juce_JSONWriter.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlPullParser.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
+#include "zip/juce_LZ4DecompressorInputStream.cpp"
+#include "zip/juce_LZ4CompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
 #include "files/juce_FileFilter.cpp"
 #include "files/juce_WildcardFileFilter.cpp"
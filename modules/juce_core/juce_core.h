@@ -330,6 +330,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "json/juce_JSONUtils.h"
+#include "json/juce_JSONDocument.h"
+#include "json/juce_JSONWriter.h"
 #include "serialisation/juce_Serialisation.h"
 #include "json/juce_JSONSerialisation.h"
 #include "maths/juce_BigInteger.h"
@@ -355,6 +357,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "network/juce_MACAddress.h"
 #include "network/juce_NamedPipe.h"
 #include "network/juce_Socket.h"
+#include "network/juce_SocketEventMultiplexer.h"
 #include "network/juce_URL.h"
 #include "network/juce_WebInputStream.h"
 #include "streams/juce_URLInputSource.h"
@@ -362,8 +365,11 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlPullParser.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
+#include "zip/juce_LZ4CompressorOutputStream.h"
+#include "zip/juce_LZ4DecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
@@ -195,6 +195,7 @@
  #include <signal.h>
  #include <stddef.h>
  #include <sys/dir.h>
+ #include <sys/epoll.h>
  #include <sys/file.h>
  #include <sys/ioctl.h>
  #include <sys/mman.h>
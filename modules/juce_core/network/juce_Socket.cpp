@@ -311,6 +311,53 @@ namespace SocketHelpers
         return (int) bytesRead;
     }
 
+    static bool lastCallWouldHaveBlocked() noexcept
+    {
+       #if JUCE_WINDOWS
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+       #else
+        return errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR;
+       #endif
+    }
+
+    // For sockets in non-blocking mode: returns 0 if there's nothing to read yet,
+    // and -1 if the connection has been closed
+    static int readAvailableData (SocketHandle handle, void* destBuffer, int maxBytesToRead,
+                                  CriticalSection& readLock) noexcept
+    {
+        // avoid race-condition
+        CriticalSection::ScopedTryLockType lock (readLock);
+
+        if (! lock.isLocked() || maxBytesToRead <= 0)
+            return 0;
+
+        auto bytesRead = ::recv (handle, static_cast<char*> (destBuffer), (juce_recvsend_size_t) maxBytesToRead, 0);
+
+        if (bytesRead > 0)
+            return (int) bytesRead;
+
+        if (bytesRead < 0 && lastCallWouldHaveBlocked())
+            return 0;
+
+        return -1;
+    }
+
+    static int writeAvailableSpace (SocketHandle handle, const void* sourceBuffer, int numBytesToWrite) noexcept
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        constexpr int flags = MSG_NOSIGNAL;
+       #else
+        constexpr int flags = 0;
+       #endif
+
+        auto bytesWritten = ::send (handle, static_cast<const char*> (sourceBuffer), (juce_recvsend_size_t) numBytesToWrite, flags);
+
+        if (bytesWritten < 0)
+            return lastCallWouldHaveBlocked() ? 0 : -1;
+
+        return (int) bytesWritten;
+    }
+
     static int waitForReadiness (std::atomic<int>& handle, CriticalSection& readLock,
                                  bool forReading, int timeoutMsecs) noexcept
     {
@@ -519,9 +566,14 @@ StreamingSocket::~StreamingSocket()
 //==============================================================================
 int StreamingSocket::read (void* destBuffer, int maxBytesToRead, bool shouldBlock)
 {
-    return (connected && ! isListener) ? SocketHelpers::readSocket ((SocketHandle) handle.load(), destBuffer,maxBytesToRead,
-                                                                    connected, shouldBlock, readLock)
-                                       : -1;
+    if (isListener || ! connected)
+        return -1;
+
+    if (nonBlocking)
+        return SocketHelpers::readAvailableData ((SocketHandle) handle.load(), destBuffer, maxBytesToRead, readLock);
+
+    return SocketHelpers::readSocket ((SocketHandle) handle.load(), destBuffer, maxBytesToRead,
+                                      connected, shouldBlock, readLock);
 }
 
 int StreamingSocket::write (const void* sourceBuffer, int numBytesToWrite)
@@ -529,9 +581,20 @@ int StreamingSocket::write (const void* sourceBuffer, int numBytesToWrite)
     if (isListener || ! connected)
         return -1;
 
+    if (nonBlocking)
+        return SocketHelpers::writeAvailableSpace ((SocketHandle) handle.load(), sourceBuffer, numBytesToWrite);
+
     return (int) ::send ((SocketHandle) handle.load(), (const char*) sourceBuffer, (juce_recvsend_size_t) numBytesToWrite, 0);
 }
 
+bool StreamingSocket::setNonBlocking (bool shouldBeNonBlocking)
+{
+    nonBlocking = shouldBeNonBlocking;
+
+    const auto h = (SocketHandle) handle.load();
+    return h == invalidSocket || SocketHelpers::setSocketBlockingState (h, ! shouldBeNonBlocking);
+}
+
 //==============================================================================
 int StreamingSocket::waitUntilReady (bool readyForReading, int timeoutMsecs)
 {
@@ -581,7 +644,8 @@ bool StreamingSocket::connect (const String& remoteHostName, int remotePortNumbe
     if (! connected)
         return false;
 
-    if (! SocketHelpers::resetSocketOptions ((SocketHandle) handle.load(), false, false, options))
+    if (! SocketHelpers::resetSocketOptions ((SocketHandle) handle.load(), false, false, options)
+         || (nonBlocking && ! setNonBlocking (true)))
     {
         close();
         return false;
@@ -623,7 +687,8 @@ bool StreamingSocket::createListener (int newPortNumber, const String& localHost
    #endif
 
     if (SocketHelpers::bindSocket ((SocketHandle) handle.load(), portNumber, localHostName)
-         && listen ((SocketHandle) handle.load(), SOMAXCONN) >= 0)
+         && listen ((SocketHandle) handle.load(), SOMAXCONN) >= 0
+         && (! nonBlocking || setNonBlocking (true)))
     {
         connected = true;
         return true;
@@ -646,8 +711,14 @@ StreamingSocket* StreamingSocket::waitForNextConnection() const
         auto newSocket = (int) accept ((SocketHandle) handle.load(), (struct sockaddr*) &address, &len);
 
         if (newSocket >= 0 && connected)
-            return new StreamingSocket (inet_ntoa (((struct sockaddr_in*) &address)->sin_addr),
-                                        portNumber, newSocket, options);
+        {
+            auto* result = new StreamingSocket (inet_ntoa (((struct sockaddr_in*) &address)->sin_addr),
+                                                portNumber, newSocket, options);
+
+            // some platforms make accepted sockets inherit the listener's blocking state, and some don't
+            result->setNonBlocking (nonBlocking);
+            return result;
+        }
     }
 
     return nullptr;
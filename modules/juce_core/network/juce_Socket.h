@@ -221,6 +221,33 @@ public:
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    //==============================================================================
+    /** Switches the socket in or out of non-blocking mode.
+
+        In non-blocking mode, none of the methods wait for the network, apart from connect():
+
+        - read() returns whatever data has already arrived, or 0 if there isn't any yet. It
+          returns -1 when the other end has closed the connection. The
+          blockUntilSpecifiedAmountHasArrived flag is ignored.
+        - write() sends as much of the data as the system can buffer straight away, and
+          returns the number of bytes that it took, which may be fewer than requested, or 0.
+        - waitForNextConnection() returns nullptr if there's no connection waiting.
+
+        This is intended for use with a SocketEventMultiplexer, which will tell you when the
+        socket is ready to be read or written. The mode stays the same when the socket is
+        reconnected, and sockets returned by waitForNextConnection() start off in the same
+        mode as the listener.
+
+        @returns  true on success
+        @see SocketEventMultiplexer
+    */
+    bool setNonBlocking (bool shouldBeNonBlocking);
+
+    /** True if the socket is in non-blocking mode.
+        @see setNonBlocking
+    */
+    bool isNonBlocking() const noexcept                         { return nonBlocking; }
+
     //==============================================================================
     /** Puts this socket into "listener" mode.
 
@@ -253,7 +280,7 @@ private:
     SocketOptions options;
     String hostName;
     std::atomic<int> portNumber { 0 }, handle { -1 };
-    std::atomic<bool> connected { false }, isListener { false };
+    std::atomic<bool> connected { false }, isListener { false }, nonBlocking { false };
     mutable CriticalSection readLock;
 
     StreamingSocket (const String& hostname, int portNumber, int handle, const SocketOptions& options);
@@ -0,0 +1,559 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if ! JUCE_WASM
+
+struct SocketEventMultiplexer::Pimpl
+{
+    explicit Pimpl (int numThreadsToUse)
+    {
+       #if JUCE_LINUX
+        epollFd = epoll_create1 (EPOLL_CLOEXEC);
+        wakeFd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (epollFd < 0 || wakeFd < 0)
+        {
+            jassertfalse;
+            return;
+        }
+
+        // The wake-up event is level-triggered and never cleared, so that once it's
+        // been signalled, every thread that's waiting will see it
+        epoll_event e {};
+        e.events = EPOLLIN;
+        e.data.u64 = wakeUpMarker;
+        epoll_ctl (epollFd, EPOLL_CTL_ADD, wakeFd, &e);
+       #else
+        numThreadsToUse = 1;
+
+        if (! (wakeSocket.bindToPort (0, "127.0.0.1")))
+        {
+            jassertfalse;
+            return;
+        }
+
+        wakePort = wakeSocket.getBoundPort();
+       #endif
+
+        for (int i = 0; i < jmax (1, numThreadsToUse); ++i)
+            threads.add (new WorkerThread (*this))->startThread();
+    }
+
+    ~Pimpl()
+    {
+        for (auto* t : threads)
+            t->signalThreadShouldExit();
+
+       #if JUCE_LINUX
+        if (wakeFd >= 0)
+        {
+            const uint64 one = 1;
+            [[maybe_unused]] auto written = ::write (wakeFd, &one, sizeof (one));
+        }
+       #else
+        wake();
+       #endif
+
+        threads.clear();
+
+       #if JUCE_LINUX
+        if (epollFd >= 0)  ::close (epollFd);
+        if (wakeFd >= 0)   ::close (wakeFd);
+       #endif
+    }
+
+    //==============================================================================
+    bool add (int handle, int events, Callback callback)
+    {
+        if (handle < 0 || callback == nullptr || threads.isEmpty())
+            return false;
+
+        auto reg = std::make_shared<Registration>();
+        reg->handle = handle;
+        reg->events = events;
+        reg->callback = std::move (callback);
+
+        {
+            const ScopedLock sl (lock);
+
+            if (registrations.find (handle) != registrations.end())
+                return false;
+
+            reg->generation = ++lastGeneration;
+
+           #if JUCE_LINUX
+            if (! arm (*reg, EPOLL_CTL_ADD))
+                return false;
+           #else
+            needsRebuild = true;
+           #endif
+
+            registrations[handle] = std::move (reg);
+        }
+
+       #if ! JUCE_LINUX
+        wake();
+       #endif
+        return true;
+    }
+
+    bool setEvents (int handle, int events)
+    {
+        const ScopedLock sl (lock);
+        auto* reg = find (handle);
+
+        if (reg == nullptr)
+            return false;
+
+        reg->events = events;
+
+       #if JUCE_LINUX
+        // If the callback is running, this re-arms the socket early, which may cause
+        // another thread to wait for it to finish and then call it again. That's harmless,
+        // because the events are level-triggered.
+        return arm (*reg, EPOLL_CTL_MOD);
+       #else
+        needsRebuild = true;
+        wake();
+        return true;
+       #endif
+    }
+
+    void remove (int handle)
+    {
+        std::shared_ptr<Registration> reg;
+
+        {
+            const ScopedLock sl (lock);
+            auto it = registrations.find (handle);
+
+            if (it == registrations.end())
+                return;
+
+            reg = std::move (it->second);
+            registrations.erase (it);
+
+           #if JUCE_LINUX
+            epoll_ctl (epollFd, EPOLL_CTL_DEL, handle, nullptr);
+           #else
+            needsRebuild = true;
+           #endif
+        }
+
+       #if ! JUCE_LINUX
+        wake();
+       #endif
+
+        // This waits for the callback to finish if it's running on another thread. The lock
+        // is re-entrant, so it won't block if we're being called from inside the callback.
+        const ScopedLock cl (reg->callbackLock);
+        reg->removed = true;
+    }
+
+    bool contains (int handle) const
+    {
+        const ScopedLock sl (lock);
+        return registrations.find (handle) != registrations.end();
+    }
+
+    int size() const
+    {
+        const ScopedLock sl (lock);
+        return (int) registrations.size();
+    }
+
+private:
+    //==============================================================================
+    struct Registration
+    {
+        int handle = -1;
+        uint32 generation = 0;
+        int events = 0;
+        Callback callback;
+        CriticalSection callbackLock;
+        bool removed = false;
+    };
+
+    struct WorkerThread final : public Thread
+    {
+        explicit WorkerThread (Pimpl& p)  : Thread (SystemStats::getJUCEVersion() + ": Sockets"), owner (p) {}
+        ~WorkerThread() override          { stopThread (-1); }
+        void run() override               { owner.run (*this); }
+
+        Pimpl& owner;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkerThread)
+    };
+
+    Registration* find (int handle) const
+    {
+        auto it = registrations.find (handle);
+        return it != registrations.end() ? it->second.get() : nullptr;
+    }
+
+    void dispatch (int handle, uint32 generation, int eventFlags)
+    {
+        std::shared_ptr<Registration> reg;
+
+        {
+            const ScopedLock sl (lock);
+            auto it = registrations.find (handle);
+
+            // The generation check skips events for a socket that has been removed, and whose
+            // handle has since been reused for a new one
+            if (it == registrations.end() || it->second->generation != generation)
+                return;
+
+            reg = it->second;
+            eventFlags &= (reg->events | error);
+        }
+
+        {
+            const ScopedLock cl (reg->callbackLock);
+
+            if (reg->removed)
+                return;
+
+            if (eventFlags != 0)
+                reg->callback (eventFlags);
+        }
+
+       #if JUCE_LINUX
+        const ScopedLock sl (lock);
+        auto it = registrations.find (handle);
+
+        if (it != registrations.end() && it->second == reg)
+            arm (*reg, EPOLL_CTL_MOD);
+       #endif
+    }
+
+    CriticalSection lock;
+    std::unordered_map<int, std::shared_ptr<Registration>> registrations;
+    uint32 lastGeneration = 0;
+    OwnedArray<WorkerThread> threads;
+
+   #if JUCE_LINUX
+    //==============================================================================
+    static constexpr uint64 wakeUpMarker = std::numeric_limits<uint64>::max();
+    int epollFd = -1, wakeFd = -1;
+
+    // Each socket is added with EPOLLONESHOT, so that only one thread gets its events, and
+    // it's re-armed after its callback has finished
+    bool arm (const Registration& reg, int operation)
+    {
+        epoll_event e {};
+        e.events = EPOLLONESHOT | ((reg.events & readable) != 0 ? EPOLLIN : 0u)
+                                | ((reg.events & writable) != 0 ? EPOLLOUT : 0u);
+        e.data.u64 = ((uint64) reg.generation << 32) | (uint32) reg.handle;
+
+        return epoll_ctl (epollFd, operation, reg.handle, &e) == 0;
+    }
+
+    void run (Thread& thread)
+    {
+        std::array<epoll_event, 64> events;
+
+        while (! thread.threadShouldExit())
+        {
+            const auto numEvents = epoll_wait (epollFd, events.data(), (int) events.size(), -1);
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                const auto& e = events[(size_t) i];
+
+                if (e.data.u64 == wakeUpMarker)
+                    continue;
+
+                int flags = 0;
+
+                if ((e.events & EPOLLIN) != 0)                  flags |= readable;
+                if ((e.events & EPOLLOUT) != 0)                 flags |= writable;
+                if ((e.events & (EPOLLERR | EPOLLHUP)) != 0)    flags |= error;
+
+                dispatch ((int) (uint32) e.data.u64, (uint32) (e.data.u64 >> 32), flags);
+            }
+        }
+    }
+   #else
+    //==============================================================================
+    // There's no portable equivalent of eventfd, so the polling thread is woken by
+    // sending a datagram to a socket on the loopback interface
+    DatagramSocket wakeSocket;
+    int wakePort = 0;
+    CriticalSection wakeLock;
+    std::atomic<bool> wakePending { false }, needsRebuild { true };
+
+    void wake()
+    {
+        if (wakePending.exchange (true))
+            return;
+
+        const ScopedLock sl (wakeLock);
+        const char byte = 0;
+        wakeSocket.write ("127.0.0.1", wakePort, &byte, 1);
+    }
+
+    void run (Thread& thread)
+    {
+       #if JUCE_WINDOWS
+        std::vector<WSAPOLLFD> fds;
+       #else
+        std::vector<pollfd> fds;
+       #endif
+        std::vector<uint32> generations;
+
+        while (! thread.threadShouldExit())
+        {
+            if (needsRebuild.exchange (false))
+            {
+                fds.clear();
+                generations.clear();
+
+                const ScopedLock sl (lock);
+
+                fds.push_back ({ (SocketHandle) wakeSocket.getRawSocketHandle(), POLLIN, 0 });
+                generations.push_back (0);
+
+                for (auto& [handle, reg] : registrations)
+                {
+                    fds.push_back ({ (SocketHandle) handle,
+                                     (short) (((reg->events & readable) != 0 ? POLLIN : 0)
+                                               | ((reg->events & writable) != 0 ? POLLOUT : 0)),
+                                     0 });
+                    generations.push_back (reg->generation);
+                }
+            }
+
+            for (auto& f : fds)
+                f.revents = 0;
+
+           #if JUCE_WINDOWS
+            const auto result = WSAPoll (fds.data(), (ULONG) fds.size(), -1);
+           #else
+            const auto result = poll (fds.data(), (nfds_t) fds.size(), -1);
+           #endif
+
+            if (result <= 0)
+                continue;
+
+            if (fds[0].revents != 0)
+            {
+                wakePending = false;
+                char buffer[64];
+
+                while (wakeSocket.read (buffer, (int) sizeof (buffer), false) > 0)
+                {}
+            }
+
+            for (size_t i = 1; i < fds.size() && ! thread.threadShouldExit(); ++i)
+            {
+                const auto revents = fds[i].revents;
+
+                if (revents == 0)
+                    continue;
+
+                int flags = 0;
+
+                if ((revents & POLLIN) != 0)                            flags |= readable;
+                if ((revents & POLLOUT) != 0)                           flags |= writable;
+                if ((revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)    flags |= error;
+
+                dispatch ((int) fds[i].fd, generations[i], flags);
+            }
+        }
+    }
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
+};
+
+//==============================================================================
+SocketEventMultiplexer::SocketEventMultiplexer (int numThreads)
+    : pimpl (std::make_unique<Pimpl> (numThreads))
+{
+}
+
+SocketEventMultiplexer::~SocketEventMultiplexer() = default;
+
+bool SocketEventMultiplexer::addSocket (int rawSocketHandle, int eventsToWatch, Callback callback)
+{
+    return pimpl->add (rawSocketHandle, eventsToWatch, std::move (callback));
+}
+
+bool SocketEventMultiplexer::setEventsToWatch (int rawSocketHandle, int eventsToWatch)
+{
+    return pimpl->setEvents (rawSocketHandle, eventsToWatch);
+}
+
+void SocketEventMultiplexer::removeSocket (int rawSocketHandle)
+{
+    pimpl->remove (rawSocketHandle);
+}
+
+bool SocketEventMultiplexer::isWatching (int rawSocketHandle) const
+{
+    return pimpl->contains (rawSocketHandle);
+}
+
+int SocketEventMultiplexer::getNumSockets() const
+{
+    return pimpl->size();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct SocketEventMultiplexerTests final : public UnitTest
+{
+    SocketEventMultiplexerTests()
+        : UnitTest ("SocketEventMultiplexer", UnitTestCategories::networking)
+    {
+    }
+
+    void runTest() override
+    {
+        const auto localHost = IPAddress::local().toString();
+
+        beginTest ("Non-blocking StreamingSocket");
+        {
+            StreamingSocket listener;
+            expect (listener.setNonBlocking (true));
+            expect (listener.createListener (0, localHost));
+            expect (listener.waitForNextConnection() == nullptr);
+
+            StreamingSocket client;
+            expect (client.connect (localHost, listener.getBoundPort()));
+            expect (listener.waitUntilReady (true, 5000) == 1);
+
+            std::unique_ptr<StreamingSocket> server (listener.waitForNextConnection());
+            expect (server != nullptr);
+            expect (server->isNonBlocking());
+
+            char buffer[16] = {};
+            expectEquals (server->read (buffer, (int) sizeof (buffer), true), 0);
+
+            expectEquals (client.write ("hello", 5), 5);
+            expect (server->waitUntilReady (true, 5000) == 1);
+            expectEquals (server->read (buffer, (int) sizeof (buffer), false), 5);
+            expectEquals (String (buffer, 5), String ("hello"));
+
+            client.close();
+            expect (server->waitUntilReady (true, 5000) == 1);
+            expectEquals (server->read (buffer, (int) sizeof (buffer), false), -1);
+        }
+
+        beginTest ("SocketEventMultiplexer");
+        {
+            constexpr int numClients = 8;
+
+            SocketEventMultiplexer multiplexer (2);
+            StreamingSocket listener;
+            OwnedArray<StreamingSocket> servers;
+            CriticalSection serversLock;
+            std::atomic<int> numBytesReceived { 0 }, numClosed { 0 };
+            WaitableEvent allReceived, allClosed;
+
+            listener.setNonBlocking (true);
+            expect (listener.createListener (0, localHost));
+
+            expect (multiplexer.addSocket (listener.getRawSocketHandle(), SocketEventMultiplexer::readable, [&] (int)
+            {
+                while (auto* s = listener.waitForNextConnection())
+                {
+                    const ScopedLock sl (serversLock);
+                    servers.add (s);
+
+                    multiplexer.addSocket (s->getRawSocketHandle(), SocketEventMultiplexer::readable, [&, s] (int)
+                    {
+                        char buffer[256];
+
+                        for (;;)
+                        {
+                            const auto numRead = s->read (buffer, (int) sizeof (buffer), false);
+
+                            if (numRead == 0)
+                                break;
+
+                            if (numRead < 0)
+                            {
+                                multiplexer.removeSocket (s->getRawSocketHandle());
+
+                                if (++numClosed == numClients)
+                                    allClosed.signal();
+
+                                break;
+                            }
+
+                            if ((numBytesReceived += numRead) == numClients * 4)
+                                allReceived.signal();
+                        }
+                    });
+                }
+            }));
+
+            expect (! multiplexer.addSocket (listener.getRawSocketHandle(), SocketEventMultiplexer::readable, [] (int) {}));
+
+            OwnedArray<StreamingSocket> clients;
+
+            for (int i = 0; i < numClients; ++i)
+            {
+                auto* client = clients.add (new StreamingSocket());
+                expect (client->connect (localHost, listener.getBoundPort()));
+                expectEquals (client->write ("ping", 4), 4);
+            }
+
+            expect (allReceived.wait (5000));
+            expectEquals (numBytesReceived.load(), numClients * 4);
+
+            clients.clear();
+            expect (allClosed.wait (5000));
+            expectEquals (multiplexer.getNumSockets(), 1);
+
+            multiplexer.removeSocket (listener.getRawSocketHandle());
+            expect (! multiplexer.isWatching (listener.getRawSocketHandle()));
+            expectEquals (multiplexer.getNumSockets(), 0);
+        }
+    }
+};
+
+static SocketEventMultiplexerTests socketEventMultiplexerTests;
+
+#endif
+
+#endif
+
+} // namespace juce
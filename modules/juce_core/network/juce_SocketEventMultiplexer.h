@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Watches a set of sockets and calls a function for each one when it's ready to be
+    read from or written to.
+
+    Rather than having a thread that blocks on each socket, this lets a small number
+    of threads look after a large number of sockets. On Linux it uses epoll, and can
+    share the sockets between several threads. On other platforms it uses poll() on a
+    single thread, which is fine for up to a few hundred sockets.
+
+    The sockets should be put into non-blocking mode (see StreamingSocket::setNonBlocking()),
+    so that reading or writing them in a callback can never hold up the other sockets.
+
+    @code
+    SocketEventMultiplexer multiplexer;
+
+    socket.setNonBlocking (true);
+
+    multiplexer.addSocket (socket.getRawSocketHandle(), SocketEventMultiplexer::readable, [&] (int)
+    {
+        char buffer[4096];
+
+        for (;;)
+        {
+            auto numRead = socket.read (buffer, sizeof (buffer), false);
+
+            if (numRead == 0)
+                break;
+
+            if (numRead < 0)
+            {
+                multiplexer.removeSocket (socket.getRawSocketHandle());
+                break;
+            }
+
+            handleData (buffer, numRead);
+        }
+    });
+    @endcode
+
+    @see StreamingSocket, DatagramSocket
+
+    @tags{Core}
+*/
+class JUCE_API  SocketEventMultiplexer  final
+{
+public:
+    //==============================================================================
+    /** The events that a socket can be watched for. */
+    enum EventFlags
+    {
+        readable = 1,   /**< There's data waiting to be read, the other end has closed the
+                             connection, or (for a listener) a new connection is waiting. */
+        writable = 2,   /**< There's space for more data to be written. */
+        error    = 4    /**< The socket has failed or been shut down. This is always reported,
+                             whether or not it was asked for. */
+    };
+
+    /** The function that's called when a socket is ready. It's passed a combination
+        of EventFlags saying which events happened.
+    */
+    using Callback = std::function<void (int eventFlags)>;
+
+    //==============================================================================
+    /** Creates a multiplexer and starts its threads.
+
+        More than one thread is only useful if the callbacks do a lot of work, and is
+        only supported on Linux; other platforms always use a single thread.
+    */
+    explicit SocketEventMultiplexer (int numThreads = 1);
+
+    /** Destructor.
+        This stops the threads, but doesn't close any sockets that are still being watched.
+    */
+    ~SocketEventMultiplexer();
+
+    //==============================================================================
+    /** Starts watching a socket.
+
+        The callback will be called on one of the multiplexer's threads whenever any of the
+        events are ready. The same socket's callback is never called on more than one thread
+        at once. Events are level-triggered, so if a callback doesn't read all the data that's
+        waiting, it'll be called again straight away.
+
+        @param rawSocketHandle   the socket's handle, from StreamingSocket::getRawSocketHandle()
+                                 or DatagramSocket::getRawSocketHandle()
+        @param eventsToWatch     a combination of EventFlags
+        @param callback          the function to call
+        @returns  false if the socket couldn't be added, e.g. if it's already being watched
+    */
+    bool addSocket (int rawSocketHandle, int eventsToWatch, Callback callback);
+
+    /** Changes the events that a socket is being watched for.
+
+        This is typically used to watch for the writable event only while there's data
+        waiting to be sent. It's fine to call this from the socket's own callback.
+
+        @returns  false if the socket isn't being watched
+    */
+    bool setEventsToWatch (int rawSocketHandle, int eventsToWatch);
+
+    /** Stops watching a socket.
+
+        When this returns, the socket's callback isn't running and won't be called again,
+        so it's safe to close the socket. The exception is when it's called from the
+        socket's own callback, in which case it returns straight away, and the callback
+        won't be called again after it returns.
+
+        Make sure a socket is removed before it's closed, as the system can reuse its
+        handle for another socket.
+    */
+    void removeSocket (int rawSocketHandle);
+
+    /** True if the socket is currently being watched. */
+    bool isWatching (int rawSocketHandle) const;
+
+    /** Returns the number of sockets that are being watched. */
+    int getNumSockets() const;
+
+private:
+    //==============================================================================
+    struct Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SocketEventMultiplexer)
+};
+
+} // namespace juce
@@ -0,0 +1,857 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+XmlPullParser::XmlPullParser (InputStream& sourceStream)
+    : source (&sourceStream)
+{
+}
+
+XmlPullParser::XmlPullParser (std::unique_ptr<InputStream> sourceStream)
+    : ownedStream (std::move (sourceStream)), source (ownedStream.get())
+{
+    jassert (source != nullptr);
+}
+
+XmlPullParser::~XmlPullParser() = default;
+
+void XmlPullParser::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+bool XmlPullParser::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return tagName == possibleTagName;
+}
+
+const String& XmlPullParser::getAttributeName (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return attributes.getReference (index).name;
+
+    static const String empty;
+    return empty;
+}
+
+const String& XmlPullParser::getAttributeValue (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return attributes.getReference (index).value;
+
+    static const String empty;
+    return empty;
+}
+
+String XmlPullParser::getStringAttribute (StringRef attributeName, const String& defaultReturnValue) const
+{
+    for (auto& att : attributes)
+        if (att.name == attributeName)
+            return att.value;
+
+    return defaultReturnValue;
+}
+
+bool XmlPullParser::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (auto& att : attributes)
+        if (att.name == attributeName)
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+bool XmlPullParser::ensureAvailable (size_t numBytes)
+{
+    if (bufferEnd - bufferStart >= numBytes)
+        return true;
+
+    if (bufferStart > 0)
+    {
+        bufferEnd -= bufferStart;
+        memmove (buffer, buffer + bufferStart, bufferEnd);
+        bufferStart = 0;
+    }
+
+    if (numBytes > bufferSize)
+    {
+        bufferSize = jmax (numBytes, (size_t) 32768);
+        buffer.realloc (bufferSize);
+    }
+
+    while (bufferEnd < numBytes && ! streamExhausted)
+    {
+        auto numRead = source->read (buffer + bufferEnd, (int) (bufferSize - bufferEnd));
+
+        if (numRead <= 0)
+            streamExhausted = true;
+        else
+            bufferEnd += (size_t) numRead;
+    }
+
+    return bufferEnd >= numBytes;
+}
+
+int XmlPullParser::peek (size_t offset)
+{
+    return ensureAvailable (offset + 1) ? (int) (uint8) buffer[bufferStart + offset] : -1;
+}
+
+bool XmlPullParser::startsWith (const char* prefix)
+{
+    auto length = strlen (prefix);
+    return ensureAvailable (length) && memcmp (buffer + bufferStart, prefix, length) == 0;
+}
+
+void XmlPullParser::skip (size_t numBytes) noexcept
+{
+    jassert (bufferEnd - bufferStart >= numBytes);
+    bufferStart += numBytes;
+}
+
+bool XmlPullParser::skipUntil (const char* terminator)
+{
+    auto length = strlen (terminator);
+
+    for (;;)
+    {
+        if (! ensureAvailable (length))
+            return false;
+
+        auto* start = buffer + bufferStart;
+        auto numToSearch = bufferEnd - bufferStart - (length - 1);
+
+        for (size_t i = 0; i < numToSearch; ++i)
+        {
+            if (start[i] == terminator[0] && memcmp (start + i, terminator, length) == 0)
+            {
+                skip (i + length);
+                return true;
+            }
+        }
+
+        // keep the last few bytes, as the terminator may straddle the end of the buffer
+        skip (numToSearch);
+    }
+}
+
+void XmlPullParser::skipWhitespace()
+{
+    while (ensureAvailable (1))
+    {
+        auto c = buffer[bufferStart];
+
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            break;
+
+        ++bufferStart;
+    }
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::fail (const String& message)
+{
+    lastError = message;
+    finished = true;
+    currentEvent = EventType::error;
+    tagName.clear();
+    text.clear();
+    attributes.clearQuick();
+    return currentEvent;
+}
+
+XmlPullParser::EventType XmlPullParser::next()
+{
+    if (finished)
+        return currentEvent;
+
+    attributes.clearQuick();
+    text.clear();
+
+    if (pendingEndElement)
+    {
+        // the end of an empty-element tag, e.g. <foo/>
+        pendingEndElement = false;
+        depth = openElements.size();
+        openElements.remove (openElements.size() - 1);
+        currentEvent = EventType::endElement;
+        return currentEvent;
+    }
+
+    if (! headerRead)
+    {
+        headerRead = true;
+
+        if (! readPrologue())
+            return currentEvent;
+
+        return readStartTag();
+    }
+
+    if (openElements.isEmpty())
+    {
+        finished = true;
+        depth = 0;
+        tagName.clear();
+        currentEvent = EventType::endOfDocument;
+        return currentEvent;
+    }
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            return fail ("unmatched tags");
+
+        if (buffer[bufferStart] == '<')
+        {
+            if (startsWith ("</"))
+                return readEndTag();
+
+            if (startsWith ("<![CDATA["))
+                return readCDATA();
+
+            if (! (startsWith ("<!--") || startsWith ("<?")))
+                return readStartTag();
+        }
+
+        if (readCharacterData())
+            return currentEvent;
+    }
+}
+
+bool XmlPullParser::skipElement()
+{
+    if (currentEvent != EventType::startElement)
+        return false;
+
+    auto targetDepth = depth;
+
+    for (;;)
+    {
+        auto event = next();
+
+        if (event == EventType::endElement && depth == targetDepth)
+            return true;
+
+        if (event == EventType::endOfDocument || event == EventType::error)
+            return false;
+    }
+}
+
+//==============================================================================
+bool XmlPullParser::readPrologue()
+{
+    if (! ensureAvailable (3))
+    {
+        if (bufferEnd == bufferStart)
+        {
+            fail ("not enough input");
+            return false;
+        }
+    }
+    else if (CharPointer_UTF8::isByteOrderMark (buffer + bufferStart))
+    {
+        skip (3);
+    }
+    else if (CharPointer_UTF16::isByteOrderMarkBigEndian (buffer + bufferStart)
+              || CharPointer_UTF16::isByteOrderMarkLittleEndian (buffer + bufferStart))
+    {
+        // UTF-16 can't be parsed incrementally, so the whole thing has to be converted first
+        MemoryOutputStream data;
+        data.write (buffer + bufferStart, bufferEnd - bufferStart);
+        data.writeFromInputStream (*source, -1);
+
+        auto convertedText = data.toString();
+
+        bufferStart = bufferEnd = 0;
+        streamExhausted = false;
+        ownedStream = std::make_unique<MemoryInputStream> (MemoryBlock (convertedText.toRawUTF8(), convertedText.getNumBytesAsUTF8()), true);
+        source = ownedStream.get();
+    }
+
+    for (;;)
+    {
+        skipWhitespace();
+
+        if (! ensureAvailable (1))
+        {
+            fail ("not enough input");
+            return false;
+        }
+
+        if (startsWith ("<?"))
+        {
+            if (! skipUntil ("?>"))
+            {
+                fail ("malformed header");
+                return false;
+            }
+        }
+        else if (startsWith ("<!--"))
+        {
+            if (! skipUntil ("-->"))
+            {
+                fail ("not enough input");
+                return false;
+            }
+        }
+        else if (startsWith ("<!DOCTYPE"))
+        {
+            skip (9);
+
+            for (int n = 1; n > 0;)
+            {
+                auto c = peek();
+
+                if (c < 0)
+                {
+                    fail ("malformed DTD");
+                    return false;
+                }
+
+                skip (1);
+
+                if (c == '<')
+                    ++n;
+                else if (c == '>')
+                    --n;
+            }
+        }
+        else if (buffer[bufferStart] == '<')
+        {
+            return true;
+        }
+        else
+        {
+            fail ("illegal character found before the document element");
+            return false;
+        }
+    }
+}
+
+bool XmlPullParser::readIdentifier (String& result)
+{
+    size_t length = 0;
+
+    for (;;)
+    {
+        if (! ensureAvailable (length + 1))
+            break;
+
+        auto c = (uint8) buffer[bufferStart + length];
+
+        if (c < 0x80 && ! XmlIdentifierChars::isIdentifierChar ((juce_wchar) c))
+            break;
+
+        ++length;
+    }
+
+    if (length == 0)
+        return false;
+
+    result = String::fromUTF8 (buffer + bufferStart, (int) length);
+    skip (length);
+    return true;
+}
+
+XmlPullParser::EventType XmlPullParser::readStartTag()
+{
+    skip (1);
+
+    if (! readIdentifier (tagName))
+    {
+        // no tag name - but allow for a gap after the '<' before giving an error
+        skipWhitespace();
+
+        if (! readIdentifier (tagName))
+            return fail ("tag name missing");
+    }
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = peek();
+
+        if (c < 0)
+            return fail ("unmatched tags");
+
+        // empty tag
+        if (c == '/' && peek (1) == '>')
+        {
+            skip (2);
+            pendingEndElement = true;
+            break;
+        }
+
+        if (c == '>')
+        {
+            skip (1);
+            break;
+        }
+
+        Attribute att;
+
+        if (c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c))
+        {
+            readIdentifier (att.name);
+            skipWhitespace();
+
+            if (peek() != '=')
+                return fail ("expected '=' after attribute '" + att.name + "'");
+
+            skip (1);
+            skipWhitespace();
+
+            auto quote = peek();
+
+            if (quote != '"' && quote != '\'')
+                return fail ("expected a quoted value for attribute '" + att.name + "'");
+
+            if (! readQuotedValue (att.value))
+                return fail ("unmatched quotes");
+
+            attributes.add (std::move (att));
+            continue;
+        }
+
+        return fail ("illegal character found in " + tagName + ": '" + String::charToString ((juce_wchar) c) + "'");
+    }
+
+    openElements.add (tagName);
+    depth = openElements.size();
+    currentEvent = EventType::startElement;
+    return currentEvent;
+}
+
+XmlPullParser::EventType XmlPullParser::readEndTag()
+{
+    if (! skipUntil (">"))
+        return fail ("unmatched tags");
+
+    // like XmlDocument, this doesn't check that the closing tag's name matches
+    depth = openElements.size();
+    tagName = openElements[depth - 1];
+    openElements.remove (openElements.size() - 1);
+    currentEvent = EventType::endElement;
+    return currentEvent;
+}
+
+XmlPullParser::EventType XmlPullParser::readCDATA()
+{
+    skip (9);
+    scratch.reset();
+
+    for (;;)
+    {
+        if (! ensureAvailable (3))
+            return fail ("unterminated CDATA section");
+
+        auto* start = buffer + bufferStart;
+        auto numToSearch = bufferEnd - bufferStart - 2;
+        size_t i = 0;
+
+        while (i < numToSearch && ! (start[i] == ']' && start[i + 1] == ']' && start[i + 2] == '>'))
+            ++i;
+
+        scratch.write (start, i);
+        skip (i);
+
+        if (i < numToSearch)
+        {
+            skip (3);
+            break;
+        }
+    }
+
+    text = scratch.toUTF8();
+    depth = openElements.size();
+    tagName.clear();
+    currentEvent = EventType::text;
+    return currentEvent;
+}
+
+bool XmlPullParser::readCharacterData()
+{
+    scratch.reset();
+    bool contentShouldBeUsed = ! ignoreEmptyTextElements;
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+        {
+            fail ("unmatched tags");
+            return true;
+        }
+
+        auto* start = buffer + bufferStart;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end)
+        {
+            auto c = *p;
+
+            if (c == '<' || c == '&' || c == '\r')
+                break;
+
+            if (! contentShouldBeUsed && c != ' ' && c != '\t' && c != '\n')
+                contentShouldBeUsed = true;
+
+            ++p;
+        }
+
+        scratch.write (start, (size_t) (p - start));
+        skip ((size_t) (p - start));
+
+        if (p == end)
+            continue;
+
+        auto c = *p;
+
+        if (c == '\r')
+        {
+            skip (1);
+
+            if (peek() != '\n')
+                scratch.writeByte ('\n');
+        }
+        else if (c == '&')
+        {
+            auto oldSize = scratch.getDataSize();
+            readEntity (scratch);
+
+            if (! contentShouldBeUsed)
+            {
+                for (auto i = oldSize; i < scratch.getDataSize(); ++i)
+                {
+                    auto e = static_cast<const char*> (scratch.getData())[i];
+
+                    if (e != ' ' && e != '\t' && e != '\n' && e != '\r')
+                        contentShouldBeUsed = true;
+                }
+            }
+        }
+        else if (startsWith ("<!--"))
+        {
+            skip (4);
+
+            if (! skipUntil ("-->"))
+            {
+                fail ("unterminated comment");
+                return true;
+            }
+        }
+        else if (startsWith ("<?"))
+        {
+            skip (2);
+
+            if (! skipUntil ("?>"))
+            {
+                fail ("unterminated processing instruction");
+                return true;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (! contentShouldBeUsed)
+        return false;
+
+    text = scratch.toUTF8();
+    depth = openElements.size();
+    tagName.clear();
+    currentEvent = EventType::text;
+    return true;
+}
+
+bool XmlPullParser::readQuotedValue (String& result)
+{
+    auto quote = (char) peek();
+    skip (1);
+    scratch.reset();
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            return false;
+
+        auto* start = buffer + bufferStart;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end && *p != quote && *p != '&')
+            ++p;
+
+        scratch.write (start, (size_t) (p - start));
+        skip ((size_t) (p - start));
+
+        if (p == end)
+            continue;
+
+        if (*p == quote)
+        {
+            skip (1);
+            break;
+        }
+
+        readEntity (scratch);
+    }
+
+    result = scratch.toUTF8();
+    return true;
+}
+
+void XmlPullParser::readEntity (MemoryOutputStream& dest)
+{
+    // entities are short, so it's enough to look for the semicolon in a small window
+    constexpr size_t maxEntityLength = 32;
+    ensureAvailable (maxEntityLength);
+
+    auto* start = buffer + bufferStart;
+    auto available = jmin (bufferEnd - bufferStart, maxEntityLength);
+    size_t semiColon = 1;
+
+    while (semiColon < available && start[semiColon] != ';')
+        ++semiColon;
+
+    if (semiColon >= available)
+    {
+        lastError = "unterminated entity";
+        dest.writeByte ('&');
+        skip (1);
+        return;
+    }
+
+    auto name = CharPointer_UTF8 (start + 1);
+    auto nameLength = (int) semiColon - 1;
+
+    auto nameIs = [&] (const char* entityName)
+    {
+        return (int) strlen (entityName) == nameLength
+                && name.compareIgnoreCaseUpTo (CharPointer_ASCII (entityName), nameLength) == 0;
+    };
+
+    if      (nameIs ("amp"))   dest.writeByte ('&');
+    else if (nameIs ("quot"))  dest.writeByte ('"');
+    else if (nameIs ("apos"))  dest.writeByte ('\'');
+    else if (nameIs ("lt"))    dest.writeByte ('<');
+    else if (nameIs ("gt"))    dest.writeByte ('>');
+    else if (nameLength > 1 && start[1] == '#')
+    {
+        const bool isHex = (start[2] == 'x' || start[2] == 'X');
+        int64 charCode = 0;
+        bool isValid = nameLength > (isHex ? 2 : 1);
+
+        for (auto i = (size_t) (isHex ? 3 : 2); i < semiColon && isValid; ++i)
+        {
+            auto digit = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) start[i])
+                               : (start[i] >= '0' && start[i] <= '9' ? start[i] - '0' : -1);
+
+            isValid = digit >= 0 && charCode <= 0x10ffff;
+            charCode = charCode * (isHex ? 16 : 10) + digit;
+        }
+
+        if (isValid && charCode > 0 && charCode <= 0x10ffff)
+        {
+            dest.appendUTF8Char ((juce_wchar) charCode);
+        }
+        else
+        {
+            lastError = "illegal escape sequence";
+            dest.write (start, semiColon + 1);
+        }
+    }
+    else
+    {
+        // entities declared in a DTD aren't supported, so pass it through unchanged
+        lastError = "unknown entity";
+        dest.write (start, semiColon + 1);
+    }
+
+    skip (semiColon + 1);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlPullParserTests final : public UnitTest
+{
+public:
+    XmlPullParserTests()
+        : UnitTest ("XmlPullParser", UnitTestCategories::xml)
+    {}
+
+    static String describeEvents (const String& xml, bool ignoreEmptyText = true)
+    {
+        MemoryInputStream in (xml.toRawUTF8(), xml.getNumBytesAsUTF8(), false);
+        XmlPullParser parser (in);
+        parser.setEmptyTextElementsIgnored (ignoreEmptyText);
+        String result;
+
+        for (;;)
+        {
+            switch (parser.next())
+            {
+                case XmlPullParser::EventType::startElement:
+                    result << "<" << parser.getTagName();
+
+                    for (int i = 0; i < parser.getNumAttributes(); ++i)
+                        result << " " << parser.getAttributeName (i) << "=[" << parser.getAttributeValue (i) << "]";
+
+                    result << ":" << parser.getDepth() << ">";
+                    break;
+
+                case XmlPullParser::EventType::endElement:
+                    result << "</" << parser.getTagName() << ":" << parser.getDepth() << ">";
+                    break;
+
+                case XmlPullParser::EventType::text:
+                    result << "[" << parser.getText() << "]";
+                    break;
+
+                case XmlPullParser::EventType::endOfDocument:
+                    return result;
+
+                case XmlPullParser::EventType::error:
+                    return result + "ERROR: " + parser.getLastParseError();
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events");
+        {
+            expectEquals (describeEvents ("<a/>"), String ("<a:1></a:1>"));
+
+            expectEquals (describeEvents ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                          "<!DOCTYPE foo [ <!ELEMENT a ANY> ]>\n"
+                                          "<!-- comment -->\n"
+                                          "<a x=\"1\" y='two'>\n"
+                                          "  <b>hello<!-- c -->, world</b>\n"
+                                          "  <c/>\n"
+                                          "  <![CDATA[<raw> & stuff]]>\n"
+                                          "</a>\n"
+                                          "trailing junk"),
+                          String ("<a x=[1] y=[two]:1><b:2>[hello, world]</b:2><c:2></c:2>[<raw> & stuff]</a:1>"));
+
+            expectEquals (describeEvents ("<a> <b/> </a>", false),
+                          String ("<a:1>[ ]<b:2></b:2>[ ]</a:1>"));
+        }
+
+        beginTest ("Entities");
+        {
+            expectEquals (describeEvents ("<a v=\"&lt;&amp;&gt;&quot;&apos;\">&#65;&#x42;&#x20AC;\r\nx&unknown;</a>"),
+                          String ("<a v=[<&>\"']:1>[AB") + String (CharPointer_UTF8 ("\xe2\x82\xac")) + "\nx&unknown;]</a:1>");
+        }
+
+        beginTest ("Errors");
+        {
+            expect (describeEvents ("").endsWith ("ERROR: not enough input"));
+            expect (describeEvents ("<a><b></a>").endsWith ("ERROR: unmatched tags"));
+            expect (describeEvents ("<a x=\"1></a>").endsWith ("ERROR: unmatched quotes"));
+            expect (describeEvents ("<a x></a>").endsWith ("ERROR: expected '=' after attribute 'x'"));
+            expect (describeEvents ("< >").endsWith ("ERROR: tag name missing"));
+            expect (describeEvents ("<a><![CDATA[abc</a>").endsWith ("ERROR: unterminated CDATA section"));
+        }
+
+        beginTest ("Skipping elements");
+        {
+            String xml ("<root><skip a=\"1\"><x><y/></x>text</skip><keep/></root>");
+            MemoryInputStream in (xml.toRawUTF8(), xml.getNumBytesAsUTF8(), false);
+            XmlPullParser parser (in);
+
+            expect (parser.next() == XmlPullParser::EventType::startElement);
+            expect (parser.next() == XmlPullParser::EventType::startElement);
+            expect (parser.hasTagName ("skip"));
+            expectEquals (parser.getStringAttribute ("a"), String ("1"));
+            expect (parser.skipElement());
+            expect (parser.next() == XmlPullParser::EventType::startElement);
+            expect (parser.hasTagName ("keep"));
+        }
+
+        beginTest ("Matches XmlDocument for large documents");
+        {
+            XmlElement root ("root");
+            Random r (1234);
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                auto* child = root.createNewChildElement ("item" + String (i % 7));
+                child->setAttribute ("index", i);
+                child->setAttribute ("name", "a & b < c " + String (r.nextInt64()));
+                child->addTextElement ("text " + String (i) + " " + String (CharPointer_UTF8 ("\xe2\x82\xac")));
+            }
+
+            auto text = root.toString();
+            MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+            BufferedInputStream buffered (in, 17);
+            XmlPullParser parser (buffered);
+
+            auto doc = parseXML (text);
+            expect (doc != nullptr);
+
+            expect (parser.next() == XmlPullParser::EventType::startElement);
+            expect (parser.hasTagName ("root"));
+
+            for (auto* child : doc->getChildIterator())
+            {
+                expect (parser.next() == XmlPullParser::EventType::startElement);
+                expectEquals (parser.getTagName(), child->getTagName());
+                expectEquals (parser.getStringAttribute ("index"), child->getStringAttribute ("index"));
+                expectEquals (parser.getStringAttribute ("name"), child->getStringAttribute ("name"));
+                expect (parser.next() == XmlPullParser::EventType::text);
+                expectEquals (parser.getText(), child->getAllSubText());
+                expect (parser.next() == XmlPullParser::EventType::endElement);
+            }
+
+            expect (parser.next() == XmlPullParser::EventType::endElement);
+            expect (parser.next() == XmlPullParser::EventType::endOfDocument);
+            expect (parser.getLastParseError().isEmpty());
+        }
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
+
+} // namespace juce
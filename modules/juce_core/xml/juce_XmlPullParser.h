@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A streaming, pull-style XML parser that reads from an InputStream.
+
+    Unlike XmlDocument, this class never holds the whole document in memory and
+    doesn't build an XmlElement tree. Instead, each call to next() reads just enough
+    of the stream to produce the next event (the start or end of an element, or a
+    block of text), so the memory used is bounded by the size of the largest single
+    tag or text block rather than the size of the document.
+
+    e.g.
+    @code
+    FileInputStream in (myFile);
+    XmlPullParser parser (in);
+
+    for (;;)
+    {
+        auto event = parser.next();
+
+        if (event == XmlPullParser::EventType::startElement)
+            DBG ("<" << parser.getTagName() << "> at depth " << parser.getDepth());
+        else if (event == XmlPullParser::EventType::text)
+            DBG (parser.getText());
+        else if (event != XmlPullParser::EventType::endElement)
+            break;
+    }
+
+    if (parser.getLastParseError().isNotEmpty())
+        DBG (parser.getLastParseError());
+    @endcode
+
+    The parser is as lenient as XmlDocument: it skips the header, comments, processing
+    instructions and any DTD, and it doesn't check that closing tags match their opening
+    tags. The standard character entities and numeric character references are expanded,
+    but entities declared in a DTD aren't loaded, so any other entity references are
+    passed through to the text unchanged.
+
+    The stream is expected to contain UTF-8. If it starts with a UTF-16 byte-order mark,
+    the parser has to read the whole stream before it can begin, because the text must
+    be converted first.
+
+    @see XmlDocument, ValueTree::fromXml
+
+    @tags{Core}
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser that reads from a stream.
+        The stream must remain valid for the lifetime of this object.
+    */
+    explicit XmlPullParser (InputStream& sourceStream);
+
+    /** Creates a parser that reads from a stream, taking ownership of it. */
+    explicit XmlPullParser (std::unique_ptr<InputStream> sourceStream);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The types of event that next() can return. */
+    enum class EventType
+    {
+        startElement,   /**< An opening tag was read. Use getTagName() and the attribute methods to inspect it. */
+        endElement,     /**< A closing tag was read, or the end of an empty-element tag such as <foo/>. */
+        text,           /**< A block of character data or a CDATA section was read. Use getText() to get its content. */
+        endOfDocument,  /**< The outer element has been closed, so there's nothing more to read. */
+        error           /**< The document is malformed. Use getLastParseError() to find out why. */
+    };
+
+    /** Reads the next event from the stream.
+        Once this has returned endOfDocument or error, it will continue to return
+        that value for all subsequent calls.
+    */
+    EventType next();
+
+    /** Returns the type of the event that was most recently returned by next(). */
+    EventType getEventType() const noexcept             { return currentEvent; }
+
+    /** Returns the nesting level of the current element.
+        The outer document element has a depth of 1, its children have a depth of 2, etc.
+        For an endElement event, this is the depth of the element being closed.
+    */
+    int getDepth() const noexcept                       { return depth; }
+
+    /** For startElement and endElement events, returns the tag name of the element. */
+    const String& getTagName() const noexcept           { return tagName; }
+
+    /** Returns true if the current startElement or endElement event has the given tag name. */
+    bool hasTagName (StringRef possibleTagName) const noexcept;
+
+    /** For text events, returns the text content, with any entities expanded. */
+    const String& getText() const noexcept              { return text; }
+
+    //==============================================================================
+    /** For startElement events, returns the number of attributes the element has. */
+    int getNumAttributes() const noexcept               { return attributes.size(); }
+
+    /** For startElement events, returns the name of one of the element's attributes. */
+    const String& getAttributeName (int index) const noexcept;
+
+    /** For startElement events, returns the value of one of the element's attributes. */
+    const String& getAttributeValue (int index) const noexcept;
+
+    /** For startElement events, returns the value of a named attribute, or a default
+        value if the element doesn't have an attribute with that name.
+    */
+    String getStringAttribute (StringRef attributeName, const String& defaultReturnValue = {}) const;
+
+    /** For startElement events, returns true if the element has an attribute with the given name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    //==============================================================================
+    /** Skips the remainder of the element that was opened by the current startElement event.
+
+        After this returns true, the current event will be the endElement that matches it,
+        so calling next() will continue with whatever follows the element.
+        If the current event isn't a startElement, this does nothing and returns false.
+    */
+    bool skipElement();
+
+    /** Returns the error from the most recent parse failure, or an empty string if
+        no error has occurred.
+    */
+    const String& getLastParseError() const noexcept    { return lastError; }
+
+    /** Sets a flag to change the treatment of empty text elements.
+
+        If this is true (the default state), then any text blocks that contain only
+        whitespace characters won't produce text events. If you need to catch
+        whitespace-only text, you should set this to false before starting to parse.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+private:
+    //==============================================================================
+    struct Attribute
+    {
+        String name, value;
+    };
+
+    std::unique_ptr<InputStream> ownedStream;
+    InputStream* source;
+    HeapBlock<char> buffer;
+    size_t bufferSize = 0, bufferStart = 0, bufferEnd = 0;
+    bool streamExhausted = false, headerRead = false, pendingEndElement = false;
+    bool finished = false, ignoreEmptyTextElements = true;
+
+    EventType currentEvent = EventType::text;
+    int depth = 0;
+    String tagName, text, lastError;
+    Array<Attribute> attributes;
+    StringArray openElements;
+    MemoryOutputStream scratch;
+
+    bool ensureAvailable (size_t numBytes);
+    int peek (size_t offset = 0);
+    bool startsWith (const char* prefix);
+    void skip (size_t numBytes) noexcept;
+    bool skipUntil (const char* terminator);
+    void skipWhitespace();
+
+    EventType fail (const String& message);
+    bool readPrologue();
+    bool readIdentifier (String& result);
+    EventType readStartTag();
+    EventType readEndTag();
+    bool readCharacterData();
+    EventType readCDATA();
+    bool readQuotedValue (String& result);
+    void readEntity (MemoryOutputStream& dest);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+} // namespace juce
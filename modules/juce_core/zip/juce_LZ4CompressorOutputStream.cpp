@@ -0,0 +1,640 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace LZ4Helpers
+{
+    /*  Compresses blocks of data in the LZ4 block format.
+
+        At level 1 this uses a single-entry hash table and skips ahead faster through
+        data that isn't compressing, in the same way as the reference LZ4 encoder's fast
+        mode. Higher levels keep a chain of all the previous positions with the same hash,
+        and search progressively more of it for the longest match.
+    */
+    struct BlockCompressor
+    {
+        static int getMaxCompressedSize (int numBytes) noexcept     { return numBytes + numBytes / 255 + 16; }
+
+        // The destination must have space for at least getMaxCompressedSize (srcSize) bytes.
+        int compress (const uint8* src, int srcSize, uint8* dest, int level) noexcept
+        {
+            auto op = dest;
+            int anchor = 0;
+
+            if (srcSize > matchFindLimit)
+            {
+                const auto useChain = level > 1;
+                const auto hashBits = useChain ? 16 : 13;
+                const auto maxAttempts = useChain ? (1 << (level - 1)) : 1;
+                const auto matchLimit = srcSize - lastLiterals;
+                const auto lastMatchStart = srcSize - matchFindLimit;
+
+                std::fill (head.get(), head.get() + (1 << hashBits), -1);
+
+                const auto hashAt = [&] (int pos)
+                {
+                    return (int) ((read32 (src + pos) * 2654435761u) >> (32 - hashBits));
+                };
+
+                int ip = 0, nextToInsert = 0, numMisses = 0;
+
+                while (ip <= lastMatchStart)
+                {
+                    int candidate;
+
+                    if (useChain)
+                    {
+                        for (; nextToInsert < ip; ++nextToInsert)
+                        {
+                            auto h = hashAt (nextToInsert);
+                            auto previous = head[h];
+                            chain[nextToInsert & 0xffff] = (uint16) ((previous >= 0 && nextToInsert - previous <= maxOffset) ? nextToInsert - previous : 0);
+                            head[h] = nextToInsert;
+                        }
+
+                        candidate = head[hashAt (ip)];
+                    }
+                    else
+                    {
+                        auto h = hashAt (ip);
+                        candidate = head[h];
+                        head[h] = ip;
+                    }
+
+                    int bestLength = 0, bestPos = 0;
+
+                    for (int attempts = maxAttempts; candidate >= 0 && ip - candidate <= maxOffset && --attempts >= 0;)
+                    {
+                        if (read32 (src + candidate) == read32 (src + ip))
+                        {
+                            auto length = minMatch + countMatch (src + ip + minMatch, src + candidate + minMatch, src + matchLimit);
+
+                            if (length > bestLength)
+                            {
+                                bestLength = length;
+                                bestPos = candidate;
+
+                                if (ip + length >= matchLimit)
+                                    break;
+                            }
+                        }
+
+                        if (! useChain)
+                            break;
+
+                        auto delta = chain[candidate & 0xffff];
+
+                        if (delta == 0)
+                            break;
+
+                        candidate -= delta;
+                    }
+
+                    if (bestLength < minMatch)
+                    {
+                        ip += useChain ? 1 : 1 + (numMisses++ >> 6);
+                        continue;
+                    }
+
+                    numMisses = 0;
+
+                    while (ip > anchor && bestPos > 0 && src[ip - 1] == src[bestPos - 1])
+                    {
+                        --ip;
+                        --bestPos;
+                        ++bestLength;
+                    }
+
+                    op = writeSequence (op, src + anchor, ip - anchor, ip - bestPos, bestLength);
+                    ip += bestLength;
+                    anchor = ip;
+
+                    if (! useChain && ip - 2 <= lastMatchStart)
+                        head[hashAt (ip - 2)] = ip - 2;
+                }
+            }
+
+            return (int) (writeLiterals (op, src + anchor, srcSize - anchor) - dest);
+        }
+
+    private:
+        HeapBlock<int> head { 1 << 16 };
+        HeapBlock<uint16> chain { (int) historySize };
+
+        static uint32 read32 (const uint8* p) noexcept
+        {
+            uint32 v;
+            memcpy (&v, p, sizeof (v));
+            return v;
+        }
+
+        static int countMatch (const uint8* p, const uint8* match, const uint8* limit) noexcept
+        {
+            const auto start = p;
+
+            while (p + 8 <= limit)
+            {
+                uint64 a, b;
+                memcpy (&a, p, 8);
+                memcpy (&b, match, 8);
+
+                if (a != b)
+                    break;
+
+                p += 8;
+                match += 8;
+            }
+
+            while (p < limit && *p == *match)
+            {
+                ++p;
+                ++match;
+            }
+
+            return (int) (p - start);
+        }
+
+        static uint8* writeExtraLength (uint8* op, int length) noexcept
+        {
+            for (length -= 15; length >= 255; length -= 255)
+                *op++ = 255;
+
+            *op++ = (uint8) length;
+            return op;
+        }
+
+        static uint8* writeLiterals (uint8* op, const uint8* literals, int numLiterals) noexcept
+        {
+            *op++ = (uint8) (jmin (numLiterals, 15) << 4);
+
+            if (numLiterals >= 15)
+                op = writeExtraLength (op, numLiterals);
+
+            memcpy (op, literals, (size_t) numLiterals);
+            return op + numLiterals;
+        }
+
+        static uint8* writeSequence (uint8* op, const uint8* literals, int numLiterals, int offset, int matchLength) noexcept
+        {
+            auto token = op;
+            op = writeLiterals (op, literals, numLiterals);
+
+            *op++ = (uint8) offset;
+            *op++ = (uint8) (offset >> 8);
+
+            matchLength -= minMatch;
+            *token |= (uint8) jmin (matchLength, 15);
+
+            return matchLength >= 15 ? writeExtraLength (op, matchLength) : op;
+        }
+    };
+}
+
+//==============================================================================
+class LZ4CompressorOutputStream::LZ4CompressorHelper
+{
+public:
+    LZ4CompressorHelper (const LZ4CompressorOptions& o)
+        : options (o),
+          blockSize (LZ4CompressorOptions::getNumBytesInBlock (o.getBlockSize())),
+          numBlocksPerBatch (o.getNumThreads() > 1 ? o.getNumThreads() * 2 : 1)
+    {
+        for (int i = 0; i < numBlocksPerBatch; ++i)
+            blocks.add (new Block (blockSize));
+
+        for (int i = 0; i < o.getNumThreads(); ++i)
+            compressors.add (new LZ4Helpers::BlockCompressor());
+
+        if (o.getNumThreads() > 1)
+            pool = std::make_unique<ThreadPool> (ThreadPoolOptions{}.withThreadName ("LZ4 compressor")
+                                                                    .withNumberOfThreads (o.getNumThreads() - 1));
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on an LZ4 stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        if (! (hasWrittenHeader || writeFrameHeader (out)))
+            return false;
+
+        if (options.getContentChecksum())
+            contentHash.update (data, dataSize);
+
+        while (dataSize > 0)
+        {
+            auto& block = *blocks.getUnchecked (numBlocksFilled);
+            auto numToCopy = (int) jmin (dataSize, (size_t) (blockSize - block.numInputBytes));
+
+            memcpy (block.input + block.numInputBytes, data, (size_t) numToCopy);
+            block.numInputBytes += numToCopy;
+            data += numToCopy;
+            dataSize -= (size_t) numToCopy;
+
+            if (block.numInputBytes == blockSize && ++numBlocksFilled == numBlocksPerBatch)
+                if (! writeBlocks (out))
+                    return false;
+        }
+
+        return true;
+    }
+
+    bool finish (OutputStream& out)
+    {
+        if (finished)
+            return true;
+
+        finished = true;
+
+        if (! (hasWrittenHeader || writeFrameHeader (out)))
+            return false;
+
+        if (blocks.getUnchecked (numBlocksFilled)->numInputBytes > 0)
+            ++numBlocksFilled;
+
+        if (! (writeBlocks (out) && out.writeInt (0)))
+            return false;
+
+        if (options.getContentChecksum() && ! out.writeInt ((int) contentHash.getHash()))
+            return false;
+
+        if (options.getSeekTable())
+        {
+            // The seek table is stored in a skippable frame, with the same layout as the
+            // seek table used by zstd's seekable format, but with each entry referring to
+            // a block rather than a separate frame.
+            auto numBlocks = (int) seekTable.getDataSize() / 8;
+
+            return out.writeInt ((int) LZ4Helpers::seekTableFrameMagic)
+                && out.writeInt ((int) seekTable.getDataSize() + LZ4Helpers::seekTableFooterSize)
+                && out.write (seekTable.getData(), seekTable.getDataSize())
+                && out.writeInt (numBlocks)
+                && out.writeByte (0)
+                && out.writeInt ((int) LZ4Helpers::seekTableFooterMagic);
+        }
+
+        return true;
+    }
+
+private:
+    struct Block
+    {
+        explicit Block (int size)
+            : input ((size_t) size),
+              output ((size_t) LZ4Helpers::BlockCompressor::getMaxCompressedSize (size))
+        {}
+
+        void compress (LZ4Helpers::BlockCompressor& compressor, int level) noexcept
+        {
+            numOutputBytes = compressor.compress (input, numInputBytes, output, level);
+        }
+
+        bool writeTo (OutputStream& out) const
+        {
+            if (numOutputBytes < numInputBytes)
+                return out.writeInt (numOutputBytes) && out.write (output, (size_t) numOutputBytes);
+
+            return out.writeInt ((int) ((uint32) numInputBytes | LZ4Helpers::uncompressedBlockFlag))
+                && out.write (input, (size_t) numInputBytes);
+        }
+
+        int getNumBytesWritten() const noexcept     { return 4 + jmin (numInputBytes, numOutputBytes); }
+
+        HeapBlock<uint8> input, output;
+        int numInputBytes = 0, numOutputBytes = 0;
+    };
+
+    const LZ4CompressorOptions options;
+    const int blockSize, numBlocksPerBatch;
+    OwnedArray<Block> blocks;
+    OwnedArray<LZ4Helpers::BlockCompressor> compressors;
+    std::unique_ptr<ThreadPool> pool;
+    int numBlocksFilled = 0;
+    bool hasWrittenHeader = false, finished = false;
+    LZ4Helpers::XXHash32 contentHash;
+    MemoryOutputStream seekTable;
+
+    bool writeFrameHeader (OutputStream& out)
+    {
+        hasWrittenHeader = true;
+
+        // version 01, with independent blocks
+        const uint8 descriptor[] = { (uint8) (0x60 | (options.getContentChecksum() ? 0x04 : 0)),
+                                     (uint8) ((int) options.getBlockSize() << 4) };
+
+        return out.writeInt ((int) LZ4Helpers::frameMagic)
+            && out.write (descriptor, sizeof (descriptor))
+            && out.writeByte ((char) (uint8) (LZ4Helpers::XXHash32::calculate (descriptor, sizeof (descriptor)) >> 8));
+    }
+
+    void compressBlocks()
+    {
+        std::atomic<int> nextBlock { 0 };
+
+        const auto compressNextBlocks = [&] (LZ4Helpers::BlockCompressor& compressor)
+        {
+            for (int i; (i = nextBlock++) < numBlocksFilled;)
+                blocks.getUnchecked (i)->compress (compressor, options.getCompressionLevel());
+        };
+
+        const auto numExtraThreads = jmin (compressors.size(), numBlocksFilled) - 1;
+
+        if (numExtraThreads <= 0)
+        {
+            compressNextBlocks (*compressors.getUnchecked (0));
+            return;
+        }
+
+        WaitableEvent allThreadsFinished;
+        std::atomic<int> numThreadsRunning { numExtraThreads };
+
+        for (int i = 1; i <= numExtraThreads; ++i)
+        {
+            pool->addJob ([&, i]
+            {
+                compressNextBlocks (*compressors.getUnchecked (i));
+
+                if (--numThreadsRunning == 0)
+                    allThreadsFinished.signal();
+            });
+        }
+
+        compressNextBlocks (*compressors.getUnchecked (0));
+        allThreadsFinished.wait();
+    }
+
+    bool writeBlocks (OutputStream& out)
+    {
+        compressBlocks();
+
+        for (int i = 0; i < numBlocksFilled; ++i)
+        {
+            auto& block = *blocks.getUnchecked (i);
+
+            if (! block.writeTo (out))
+                return false;
+
+            if (options.getSeekTable())
+            {
+                seekTable.writeInt (block.getNumBytesWritten());
+                seekTable.writeInt (block.numInputBytes);
+            }
+
+            block.numInputBytes = 0;
+        }
+
+        numBlocksFilled = 0;
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LZ4CompressorHelper)
+};
+
+//==============================================================================
+LZ4CompressorOutputStream::LZ4CompressorOutputStream (OutputStream& s, const LZ4CompressorOptions& options)
+    : LZ4CompressorOutputStream (&s, false, options)
+{
+}
+
+LZ4CompressorOutputStream::LZ4CompressorOutputStream (OutputStream* out, bool deleteDestStream, const LZ4CompressorOptions& options)
+    : destStream (out, deleteDestStream),
+      helper (new LZ4CompressorHelper (options))
+{
+    jassert (out != nullptr);
+}
+
+LZ4CompressorOutputStream::~LZ4CompressorOutputStream()
+{
+    flush();
+}
+
+void LZ4CompressorOutputStream::flush()
+{
+    helper->finish (*destStream);
+    destStream->flush();
+}
+
+bool LZ4CompressorOutputStream::write (const void* destBuffer, size_t howMany)
+{
+    jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
+
+    return helper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
+}
+
+int64 LZ4CompressorOutputStream::getPosition()
+{
+    return destStream->getPosition();
+}
+
+bool LZ4CompressorOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct LZ4Tests final : public UnitTest
+{
+    LZ4Tests()
+        : UnitTest ("LZ4", UnitTestCategories::compression)
+    {}
+
+    static MemoryBlock createTestData (Random& rng, int size)
+    {
+        // a mixture of repetitive text and noise, so that some blocks compress and some don't
+        MemoryOutputStream out;
+        const char* const words[] = { "sample", "buffer", "audio", "plugin", "parameter", "state", " ", "\n" };
+
+        while ((int) out.getDataSize() < size)
+        {
+            if (rng.nextInt (20) == 0)
+            {
+                for (int i = rng.nextInt (500); --i >= 0;)
+                    out.writeByte ((char) rng.nextInt (256));
+            }
+            else if (rng.nextInt (10) == 0)
+            {
+                auto offset = rng.nextInt (jmax (1, (int) out.getDataSize()));
+                auto length = rng.nextInt (300);
+                MemoryBlock copy (static_cast<const char*> (out.getData()) + offset,
+                                  (size_t) jmin (length, (int) out.getDataSize() - offset));
+                out << copy;
+            }
+            else
+            {
+                out << words[rng.nextInt (numElementsInArray (words))];
+            }
+        }
+
+        auto result = out.getMemoryBlock();
+        result.setSize ((size_t) size);
+        return result;
+    }
+
+    static MemoryBlock compress (const MemoryBlock& data, const LZ4CompressorOptions& options, Random& rng)
+    {
+        MemoryOutputStream compressed;
+
+        {
+            LZ4CompressorOutputStream lz4 (compressed, options);
+
+            for (size_t pos = 0; pos < data.getSize();)
+            {
+                auto numToWrite = jmin (data.getSize() - pos, (size_t) rng.nextInt (100000) + 1);
+                lz4.write (static_cast<const char*> (data.getData()) + pos, numToWrite);
+                pos += numToWrite;
+            }
+        }
+
+        return compressed.getMemoryBlock();
+    }
+
+    void runTest() override
+    {
+        auto rng = getRandom();
+
+        beginTest ("Round trip");
+        {
+            for (int i = 0; i < 40; ++i)
+            {
+                auto data = createTestData (rng, rng.nextInt (i < 10 ? 50 : 400000));
+                auto options = LZ4CompressorOptions{}.withCompressionLevel (rng.nextInt ({ 1, 10 }))
+                                                     .withBlockSize ((LZ4CompressorOptions::BlockSize) rng.nextInt ({ 4, 7 }))
+                                                     .withNumThreads (rng.nextInt ({ 1, 4 }))
+                                                     .withContentChecksum (rng.nextBool())
+                                                     .withSeekTable (rng.nextBool());
+
+                auto compressed = compress (data, options, rng);
+
+                MemoryInputStream compressedInput (compressed, false);
+                LZ4DecompressorInputStream lz4 (compressedInput);
+
+                MemoryOutputStream uncompressed;
+                uncompressed << lz4;
+
+                expect (! lz4.hasError());
+                expect (lz4.isExhausted());
+                expect (uncompressed.getMemoryBlock() == data);
+            }
+        }
+
+        beginTest ("Compression levels");
+        {
+            auto data = createTestData (rng, 300000);
+            size_t previousSize = 0;
+
+            for (int level : { 9, 1 })
+            {
+                auto compressed = compress (data, LZ4CompressorOptions{}.withCompressionLevel (level), rng);
+
+                expect (compressed.getSize() < data.getSize() * 3 / 4);
+                expect (compressed.getSize() >= previousSize);
+                previousSize = compressed.getSize();
+            }
+        }
+
+        beginTest ("Multi-threaded output is identical");
+        {
+            auto data = createTestData (rng, 1000000);
+            auto options = LZ4CompressorOptions{}.withCompressionLevel (3);
+
+            expect (compress (data, options, rng) == compress (data, options.withNumThreads (4), rng));
+        }
+
+        beginTest ("Random access");
+        {
+            auto data = createTestData (rng, 500000);
+            auto compressed = compress (data, LZ4CompressorOptions{}.withNumThreads (2), rng);
+
+            MemoryInputStream compressedInput (compressed, false);
+            LZ4DecompressorInputStream lz4 (compressedInput);
+
+            expectEquals (lz4.getTotalLength(), (int64) data.getSize());
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto pos = rng.nextInt ((int) data.getSize());
+                auto numBytes = jmin (rng.nextInt (100000), (int) data.getSize() - pos);
+                MemoryBlock buffer ((size_t) numBytes);
+
+                expect (lz4.setPosition (pos));
+                expectEquals (lz4.getPosition(), (int64) pos);
+                expectEquals (lz4.read (buffer.getData(), numBytes), numBytes);
+                expect (memcmp (buffer.getData(), static_cast<const char*> (data.getData()) + pos, (size_t) numBytes) == 0);
+            }
+
+            expect (lz4.setPosition ((int64) data.getSize()));
+            expect (lz4.isExhausted());
+            expect (! lz4.hasError());
+
+            // without a seek table, seeking has to decompress from the start
+            auto withoutTable = compress (data, LZ4CompressorOptions{}.withSeekTable (false), rng);
+            MemoryInputStream input2 (withoutTable, false);
+            LZ4DecompressorInputStream lz4b (input2);
+
+            expectEquals (lz4b.getTotalLength(), (int64) -1);
+            lz4b.setPosition (400000);
+            lz4b.setPosition (12345);
+            expectEquals ((int) lz4b.readByte(), (int) static_cast<const char*> (data.getData())[12345]);
+        }
+
+        beginTest ("Corrupt content is detected");
+        {
+            auto data = createTestData (rng, 100000);
+            auto compressed = compress (data, LZ4CompressorOptions{}.withSeekTable (false), rng);
+            static_cast<uint8*> (compressed.getData())[compressed.getSize() - 1] ^= 0x10;
+
+            MemoryInputStream compressedInput (compressed, false);
+            LZ4DecompressorInputStream lz4 (compressedInput);
+            MemoryOutputStream uncompressed;
+            uncompressed << lz4;
+
+            expect (lz4.hasError());
+        }
+    }
+};
+
+static LZ4Tests lz4Tests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The settings used by an LZ4CompressorOutputStream.
+
+    e.g.
+    @code
+    LZ4CompressorOutputStream out (fileStream, LZ4CompressorOptions{}.withCompressionLevel (6)
+                                                                    .withNumThreads (4));
+    @endcode
+
+    @tags{Core}
+*/
+class JUCE_API  LZ4CompressorOptions
+{
+public:
+    /** The maximum amount of uncompressed data that each block in the stream can hold. */
+    enum class BlockSize
+    {
+        size64KB = 4,
+        size256KB,
+        size1MB,
+        size4MB
+    };
+
+    /** Sets how much to compress the data, between 1 and 9, where 1 is the fastest/lowest
+        compression and 9 is the slowest/highest compression. The compressed format is the
+        same for all levels, so the level has no effect on the speed of decompression.
+    */
+    [[nodiscard]] LZ4CompressorOptions withCompressionLevel (int x) const         { return withMember (*this, &LZ4CompressorOptions::compressionLevel, jlimit (1, 9, x)); }
+
+    /** Sets the size of the blocks that the data is split into. Each block is compressed
+        independently, so smaller blocks give finer-grained random access, and larger blocks
+        give slightly better compression.
+    */
+    [[nodiscard]] LZ4CompressorOptions withBlockSize (BlockSize x) const          { return withMember (*this, &LZ4CompressorOptions::blockSize, x); }
+
+    /** Sets the number of threads that may be used to compress blocks in parallel.
+        The output is identical regardless of the number of threads used.
+    */
+    [[nodiscard]] LZ4CompressorOptions withNumThreads (int x) const               { return withMember (*this, &LZ4CompressorOptions::numThreads, jmax (1, x)); }
+
+    /** Sets whether a checksum of the uncompressed data is written at the end of the stream. */
+    [[nodiscard]] LZ4CompressorOptions withContentChecksum (bool x) const         { return withMember (*this, &LZ4CompressorOptions::contentChecksum, x); }
+
+    /** Sets whether a seek table is written at the end of the stream. The seek table is
+        stored in a skippable frame which other LZ4 decoders will ignore, and allows an
+        LZ4DecompressorInputStream to jump directly to any position in the data.
+    */
+    [[nodiscard]] LZ4CompressorOptions withSeekTable (bool x) const               { return withMember (*this, &LZ4CompressorOptions::seekTable, x); }
+
+    int getCompressionLevel() const noexcept    { return compressionLevel; }
+    BlockSize getBlockSize() const noexcept     { return blockSize; }
+    int getNumThreads() const noexcept          { return numThreads; }
+    bool getContentChecksum() const noexcept    { return contentChecksum; }
+    bool getSeekTable() const noexcept          { return seekTable; }
+
+    /** Returns the number of bytes in a block of the given size. */
+    static int getNumBytesInBlock (BlockSize size) noexcept     { return 1 << (8 + 2 * (int) size); }
+
+private:
+    int compressionLevel = 1;
+    BlockSize blockSize = BlockSize::size64KB;
+    int numThreads = 1;
+    bool contentChecksum = true, seekTable = true;
+};
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it using the LZ4 frame format.
+
+    LZ4 compresses less tightly than zlib, but is many times faster to both compress
+    and decompress, which makes it a good choice for data that has to be written or
+    read in real time. The output can be read by an LZ4DecompressorInputStream, or by
+    any other standard LZ4 decoder, such as the lz4 command-line tool.
+
+    The data is split into blocks which are compressed independently. If more than one
+    thread is requested in the options, batches of blocks are compressed in parallel.
+
+    Important note: When you call flush() on an LZ4CompressorOutputStream, the LZ4 frame
+    is closed - this means that no more data can be written to it, and any subsequent
+    attempts to call write() will cause an assertion.
+
+    @see LZ4DecompressorInputStream, LZ4CompressorOptions, GZIPCompressorOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  LZ4CompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+        @param destStream   the stream into which the compressed data will be written
+        @param options      the settings to use
+    */
+    LZ4CompressorOutputStream (OutputStream& destStream,
+                               const LZ4CompressorOptions& options = LZ4CompressorOptions{});
+
+    /** Creates a compression stream.
+        @param destStream                       the stream into which the compressed data will be written.
+                                                Ownership of this object depends on the value of deleteDestStreamWhenDestroyed
+        @param deleteDestStreamWhenDestroyed    whether or not the LZ4CompressorOutputStream will delete the
+                                                destStream object when it is destroyed
+        @param options                          the settings to use
+    */
+    LZ4CompressorOutputStream (OutputStream* destStream,
+                               bool deleteDestStreamWhenDestroyed,
+                               const LZ4CompressorOptions& options = LZ4CompressorOptions{});
+
+    /** Destructor. */
+    ~LZ4CompressorOutputStream() override;
+
+    //==============================================================================
+    /** Flushes and closes the stream.
+        Note that unlike most streams, when you call flush() on an LZ4CompressorOutputStream,
+        the stream is closed - this means that no more data can be written to it, and any
+        subsequent attempts to call write() will cause an assertion.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+
+    class LZ4CompressorHelper;
+    std::unique_ptr<LZ4CompressorHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZ4CompressorOutputStream)
+};
+
+} // namespace juce
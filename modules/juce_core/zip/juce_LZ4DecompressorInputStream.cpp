@@ -0,0 +1,838 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace LZ4Helpers
+{
+    enum : uint32
+    {
+        frameMagic              = 0x184D2204,
+        skippableFrameMagic     = 0x184D2A50,
+        skippableFrameMask      = 0xfffffff0,
+        seekTableFrameMagic     = 0x184D2A5E,
+        seekTableFooterMagic    = 0x8F92EAB1,
+        uncompressedBlockFlag   = 0x80000000
+    };
+
+    enum
+    {
+        minMatch        = 4,
+        lastLiterals    = 5,    // the last 5 bytes of a block must always be literals
+        matchFindLimit  = 12,   // the last match must start at least 12 bytes before the end of a block
+        maxOffset       = 65535,
+        historySize     = 65536,
+        seekTableFooterSize = 9
+    };
+
+    static uint32 readLE32 (const uint8* p) noexcept
+    {
+        return (uint32) p[0] | ((uint32) p[1] << 8) | ((uint32) p[2] << 16) | ((uint32) p[3] << 24);
+    }
+
+    //==============================================================================
+    /** The 32-bit xxHash checksum used by the LZ4 frame format. */
+    struct XXHash32
+    {
+        explicit XXHash32 (uint32 seedToUse = 0) noexcept     { reset (seedToUse); }
+
+        void reset (uint32 seedToUse = 0) noexcept
+        {
+            seed = seedToUse;
+            acc[0] = seed + prime1 + prime2;
+            acc[1] = seed + prime2;
+            acc[2] = seed;
+            acc[3] = seed - prime1;
+            totalLength = 0;
+            numBuffered = 0;
+        }
+
+        void update (const void* data, size_t numBytes) noexcept
+        {
+            auto p = static_cast<const uint8*> (data);
+            totalLength += numBytes;
+
+            if (numBuffered + numBytes < 16)
+            {
+                memcpy (buffer + numBuffered, p, numBytes);
+                numBuffered += numBytes;
+                return;
+            }
+
+            if (numBuffered > 0)
+            {
+                auto numToFill = 16 - numBuffered;
+                memcpy (buffer + numBuffered, p, numToFill);
+                processStripe (buffer);
+                p += numToFill;
+                numBytes -= numToFill;
+                numBuffered = 0;
+            }
+
+            for (; numBytes >= 16; numBytes -= 16, p += 16)
+                processStripe (p);
+
+            memcpy (buffer, p, numBytes);
+            numBuffered = numBytes;
+        }
+
+        uint32 getHash() const noexcept
+        {
+            auto h = totalLength >= 16 ? rotl (acc[0], 1) + rotl (acc[1], 7) + rotl (acc[2], 12) + rotl (acc[3], 18)
+                                       : seed + prime5;
+            h += (uint32) totalLength;
+
+            size_t i = 0;
+
+            for (; i + 4 <= numBuffered; i += 4)
+                h = rotl (h + readLE32 (buffer + i) * prime3, 17) * prime4;
+
+            for (; i < numBuffered; ++i)
+                h = rotl (h + buffer[i] * prime5, 11) * prime1;
+
+            h ^= h >> 15;
+            h *= prime2;
+            h ^= h >> 13;
+            h *= prime3;
+            h ^= h >> 16;
+            return h;
+        }
+
+        static uint32 calculate (const void* data, size_t numBytes, uint32 seedToUse = 0) noexcept
+        {
+            XXHash32 hash (seedToUse);
+            hash.update (data, numBytes);
+            return hash.getHash();
+        }
+
+    private:
+        static constexpr uint32 prime1 = 2654435761u, prime2 = 2246822519u, prime3 = 3266489917u,
+                                prime4 = 668265263u, prime5 = 374761393u;
+
+        uint32 acc[4], seed;
+        uint64 totalLength;
+        uint8 buffer[16];
+        size_t numBuffered;
+
+        static uint32 rotl (uint32 x, int bits) noexcept    { return (x << bits) | (x >> (32 - bits)); }
+        static uint32 round (uint32 a, uint32 input) noexcept { return rotl (a + input * prime2, 13) * prime1; }
+
+        void processStripe (const uint8* p) noexcept
+        {
+            for (int i = 0; i < 4; ++i)
+                acc[i] = round (acc[i], readLE32 (p + 4 * i));
+        }
+    };
+
+    //==============================================================================
+    /*  Decodes a block in the LZ4 block format, checking every length and offset so that
+        corrupt data can never read or write outside the buffers. Matches may refer back
+        into the prefixSize bytes that precede dest.
+        Returns the number of bytes decoded, or -1 if the data is invalid.
+    */
+    static int decompressBlock (const uint8* src, int srcSize, uint8* dest, int destCapacity, int prefixSize) noexcept
+    {
+        auto ip = src;
+        auto op = dest;
+        const auto iend = src + srcSize;
+        const auto oend = dest + destCapacity;
+        const auto lowLimit = dest - prefixSize;
+
+        const auto readExtraLength = [&] (size_t& length)
+        {
+            if (length == 15)
+            {
+                for (;;)
+                {
+                    if (ip >= iend)
+                        return false;
+
+                    auto b = *ip++;
+                    length += b;
+
+                    if (b != 255)
+                        break;
+                }
+            }
+
+            return true;
+        };
+
+        for (;;)
+        {
+            if (ip >= iend)
+                return -1;
+
+            auto token = *ip++;
+            auto literalLength = (size_t) (token >> 4);
+
+            if (! readExtraLength (literalLength)
+                 || literalLength > (size_t) (iend - ip)
+                 || literalLength > (size_t) (oend - op))
+                return -1;
+
+            memcpy (op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            // the last sequence in a block consists only of literals
+            if (ip == iend)
+                break;
+
+            if (iend - ip < 2)
+                return -1;
+
+            auto offset = (size_t) ip[0] | ((size_t) ip[1] << 8);
+            ip += 2;
+
+            if (offset == 0 || offset > (size_t) (op - lowLimit))
+                return -1;
+
+            auto matchLength = (size_t) (token & 15);
+
+            if (! readExtraLength (matchLength))
+                return -1;
+
+            matchLength += minMatch;
+
+            if (matchLength > (size_t) (oend - op))
+                return -1;
+
+            auto match = op - offset;
+
+            if (offset >= matchLength)
+            {
+                memcpy (op, match, matchLength);
+            }
+            else if (offset >= 8)
+            {
+                for (size_t i = 0; i < matchLength; i += 8)
+                    memcpy (op + i, match + i, jmin ((size_t) 8, matchLength - i));
+            }
+            else
+            {
+                for (size_t i = 0; i < matchLength; ++i)
+                    op[i] = match[i];
+            }
+
+            op += matchLength;
+        }
+
+        return (int) (op - dest);
+    }
+}
+
+//==============================================================================
+class LZ4DecompressorInputStream::LZ4DecompressHelper
+{
+public:
+    LZ4DecompressHelper (InputStream& s)  : source (s) {}
+
+    bool hasError() const noexcept      { return error; }
+
+    int read (uint8* dest, int numBytes)
+    {
+        int numRead = 0;
+
+        while (numBytes > 0)
+        {
+            if (decodedStart >= decodedEnd && ! decodeNextBlock())
+                break;
+
+            auto numToCopy = jmin (numBytes, decodedEnd - decodedStart);
+            memcpy (dest, decoded + decodedStart, (size_t) numToCopy);
+            decodedStart += numToCopy;
+            dest += numToCopy;
+            numBytes -= numToCopy;
+            numRead += numToCopy;
+        }
+
+        return numRead;
+    }
+
+    bool isExhausted()
+    {
+        return decodedStart >= decodedEnd && ! decodeNextBlock();
+    }
+
+    int64 getTotalLength()
+    {
+        return loadSeekTable() ? seekPoints.getLast().uncompressedPos : -1;
+    }
+
+    // Uses the seek table to jump straight to the block containing a position.
+    bool seek (int64 newPos)
+    {
+        if (! loadSeekTable())
+            return false;
+
+        decodedStart = decodedEnd = 0;
+        finished = error = false;
+
+        if (newPos >= seekPoints.getLast().uncompressedPos)
+        {
+            // at or past the end of the data
+            finished = true;
+            return true;
+        }
+
+        auto last = seekPoints.size() - 1;
+        auto index = jmax (0, (int) (std::upper_bound (seekPoints.begin(), seekPoints.begin() + last, newPos,
+                                                       [] (int64 pos, const SeekPoint& p) { return pos < p.uncompressedPos; })
+                                      - seekPoints.begin()) - 1);
+
+        inFrame = true;
+        canCheckContent = false;
+
+        if (source.setPosition (seekPoints.getReference (index).compressedPos))
+            decodeNextBlock();
+        else
+            error = true;
+
+        decodedStart = jmin (decodedEnd, (int) (jmax ((int64) 0, newPos) - seekPoints.getReference (index).uncompressedPos));
+        return true;
+    }
+
+private:
+    struct SeekPoint
+    {
+        int64 compressedPos, uncompressedPos;
+    };
+
+    InputStream& source;
+    HeapBlock<uint8> compressed, decoded;
+    int maxBlockSize = 0, decodedStart = 0, decodedEnd = 0;
+    bool inFrame = false, finished = false, error = false;
+    bool blocksAreIndependent = false, hasBlockChecksums = false, hasContentChecksum = false, canCheckContent = true;
+    LZ4Helpers::XXHash32 contentHash;
+
+    int64 firstBlockPos = -1;
+    int numFramesStarted = 0;
+    bool seekTableChecked = false;
+    Array<SeekPoint> seekPoints;
+
+    bool fail() noexcept
+    {
+        error = true;
+        return false;
+    }
+
+    bool readLE32 (uint32& result)
+    {
+        uint8 bytes[4];
+
+        if (source.read (bytes, 4) != 4)
+            return false;
+
+        result = LZ4Helpers::readLE32 (bytes);
+        return true;
+    }
+
+    // Reads the next frame header, skipping any skippable frames.
+    // Returns false at the end of the stream or if there's an error.
+    bool readFrameHeader()
+    {
+        for (;;)
+        {
+            uint8 magicBytes[4];
+            auto numRead = source.read (magicBytes, 4);
+
+            if (numRead == 0)
+            {
+                finished = true;
+                return false;
+            }
+
+            if (numRead != 4)
+                return fail();
+
+            auto magic = LZ4Helpers::readLE32 (magicBytes);
+
+            if ((magic & LZ4Helpers::skippableFrameMask) == LZ4Helpers::skippableFrameMagic)
+            {
+                uint32 frameSize;
+
+                if (! readLE32 (frameSize))
+                    return fail();
+
+                auto target = source.getPosition() + (int64) frameSize;
+                source.skipNextBytes ((int64) frameSize);
+
+                if (source.getPosition() != target)
+                    return fail();
+
+                continue;
+            }
+
+            if (magic != LZ4Helpers::frameMagic)
+                return fail();
+
+            uint8 descriptor[11];
+
+            if (source.read (descriptor, 2) != 2)
+                return fail();
+
+            auto flags = descriptor[0];
+            auto blockDescriptor = descriptor[1];
+            auto blockSizeID = (blockDescriptor >> 4) & 7;
+
+            // the version must be 01, reserved bits must be zero, and dictionaries aren't supported
+            if ((flags >> 6) != 1 || (flags & 0x03) != 0 || (blockDescriptor & 0x8f) != 0 || blockSizeID < 4)
+                return fail();
+
+            auto descriptorSize = (flags & 0x08) != 0 ? 10 : 2;
+
+            if (descriptorSize > 2 && source.read (descriptor + 2, 8) != 8)
+                return fail();
+
+            if (source.read (descriptor + descriptorSize, 1) != 1
+                 || descriptor[descriptorSize] != (uint8) (LZ4Helpers::XXHash32::calculate (descriptor, (size_t) descriptorSize) >> 8))
+                return fail();
+
+            blocksAreIndependent = (flags & 0x20) != 0;
+            hasBlockChecksums    = (flags & 0x10) != 0;
+            hasContentChecksum   = (flags & 0x04) != 0;
+            canCheckContent = true;
+            contentHash.reset();
+
+            auto newMaxBlockSize = 1 << (8 + 2 * blockSizeID);
+
+            if (newMaxBlockSize > maxBlockSize)
+            {
+                maxBlockSize = newMaxBlockSize;
+                compressed.malloc (maxBlockSize);
+                decoded.malloc (LZ4Helpers::historySize + maxBlockSize);
+            }
+
+            decodedStart = decodedEnd = 0;
+            inFrame = true;
+
+            if (numFramesStarted++ == 0)
+                firstBlockPos = source.getPosition();
+
+            return true;
+        }
+    }
+
+    bool readEndOfFrame()
+    {
+        inFrame = false;
+
+        if (hasContentChecksum)
+        {
+            uint32 checksum;
+
+            if (! readLE32 (checksum) || (canCheckContent && checksum != contentHash.getHash()))
+                return fail();
+        }
+
+        return true;
+    }
+
+    bool decodeNextBlock()
+    {
+        while (! (finished || error))
+        {
+            if (! inFrame)
+            {
+                if (! readFrameHeader())
+                    return false;
+
+                continue;
+            }
+
+            uint32 blockHeader;
+
+            if (! readLE32 (blockHeader))
+                return fail();
+
+            if (blockHeader == 0)
+            {
+                if (! readEndOfFrame())
+                    return false;
+
+                continue;
+            }
+
+            auto isUncompressed = (blockHeader & LZ4Helpers::uncompressedBlockFlag) != 0;
+            auto blockSize = (int) (blockHeader & ~LZ4Helpers::uncompressedBlockFlag);
+
+            if (blockSize > maxBlockSize || source.read (compressed, blockSize) != blockSize)
+                return fail();
+
+            if (hasBlockChecksums)
+            {
+                uint32 checksum;
+
+                if (! readLE32 (checksum) || checksum != LZ4Helpers::XXHash32::calculate (compressed, (size_t) blockSize))
+                    return fail();
+            }
+
+            // when blocks are linked, keep the last 64KB of output in front of
+            // the new block, so that matches can refer back into it
+            int prefixSize = 0;
+
+            if (! blocksAreIndependent)
+            {
+                prefixSize = jmin ((int) LZ4Helpers::historySize, decodedEnd);
+                memmove (decoded, decoded + decodedEnd - prefixSize, (size_t) prefixSize);
+            }
+
+            auto dest = decoded + prefixSize;
+            int numDecoded;
+
+            if (isUncompressed)
+            {
+                memcpy (dest, compressed, (size_t) blockSize);
+                numDecoded = blockSize;
+            }
+            else
+            {
+                numDecoded = LZ4Helpers::decompressBlock (compressed, blockSize, dest, maxBlockSize, prefixSize);
+
+                if (numDecoded < 0)
+                    return fail();
+            }
+
+            if (hasContentChecksum && canCheckContent)
+                contentHash.update (dest, (size_t) numDecoded);
+
+            decodedStart = prefixSize;
+            decodedEnd = prefixSize + numDecoded;
+
+            if (numDecoded > 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Looks for a seek table at the end of the source stream, and checks that it
+    // describes a single frame of independent blocks starting at the current frame.
+    bool loadSeekTable()
+    {
+        if (seekTableChecked)
+            return ! seekPoints.isEmpty();
+
+        if (numFramesStarted == 0)
+        {
+            if (decodedStart < decodedEnd || finished || error)
+                return false;
+
+            readFrameHeader();
+
+            if (! inFrame)
+                return false;
+        }
+
+        seekTableChecked = true;
+
+        if (numFramesStarted != 1 || ! blocksAreIndependent || hasBlockChecksums)
+            return false;
+
+        auto originalPos = source.getPosition();
+        auto totalLength = source.getTotalLength();
+        readSeekTable (totalLength);
+
+        if (! source.setPosition (originalPos))
+        {
+            seekPoints.clear();
+            error = true;
+        }
+
+        return ! seekPoints.isEmpty();
+    }
+
+    void readSeekTable (int64 totalLength)
+    {
+        uint8 footer[LZ4Helpers::seekTableFooterSize];
+
+        if (totalLength < firstBlockPos + LZ4Helpers::seekTableFooterSize
+             || ! source.setPosition (totalLength - LZ4Helpers::seekTableFooterSize)
+             || source.read (footer, LZ4Helpers::seekTableFooterSize) != LZ4Helpers::seekTableFooterSize
+             || LZ4Helpers::readLE32 (footer + 5) != LZ4Helpers::seekTableFooterMagic
+             || footer[4] != 0)
+            return;
+
+        auto numBlocks = (int64) LZ4Helpers::readLE32 (footer);
+        auto tableSize = numBlocks * 8 + LZ4Helpers::seekTableFooterSize;
+        auto tableStart = totalLength - tableSize - 8;
+        uint32 frameMagic, frameSize;
+
+        if (tableStart < firstBlockPos
+             || ! source.setPosition (tableStart)
+             || ! readLE32 (frameMagic) || frameMagic != LZ4Helpers::seekTableFrameMagic
+             || ! readLE32 (frameSize) || (int64) frameSize != tableSize)
+            return;
+
+        MemoryBlock entries;
+
+        if (source.readIntoMemoryBlock (entries, numBlocks * 8) != (size_t) numBlocks * 8)
+            return;
+
+        Array<SeekPoint> points;
+        points.ensureStorageAllocated ((int) numBlocks + 1);
+        SeekPoint point { firstBlockPos, 0 };
+
+        for (int64 i = 0; i < numBlocks; ++i)
+        {
+            auto entry = static_cast<const uint8*> (entries.getData()) + i * 8;
+            auto compressedSize = LZ4Helpers::readLE32 (entry);
+            auto uncompressedSize = LZ4Helpers::readLE32 (entry + 4);
+
+            if (compressedSize <= 4 || uncompressedSize == 0 || uncompressedSize > (uint32) maxBlockSize)
+                return;
+
+            points.add (point);
+            point.compressedPos += compressedSize;
+            point.uncompressedPos += uncompressedSize;
+        }
+
+        // the table must exactly cover the frame that it follows
+        if (point.compressedPos + 4 + (hasContentChecksum ? 4 : 0) != tableStart)
+            return;
+
+        points.add (point);
+        seekPoints.swapWith (points);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LZ4DecompressHelper)
+};
+
+//==============================================================================
+LZ4DecompressorInputStream::LZ4DecompressorInputStream (InputStream* source, bool deleteSourceWhenDestroyed)
+  : sourceStream (source, deleteSourceWhenDestroyed),
+    originalSourcePos (source->getPosition()),
+    helper (new LZ4DecompressHelper (*source))
+{
+}
+
+LZ4DecompressorInputStream::LZ4DecompressorInputStream (InputStream& source)
+  : sourceStream (&source, false),
+    originalSourcePos (source.getPosition()),
+    helper (new LZ4DecompressHelper (source))
+{
+}
+
+LZ4DecompressorInputStream::~LZ4DecompressorInputStream()
+{
+}
+
+bool LZ4DecompressorInputStream::hasError() const noexcept
+{
+    return helper->hasError();
+}
+
+int64 LZ4DecompressorInputStream::getTotalLength()
+{
+    return helper->getTotalLength();
+}
+
+int LZ4DecompressorInputStream::read (void* destBuffer, int howMany)
+{
+    jassert (destBuffer != nullptr && howMany >= 0);
+
+    if (howMany <= 0)
+        return 0;
+
+    auto numRead = helper->read (static_cast<uint8*> (destBuffer), howMany);
+    currentPos += numRead;
+    return numRead;
+}
+
+bool LZ4DecompressorInputStream::isExhausted()
+{
+    return helper->isExhausted();
+}
+
+int64 LZ4DecompressorInputStream::getPosition()
+{
+    return currentPos;
+}
+
+bool LZ4DecompressorInputStream::setPosition (int64 newPos)
+{
+    if (newPos == currentPos)
+        return true;
+
+    if (helper->seek (newPos))
+    {
+        currentPos = newPos;
+        return ! helper->hasError();
+    }
+
+    if (newPos < currentPos)
+    {
+        // to go backwards without a seek table, reset the stream and start again
+        currentPos = 0;
+        helper.reset (new LZ4DecompressHelper (*sourceStream));
+
+        if (! sourceStream->setPosition (originalSourcePos))
+            return false;
+    }
+
+    skipNextBytes (newPos - currentPos);
+    return true;
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct LZ4DecompressorInputStreamTests final : public UnitTest
+{
+    LZ4DecompressorInputStreamTests()
+        : UnitTest ("LZ4DecompressorInputStream", UnitTestCategories::compression)
+    {}
+
+    static MemoryBlock createFrame (std::initializer_list<uint8> blockData, bool isCompressed = true)
+    {
+        const uint8 descriptor[] = { 0x60, 0x40 };
+
+        MemoryOutputStream out;
+        out.writeInt ((int) LZ4Helpers::frameMagic);
+        out.write (descriptor, 2);
+        out.writeByte ((char) (LZ4Helpers::XXHash32::calculate (descriptor, 2) >> 8));
+        out.writeInt ((int) ((uint32) blockData.size() | (isCompressed ? 0u : (uint32) LZ4Helpers::uncompressedBlockFlag)));
+        out.write (blockData.begin(), blockData.size());
+        out.writeInt (0);
+        return out.getMemoryBlock();
+    }
+
+    String decode (const MemoryBlock& data, bool& hadError)
+    {
+        MemoryInputStream in (data, false);
+        LZ4DecompressorInputStream lz4 (in);
+        auto result = lz4.readEntireStreamAsString();
+        hadError = lz4.hasError();
+        return result;
+    }
+
+    void runTest() override
+    {
+        beginTest ("xxHash32");
+        {
+            expectEquals ((int64) LZ4Helpers::XXHash32::calculate (nullptr, 0), (int64) 0x02CC5D05);
+
+            const String text ("Nobody inspects the spammish repetition");
+            auto expected = LZ4Helpers::XXHash32::calculate (text.toRawUTF8(), text.getNumBytesAsUTF8());
+
+            LZ4Helpers::XXHash32 hash;
+
+            for (int i = 0; i < text.length(); ++i)
+                hash.update (text.toRawUTF8() + i, 1);
+
+            expectEquals ((int64) hash.getHash(), (int64) expected);
+            expectEquals ((int64) LZ4Helpers::XXHash32::calculate ("a", 1), (int64) 0x550D7456);
+        }
+
+        beginTest ("Decoding");
+        {
+            bool hadError = false;
+
+            // "abc" as literals, then a match of 6 bytes with offset 3, then "xyz"
+            expectEquals (decode (createFrame ({ 0x32, 'a', 'b', 'c', 3, 0, 0x30, 'x', 'y', 'z' }), hadError),
+                          String ("abcabcabcxyz"));
+            expect (! hadError);
+
+            expectEquals (decode (createFrame ({ 'r', 'a', 'w' }, false), hadError), String ("raw"));
+            expect (! hadError);
+
+            auto twoFrames = createFrame ({ 0x30, 'o', 'n', 'e' });
+            twoFrames.append ("\x50\x2a\x4d\x18\x02\x00\x00\x00zz", 10);
+            auto secondFrame = createFrame ({ 0x30, 't', 'w', 'o' });
+            twoFrames.append (secondFrame.getData(), secondFrame.getSize());
+            expectEquals (decode (twoFrames, hadError), String ("onetwo"));
+            expect (! hadError);
+        }
+
+        beginTest ("Corrupt data");
+        {
+            bool hadError = false;
+
+            // offset pointing before the start of the data
+            decode (createFrame ({ 0x30, 'a', 'b', 'c', 9, 0, 0x00 }), hadError);
+            expect (hadError);
+
+            // zero offset
+            decode (createFrame ({ 0x30, 'a', 'b', 'c', 0, 0, 0x00 }), hadError);
+            expect (hadError);
+
+            // literal length running past the end of the block
+            decode (createFrame ({ 0xf0, 0xff, 0xff, 'a' }), hadError);
+            expect (hadError);
+
+            // bad header checksum
+            auto badHeader = createFrame ({ 0x10, 'a' });
+            static_cast<uint8*> (badHeader.getData())[6] ^= 1;
+            decode (badHeader, hadError);
+            expect (hadError);
+
+            // truncated stream
+            auto truncated = createFrame ({ 0x30, 'a', 'b', 'c' });
+            truncated.setSize (truncated.getSize() - 3);
+            decode (truncated, hadError);
+            expect (hadError);
+
+            decode (MemoryBlock ("not lz4", 7), hadError);
+            expect (hadError);
+
+            // random garbage must never crash
+            auto rng = getRandom();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                MemoryBlock junk ((size_t) rng.nextInt (300));
+                rng.fillBitsRandomly (junk.getData(), junk.getSize());
+
+                auto frame = createFrame ({});
+                frame.setSize (frame.getSize() - 8);
+                MemoryOutputStream out;
+                out << frame;
+                out.writeInt ((int) junk.getSize());
+                out << junk;
+                decode (out.getMemoryBlock(), hadError);
+            }
+        }
+    }
+};
+
+static LZ4DecompressorInputStreamTests lz4DecompressorInputStreamTests;
+
+#endif
+
+} // namespace juce
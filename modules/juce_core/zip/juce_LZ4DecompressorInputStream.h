@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    This stream will decompress a source-stream that contains data in the LZ4 frame format.
+
+    This can read data written by an LZ4CompressorOutputStream or by any other standard
+    LZ4 encoder. Multiple concatenated frames are read as one continuous stream, and any
+    skippable frames are ignored.
+
+    If the source stream supports seeking and the data was written with a seek table
+    (see LZ4CompressorOptions::withSeekTable()), calling setPosition() will jump
+    directly to the block containing the new position, rather than having to decompress
+    all the data that comes before it. In that case, getTotalLength() will also return
+    the uncompressed length of the data.
+
+    If the data is found to be corrupt, the stream will behave as if it has reached its
+    end, and hasError() will return true.
+
+    @see LZ4CompressorOutputStream, GZIPDecompressorInputStream
+
+    @tags{Core}
+*/
+class JUCE_API  LZ4DecompressorInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decompressor stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream
+                                            when this object is destroyed
+    */
+    LZ4DecompressorInputStream (InputStream* sourceStream,
+                                bool deleteSourceWhenDestroyed);
+
+    /** Creates a decompressor stream.
+
+        @param sourceStream     the stream to read from - the source stream must not be
+                                deleted until this object has been destroyed
+    */
+    LZ4DecompressorInputStream (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~LZ4DecompressorInputStream() override;
+
+    //==============================================================================
+    /** Returns true if the stream stopped because the data was corrupt or used
+        a feature that isn't supported.
+    */
+    bool hasError() const noexcept;
+
+    //==============================================================================
+    int64 getPosition() override;
+    bool setPosition (int64 pos) override;
+    int64 getTotalLength() override;
+    bool isExhausted() override;
+    int read (void* destBuffer, int maxBytesToRead) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> sourceStream;
+    int64 originalSourcePos, currentPos = 0;
+
+    class LZ4DecompressHelper;
+    std::unique_ptr<LZ4DecompressHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZ4DecompressorInputStream)
+};
+
+} // namespace juce
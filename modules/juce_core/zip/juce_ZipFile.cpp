@@ -51,7 +51,7 @@ struct ZipFile::ZipEntryHolder
 {
     ZipEntryHolder (const char* buffer, int fileNameLen)
     {
-        isCompressed           = readUnalignedLittleEndianShort (buffer + 10) != 0;
+        compressionMethod      = readUnalignedLittleEndianShort (buffer + 10);
         entry.fileTime         = parseFileTime (readUnalignedLittleEndianShort (buffer + 12),
                                                 readUnalignedLittleEndianShort (buffer + 14));
         compressedSize         = (int64) readUnalignedLittleEndianInt (buffer + 20);
@@ -77,9 +77,15 @@ struct ZipFile::ZipEntryHolder
         return { year, month, day, hours, minutes, seconds };
     }
 
+    enum : uint32
+    {
+        storedMethod  = 0,
+        deflateMethod = 8
+    };
+
     ZipEntry entry;
     int64 streamOffset, compressedSize;
-    bool isCompressed;
+    uint32 compressionMethod;
 };
 
 //==============================================================================
@@ -147,6 +153,82 @@ static bool hasSymbolicPart (const File& root, const File& f)
     return false;
 }
 
+static String getEntryPath (const ZipFile::ZipEntry& entry)
+{
+   #if JUCE_WINDOWS
+    return entry.filename;
+   #else
+    return entry.filename.replaceCharacter ('\\', '/');
+   #endif
+}
+
+static int getNumZipThreadsToUse (int numThreads)
+{
+    return numThreads > 0 ? numThreads : SystemStats::getNumCpus();
+}
+
+/*  Creates a pool to help the calling thread, so that numThreads threads are used in total.
+    Returns nullptr if only the calling thread is needed.
+*/
+static std::unique_ptr<ThreadPool> createZipThreadPool (int numThreads)
+{
+    if (numThreads <= 1)
+        return {};
+
+    return std::make_unique<ThreadPool> (ThreadPoolOptions{}.withThreadName ("ZipFile worker")
+                                                            .withNumberOfThreads (numThreads - 1));
+}
+
+/*  Calls task (index) for each index from 0 to numTasks - 1, using the calling thread and
+    the threads in the pool, if there is one. Once a task returns false, no more tasks will
+    be started. Returns true if all the tasks succeeded.
+*/
+static bool runZipTasksInParallel (ThreadPool* pool, int numTasks, const std::function<bool (int)>& task)
+{
+    std::atomic<int> nextTask { 0 };
+    std::atomic<bool> failed { false };
+
+    const auto runTasks = [&]
+    {
+        for (;;)
+        {
+            const auto index = nextTask++;
+
+            if (index >= numTasks || failed)
+                return;
+
+            if (! task (index))
+                failed = true;
+        }
+    };
+
+    const auto numExtraThreads = pool != nullptr ? jmin (pool->getNumThreads(), numTasks - 1) : 0;
+
+    if (numExtraThreads <= 0)
+    {
+        runTasks();
+        return ! failed;
+    }
+
+    WaitableEvent allThreadsFinished;
+    std::atomic<int> numThreadsRunning { numExtraThreads };
+
+    for (int i = 0; i < numExtraThreads; ++i)
+    {
+        pool->addJob ([&]
+        {
+            runTasks();
+
+            if (--numThreadsRunning == 0)
+                allThreadsFinished.signal();
+        });
+    }
+
+    runTasks();
+    allThreadsFinished.wait();
+    return ! failed;
+}
+
 //==============================================================================
 struct ZipFile::ZipInputStream final : public InputStream
 {
@@ -265,6 +347,18 @@ ZipFile::ZipFile (InputStream& stream)  : inputStream (&stream)
 
 ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
 {
+    mappedFile = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+
+    if (mappedFile->getData() != nullptr)
+    {
+        sourceData = static_cast<const char*> (mappedFile->getData());
+        sourceDataSize = (int64) mappedFile->getSize();
+    }
+    else
+    {
+        mappedFile.reset();
+    }
+
     init();
 }
 
@@ -323,15 +417,52 @@ const ZipFile::ZipEntry* ZipFile::getEntry (const String& fileName, bool ignoreC
     return getEntry (getIndexOfFileName (fileName, ignoreCase));
 }
 
+InputStream* ZipFile::createRawStreamForEntry (const ZipEntryHolder& zei)
+{
+    if (sourceData == nullptr)
+        return new ZipInputStream (*this, zei);
+
+    // When the whole file is in memory, the entry's data can be read directly
+    auto headerStart = zei.streamOffset;
+
+    if (headerStart + 30 <= sourceDataSize)
+    {
+        auto* header = sourceData + headerStart;
+
+        if (readUnalignedLittleEndianInt (header) == 0x04034b50)
+        {
+            auto dataStart = headerStart + 30 + readUnalignedLittleEndianShort (header + 26)
+                                              + readUnalignedLittleEndianShort (header + 28);
+
+            if (dataStart <= sourceDataSize)
+                return new MemoryInputStream (sourceData + dataStart,
+                                              (size_t) jmin (zei.compressedSize, sourceDataSize - dataStart),
+                                              false);
+        }
+    }
+
+    return new MemoryInputStream (nullptr, 0, false);
+}
+
+bool ZipFile::canReadEntriesConcurrently() const noexcept
+{
+    return sourceData != nullptr || inputSource != nullptr;
+}
+
 InputStream* ZipFile::createStreamForEntry (const int index)
 {
     InputStream* stream = nullptr;
 
     if (auto* zei = entries[index])
     {
-        stream = new ZipInputStream (*this, *zei);
+        // Only entries that are stored or use deflate can be read
+        if (zei->compressionMethod != ZipEntryHolder::storedMethod
+             && zei->compressionMethod != ZipEntryHolder::deflateMethod)
+            return nullptr;
+
+        stream = createRawStreamForEntry (*zei);
 
-        if (zei->isCompressed)
+        if (zei->compressionMethod == ZipEntryHolder::deflateMethod)
         {
             stream = new GZIPDecompressorInputStream (stream, true,
                                                       GZIPDecompressorInputStream::deflateFormat,
@@ -366,7 +497,18 @@ void ZipFile::init()
     std::unique_ptr<InputStream> toDelete;
     InputStream* in = inputStream;
 
-    if (inputSource != nullptr)
+    if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (inputStream))
+    {
+        sourceData = static_cast<const char*> (memoryStream->getData());
+        sourceDataSize = (int64) memoryStream->getDataSize();
+    }
+
+    if (sourceData != nullptr)
+    {
+        in = new MemoryInputStream (sourceData, (size_t) sourceDataSize, false);
+        toDelete.reset (in);
+    }
+    else if (inputSource != nullptr)
     {
         in = inputSource->createInputStream();
         toDelete.reset (in);
@@ -424,6 +566,96 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory,
+                              OverwriteFiles overwriteFiles,
+                              FollowSymlinks followSymlinks,
+                              int numThreads)
+{
+    numThreads = getNumZipThreadsToUse (numThreads);
+
+    if (numThreads == 1 || ! canReadEntriesConcurrently())
+    {
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            auto result = uncompressEntry (i, targetDirectory, overwriteFiles, followSymlinks);
+
+            if (result.failed())
+                return result;
+        }
+
+        return Result::ok();
+    }
+
+    // Two threads trying to create the same folder at once could make one of them fail,
+    // so all the folders are created before any of the files are written.
+    Array<int> fileEntries, symbolicLinkEntries;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries.getUnchecked (i)->entry;
+        const auto entryPath = getEntryPath (entry);
+
+        if (entryPath.isEmpty())
+            continue;
+
+        if (entry.isSymbolicLink)
+        {
+            symbolicLinkEntries.add (i);
+        }
+        else if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+        {
+            auto result = uncompressEntry (i, targetDirectory, overwriteFiles, followSymlinks);
+
+            if (result.failed())
+                return result;
+        }
+        else
+        {
+            auto parentDirectory = targetDirectory.getChildFile (entryPath).getParentDirectory();
+
+            // uncompressEntry() will report an error for any entries that fail these checks
+            if ((parentDirectory == targetDirectory || parentDirectory.isAChildOf (targetDirectory))
+                 && (followSymlinks == FollowSymlinks::yes || ! hasSymbolicPart (targetDirectory, parentDirectory)))
+                parentDirectory.createDirectory();
+
+            fileEntries.add (i);
+        }
+    }
+
+    CriticalSection errorLock;
+    auto firstError = Result::ok();
+
+    const auto pool = createZipThreadPool (jmin (numThreads, fileEntries.size()));
+
+    runZipTasksInParallel (pool.get(), fileEntries.size(), [&] (int i)
+    {
+        auto result = uncompressEntry (fileEntries.getUnchecked (i), targetDirectory, overwriteFiles, followSymlinks);
+
+        if (result.wasOk())
+            return true;
+
+        const ScopedLock sl (errorLock);
+
+        if (firstError.wasOk())
+            firstError = result;
+
+        return false;
+    });
+
+    if (firstError.failed())
+        return firstError;
+
+    for (auto i : symbolicLinkEntries)
+    {
+        auto result = uncompressEntry (i, targetDirectory, overwriteFiles, followSymlinks);
+
+        if (result.failed())
+            return result;
+    }
+
+    return Result::ok();
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     return uncompressEntry (index,
@@ -435,12 +667,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, OverwriteFiles overwriteFiles, FollowSymlinks followSymlinks)
 {
     auto* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
-   #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
-   #endif
+    auto entryPath = getEntryPath (zei->entry);
 
     if (entryPath.isEmpty())
         return Result::ok();
@@ -488,7 +715,11 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
         if (out.failedToOpen())
             return Result::fail ("Failed to write to target file: " + targetFile.getFullPathName());
 
-        out << *in;
+        // Stored entries from a memory-mapped or in-memory zip can be written without copying
+        if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (in.get()))
+            out.write (memoryStream->getData(), memoryStream->getDataSize());
+        else
+            out << *in;
     }
 
     targetFile.setCreationTime (zei->entry.fileTime);
@@ -508,10 +739,24 @@ struct ZipFile::Builder::Item
         symbolicLink = (file.exists() && file.isSymbolicLink());
     }
 
+    size_t getExpectedDataSize() const
+    {
+        return (size_t) file.getSize();
+    }
+
     bool writeData (OutputStream& target, const int64 overallStartPosition)
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        MemoryOutputStream compressedData (getExpectedDataSize());
+
+        if (! compressData (compressedData))
+            return false;
+
+        writeCompressedData (target, overallStartPosition, compressedData);
+        return true;
+    }
 
+    bool compressData (MemoryOutputStream& compressedData)
+    {
         if (symbolicLink)
         {
             auto relativePath = file.getNativeLinkedTarget().replaceCharacter (File::getSeparatorChar(), L'/');
@@ -535,14 +780,18 @@ struct ZipFile::Builder::Item
         }
 
         compressedSize = (int64) compressedData.getDataSize();
+        return true;
+    }
+
+    void writeCompressedData (OutputStream& target, const int64 overallStartPosition,
+                              const MemoryOutputStream& compressedData)
+    {
         headerStart = target.getPosition() - overallStartPosition;
 
         target.writeInt (0x04034b50);
         writeFlagsAndSizes (target);
         target << storedPathname
                << compressedData;
-
-        return true;
     }
 
     bool writeDirectoryEntry (OutputStream& target)
@@ -642,16 +891,56 @@ void ZipFile::Builder::addEntry (InputStream* stream, int compression, const Str
 }
 
 bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress) const
+{
+    return writeToStream (target, progress, 1);
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, int numThreads) const
 {
     auto fileStart = target.getPosition();
+    numThreads = getNumZipThreadsToUse (numThreads);
 
-    for (int i = 0; i < items.size(); ++i)
+    if (numThreads == 1)
     {
-        if (progress != nullptr)
-            *progress = (i + 0.5) / items.size();
+        for (int i = 0; i < items.size(); ++i)
+        {
+            if (progress != nullptr)
+                *progress = (i + 0.5) / items.size();
 
-        if (! items.getUnchecked (i)->writeData (target, fileStart))
-            return false;
+            if (! items.getUnchecked (i)->writeData (target, fileStart))
+                return false;
+        }
+    }
+    else
+    {
+        const auto batchSize = numThreads * 2;
+        const auto pool = createZipThreadPool (jmin (numThreads, items.size()));
+
+        for (int batchStart = 0; batchStart < items.size(); batchStart += batchSize)
+        {
+            const auto numInBatch = jmin (batchSize, items.size() - batchStart);
+            std::vector<std::unique_ptr<MemoryOutputStream>> compressedData ((size_t) numInBatch);
+
+            const auto compressedOk = runZipTasksInParallel (pool.get(), numInBatch, [&] (int i)
+            {
+                auto* item = items.getUnchecked (batchStart + i);
+                auto& buffer = compressedData[(size_t) i];
+                buffer = std::make_unique<MemoryOutputStream> (item->getExpectedDataSize());
+                return item->compressData (*buffer);
+            });
+
+            if (! compressedOk)
+                return false;
+
+            for (int i = 0; i < numInBatch; ++i)
+            {
+                if (progress != nullptr)
+                    *progress = (batchStart + i + 0.5) / items.size();
+
+                items.getUnchecked (batchStart + i)->writeCompressedData (target, fileStart, *compressedData[(size_t) i]);
+                compressedData[(size_t) i].reset();
+            }
+        }
     }
 
     auto directoryStart = target.getPosition();
@@ -753,6 +1042,92 @@ struct ZIPTests final : public UnitTest
         }
     }
 
+    static String createEntryContent (int index)
+    {
+        MemoryOutputStream content;
+
+        for (int i = 0; i < index * 100; ++i)
+            content << "line " << i << " of entry " << index << newLine;
+
+        return content.toString();
+    }
+
+    static String getParallelEntryName (int index)
+    {
+        return "dir" + String (index % 4) + "/sub/entry" + String (index) + ".txt";
+    }
+
+    static MemoryBlock createParallelTestZip (int numThreads)
+    {
+        ZipFile::Builder builder;
+        const Time time (2020, 1, 2, 3, 4, 6);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            MemoryOutputStream content;
+            content << createEntryContent (i);
+            builder.addEntry (new MemoryInputStream (content.getMemoryBlock(), true),
+                              i % 3 == 0 ? 0 : 6, getParallelEntryName (i), time);
+        }
+
+        MemoryOutputStream mo;
+        builder.writeToStream (mo, nullptr, numThreads);
+        return mo.getMemoryBlock();
+    }
+
+    void runParallelTest()
+    {
+        const auto data = createParallelTestZip (4);
+        expect (data == createParallelTestZip (1));
+
+        TemporaryFile zipFile (".zip");
+        expect (zipFile.getFile().replaceWithData (data.getData(), data.getSize()));
+
+        for (auto useFile : { false, true })
+        {
+            MemoryInputStream mi (data, false);
+            auto zip = useFile ? std::make_unique<ZipFile> (zipFile.getFile())
+                               : std::make_unique<ZipFile> (mi);
+
+            expectEquals (zip->getNumEntries(), 40);
+
+            TemporaryFile tmpDir;
+            tmpDir.getFile().createDirectory();
+
+            expect (zip->uncompressTo (tmpDir.getFile(), ZipFile::OverwriteFiles::yes, ZipFile::FollowSymlinks::no, 4).wasOk());
+
+            for (int i = 0; i < 40; ++i)
+            {
+                expectEquals (tmpDir.getFile().getChildFile (getParallelEntryName (i)).loadFileAsString(), createEntryContent (i));
+
+                std::unique_ptr<InputStream> input (zip->createStreamForEntry (zip->getIndexOfFileName (getParallelEntryName (i))));
+                expectEquals (input->readEntireStreamAsString(), createEntryContent (i));
+            }
+        }
+    }
+
+    void runUnsupportedMethodTest()
+    {
+        auto data = createZipMemoryBlock ({ "zstd" });
+
+        // change the central directory entry's method to Zstandard
+        auto* bytes = static_cast<char*> (data.getData());
+
+        for (size_t i = 0; i + 12 <= data.getSize(); ++i)
+            if (readUnalignedLittleEndianInt (bytes + i) == 0x02014b50)
+                bytes[i + 10] = 93;
+
+        MemoryInputStream mi (data, false);
+        ZipFile zip (mi);
+
+        expectEquals (zip.getNumEntries(), 1);
+        expect (std::unique_ptr<InputStream> (zip.createStreamForEntry (0)) == nullptr);
+
+        TemporaryFile tmpDir;
+        tmpDir.getFile().createDirectory();
+        expect (zip.uncompressEntry (0, tmpDir.getFile()).failed());
+    }
+
     void runTest() override
     {
         beginTest ("ZIP");
@@ -773,6 +1148,12 @@ struct ZIPTests final : public UnitTest
 
         beginTest ("ZipSlip");
         runZipSlipTest();
+
+        beginTest ("Parallel");
+        runParallelTest();
+
+        beginTest ("Unsupported compression method");
+        runUnsupportedMethodTest();
     }
 };
 
@@ -42,6 +42,11 @@ namespace juce
     This can enumerate the items in a ZIP file and can create suitable stream objects
     to read each one.
 
+    When a ZipFile is created from a File, the file is memory-mapped if possible, and when
+    it's created from a MemoryInputStream, the stream's data is used directly. In both
+    cases, the entries can be read without seeking or locking a shared stream, which makes
+    it possible to uncompress several entries at once on different threads.
+
     @tags{Core}
 */
 class JUCE_API  ZipFile
@@ -136,7 +141,8 @@ public:
     /** Creates a stream that can read from one of the zip file's entries.
 
         The stream that is returned must be deleted by the caller (and
-        a nullptr might be returned if a stream can't be opened for some reason).
+        a nullptr might be returned if a stream can't be opened for some reason,
+        or if the entry uses a compression method other than deflate).
 
         The stream must not be used after the ZipFile object that created
         has been deleted.
@@ -151,7 +157,8 @@ public:
     /** Creates a stream that can read from one of the zip file's entries.
 
         The stream that is returned must be deleted by the caller (and
-        a nullptr might be returned if a stream can't be opened for some reason).
+        a nullptr might be returned if a stream can't be opened for some reason,
+        or if the entry uses a compression method other than deflate).
 
         The stream must not be used after the ZipFile object that created
         has been deleted.
@@ -211,6 +218,28 @@ public:
                             OverwriteFiles overwriteFiles,
                             FollowSymlinks followSymlinks);
 
+    /** Uncompresses all of the files in the zip file, using several threads at once.
+
+        If the ZipFile was created from a File, an InputSource or a MemoryInputStream, the
+        entries are uncompressed in parallel. If it was created from any other kind of stream,
+        they can't be read concurrently, so this behaves like the single-threaded version.
+
+        The folders are all created first, and any symbolic links are created after all the
+        other entries have been written. If any entry fails, the remaining entries are skipped
+        and the first error is returned.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param overwriteFiles       whether to overwrite existing files with similarly-named ones
+        @param followSymlinks       whether to follow symlinks inside the target directory
+        @param numThreads           the maximum number of threads to use, including the calling
+                                    thread. If this is 0 or less, the number of CPUs is used.
+        @returns success if all the files are successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         OverwriteFiles overwriteFiles,
+                         FollowSymlinks followSymlinks,
+                         int numThreads);
+
     //==============================================================================
     /** Used to create a new zip file.
 
@@ -258,6 +287,23 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, compressing several items at once on different threads.
+
+            Each item is compressed into a temporary memory buffer, and the buffers are written
+            to the stream in the same order that the items were added, so the result is identical
+            to the output of the single-threaded version. The items are processed in batches to
+            limit the amount of memory that's used.
+
+            Note that any streams that were passed to addEntry() will be read on background threads.
+
+            @param target       the stream to write to
+            @param progress     if this is non-null, it will be updated with an approximate
+                                progress status between 0 and 1.0
+            @param numThreads   the maximum number of threads to use, including the calling thread.
+                                If this is 0 or less, the number of CPUs is used.
+        */
+        bool writeToStream (OutputStream& target, double* progress, int numThreads) const;
+
         //==============================================================================
     private:
         struct Item;
@@ -276,6 +322,9 @@ private:
     InputStream* inputStream = nullptr;
     std::unique_ptr<InputStream> streamToDelete;
     std::unique_ptr<InputSource> inputSource;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const char* sourceData = nullptr;
+    int64 sourceDataSize = 0;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -290,6 +339,8 @@ private:
    #endif
 
     void init();
+    InputStream* createRawStreamForEntry (const ZipEntryHolder&);
+    bool canReadEntriesConcurrently() const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
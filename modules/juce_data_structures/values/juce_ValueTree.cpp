@@ -1030,6 +1030,80 @@ ValueTree ValueTree::fromXml (const String& xmlText)
     return {};
 }
 
+ValueTree ValueTree::fromXml (InputStream& xmlSource)
+{
+    XmlPullParser parser (xmlSource);
+    return fromXml (parser);
+}
+
+ValueTree ValueTree::fromXml (XmlPullParser& parser)
+{
+    if (parser.getEventType() != XmlPullParser::EventType::startElement
+         && parser.next() != XmlPullParser::EventType::startElement)
+        return {};
+
+    Array<ValueTree> openTrees;
+    ValueTree result;
+
+    for (;;)
+    {
+        switch (parser.getEventType())
+        {
+            case XmlPullParser::EventType::startElement:
+            {
+                ValueTree v (parser.getTagName());
+                auto& properties = v.object->properties;
+
+                for (int i = 0; i < parser.getNumAttributes(); ++i)
+                {
+                    auto& name = parser.getAttributeName (i);
+                    auto& value = parser.getAttributeValue (i);
+
+                    if (name.startsWith ("base64:"))
+                    {
+                        MemoryBlock mb;
+
+                        if (mb.fromBase64Encoding (value))
+                        {
+                            properties.set (name.substring (7), var (mb));
+                            continue;
+                        }
+                    }
+
+                    properties.set (name, var (value));
+                }
+
+                if (openTrees.isEmpty())
+                    result = v;
+                else
+                    openTrees.getReference (openTrees.size() - 1).appendChild (v, nullptr);
+
+                openTrees.add (std::move (v));
+                break;
+            }
+
+            case XmlPullParser::EventType::endElement:
+                openTrees.removeLast();
+
+                if (openTrees.isEmpty())
+                    return result;
+
+                break;
+
+            case XmlPullParser::EventType::text:
+                // ValueTrees don't have any equivalent to XML text elements!
+                jassertfalse;
+                break;
+
+            case XmlPullParser::EventType::endOfDocument:
+            case XmlPullParser::EventType::error:
+                return {};
+        }
+
+        parser.next();
+    }
+}
+
 String ValueTree::toXmlString (const XmlElement::TextFormat& format) const
 {
     if (auto xml = createXml())
@@ -1217,6 +1291,10 @@ public:
 
                 auto v4 = v2.createCopy();
                 expect (v1.isEquivalentTo (v4));
+
+                auto xmlText = v1.toXmlString();
+                MemoryInputStream xmlStream (xmlText.toRawUTF8(), xmlText.getNumBytesAsUTF8(), false);
+                expect (ValueTree::fromXml (xmlStream).isEquivalentTo (ValueTree::fromXml (xmlText)));
             }
         }
 
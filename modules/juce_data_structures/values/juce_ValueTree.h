@@ -453,6 +453,29 @@ public:
     */
     static ValueTree fromXml (const String& xmlText);
 
+    /** Tries to recreate a tree from XML text that is read from a stream.
+
+        The XML is parsed incrementally with an XmlPullParser, and the tree is built
+        directly from it without creating an intermediate XmlElement, so this needs much
+        less memory than the other fromXml() methods when loading large documents.
+
+        Like the other fromXml() methods, this should only be fed XML that was created
+        by the createXml() method.
+        @returns the new tree, or an invalid tree if the XML couldn't be parsed
+    */
+    static ValueTree fromXml (InputStream& xmlSource);
+
+    /** Builds a tree from the element that an XmlPullParser is positioned on.
+
+        If the parser's current event is a startElement, the tree is built from that
+        element, otherwise the parser is first advanced to its next event, which must be
+        a startElement. When this returns, the parser will have consumed everything up to
+        and including the matching endElement, so you can use this to load the elements of
+        a large document one at a time.
+        @returns the new tree, or an invalid tree if the XML couldn't be parsed
+    */
+    static ValueTree fromXml (XmlPullParser& parser);
+
     /** This returns a string containing an XML representation of the tree.
         This is quite handy for debugging purposes, as it provides a quick way to view a tree.
         @see createXml()
@@ -35,20 +35,291 @@
 namespace juce
 {
 
-class AsyncUpdater::AsyncUpdaterMessage final : public CallbackMessage
+/*
+    Holds the pending state of an AsyncUpdater, and outlives it if there's an update pending.
+
+    Rather than posting a message for every AsyncUpdater that's triggered, each one adds itself
+    to a shared lock-free list, and only the one that makes the list non-empty posts a message.
+    When that message arrives, it moves the updates in the list onto the end of a queue that's
+    only used by the message thread, and delivers them from there in the order that they were
+    triggered. Any updates triggered while that's happening are added to a new list, and are
+    delivered by the next message.
+
+    If one of the callbacks runs a modal loop, the rest of the queue mustn't wait for it to
+    finish, so while there are undelivered updates a second message is kept posted which will
+    carry on delivering them from inside the loop.
+
+    Both messages are allocated up front and re-posted each time, so triggering an update
+    doesn't allocate on the calling thread.
+*/
+class AsyncUpdater::AsyncUpdaterMessage final : public ReferenceCountedObject
 {
 public:
-    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au) {}
+    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au)
+    {
+        DispatchMessage::createSpareIfNeeded();
+    }
 
-    void messageCallback() override
+    bool post()
     {
-        if (shouldDeliver.compareAndSetBool (0, 1))
-            owner.handleAsyncUpdate();
+        // If this is still in the list from an earlier update, it'll be delivered from there
+        if (isQueued.exchange (true))
+            return true;
+
+        incReferenceCount();
+
+        if (addToPendingList (this))
+            return DispatchMessage::postDispatch();
+
+        return true;
     }
 
     AsyncUpdater& owner;
     Atomic<int> shouldDeliver;
 
+private:
+    //==============================================================================
+    class DispatchMessage final : public CallbackMessage
+    {
+    public:
+        explicit DispatchMessage (bool resumes)  : resumesDelivery (resumes)
+        {
+            if (! resumesDelivery)
+                ++getSpares().numDispatchMessages;
+        }
+
+        ~DispatchMessage() override
+        {
+            // If the message couldn't be posted or was discarded, the updates waiting for it are
+            // cancelled, so that they can be triggered again later
+            if (isPosted)
+            {
+                // The delivery queue is always emptied by the message that's delivering from it, so
+                // there's nothing to cancel there, but another message may need posting later
+                if (resumesDelivery)
+                    getDeliveryQueue().isResumePosted = false;
+                else
+                    cancel (getPendingList().exchange (nullptr, std::memory_order_acquire));
+            }
+
+            if (! resumesDelivery)
+                --getSpares().numDispatchMessages;
+        }
+
+        // Makes sure that there's a message ready for the next time the pending list becomes
+        // non-empty. One that's been posted will be reused when it arrives.
+        static void createSpareIfNeeded()
+        {
+            auto& spares = getSpares();
+
+            if (spares.numDispatchMessages.load() == 0)
+            {
+                auto* newMessage = new DispatchMessage (false);
+                newMessage->incReferenceCount();
+
+                DispatchMessage* expected = nullptr;
+
+                if (! spares.dispatch.compare_exchange_strong (expected, newMessage))
+                    newMessage->decReferenceCount();
+            }
+        }
+
+        // Called on the thread that made the pending list non-empty
+        static bool postDispatch()
+        {
+            auto* msg = getSpares().dispatch.exchange (nullptr, std::memory_order_acquire);
+
+            // This only happens if the last message was discarded without being delivered
+            if (msg == nullptr)
+            {
+                msg = new DispatchMessage (false);
+                msg->incReferenceCount();
+            }
+
+            return msg->postAndRelease();
+        }
+
+        // Only called on the message thread
+        static bool postResume()
+        {
+            auto* msg = std::exchange (getSpares().resume, nullptr);
+
+            if (msg == nullptr)
+            {
+                msg = new DispatchMessage (true);
+                msg->incReferenceCount();
+            }
+
+            return msg->postAndRelease();
+        }
+
+        void messageCallback() override
+        {
+            isPosted = false;
+            auto& queue = getDeliveryQueue();
+
+            // The message is put back before anything else happens, so that it can be posted again
+            // as soon as the pending list has been taken
+            if (resumesDelivery)
+            {
+                queue.isResumePosted = false;
+                incReferenceCount();
+                releaseMessage (std::exchange (getSpares().resume, this));
+            }
+            else
+            {
+                incReferenceCount();
+                releaseMessage (getSpares().dispatch.exchange (this, std::memory_order_release));
+
+                moveToDeliveryQueue (getPendingList().exchange (nullptr, std::memory_order_acquire));
+            }
+
+            while (auto* current = queue.first)
+            {
+                queue.first = std::exchange (current->nextPending, nullptr);
+
+                if (queue.first == nullptr)
+                    queue.last = nullptr;
+                else if (! queue.isResumePosted)
+                    queue.isResumePosted = postResume();
+
+                current->removeFromList();
+
+                JUCE_TRY
+                {
+                    if (current->shouldDeliver.compareAndSetBool (0, 1))
+                        current->owner.handleAsyncUpdate();
+                }
+                JUCE_CATCH_EXCEPTION
+
+                // The list's reference keeps this alive if the callback deletes the AsyncUpdater
+                current->decReferenceCount();
+            }
+        }
+
+    private:
+        friend class AsyncUpdaterMessage;
+
+        // Posts the message, and drops the reference that the caller took from the spares. If it
+        // can't be posted, that deletes it, and the destructor cancels the pending updates.
+        bool postAndRelease()
+        {
+            isPosted = true;
+            const auto posted = post();
+            decReferenceCount();
+            return posted;
+        }
+
+        static void releaseMessage (DispatchMessage* msg) noexcept
+        {
+            if (msg != nullptr)
+                msg->decReferenceCount();
+        }
+
+        static void cancel (AsyncUpdaterMessage* msg) noexcept
+        {
+            while (msg != nullptr)
+            {
+                auto* current = std::exchange (msg, msg->nextPending);
+                current->shouldDeliver.set (0);
+                current->removeFromList();
+                current->decReferenceCount();
+            }
+        }
+
+        const bool resumesDelivery;
+        bool isPosted = false;
+
+        JUCE_DECLARE_NON_COPYABLE (DispatchMessage)
+    };
+
+    //==============================================================================
+    struct DeliveryQueue
+    {
+        AsyncUpdaterMessage* first = nullptr;
+        AsyncUpdaterMessage* last = nullptr;
+        bool isResumePosted = false;
+    };
+
+    // The messages that are waiting to be posted again
+    struct SpareMessages
+    {
+        ~SpareMessages()
+        {
+            DispatchMessage::releaseMessage (dispatch.exchange (nullptr));
+            DispatchMessage::releaseMessage (std::exchange (resume, nullptr));
+        }
+
+        std::atomic<DispatchMessage*> dispatch { nullptr };
+        DispatchMessage* resume = nullptr; // only used on the message thread
+        std::atomic<int> numDispatchMessages { 0 };
+    };
+
+    static std::atomic<AsyncUpdaterMessage*>& getPendingList() noexcept
+    {
+        static std::atomic<AsyncUpdaterMessage*> pendingList { nullptr };
+        return pendingList;
+    }
+
+    static DeliveryQueue& getDeliveryQueue() noexcept
+    {
+        static DeliveryQueue queue;
+        return queue;
+    }
+
+    static SpareMessages& getSpares() noexcept
+    {
+        static SpareMessages spares;
+        return spares;
+    }
+
+    // Returns true if the list was empty
+    static bool addToPendingList (AsyncUpdaterMessage* msg) noexcept
+    {
+        auto& list = getPendingList();
+        auto* head = list.load (std::memory_order_relaxed);
+
+        do
+        {
+            msg->nextPending = head;
+        }
+        while (! list.compare_exchange_weak (head, msg, std::memory_order_release, std::memory_order_relaxed));
+
+        return head == nullptr;
+    }
+
+    // Appends a list taken from the pending list to the delivery queue, reversing it so that
+    // the earliest update comes first
+    static void moveToDeliveryQueue (AsyncUpdaterMessage* msg) noexcept
+    {
+        if (msg == nullptr)
+            return;
+
+        auto* const newLast = msg;
+        AsyncUpdaterMessage* newFirst = nullptr;
+
+        while (msg != nullptr)
+        {
+            auto* next = msg->nextPending;
+            msg->nextPending = newFirst;
+            newFirst = std::exchange (msg, next);
+        }
+
+        auto& queue = getDeliveryQueue();
+        (queue.last != nullptr ? queue.last->nextPending : queue.first) = newFirst;
+        queue.last = newLast;
+    }
+
+    // Must be called before the update is delivered, so that it can be triggered again from its callback
+    void removeFromList() noexcept
+    {
+        nextPending = nullptr;
+        isQueued = false;
+    }
+
+    std::atomic<bool> isQueued { false };
+    AsyncUpdaterMessage* nextPending = nullptr;
+
     JUCE_DECLARE_NON_COPYABLE (AsyncUpdaterMessage)
 };
 
@@ -102,4 +373,145 @@ bool AsyncUpdater::isUpdatePending() const noexcept
     return activeMessage->shouldDeliver.value != 0;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! (JUCE_MAC || JUCE_IOS || JUCE_ANDROID)
+
+class AsyncUpdaterTests final : public UnitTest
+{
+public:
+    AsyncUpdaterTests()
+        : UnitTest ("AsyncUpdater", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        auto* mm = MessageManager::getInstance();
+
+        if (! mm->isThisTheMessageThread())
+            return;
+
+        beginTest ("Triggering many updaters delivers each one once");
+        {
+            Array<int> order;
+            OwnedArray<RecordingUpdater> updaters;
+
+            for (int i = 0; i < 200; ++i)
+                updaters.add (new RecordingUpdater (order, i));
+
+            std::thread backgroundThread ([&]
+            {
+                for (int i = 0; i < updaters.size(); i += 2)
+                    for (int repeat = 0; repeat < 3; ++repeat)
+                        updaters.getUnchecked (i)->triggerAsyncUpdate();
+            });
+
+            for (int i = 1; i < updaters.size(); i += 2)
+                for (int repeat = 0; repeat < 3; ++repeat)
+                    updaters.getUnchecked (i)->triggerAsyncUpdate();
+
+            backgroundThread.join();
+
+            dispatchAllPendingMessages();
+
+            expectEquals (order.size(), updaters.size());
+
+            for (auto* u : updaters)
+            {
+                expectEquals (u->numCallbacks, 1);
+                expect (! u->isUpdatePending());
+            }
+
+            // Updates triggered on one thread are delivered in the order they were triggered
+            for (int i = 3; i < updaters.size(); i += 2)
+                expect (order.indexOf (i) > order.indexOf (i - 2));
+        }
+
+        beginTest ("An update can be cancelled while it's waiting in a batch");
+        {
+            Array<int> order;
+            RecordingUpdater first (order, 1), second (order, 2), third (order, 3);
+            first.onUpdate = [&] { second.cancelPendingUpdate(); };
+
+            first.triggerAsyncUpdate();
+            second.triggerAsyncUpdate();
+            third.triggerAsyncUpdate();
+            dispatchAllPendingMessages();
+
+            expect (order == Array<int> { 1, 3 });
+            expect (! second.isUpdatePending());
+
+            second.triggerAsyncUpdate();
+            dispatchAllPendingMessages();
+            expect (order == Array<int> { 1, 3, 2 });
+        }
+
+        beginTest ("Deleting an updater that's still pending is safe");
+        {
+            Array<int> order;
+            auto first = std::make_unique<RecordingUpdater> (order, 1);
+            auto second = std::make_unique<RecordingUpdater> (order, 2);
+            auto third = std::make_unique<RecordingUpdater> (order, 3);
+            first->onUpdate = [&] { second.reset(); };
+
+            first->triggerAsyncUpdate();
+            second->triggerAsyncUpdate();
+            third->triggerAsyncUpdate();
+            third.reset();
+
+            dispatchAllPendingMessages();
+            expect (order == Array<int> { 1 });
+            expect (second == nullptr);
+        }
+
+        beginTest ("Updates are delivered from a nested loop");
+        {
+            Array<int> order;
+            RecordingUpdater first (order, 1), second (order, 2), third (order, 3), fourth (order, 4);
+
+            first.onUpdate = [&]
+            {
+                fourth.triggerAsyncUpdate();
+                dispatchAllPendingMessages();
+                order.add (5);
+            };
+
+            first.triggerAsyncUpdate();
+            second.triggerAsyncUpdate();
+            third.triggerAsyncUpdate();
+            dispatchAllPendingMessages();
+
+            expect (order == Array<int> { 1, 2, 3, 4, 5 });
+        }
+    }
+
+private:
+    struct RecordingUpdater final : public AsyncUpdater
+    {
+        RecordingUpdater (Array<int>& o, int v) : order (o), value (v) {}
+        ~RecordingUpdater() override { cancelPendingUpdate(); }
+
+        void handleAsyncUpdate() override
+        {
+            ++numCallbacks;
+            order.add (value);
+            NullCheckedInvocation::invoke (onUpdate);
+        }
+
+        Array<int>& order;
+        const int value;
+        int numCallbacks = 0;
+        std::function<void()> onUpdate;
+    };
+
+    static void dispatchAllPendingMessages()
+    {
+        while (detail::dispatchNextMessageOnSystemQueue (true))
+        {}
+    }
+};
+
+static AsyncUpdaterTests asyncUpdaterTests;
+
+#endif
+
 } // namespace juce
@@ -67,10 +67,12 @@ public:
         soon as possible.
 
         If an update callback is already pending but hasn't happened yet, calling
-        this method will have no effect.
+        this method will have no effect. The updates for all the AsyncUpdaters that
+        are triggered before the message thread gets round to them are delivered
+        together, by a single message.
 
         It's thread-safe to call this method from any thread, BUT beware of calling
-        it from a real-time (e.g. audio) thread, because it involves posting a message
+        it from a real-time (e.g. audio) thread, because it may involve posting a message
         to the system queue, which means it may block (and in general will do on
         most OSes).
     */
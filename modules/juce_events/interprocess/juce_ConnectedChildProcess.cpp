@@ -42,6 +42,9 @@ static const char* killMessage  = "__ipc_k_";
 static const char* pingMessage  = "__ipc_p_";
 enum { specialMessageSize = 8, defaultTimeoutMs = 8000 };
 
+// The first character of the connection name tells the worker which kind of connection to make
+static constexpr juce_wchar pipeNamePrefix = 'p', sharedMemoryNamePrefix = 's';
+
 static bool isMessageType (const MemoryBlock& mb, const char* messageType) noexcept
 {
     return mb.matches (messageType, (size_t) specialMessageSize);
@@ -101,12 +104,22 @@ private:
 struct ChildProcessCoordinator::Connection final : public InterprocessConnection,
                                                    private ChildProcessPingThread
 {
-    Connection (ChildProcessCoordinator& m, const String& pipeName, int timeout)
+    Connection (ChildProcessCoordinator& m, const String& uniqueName, bool trySharedMemory, int timeout)
         : InterprocessConnection (false, magicCoordWorkerConnectionHeader),
           ChildProcessPingThread (timeout),
           owner (m)
     {
-        createPipe (pipeName, timeoutMs);
+        const auto sharedMemoryName = String::charToString (sharedMemoryNamePrefix) + uniqueName;
+
+        if (trySharedMemory && createSharedMemory (sharedMemoryName, timeoutMs))
+        {
+            name = sharedMemoryName;
+        }
+        else
+        {
+            name = String::charToString (pipeNamePrefix) + uniqueName;
+            createPipe (name, timeoutMs);
+        }
     }
 
     ~Connection() override
@@ -117,6 +130,8 @@ struct ChildProcessCoordinator::Connection final : public InterprocessConnection
 
     using ChildProcessPingThread::startPinging;
 
+    const String& getName() const noexcept  { return name; }
+
 private:
     void connectionMade() override  {}
     void connectionLost() override  { owner.handleConnectionLost(); }
@@ -133,6 +148,7 @@ private:
     }
 
     ChildProcessCoordinator& owner;
+    String name;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Connection)
 };
@@ -168,11 +184,13 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
 {
     killWorkerProcess();
 
-    auto pipeName = "p" + String::toHexString (Random().nextInt64());
+    // The connection is created first, so that it's ready for the worker to connect to
+    connection.reset (new Connection (*this, String::toHexString (Random().nextInt64()), useSharedMemory,
+                                      timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
 
     StringArray args;
     args.add (executable.getFullPathName());
-    args.add (getCommandLinePrefix (commandLineUniqueID) + pipeName);
+    args.add (getCommandLinePrefix (commandLineUniqueID) + connection->getName());
 
     childProcess = [&]() -> std::shared_ptr<ChildProcess>
     {
@@ -187,23 +205,22 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
         return nullptr;
     }();
 
-    if (childProcess != nullptr)
+    if (childProcess != nullptr && connection->isConnected())
     {
-        connection.reset (new Connection (*this, pipeName, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
-
-        if (connection->isConnected())
-        {
-            connection->startPinging();
-            sendMessageToWorker ({ startMessage, specialMessageSize });
-            return true;
-        }
-
-        connection.reset();
+        connection->startPinging();
+        sendMessageToWorker ({ startMessage, specialMessageSize });
+        return true;
     }
 
+    connection.reset();
     return false;
 }
 
+void ChildProcessCoordinator::setUseSharedMemory (bool shouldUseSharedMemory) noexcept
+{
+    useSharedMemory = shouldUseSharedMemory;
+}
+
 void ChildProcessCoordinator::killWorkerProcess()
 {
     if (connection != nullptr)
@@ -220,12 +237,15 @@ void ChildProcessCoordinator::killWorkerProcess()
 struct ChildProcessWorker::Connection final : public InterprocessConnection,
                                               private ChildProcessPingThread
 {
-    Connection (ChildProcessWorker& p, const String& pipeName, int timeout)
+    Connection (ChildProcessWorker& p, const String& connectionName, int timeout)
         : InterprocessConnection (false, magicCoordWorkerConnectionHeader),
           ChildProcessPingThread (timeout),
           owner (p)
     {
-        connectToPipe (pipeName, timeoutMs);
+        if (connectionName.startsWithChar (sharedMemoryNamePrefix))
+            connectToSharedMemory (connectionName, timeoutMs);
+        else
+            connectToPipe (connectionName, timeoutMs);
     }
 
     ~Connection() override
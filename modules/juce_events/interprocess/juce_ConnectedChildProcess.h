@@ -141,7 +141,8 @@ using ChildProcessSlave [[deprecated ("Replaced by ChildProcessWorker.")]] = Chi
     just call launchWorkerProcess(), and it'll attempt to launch the executable that
     you specify (which may be the same exe), and assuming it has been set-up to
     correctly parse the command-line parameters (see ChildProcessWorker) then a
-    two-way connection will be created.
+    two-way connection will be created. The connection uses a named pipe, unless
+    setUseSharedMemory() has been called.
 
     The juce demo app has a good example of this class in action.
 
@@ -195,6 +196,15 @@ public:
         return launchWorkerProcess (executableToLaunch, commandLineUniqueID, timeoutMs, streamFlags);
     }
 
+    /** Makes launchWorkerProcess() connect to the worker through shared memory, rather than
+        a named pipe, where that's supported (see InterprocessConnection::createSharedMemory()).
+
+        This is off by default, because the worker must be built with a version of
+        ChildProcessWorker that knows how to connect to shared memory. It only affects
+        workers that are launched after it's called.
+    */
+    void setUseSharedMemory (bool shouldUseSharedMemory) noexcept;
+
     /** Sends a kill message to the worker, and disconnects from it.
         Note that this won't wait for it to terminate.
     */
@@ -228,6 +238,7 @@ public:
 
 private:
     std::shared_ptr<ChildProcess> childProcess;
+    bool useSharedMemory = false;
 
     struct Connection;
     std::unique_ptr<Connection> connection;
@@ -35,6 +35,21 @@
 namespace juce
 {
 
+#if ! JUCE_LINUX
+// Shared memory connections aren't available on this platform
+struct InterprocessConnection::SharedMemoryChannel
+{
+    static std::unique_ptr<SharedMemoryChannel> create (const String&, uint32, int, bool)  { return {}; }
+    static std::unique_ptr<SharedMemoryChannel> open (const String&, uint32)               { return {}; }
+
+    bool write (const void*, size_t, int)                   { return false; }
+    template <typename Callback>
+    bool readMessages (int, Callback&&)                     { return false; }
+    void close()                                            {}
+    bool isOpen() const noexcept                            { return false; }
+};
+#endif
+
 struct InterprocessConnection::ConnectionThread final : public Thread
 {
     ConnectionThread (InterprocessConnection& c)  : Thread (SystemStats::getJUCEVersion() + ": IPC"), owner (c) {}
@@ -44,6 +59,34 @@ struct InterprocessConnection::ConnectionThread final : public Thread
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConnectionThread)
 };
 
+static constexpr size_t messageHeaderSize = 2 * sizeof (uint32);
+
+// Each message is sent with a single write that takes an int size, so anything bigger
+// than this can't be a real message
+static constexpr uint32 maximumMessageSize = (uint32) std::numeric_limits<int>::max() - (uint32) messageHeaderSize;
+
+struct InterprocessConnection::MultiplexedSocket
+{
+    explicit MultiplexedSocket (SocketEventMultiplexer& m)  : multiplexer (m) {}
+
+    SocketEventMultiplexer& multiplexer;
+
+    CriticalSection registrationLock;
+    int registeredHandle = -1;
+    uint32 session = 0;
+
+    // Only used by the multiplexer's callback
+    MemoryBlock input;
+    size_t numInputBytes = 0;
+
+    CriticalSection outputLock;
+    MemoryBlock output;
+    size_t outputStart = 0, outputEnd = 0;
+    bool isWatchingForWrite = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultiplexedSocket)
+};
+
 class SafeActionImpl
 {
 public:
@@ -157,14 +200,60 @@ bool InterprocessConnection::createPipe (const String& pipeName, int timeoutMs,
     return false;
 }
 
+bool InterprocessConnection::createSharedMemory (const String& name, int timeoutMs,
+                                                 bool mustNotExist, int bufferSizeBytes)
+{
+    disconnect();
+
+    if (auto channel = SharedMemoryChannel::create (name, magicMessageHeader, bufferSizeBytes, mustNotExist))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = timeoutMs;
+        initialiseWithSharedMemory (std::move (channel));
+        return true;
+    }
+
+    return false;
+}
+
+bool InterprocessConnection::connectToSharedMemory (const String& name, int timeoutMs)
+{
+    disconnect();
+
+    if (auto channel = SharedMemoryChannel::open (name, magicMessageHeader))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = timeoutMs;
+        initialiseWithSharedMemory (std::move (channel));
+        return true;
+    }
+
+    return false;
+}
+
+void InterprocessConnection::setSocketEventMultiplexer (SocketEventMultiplexer* multiplexerToUse)
+{
+    // This has to be set before the socket is connected!
+    jassert (socket == nullptr);
+
+    if (multiplexerToUse == nullptr)
+        multiplexedSocket.reset();
+    else if (multiplexedSocket == nullptr || &multiplexedSocket->multiplexer != multiplexerToUse)
+        multiplexedSocket = std::make_unique<MultiplexedSocket> (*multiplexerToUse);
+}
+
 void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
 {
     thread->signalThreadShouldExit();
 
+    if (stopWatchingSocket())
+        threadIsRunning = false;
+
     {
         const ScopedReadLock sl (pipeAndSocketLock);
-        if (socket != nullptr)  socket->close();
-        if (pipe != nullptr)    pipe->close();
+        if (socket != nullptr)          socket->close();
+        if (pipe != nullptr)            pipe->close();
+        if (sharedMemory != nullptr)    sharedMemory->close();
     }
 
     thread->stopThread (timeoutMs);
@@ -182,6 +271,7 @@ void InterprocessConnection::deletePipeAndSocket()
     const ScopedWriteLock sl (pipeAndSocketLock);
     socket.reset();
     pipe.reset();
+    sharedMemory.reset();
 }
 
 bool InterprocessConnection::isConnected() const
@@ -189,7 +279,8 @@ bool InterprocessConnection::isConnected() const
     const ScopedReadLock sl (pipeAndSocketLock);
 
     return ((socket != nullptr && socket->isConnected())
-              || (pipe != nullptr && pipe->isOpen()))
+              || (pipe != nullptr && pipe->isOpen())
+              || (sharedMemory != nullptr && sharedMemory->isOpen()))
             && threadIsRunning;
 }
 
@@ -198,7 +289,7 @@ String InterprocessConnection::getConnectedHostName() const
     {
         const ScopedReadLock sl (pipeAndSocketLock);
 
-        if (pipe == nullptr && socket == nullptr)
+        if (pipe == nullptr && socket == nullptr && sharedMemory == nullptr)
             return {};
 
         if (socket != nullptr && ! socket->isLocal())
@@ -211,12 +302,25 @@ String InterprocessConnection::getConnectedHostName() const
 //==============================================================================
 bool InterprocessConnection::sendMessage (const MemoryBlock& message)
 {
+    return sendMessage (message.getData(), message.getSize());
+}
+
+bool InterprocessConnection::sendMessage (const void* message, size_t numBytes)
+{
+    {
+        const ScopedReadLock sl (pipeAndSocketLock);
+
+        // Shared memory doesn't need the header, as the channel checks the magic number when it connects
+        if (sharedMemory != nullptr)
+            return sharedMemory->write (message, numBytes, pipeReceiveMessageTimeout);
+    }
+
     uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
-                                ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
+                                ByteOrder::swapIfBigEndian ((uint32) numBytes) };
 
-    MemoryBlock messageData (sizeof (messageHeader) + message.getSize());
+    MemoryBlock messageData (sizeof (messageHeader) + numBytes);
     messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
-    messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
+    messageData.copyFrom (message, sizeof (messageHeader), numBytes);
 
     return writeData (messageData.getData(), (int) messageData.getSize()) == (int) messageData.getSize();
 }
@@ -226,7 +330,8 @@ int InterprocessConnection::writeData (void* data, int dataSize)
     const ScopedReadLock sl (pipeAndSocketLock);
 
     if (socket != nullptr)
-        return socket->write (data, dataSize);
+        return socket->isNonBlocking() ? writeToMultiplexedSocket (data, dataSize)
+                                       : socket->write (data, dataSize);
 
     if (pipe != nullptr)
         return pipe->write (data, dataSize, pipeReceiveMessageTimeout);
@@ -247,7 +352,41 @@ void InterprocessConnection::initialiseWithSocket (std::unique_ptr<StreamingSock
 {
     jassert (socket == nullptr && pipe == nullptr);
     socket = std::move (newSocket);
-    initialise();
+
+    if (multiplexedSocket != nullptr)
+        initialiseWithMultiplexer();
+    else
+        initialise();
+}
+
+void InterprocessConnection::initialiseWithMultiplexer()
+{
+    safeAction->setSafe (true);
+    threadIsRunning = true; // (for a multiplexed socket, this means it's being watched)
+    connectionMadeInt();
+
+    auto& m = *multiplexedSocket;
+    const ScopedLock sl (m.registrationLock);
+
+    m.numInputBytes = 0;
+    m.outputStart = m.outputEnd = 0;
+    m.isWatchingForWrite = false;
+
+    const auto session = ++m.session;
+    const auto handle = socket->getRawSocketHandle();
+
+    if (socket->setNonBlocking (true)
+         && m.multiplexer.addSocket (handle, SocketEventMultiplexer::readable,
+                                     [this, session] (int flags) { handleSocketEvents (session, flags); }))
+    {
+        m.registeredHandle = handle;
+        return;
+    }
+
+    // If the multiplexer can't take it, fall back to using a thread
+    jassertfalse;
+    socket->setNonBlocking (false);
+    thread->startThread();
 }
 
 void InterprocessConnection::initialiseWithPipe (std::unique_ptr<NamedPipe> newPipe)
@@ -257,6 +396,13 @@ void InterprocessConnection::initialiseWithPipe (std::unique_ptr<NamedPipe> newP
     initialise();
 }
 
+void InterprocessConnection::initialiseWithSharedMemory (std::unique_ptr<SharedMemoryChannel> newChannel)
+{
+    jassert (socket == nullptr && pipe == nullptr && sharedMemory == nullptr);
+    sharedMemory = std::move (newChannel);
+    initialise();
+}
+
 //==============================================================================
 struct ConnectionStateMessage final : public MessageManager::MessageBase
 {
@@ -309,8 +455,8 @@ void InterprocessConnection::connectionLostInt()
 
 struct DataDeliveryMessage final : public Message
 {
-    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, const MemoryBlock& d)
-        : safeAction (ipc), data (d)
+    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, MemoryBlock d)
+        : safeAction (ipc), data (std::move (d))
     {}
 
     void messageCallback() override
@@ -330,9 +476,35 @@ void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
     jassert (callbackConnectionState);
 
     if (useMessageThread)
+    {
         (new DataDeliveryMessage (safeAction, data))->post();
+    }
     else
-        messageReceived (data);
+    {
+        // This lets the default messageDataReceived() pass the block on without copying it again
+        const ScopedValueSetter<const MemoryBlock*> svs (messageBeingDelivered, &data);
+        messageDataReceived (data.getData(), data.getSize());
+    }
+}
+
+void InterprocessConnection::deliverDataInt (const void* data, size_t numBytes)
+{
+    jassert (callbackConnectionState);
+
+    if (useMessageThread)
+        (new DataDeliveryMessage (safeAction, MemoryBlock (data, numBytes)))->post();
+    else
+        messageDataReceived (data, numBytes);
+}
+
+void InterprocessConnection::messageDataReceived (const void* data, size_t numBytes)
+{
+    if (messageBeingDelivered != nullptr
+         && messageBeingDelivered->getData() == data
+         && messageBeingDelivered->getSize() == numBytes)
+        messageReceived (*messageBeingDelivered);
+    else
+        messageReceived (MemoryBlock (data, numBytes));
 }
 
 //==============================================================================
@@ -398,6 +570,230 @@ bool InterprocessConnection::readNextMessage()
     return false;
 }
 
+//==============================================================================
+bool InterprocessConnection::stopWatchingSocket()
+{
+    if (multiplexedSocket == nullptr)
+        return false;
+
+    auto& m = *multiplexedSocket;
+    int handle;
+
+    {
+        const ScopedLock sl (m.registrationLock);
+        handle = std::exchange (m.registeredHandle, -1);
+    }
+
+    // This waits for the callback to finish, unless it's being called from the callback
+    if (handle >= 0)
+        m.multiplexer.removeSocket (handle);
+
+    return handle >= 0;
+}
+
+bool InterprocessConnection::isWatchingSocket (uint32 session)
+{
+    auto& m = *multiplexedSocket;
+    const ScopedLock sl (m.registrationLock);
+    return m.registeredHandle >= 0 && m.session == session;
+}
+
+void InterprocessConnection::handleSocketEvents (uint32 session, int eventFlags)
+{
+    if ((eventFlags & SocketEventMultiplexer::writable) != 0)
+        flushSocketOutput();
+
+    if ((eventFlags & (SocketEventMultiplexer::readable | SocketEventMultiplexer::error)) != 0)
+        readFromSocket (session);
+}
+
+void InterprocessConnection::readFromSocket (uint32 session)
+{
+    auto& m = *multiplexedSocket;
+
+    // Reading is limited to a few chunks per callback, so that one busy connection can't
+    // hold up the others. If there's more data waiting, the callback will be called again.
+    for (int i = 0; i < 8; ++i)
+    {
+        constexpr size_t chunkSize = 65536;
+        auto spaceNeeded = m.numInputBytes + chunkSize;
+
+        if (m.numInputBytes >= messageHeaderSize)
+        {
+            // The size comes from the other end of the connection, so the header has to be
+            // checked before the buffer is made big enough for it
+            uint32 messageHeader[2];
+            memcpy (messageHeader, m.input.getData(), sizeof (messageHeader));
+            const auto messageSize = ByteOrder::swapIfBigEndian (messageHeader[1]);
+
+            if (ByteOrder::swapIfBigEndian (messageHeader[0]) != magicMessageHeader
+                 || messageSize > maximumMessageSize)
+            {
+                socketConnectionLost();
+                return;
+            }
+
+            // make room for the whole of the current message, so that it arrives in one block
+            spaceNeeded = jmax (spaceNeeded, messageHeaderSize + messageSize);
+        }
+
+        m.input.ensureSize (spaceNeeded);
+        int numRead;
+
+        {
+            const ScopedReadLock sl (pipeAndSocketLock);
+
+            if (socket == nullptr)
+                return;
+
+            numRead = socket->read (addBytesToPointer (m.input.getData(), m.numInputBytes),
+                                    (int) jmin (m.input.getSize() - m.numInputBytes, (size_t) std::numeric_limits<int>::max()),
+                                    false);
+        }
+
+        if (numRead == 0)
+            return;
+
+        if (numRead < 0)
+        {
+            socketConnectionLost();
+            return;
+        }
+
+        m.numInputBytes += (size_t) numRead;
+
+        if (! deliverSocketMessages (session))
+            return;
+    }
+}
+
+bool InterprocessConnection::deliverSocketMessages (uint32 session)
+{
+    auto& m = *multiplexedSocket;
+    size_t pos = 0;
+
+    while (m.numInputBytes - pos >= messageHeaderSize)
+    {
+        uint32 messageHeader[2];
+        memcpy (messageHeader, addBytesToPointer (m.input.getData(), pos), sizeof (messageHeader));
+
+        const auto bytesInMessage = ByteOrder::swapIfBigEndian (messageHeader[1]);
+
+        if (ByteOrder::swapIfBigEndian (messageHeader[0]) != magicMessageHeader
+             || bytesInMessage > maximumMessageSize)
+        {
+            socketConnectionLost();
+            return false;
+        }
+
+        if (m.numInputBytes - pos - sizeof (messageHeader) < bytesInMessage)
+            break;
+
+        pos += sizeof (messageHeader);
+
+        if (bytesInMessage > 0)
+            deliverDataInt (addBytesToPointer (m.input.getData(), pos), bytesInMessage);
+
+        pos += bytesInMessage;
+
+        // the callback may have disconnected or reconnected the socket
+        if (! isWatchingSocket (session))
+            return false;
+    }
+
+    if (pos > 0)
+    {
+        m.numInputBytes -= pos;
+        memmove (m.input.getData(), addBytesToPointer (m.input.getData(), pos), m.numInputBytes);
+    }
+
+    return true;
+}
+
+void InterprocessConnection::socketConnectionLost()
+{
+    // If this fails, disconnect() is already cleaning up on another thread
+    if (stopWatchingSocket())
+    {
+        deletePipeAndSocket();
+        connectionLostInt();
+        threadIsRunning = false;
+    }
+}
+
+int InterprocessConnection::writeToMultiplexedSocket (const void* data, int dataSize)
+{
+    auto& m = *multiplexedSocket;
+    const ScopedLock sl (m.outputLock);
+    int numWritten = 0;
+
+    if (m.outputStart == m.outputEnd)
+    {
+        m.outputStart = m.outputEnd = 0;
+        numWritten = socket->write (data, dataSize);
+
+        if (numWritten < 0 || numWritten == dataSize)
+            return numWritten;
+    }
+    else if (m.outputStart > m.output.getSize() / 2)
+    {
+        m.outputEnd -= m.outputStart;
+        memmove (m.output.getData(), addBytesToPointer (m.output.getData(), m.outputStart), m.outputEnd);
+        m.outputStart = 0;
+    }
+
+    // queue whatever the socket couldn't take, and send it when it becomes writable
+    const auto numToQueue = (size_t) (dataSize - numWritten);
+    const auto spaceNeeded = m.outputEnd + numToQueue;
+
+    if (spaceNeeded > m.output.getSize())
+        m.output.ensureSize (jmax (spaceNeeded, m.output.getSize() + m.output.getSize() / 2));
+
+    memcpy (addBytesToPointer (m.output.getData(), m.outputEnd), addBytesToPointer (data, numWritten), numToQueue);
+    m.outputEnd = spaceNeeded;
+
+    if (! m.isWatchingForWrite)
+    {
+        m.isWatchingForWrite = true;
+        m.multiplexer.setEventsToWatch (socket->getRawSocketHandle(),
+                                        SocketEventMultiplexer::readable | SocketEventMultiplexer::writable);
+    }
+
+    return dataSize;
+}
+
+void InterprocessConnection::flushSocketOutput()
+{
+    const ScopedReadLock sl (pipeAndSocketLock);
+
+    if (socket == nullptr)
+        return;
+
+    auto& m = *multiplexedSocket;
+    const ScopedLock ol (m.outputLock);
+
+    while (m.outputStart < m.outputEnd)
+    {
+        const auto numWritten = socket->write (addBytesToPointer (m.output.getData(), m.outputStart),
+                                               (int) jmin (m.outputEnd - m.outputStart, (size_t) std::numeric_limits<int>::max()));
+
+        if (numWritten == 0)
+            return;
+
+        // If the connection has failed, the data is thrown away and the failure
+        // will be noticed when the socket is next read
+        if (numWritten < 0)
+            break;
+
+        m.outputStart += (size_t) numWritten;
+    }
+
+    m.outputStart = m.outputEnd = 0;
+    m.isWatchingForWrite = false;
+    m.multiplexer.setEventsToWatch (socket->getRawSocketHandle(), SocketEventMultiplexer::readable);
+}
+
+//==============================================================================
 void InterprocessConnection::runThread()
 {
     while (! thread->threadShouldExit())
@@ -428,6 +824,26 @@ void InterprocessConnection::runThread()
                 break;
             }
         }
+        else if (sharedMemory != nullptr)
+        {
+            const auto isOpen = sharedMemory->readMessages (100, [this] (const void* data, size_t numBytes)
+            {
+                deliverDataInt (data, numBytes);
+            });
+
+            if (! isOpen)
+            {
+                if (! thread->threadShouldExit())
+                {
+                    deletePipeAndSocket();
+                    connectionLostInt();
+                }
+
+                break;
+            }
+
+            continue;
+        }
         else
         {
             break;
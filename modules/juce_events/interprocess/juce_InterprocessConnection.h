@@ -41,20 +41,25 @@ class MemoryBlock;
 
 //==============================================================================
 /**
-    Manages a simple two-way messaging connection to another process, using either
-    a socket or a named pipe as the transport medium.
+    Manages a simple two-way messaging connection to another process, using a socket,
+    a named pipe or a block of shared memory as the transport medium.
 
-    To connect to a waiting socket or an open pipe, use the connectToSocket() or
-    connectToPipe() methods. If this succeeds, messages can be sent to the other end,
-    and incoming messages will result in a callback via the messageReceived()
-    method.
+    To connect to a waiting socket, an open pipe or some shared memory, use the
+    connectToSocket(), connectToPipe() or connectToSharedMemory() methods. If this
+    succeeds, messages can be sent to the other end, and incoming messages will result
+    in a callback via the messageReceived() method.
 
     To open a pipe and wait for another client to connect to it, use the createPipe()
-    method.
+    method. For the lowest latency between two processes on the same machine, use
+    createSharedMemory() instead.
 
     To act as a socket server and create connections for one or more client, see the
     InterprocessConnectionServer class.
 
+    Normally each connection has a thread of its own, which reads the incoming messages.
+    If you need a large number of socket connections, use setSocketEventMultiplexer() to
+    let them share the threads of a SocketEventMultiplexer instead.
+
     IMPORTANT NOTE: Your derived Connection class *must* call `disconnect` in its destructor
     in order to cancel any pending messages before the class is destroyed.
 
@@ -132,10 +137,74 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs, bool mustNotExist = false);
 
+    /** Tries to create a block of shared memory for another process on the same machine to
+        connect to.
+
+        Messages are passed through a ring buffer in the shared memory for each direction, so
+        sending a message is a single copy, and a process that's waiting for a message is only
+        woken when one arrives. This makes it much faster than a pipe or socket, for both
+        throughput and latency.
+
+        The other process should use connectToSharedMemory() with the same name to connect
+        to it. Messages can be sent before the other process has connected, and will be
+        waiting in the buffer when it does.
+
+        This is currently only supported on Linux, and will return false on other platforms,
+        so you may want to fall back to using createPipe() if it fails.
+
+        @param name                     the name to use for the shared memory - this should be
+                                        unique to your app
+        @param sendMessageTimeoutMs     how long sendMessage() should wait for space if the buffer
+                                        is full, or -1 for an infinite timeout
+        @param mustNotExist             if set to true, the method will fail if shared memory with
+                                        this name already exists
+        @param bufferSizeBytes          the size of the buffer for each direction. Messages that
+                                        are bigger than a quarter of this size are split up and
+                                        reassembled by the receiver, which is slower.
+        @returns true if the shared memory was created
+        @see connectToSharedMemory
+    */
+    bool createSharedMemory (const String& name,
+                             int sendMessageTimeoutMs,
+                             bool mustNotExist = false,
+                             int bufferSizeBytes = 1 << 20);
+
+    /** Tries to connect to a block of shared memory that another process has created
+        with createSharedMemory().
+
+        Only one connection can be made to each block of shared memory.
+
+        @param name                     the name that was passed to createSharedMemory()
+        @param sendMessageTimeoutMs     how long sendMessage() should wait for space if the buffer
+                                        is full, or -1 for an infinite timeout
+        @returns true if it connects successfully
+        @see createSharedMemory
+    */
+    bool connectToSharedMemory (const String& name, int sendMessageTimeoutMs);
+
+    /** Makes socket connections use a SocketEventMultiplexer to read their messages,
+        rather than starting a thread for each connection.
+
+        This must be called before the socket is connected, and doesn't affect pipes or
+        shared memory, which always use a thread. Pass nullptr to go back to using a thread.
+        The multiplexer must not be deleted until disconnect() has been called.
+
+        When a multiplexer is used, sendMessage() doesn't wait for the data to be sent. Any
+        data that the socket can't take straight away is kept in a queue, and sent when the
+        socket is ready for it.
+
+        If callbacksOnMessageThread is false, the callbacks will be made on one of the
+        multiplexer's threads, which is shared with other connections, so they should
+        return quickly.
+
+        @see InterprocessConnectionServer::beginWaitingForSocket
+    */
+    void setSocketEventMultiplexer (SocketEventMultiplexer* multiplexerToUse);
+
     /** Whether the disconnect call should trigger callbacks. */
     enum class Notify { no, yes };
 
-    /** Disconnects and closes any currently-open sockets or pipes.
+    /** Disconnects and closes any currently-open sockets, pipes or shared memory.
 
         Derived classes *must* call this in their destructors in order to avoid undefined
         behaviour.
@@ -145,13 +214,13 @@ public:
     */
     void disconnect (int timeoutMs = -1, Notify notify = Notify::yes);
 
-    /** True if a socket or pipe is currently active. */
+    /** True if a socket, pipe or shared memory connection is currently active. */
     bool isConnected() const;
 
-    /** Returns the socket that this connection is using (or nullptr if it uses a pipe). */
+    /** Returns the socket that this connection is using (or nullptr if it uses a pipe or shared memory). */
     StreamingSocket* getSocket() const noexcept                 { return socket.get(); }
 
-    /** Returns the pipe that this connection is using (or nullptr if it uses a socket). */
+    /** Returns the pipe that this connection is using (or nullptr if it uses a socket or shared memory). */
     NamedPipe* getPipe() const noexcept                         { return pipe.get(); }
 
     /** Returns the name of the machine at the other end of this connection.
@@ -170,6 +239,13 @@ public:
     */
     bool sendMessage (const MemoryBlock& message);
 
+    /** Tries to send a message to the other end of this connection, without needing
+        the data to be in a MemoryBlock.
+
+        @see sendMessage
+    */
+    bool sendMessage (const void* messageData, size_t numBytes);
+
     //==============================================================================
     /** Called when the connection is first connected.
 
@@ -200,12 +276,30 @@ public:
     */
     virtual void messageReceived (const MemoryBlock& message) = 0;
 
+    /** Called when a message arrives, if the connection wasn't created with the
+        callbacksOnMessageThread flag set.
+
+        The data is only valid until this method returns. For a shared memory connection,
+        it points straight into the shared buffer, so overriding this method lets you handle
+        a message without it being copied at all. Note that the memory can also be written
+        by the other process, so don't assume that the data is trustworthy or won't change.
+
+        The default implementation calls messageReceived() with the data in a MemoryBlock.
+        When the connection uses the message thread, messageReceived() is called instead.
+
+        @see messageReceived
+    */
+    virtual void messageDataReceived (const void* data, size_t numBytes);
+
 
 private:
     //==============================================================================
     ReadWriteLock pipeAndSocketLock;
     std::unique_ptr<StreamingSocket> socket;
     std::unique_ptr<NamedPipe> pipe;
+
+    struct SharedMemoryChannel;
+    std::unique_ptr<SharedMemoryChannel> sharedMemory;
     bool callbackConnectionState = false;
     const bool useMessageThread;
     const uint32 magicMessageHeader;
@@ -215,10 +309,12 @@ private:
     void initialise();
     void initialiseWithSocket (std::unique_ptr<StreamingSocket>);
     void initialiseWithPipe (std::unique_ptr<NamedPipe>);
+    void initialiseWithSharedMemory (std::unique_ptr<SharedMemoryChannel>);
     void deletePipeAndSocket();
     void connectionMadeInt();
     void connectionLostInt();
     void deliverDataInt (const MemoryBlock&);
+    void deliverDataInt (const void*, size_t);
     bool readNextMessage();
     int readData (void*, int);
 
@@ -232,6 +328,21 @@ private:
     void runThread();
     int writeData (void*, int);
 
+    struct MultiplexedSocket;
+    std::unique_ptr<MultiplexedSocket> multiplexedSocket;
+
+    void initialiseWithMultiplexer();
+    bool stopWatchingSocket();
+    bool isWatchingSocket (uint32 session);
+    void handleSocketEvents (uint32 session, int eventFlags);
+    void readFromSocket (uint32 session);
+    bool deliverSocketMessages (uint32 session);
+    void socketConnectionLost();
+    int writeToMultiplexedSocket (const void*, int);
+    void flushSocketOutput();
+
+    const MemoryBlock* messageBeingDelivered = nullptr;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnection)
 };
 
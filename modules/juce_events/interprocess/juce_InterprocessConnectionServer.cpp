@@ -61,10 +61,35 @@ bool InterprocessConnectionServer::beginWaitingForSocket (const int portNumber,
     return false;
 }
 
+bool InterprocessConnectionServer::beginWaitingForSocket (SocketEventMultiplexer& multiplexerToUse,
+                                                          const int portNumber, const String& bindAddress)
+{
+    stop();
+
+    socket.reset (new StreamingSocket());
+    socket->setNonBlocking (true);
+
+    if (socket->createListener (portNumber, bindAddress)
+         && multiplexerToUse.addSocket (socket->getRawSocketHandle(), SocketEventMultiplexer::readable,
+                                        [this] (int) { acceptPendingConnections(); }))
+    {
+        multiplexer = &multiplexerToUse;
+        return true;
+    }
+
+    socket.reset();
+    return false;
+}
+
 void InterprocessConnectionServer::stop()
 {
     signalThreadShouldExit();
 
+    if (multiplexer != nullptr && socket != nullptr)
+        multiplexer->removeSocket (socket->getRawSocketHandle());
+
+    multiplexer = nullptr;
+
     if (socket != nullptr)
         socket->close();
 
@@ -89,4 +114,19 @@ void InterprocessConnectionServer::run()
     }
 }
 
+void InterprocessConnectionServer::acceptPendingConnections()
+{
+    // The listener is non-blocking, so this returns nullptr once there are no more waiting
+    while (auto* newSocket = socket->waitForNextConnection())
+    {
+        std::unique_ptr<StreamingSocket> clientSocket (newSocket);
+
+        if (auto* newConnection = createConnectionObject())
+        {
+            newConnection->setSocketEventMultiplexer (multiplexer);
+            newConnection->initialiseWithSocket (std::move (clientSocket));
+        }
+    }
+}
+
 } // namespace juce
@@ -79,6 +79,24 @@ public:
     */
     bool beginWaitingForSocket (int portNumber, const String& bindAddress = String());
 
+    /** Starts listening on the given port number, using a SocketEventMultiplexer rather
+        than a thread of its own.
+
+        This works like the other version of beginWaitingForSocket(), but the new
+        connections are accepted on one of the multiplexer's threads, and each connection
+        object that createConnectionObject() returns is set up to read its socket using
+        the same multiplexer (see InterprocessConnection::setSocketEventMultiplexer()).
+        This lets a server handle many clients without needing a thread for each one.
+
+        The multiplexer must not be deleted until stop() has been called, and the
+        connections have been disconnected.
+
+        @see createConnectionObject, stop
+    */
+    bool beginWaitingForSocket (SocketEventMultiplexer& multiplexerToUse,
+                                int portNumber,
+                                const String& bindAddress = String());
+
     /** Terminates the listener thread, if it's active.
 
         @see beginWaitingForSocket
@@ -109,8 +127,10 @@ protected:
 private:
     //==============================================================================
     std::unique_ptr<StreamingSocket> socket;
+    SocketEventMultiplexer* multiplexer = nullptr;
 
     void run() override;
+    void acceptPendingConnections();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InterprocessConnectionServer)
 };
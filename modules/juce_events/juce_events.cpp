@@ -63,6 +63,11 @@
 
 #elif JUCE_LINUX || JUCE_BSD
  #include <unistd.h>
+
+ #if JUCE_LINUX
+  #include <linux/futex.h>
+  #include "native/juce_SharedMemory_linux.h"
+ #endif
 #endif
 
 //==============================================================================
@@ -77,6 +82,12 @@
 #include "timers/juce_MultiTimer.cpp"
 #include "timers/juce_Timer.cpp"
 #include "interprocess/juce_ChildProcessManager.cpp"
+
+#if JUCE_LINUX
+ #include "native/juce_SharedMemory_linux.cpp"
+ #include "native/juce_SharedMemoryChannel_linux.cpp"
+#endif
+
 #include "interprocess/juce_InterprocessConnection.cpp"
 #include "interprocess/juce_InterprocessConnectionServer.cpp"
 #include "interprocess/juce_ConnectedChildProcess.cpp"
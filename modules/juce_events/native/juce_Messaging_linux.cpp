@@ -36,34 +36,36 @@ namespace juce
 {
 
 //==============================================================================
+/*
+    A queue of messages that can be posted from any thread, and which are delivered on the
+    message thread.
+
+    Each post pushes a new node onto a lock-free stack, so a message that's posted more than
+    once is delivered once for each post. Only the post that makes the stack non-empty needs
+    to wake the message thread, which then takes the whole stack in one go and appends it, in
+    the order it was posted, to a queue of messages to deliver. Messages posted while that
+    queue is being delivered will wake the message thread again, so other events get a chance
+    to run between batches.
+
+    If a callback runs a nested or modal loop, the rest of the queue has to be delivered from
+    inside that loop, before anything that's posted later. So while there are messages left
+    in the queue, the message thread keeps itself woken up.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
     {
-        [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, msgpipe);
-        jassert (err == 0);
-
-        LinuxEventLoop::registerFdCallback (getReadHandle(),
-                                            [this] (int fd)
-                                            {
-                                                while (auto msg = popNextMessage (fd))
-                                                {
-                                                    JUCE_TRY
-                                                    {
-                                                        msg->messageCallback();
-                                                    }
-                                                    JUCE_CATCH_EXCEPTION
-                                                }
-                                            });
+        LinuxEventLoop::registerFdCallback (wakeUpEvent.getReadHandle(),
+                                            [this] (int) { dispatchPendingMessages(); });
     }
 
     ~InternalMessageQueue()
     {
-        LinuxEventLoop::unregisterFdCallback (getReadHandle());
+        LinuxEventLoop::unregisterFdCallback (wakeUpEvent.getReadHandle());
 
-        close (getReadHandle());
-        close (getWriteHandle());
+        deleteNodes (pendingMessages.exchange (nullptr));
+        deleteNodes (std::exchange (firstToDeliver, nullptr));
 
         clearSingletonInstance();
     }
@@ -71,48 +73,142 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        auto* node = new Node { msg, pendingMessages.load (std::memory_order_relaxed) };
 
-        if (bytesInSocket < maxBytesInSocketQueue)
-        {
-            bytesInSocket++;
+        while (! pendingMessages.compare_exchange_weak (node->next, node, std::memory_order_release, std::memory_order_relaxed))
+        {}
 
-            ScopedUnlock ul (lock);
-            unsigned char x = 0xff;
-            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, 1);
-        }
+        if (node->next == nullptr)
+            wakeUpEvent.signal();
     }
 
     //==============================================================================
     JUCE_DECLARE_SINGLETON_INLINE (InternalMessageQueue, false)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    //==============================================================================
+    /*  A file descriptor that becomes readable when the message thread needs to wake up.
+        On Linux this is an eventfd, and elsewhere it's one end of a socket pair.
+    */
+    class WakeUpEvent
+    {
+    public:
+        WakeUpEvent()
+        {
+           #if JUCE_LINUX
+            fds[0] = fds[1] = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+            jassert (fds[0] >= 0);
+           #else
+            [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, fds);
+            jassert (err == 0);
+            fcntl (fds[0], F_SETFL, fcntl (fds[0], F_GETFL) | O_NONBLOCK);
+            fcntl (fds[1], F_SETFL, fcntl (fds[1], F_GETFL) | O_NONBLOCK);
+           #endif
+        }
+
+        ~WakeUpEvent()
+        {
+            close (fds[0]);
+
+            if (fds[1] != fds[0])
+                close (fds[1]);
+        }
+
+        int getReadHandle() const noexcept   { return fds[0]; }
 
-    int msgpipe[2];
-    int bytesInSocket = 0;
-    static constexpr int maxBytesInSocketQueue = 128;
+        void signal() const noexcept
+        {
+           #if JUCE_LINUX
+            const uint64_t value = 1;
+           #else
+            const unsigned char value = 0xff;
+           #endif
 
-    int getWriteHandle() const noexcept  { return msgpipe[0]; }
-    int getReadHandle() const noexcept   { return msgpipe[1]; }
+            [[maybe_unused]] auto numBytes = write (fds[1], &value, sizeof (value));
+        }
 
-    MessageManager::MessageBase::Ptr popNextMessage (int fd) noexcept
+        void clear() const noexcept
+        {
+            char buffer[64];
+
+            while (read (fds[0], buffer, sizeof (buffer)) > 0)
+            {}
+        }
+
+    private:
+        int fds[2];
+
+        JUCE_DECLARE_NON_COPYABLE (WakeUpEvent)
+    };
+
+    //==============================================================================
+    struct Node
     {
-        const ScopedLock sl (lock);
+        MessageManager::MessageBase::Ptr message;
+        Node* next;
+    };
+
+    static void deleteNodes (Node* node) noexcept
+    {
+        while (node != nullptr)
+            delete std::exchange (node, node->next);
+    }
+
+    // This is only called on the message thread, but may be re-entered from a callback
+    void dispatchPendingMessages()
+    {
+        // The event has to be cleared before the messages are taken, so that a message
+        // posted in between will either be taken now, or will signal the event again
+        wakeUpEvent.clear();
+        isWakeUpPending = false;
 
-        if (bytesInSocket > 0)
+        // The stack holds the newest message first, so it's reversed to deliver them in order
+        Node* batch = nullptr;
+        Node* batchEnd = nullptr;
+
+        for (auto* node = pendingMessages.exchange (nullptr, std::memory_order_acquire); node != nullptr;)
         {
-            --bytesInSocket;
+            if (batchEnd == nullptr)
+                batchEnd = node;
 
-            ScopedUnlock ul (lock);
-            unsigned char x;
-            [[maybe_unused]] auto numBytes = read (fd, &x, 1);
+            auto* next = node->next;
+            node->next = batch;
+            batch = std::exchange (node, next);
         }
 
-        return queue.removeAndReturn (0);
+        if (batch != nullptr)
+        {
+            (firstToDeliver == nullptr ? firstToDeliver : lastToDeliver->next) = batch;
+            lastToDeliver = batchEnd;
+        }
+
+        while (firstToDeliver != nullptr)
+        {
+            std::unique_ptr<Node> node (std::exchange (firstToDeliver, firstToDeliver->next));
+
+            if (firstToDeliver == nullptr)
+                lastToDeliver = nullptr;
+            else if (! std::exchange (isWakeUpPending, true))
+                wakeUpEvent.signal();
+
+            const auto msg = std::move (node->message);
+            node.reset();
+
+            JUCE_TRY
+            {
+                msg->messageCallback();
+            }
+            JUCE_CATCH_EXCEPTION
+        }
     }
+
+    WakeUpEvent wakeUpEvent;
+    std::atomic<Node*> pendingMessages { nullptr };
+
+    // These are only used on the message thread
+    Node* firstToDeliver = nullptr;
+    Node* lastToDeliver = nullptr;
+    bool isWakeUpPending = false;
 };
 
 //==============================================================================
@@ -121,8 +217,8 @@ private:
 
     The callback for a particular FD should be called whenever that file has data to read.
 
-    For standalone apps, the main thread will call poll to wait for new data on any FD, and then
-    call the associated callbacks for any FDs that changed.
+    For standalone apps, the main thread will wait for new data on any FD (using epoll on Linux,
+    or poll elsewhere), and then call the associated callbacks for any FDs that changed.
 
     For plugins, the host (generally) provides some kind of run loop mechanism instead.
     - In VST2 plugins, the host should call effEditIdle at regular intervals, and plugins can
@@ -140,21 +236,21 @@ struct InternalRunLoop
 public:
     InternalRunLoop() = default;
 
+    ~InternalRunLoop()
+    {
+        if (epollFd >= 0)
+            close (epollFd);
+    }
+
     void registerFdCallback (int fd, std::function<void()>&& cb, short eventMask)
     {
         {
             const ScopedLock sl (lock);
 
-            callbacks.emplace (fd, std::make_shared<std::function<void()>> (std::move (cb)));
-
-            const auto iter = getPollfd (fd);
-
-            if (iter == pfds.end() || iter->fd != fd)
-                pfds.insert (iter, { fd, eventMask, 0 });
+            if (callbacks.emplace (fd, std::make_shared<std::function<void()>> (std::move (cb))).second)
+                addFd (fd, eventMask);
             else
                 jassertfalse;
-
-            jassert (pfdsAreSorted());
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -165,16 +261,10 @@ public:
         {
             const ScopedLock sl (lock);
 
-            callbacks.erase (fd);
-
-            const auto iter = getPollfd (fd);
-
-            if (iter != pfds.end() && iter->fd == fd)
-                pfds.erase (iter);
+            if (callbacks.erase (fd) != 0)
+                removeFd (fd);
             else
                 jassertfalse;
-
-            jassert (pfdsAreSorted());
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -182,14 +272,21 @@ public:
 
     bool dispatchPendingEvents()
     {
-        callbackStorage.clear();
-        getFunctionsToCallThisTime (callbackStorage);
+        // A callback may run a nested loop that calls this again, so the storage is moved out
+        // while it's being used, and put back afterwards to be reused
+        auto functions = std::move (callbackStorage);
+        functions.clear();
+        getFunctionsToCallThisTime (functions);
 
         // CriticalSection should be available during the callback
-        for (auto& fn : callbackStorage)
-            (*fn)();
-
-        return ! callbackStorage.empty();
+        for (auto& [fd, fn] : functions)
+            if (isStillRegistered (fd, fn))
+                (*fn)();
+
+        const auto anyCalled = ! functions.empty();
+        functions.clear();
+        callbackStorage = std::move (functions);
+        return anyCalled;
     }
 
     void dispatchEvent (int fd) const
@@ -208,6 +305,16 @@ public:
 
     bool sleepUntilNextEvent (int timeoutMs)
     {
+       #if JUCE_LINUX
+        // The epoll set can be changed while another thread is waiting on it, so
+        // there's no need to hold the lock here
+        if (epollFd >= 0)
+        {
+            epoll_event event{};
+            return epoll_wait (epollFd, &event, 1, timeoutMs) != 0;
+        }
+       #endif
+
         const ScopedLock sl (lock);
         return poll (pfds.data(), static_cast<nfds_t> (pfds.size()), timeoutMs) != 0;
     }
@@ -232,6 +339,7 @@ public:
 
 private:
     using SharedCallback = std::shared_ptr<std::function<void()>>;
+    using FdAndCallback = std::pair<int, SharedCallback>;
 
     /*  Appends any functions that need to be called to the passed-in vector.
 
@@ -239,10 +347,27 @@ private:
         locking or racing in the event that the function attempts to register/deregister a
         new FD callback.
     */
-    void getFunctionsToCallThisTime (std::vector<SharedCallback>& functions)
+    void getFunctionsToCallThisTime (std::vector<FdAndCallback>& functions)
     {
         const ScopedLock sl (lock);
 
+       #if JUCE_LINUX
+        if (epollFd >= 0)
+        {
+            const auto numReady = epoll_wait (epollFd, readyEvents.data(), (int) readyEvents.size(), 0);
+
+            for (int i = 0; i < numReady; ++i)
+            {
+                const auto iter = callbacks.find (readyEvents[(size_t) i].data.fd);
+
+                if (iter != callbacks.end())
+                    functions.emplace_back (*iter);
+            }
+
+            return;
+        }
+       #endif
+
         if (! sleepUntilNextEvent (0))
             return;
 
@@ -253,11 +378,73 @@ private:
                 const auto iter = callbacks.find (pfd.fd);
 
                 if (iter != callbacks.end())
-                    functions.emplace_back (iter->second);
+                    functions.emplace_back (*iter);
             }
         }
     }
 
+    // An earlier callback in the same batch may have unregistered this one
+    bool isStillRegistered (int fd, const SharedCallback& fn) const
+    {
+        const ScopedLock sl (lock);
+        const auto iter = callbacks.find (fd);
+        return iter != callbacks.end() && iter->second == fn;
+    }
+
+    void addFd (int fd, short eventMask)
+    {
+       #if JUCE_LINUX
+        if (epollFd >= 0)
+        {
+            static_assert (POLLIN == EPOLLIN && POLLPRI == EPOLLPRI && POLLOUT == EPOLLOUT
+                            && POLLERR == EPOLLERR && POLLHUP == EPOLLHUP);
+
+            epoll_event event{};
+            event.events = static_cast<uint32_t> (static_cast<unsigned short> (eventMask));
+            event.data.fd = fd;
+
+            // If a FD was closed without being unregistered, a duplicate of it may still be
+            // in the set, in which case the existing entry is updated
+            [[maybe_unused]] const auto added = epoll_ctl (epollFd, EPOLL_CTL_ADD, fd, &event) == 0
+                                                 || (errno == EEXIST && epoll_ctl (epollFd, EPOLL_CTL_MOD, fd, &event) == 0);
+
+            // This FD can't be watched, e.g. because it refers to a regular file
+            jassert (added);
+            return;
+        }
+       #endif
+
+        const auto iter = getPollfd (fd);
+
+        if (iter == pfds.end() || iter->fd != fd)
+            pfds.insert (iter, { fd, eventMask, 0 });
+        else
+            jassertfalse;
+
+        jassert (pfdsAreSorted());
+    }
+
+    void removeFd (int fd)
+    {
+       #if JUCE_LINUX
+        if (epollFd >= 0)
+        {
+            // This will fail if the FD has already been closed, which removes it from the set anyway
+            epoll_ctl (epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            return;
+        }
+       #endif
+
+        const auto iter = getPollfd (fd);
+
+        if (iter != pfds.end() && iter->fd == fd)
+            pfds.erase (iter);
+        else
+            jassertfalse;
+
+        jassert (pfdsAreSorted());
+    }
+
     std::vector<pollfd>::iterator getPollfd (int fd)
     {
         return std::lower_bound (pfds.begin(), pfds.end(), fd, [] (auto descriptor, auto toFind)
@@ -273,8 +460,19 @@ private:
 
     CriticalSection lock;
 
-    std::map<int, SharedCallback> callbacks;
-    std::vector<SharedCallback> callbackStorage;
+    std::unordered_map<int, SharedCallback> callbacks;
+    std::vector<FdAndCallback> callbackStorage;
+
+   #if JUCE_LINUX
+    // On Linux, the FDs are watched with epoll, so that the cost of registering a FD or
+    // waiting for events doesn't grow with the number of FDs. The pfds are only used if
+    // the epoll instance couldn't be created.
+    const int epollFd = epoll_create1 (EPOLL_CLOEXEC);
+    std::array<epoll_event, 64> readyEvents;
+   #else
+    static constexpr int epollFd = -1;
+   #endif
+
     std::vector<pollfd> pfds;
 
     ListenerList<LinuxEventLoopInternal::Listener> listeners;
@@ -401,4 +599,299 @@ std::vector<int> LinuxEventLoopInternal::getRegisteredFds()
     return {};
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class InternalMessageQueueTests final : public UnitTest
+{
+public:
+    InternalMessageQueueTests()
+        : UnitTest ("InternalMessageQueue", UnitTestCategories::native)
+    {}
+
+    void runTest() override
+    {
+        auto* mm = MessageManager::getInstance();
+
+        if (! mm->isThisTheMessageThread())
+            return;
+
+        beginTest ("A message that's posted twice is delivered twice");
+        {
+            Array<int> order;
+            const MessageManager::MessageBase::Ptr repeated (new RecordingMessage (order, 1));
+
+            expect (repeated->post());
+            expect ((new RecordingMessage (order, 2))->post());
+            expect (repeated->post());
+            expect ((new RecordingMessage (order, 3))->post());
+            expectEquals (repeated->getReferenceCount(), 3);
+
+            dispatchAllPendingMessages();
+            expect (order == Array<int> { 1, 2, 1, 3 });
+            expectEquals (repeated->getReferenceCount(), 1);
+        }
+
+        beginTest ("A message can post itself again from its callback");
+        {
+            Array<int> order;
+            const MessageManager::MessageBase::Ptr msg (new RecordingMessage (order, 1, 1));
+
+            expect (msg->post());
+            dispatchAllPendingMessages();
+
+            expect (order == Array<int> { 1, 1 });
+            expectEquals (msg->getReferenceCount(), 1);
+        }
+
+        beginTest ("Messages are delivered in order from a nested loop");
+        {
+            Array<int> order;
+
+            expect ((new NestedLoopMessage (order, true))->post());
+            expect ((new RecordingMessage (order, 2))->post());
+            expect ((new RecordingMessage (order, 3))->post());
+
+            dispatchAllPendingMessages();
+            expect (order == Array<int> { 1, 2, 3, 4, 5 });
+        }
+
+        beginTest ("A nested loop delivers the rest of the queue when nothing new is posted");
+        {
+            Array<int> order;
+
+            expect ((new NestedLoopMessage (order, false))->post());
+            expect ((new RecordingMessage (order, 2))->post());
+            expect ((new RecordingMessage (order, 3))->post());
+
+            dispatchAllPendingMessages();
+            expect (order == Array<int> { 1, 2, 3, 5 });
+        }
+    }
+
+private:
+    struct RecordingMessage final : public MessageManager::MessageBase
+    {
+        RecordingMessage (Array<int>& o, int v, int repostsToMake = 0)
+            : order (o), value (v), numReposts (repostsToMake) {}
+
+        void messageCallback() override
+        {
+            order.add (value);
+
+            if (numReposts-- > 0)
+                post();
+        }
+
+        Array<int>& order;
+        const int value;
+        int numReposts;
+    };
+
+    static void dispatchAllPendingMessages()
+    {
+        while (detail::dispatchNextMessageOnSystemQueue (true))
+        {}
+    }
+
+    // Runs a nested loop from its callback, as a modal component would
+    struct NestedLoopMessage final : public MessageManager::MessageBase
+    {
+        NestedLoopMessage (Array<int>& o, bool shouldPost) : order (o), postFromCallback (shouldPost) {}
+
+        void messageCallback() override
+        {
+            order.add (1);
+
+            if (postFromCallback)
+                (new RecordingMessage (order, 4))->post();
+
+            dispatchAllPendingMessages();
+            order.add (5);
+        }
+
+        Array<int>& order;
+        const bool postFromCallback;
+    };
+};
+
+static InternalMessageQueueTests internalMessageQueueTests;
+
+class InternalRunLoopTests final : public UnitTest
+{
+public:
+    InternalRunLoopTests()
+        : UnitTest ("InternalRunLoop", UnitTestCategories::native)
+    {}
+
+    void runTest() override
+    {
+        auto* runLoop = InternalRunLoop::getInstanceWithoutCreating();
+
+        if (runLoop == nullptr || ! MessageManager::getInstance()->isThisTheMessageThread())
+            return;
+
+        const auto dispatch = [runLoop] { runLoop->dispatchPendingEvents(); };
+
+        beginTest ("A callback is called while its fd is ready, until it's unregistered");
+        {
+            Pipe pipe;
+            int numCalls = 0;
+
+            LinuxEventLoop::registerFdCallback (pipe.getReadHandle(), [&] (int) { ++numCalls; pipe.drain(); });
+            dispatch();
+            expectEquals (numCalls, 0);
+
+            pipe.write();
+            dispatch();
+            dispatch();
+            expectEquals (numCalls, 1);
+
+            pipe.write();
+            dispatch();
+            expectEquals (numCalls, 2);
+
+            LinuxEventLoop::unregisterFdCallback (pipe.getReadHandle());
+            pipe.write();
+            dispatch();
+            expectEquals (numCalls, 2);
+        }
+
+        beginTest ("A callback can unregister itself");
+        {
+            Pipe pipe;
+            int numCalls = 0;
+
+            LinuxEventLoop::registerFdCallback (pipe.getReadHandle(), [&] (int fd)
+            {
+                ++numCalls;
+                LinuxEventLoop::unregisterFdCallback (fd);
+            });
+
+            pipe.write();
+            dispatch();
+            dispatch();
+            expectEquals (numCalls, 1);
+        }
+
+        beginTest ("A callback can unregister another fd that's ready");
+        {
+            Pipe first, second;
+            int numCalls = 0;
+
+            const auto callback = [&] (int)
+            {
+                ++numCalls;
+                LinuxEventLoop::unregisterFdCallback (first.getReadHandle());
+                LinuxEventLoop::unregisterFdCallback (second.getReadHandle());
+            };
+
+            LinuxEventLoop::registerFdCallback (first.getReadHandle(), callback);
+            LinuxEventLoop::registerFdCallback (second.getReadHandle(), callback);
+
+            first.write();
+            second.write();
+            dispatch();
+            dispatch();
+            expectEquals (numCalls, 1);
+        }
+
+        beginTest ("A callback can register another fd");
+        {
+            Pipe first, second;
+            int numFirstCalls = 0, numSecondCalls = 0;
+
+            LinuxEventLoop::registerFdCallback (first.getReadHandle(), [&] (int fd)
+            {
+                ++numFirstCalls;
+                LinuxEventLoop::unregisterFdCallback (fd);
+                LinuxEventLoop::registerFdCallback (second.getReadHandle(), [&] (int) { ++numSecondCalls; second.drain(); });
+            });
+
+            first.write();
+            second.write();
+            dispatch();
+            dispatch();
+
+            expectEquals (numFirstCalls, 1);
+            expectEquals (numSecondCalls, 1);
+
+            LinuxEventLoop::unregisterFdCallback (second.getReadHandle());
+        }
+
+        beginTest ("An fd that's never drained doesn't stop other fds being dispatched");
+        {
+            // There are more of these than can be returned by a single wait
+            std::vector<std::unique_ptr<Pipe>> undrained;
+            std::vector<int> numUndrainedCalls (100, 0);
+
+            for (size_t i = 0; i < numUndrainedCalls.size(); ++i)
+            {
+                undrained.push_back (std::make_unique<Pipe>());
+                undrained.back()->write();
+                LinuxEventLoop::registerFdCallback (undrained.back()->getReadHandle(), [&, i] (int) { ++numUndrainedCalls[i]; });
+            }
+
+            Pipe other;
+            int numOtherCalls = 0;
+            LinuxEventLoop::registerFdCallback (other.getReadHandle(), [&] (int) { ++numOtherCalls; other.drain(); });
+
+            for (int i = 0; i < 3; ++i)
+            {
+                other.write();
+                dispatch();
+                dispatch();
+            }
+
+            expectEquals (numOtherCalls, 3);
+            expect (std::all_of (numUndrainedCalls.begin(), numUndrainedCalls.end(), [] (int n) { return n > 0; }));
+
+            LinuxEventLoop::unregisterFdCallback (other.getReadHandle());
+
+            for (auto& p : undrained)
+                LinuxEventLoop::unregisterFdCallback (p->getReadHandle());
+        }
+    }
+
+private:
+    struct Pipe
+    {
+        Pipe()
+        {
+            [[maybe_unused]] const auto result = pipe2 (fds, O_CLOEXEC | O_NONBLOCK);
+            jassert (result == 0);
+        }
+
+        ~Pipe()
+        {
+            close (fds[0]);
+            close (fds[1]);
+        }
+
+        int getReadHandle() const noexcept   { return fds[0]; }
+
+        void write() const noexcept
+        {
+            const char byte = 0;
+            [[maybe_unused]] const auto numBytes = ::write (fds[1], &byte, 1);
+        }
+
+        void drain() const noexcept
+        {
+            char buffer[64];
+
+            while (read (fds[0], buffer, sizeof (buffer)) > 0)
+            {}
+        }
+
+        int fds[2];
+
+        JUCE_DECLARE_NON_COPYABLE (Pipe)
+    };
+};
+
+static InternalRunLoopTests internalRunLoopTests;
+
+#endif
+
 } // namespace juce
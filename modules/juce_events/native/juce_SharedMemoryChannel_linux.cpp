@@ -0,0 +1,686 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/*  A two-way channel between two processes on the same machine, made from a block of
+    POSIX shared memory that holds a single-producer, single-consumer ring buffer for
+    each direction.
+
+    Each message is stored as a record with a small header, contiguously, so that the
+    receiver can be handed a pointer straight into the buffer. If a record doesn't fit
+    before the end of the buffer, a padding record fills the gap and the message starts
+    again at the beginning. Messages that are too big to fit are split into fragments,
+    which the receiver joins back together.
+
+    A process that's waiting for data or space sleeps on a futex in the shared memory,
+    and the other side only makes a system call to wake it if it has said that it's
+    waiting, so a busy connection doesn't need any system calls at all.
+*/
+struct InterprocessConnection::SharedMemoryChannel
+{
+    ~SharedMemoryChannel()
+    {
+        close();
+    }
+
+    static std::unique_ptr<SharedMemoryChannel> create (const String& name, uint32 magic,
+                                                        int bufferSizeBytes, bool mustNotExist)
+    {
+        const auto capacity = (uint32) nextPowerOfTwo (jlimit (minimumCapacity, maximumCapacity, bufferSizeBytes));
+        auto region = detail::SharedMemoryRegion::create (getSharedMemoryName (name),
+                                                          sizeof (Header) + 2 * (size_t) capacity,
+                                                          mustNotExist);
+
+        if (region == nullptr)
+            return {};
+
+        auto* newHeader = new (region->getData()) Header();
+        newHeader->magic = magic;
+        newHeader->capacity = capacity;
+        newHeader->processIDs[creatorEnd] = (int32) getpid();
+        newHeader->states[creatorEnd] = connected;
+        newHeader->layoutVersion.store (currentLayoutVersion, std::memory_order_release);
+
+        return std::unique_ptr<SharedMemoryChannel> (new SharedMemoryChannel (std::move (region), capacity, creatorEnd));
+    }
+
+    static std::unique_ptr<SharedMemoryChannel> open (const String& name, uint32 magic)
+    {
+        auto region = detail::SharedMemoryRegion::open (getSharedMemoryName (name), sizeof (Header) + 1);
+
+        if (region == nullptr)
+            return {};
+
+        auto* existingHeader = static_cast<Header*> (region->getData());
+
+        // The creator may still be filling in the header
+        for (int i = 0; existingHeader->layoutVersion.load (std::memory_order_acquire) == 0 && i < 1000; ++i)
+            Thread::sleep (1);
+
+        const auto capacity = existingHeader->capacity;
+        auto expectedState = (uint32) notConnected;
+
+        if (existingHeader->layoutVersion.load (std::memory_order_acquire) != currentLayoutVersion
+             || existingHeader->magic != magic
+             || ! isPowerOfTwo (capacity)
+             || region->getSize() != sizeof (Header) + 2 * (size_t) capacity
+             || ! existingHeader->states[connectorEnd].compare_exchange_strong (expectedState, connected))
+        {
+            return {};
+        }
+
+        existingHeader->processIDs[connectorEnd] = (int32) getpid();
+
+        // Both ends have now mapped the memory, so the name is no longer needed
+        region->removeName();
+
+        return std::unique_ptr<SharedMemoryChannel> (new SharedMemoryChannel (std::move (region), capacity, connectorEnd));
+    }
+
+    //==============================================================================
+    /*  Copies a message into the outgoing buffer, waiting for space if necessary. */
+    bool write (const void* data, size_t numBytes, int timeoutMs)
+    {
+        const ScopedLock sl (writeLock);
+
+        const auto startTime = Time::getMillisecondCounter();
+        auto* source = static_cast<const uint8*> (data);
+
+        while (numBytes > 0)
+        {
+            const auto numThisTime = jmin (numBytes, (size_t) maximumRecordSize());
+            numBytes -= numThisTime;
+
+            if (! writeRecord (source, (uint32) numThisTime, numBytes > 0 ? moreFragmentsFlag : 0u, startTime, timeoutMs))
+                return false;
+
+            source += numThisTime;
+        }
+
+        return true;
+    }
+
+    /*  Waits for up to timeoutMs for messages to arrive, and passes each message that's
+        available to the callback as a pointer and size. The data is only valid until the
+        callback returns. Returns false once the channel has been closed at either end.
+    */
+    template <typename Callback>
+    bool readMessages (int timeoutMs, Callback&& callback)
+    {
+        auto& ring = header->rings[1 - end];
+        auto* buffer = getBuffer (1 - end);
+
+        if (! waitForData (ring, timeoutMs))
+            return ! isClosed() && isOtherEndAlive();
+
+        const auto endPosition = ring.writePosition.load (std::memory_order_acquire);
+
+        if (endPosition - readPosition > capacity)
+            return failWithCorruptData();
+
+        while (readPosition != endPosition && ! isClosed())
+        {
+            const auto offset = (uint32) (readPosition & (capacity - 1));
+            RecordHeader record;
+            std::memcpy (&record, buffer + offset, sizeof (record));
+
+            const auto recordSize = getRecordSize (record.size);
+
+            if (record.size > capacity - offset - sizeof (RecordHeader) || readPosition + recordSize > endPosition)
+                return failWithCorruptData();
+
+            const auto* payload = buffer + offset + sizeof (RecordHeader);
+
+            if ((record.flags & paddingFlag) != 0)
+            {
+                // nothing to deliver
+            }
+            else if ((record.flags & moreFragmentsFlag) != 0 || ! fragments.isEmpty())
+            {
+                fragments.append (payload, record.size);
+
+                if ((record.flags & moreFragmentsFlag) == 0)
+                {
+                    callback (static_cast<const void*> (fragments.getData()), fragments.getSize());
+                    fragments.reset();
+                }
+            }
+            else
+            {
+                callback (static_cast<const void*> (payload), (size_t) record.size);
+            }
+
+            readPosition += recordSize;
+            ring.readPosition.store (readPosition, std::memory_order_release);
+            wakeIfWaiting (ring.writerIsWaiting, ring.spaceAvailable);
+        }
+
+        return true;
+    }
+
+    /*  Closes this end of the channel, waking up any threads in either process that are
+        waiting for it.
+    */
+    void close()
+    {
+        if (closedLocally.exchange (true))
+            return;
+
+        header->states[end] = closed;
+
+        if (end == creatorEnd)
+        {
+            // If nothing connected, the name still needs removing, otherwise the other end has done it
+            auto expectedState = (uint32) notConnected;
+
+            if (header->states[connectorEnd].compare_exchange_strong (expectedState, closed))
+                region->removeName();
+            else
+                region->releaseName();
+        }
+
+        for (auto& ring : header->rings)
+        {
+            for (auto* signal : { &ring.dataAvailable, &ring.spaceAvailable })
+            {
+                ++(*signal);
+                detail::Futex::wake (*signal);
+            }
+        }
+    }
+
+    bool isOpen() const noexcept
+    {
+        return ! isClosed() && header->states[1 - end].load() != closed;
+    }
+
+private:
+    //==============================================================================
+    enum : uint32
+    {
+        currentLayoutVersion = 1,
+        notConnected = 0,
+        connected = 1,
+        closed = 2,
+        paddingFlag = 1,
+        moreFragmentsFlag = 2
+    };
+
+    enum { creatorEnd = 0, connectorEnd = 1 };
+
+    static constexpr int minimumCapacity = 4096, maximumCapacity = 1 << 30, maximumWaitMs = 100;
+
+    struct RecordHeader
+    {
+        uint32 size, flags;
+    };
+
+    // The positions are running totals of the number of bytes written and read. The
+    // reader and writer each keep to their own cache line.
+    struct Ring
+    {
+        alignas (64) std::atomic<uint64> writePosition;
+        std::atomic<uint32> dataAvailable, readerIsWaiting;
+
+        alignas (64) std::atomic<uint64> readPosition;
+        std::atomic<uint32> spaceAvailable, writerIsWaiting;
+    };
+
+    struct Header
+    {
+        std::atomic<uint32> layoutVersion;
+        uint32 magic, capacity;
+        std::atomic<uint32> states[2];
+        std::atomic<int32> processIDs[2];
+
+        // rings[0] carries messages from the creator to the connector, rings[1] the reverse
+        Ring rings[2];
+    };
+
+    static_assert (std::atomic<uint64>::is_always_lock_free && std::atomic<uint32>::is_always_lock_free,
+                   "The atomics in the shared memory must be lock-free to work between processes");
+
+    SharedMemoryChannel (std::unique_ptr<detail::SharedMemoryRegion> r, uint32 bufferCapacity, int thisEnd)
+        : region (std::move (r)), header (static_cast<Header*> (region->getData())), capacity (bufferCapacity), end (thisEnd)
+    {
+    }
+
+    static String getSharedMemoryName (const String& name)
+    {
+        return "/juce_ipc_" + File::createLegalFileName (name).replaceCharacter ('/', '_');
+    }
+
+    static uint32 getRecordSize (uint32 payloadSize) noexcept
+    {
+        return (uint32) ((sizeof (RecordHeader) + payloadSize + 7) & ~(size_t) 7);
+    }
+
+    uint32 maximumRecordSize() const noexcept   { return capacity / 4; }
+
+    uint8* getBuffer (int ringIndex) const noexcept
+    {
+        return reinterpret_cast<uint8*> (header) + sizeof (Header) + (size_t) ringIndex * capacity;
+    }
+
+    bool isClosed() const noexcept              { return closedLocally.load(); }
+
+    bool isOtherEndAlive() const
+    {
+        const auto otherEnd = 1 - end;
+        const auto state = header->states[otherEnd].load();
+
+        if (state == closed)
+            return false;
+
+        if (state == connected)
+        {
+            const auto pid = (pid_t) header->processIDs[otherEnd].load();
+
+            if (pid > 0 && ! isProcessRunning (pid))
+                return false;
+        }
+
+        return true;
+    }
+
+    static bool isProcessRunning (pid_t pid)
+    {
+        if (kill (pid, 0) != 0)
+            return errno != ESRCH;
+
+        // A child process that has died stays around as a zombie until its parent reaps it,
+        // which may not happen until the parent's message thread gets round to it
+        char path[32];
+        snprintf (path, sizeof (path), "/proc/%d/stat", (int) pid);
+
+        const auto fd = ::open (path, O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+            return true;
+
+        char stat[256];
+        const auto numRead = ::read (fd, stat, sizeof (stat) - 1);
+        ::close (fd);
+
+        if (numRead <= 0)
+            return true;
+
+        stat[numRead] = 0;
+
+        // The state follows the command name, which is in brackets and may contain spaces
+        if (auto* nameEnd = strrchr (stat, ')'); nameEnd != nullptr && nameEnd[1] == ' ')
+            return nameEnd[2] != 'Z' && nameEnd[2] != 'X';
+
+        return true;
+    }
+
+    bool failWithCorruptData()
+    {
+        // The other process has written something that doesn't make sense, so it can't be trusted
+        jassertfalse;
+        close();
+        return false;
+    }
+
+    //==============================================================================
+    bool writeRecord (const uint8* source, uint32 numBytes, uint32 flags, uint32 startTime, int timeoutMs)
+    {
+        auto& ring = header->rings[end];
+        auto* buffer = getBuffer (end);
+
+        const auto recordSize = getRecordSize (numBytes);
+        const auto bytesToEnd = capacity - (uint32) (writePosition & (capacity - 1));
+        const auto paddingSize = recordSize > bytesToEnd ? bytesToEnd : 0u;
+
+        if (! waitForSpace (ring, paddingSize + recordSize, startTime, timeoutMs))
+            return false;
+
+        if (paddingSize > 0)
+        {
+            const RecordHeader padding { paddingSize - (uint32) sizeof (RecordHeader), paddingFlag };
+            std::memcpy (buffer + (writePosition & (capacity - 1)), &padding, sizeof (padding));
+            writePosition += paddingSize;
+        }
+
+        auto* dest = buffer + (writePosition & (capacity - 1));
+        const RecordHeader record { numBytes, flags };
+        std::memcpy (dest, &record, sizeof (record));
+        std::memcpy (dest + sizeof (record), source, numBytes);
+
+        writePosition += recordSize;
+        ring.writePosition.store (writePosition, std::memory_order_release);
+        wakeIfWaiting (ring.readerIsWaiting, ring.dataAvailable);
+        return true;
+    }
+
+    bool waitForSpace (Ring& ring, uint32 numBytesNeeded, uint32 startTime, int timeoutMs)
+    {
+        const auto hasSpace = [&]
+        {
+            return capacity - (writePosition - ring.readPosition.load (std::memory_order_acquire)) >= numBytesNeeded;
+        };
+
+        for (;;)
+        {
+            if (isClosed() || writePosition - ring.readPosition.load (std::memory_order_acquire) > capacity)
+                return false;
+
+            if (hasSpace())
+                return true;
+
+            const auto timeRemaining = timeoutMs < 0 ? maximumWaitMs
+                                                     : timeoutMs - (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeRemaining <= 0 || ! isOtherEndAlive())
+                return false;
+
+            waitOnSignal (ring.writerIsWaiting, ring.spaceAvailable, hasSpace, jmin (timeRemaining, maximumWaitMs));
+        }
+    }
+
+    bool waitForData (Ring& ring, int timeoutMs)
+    {
+        const auto hasData = [&] { return ring.writePosition.load (std::memory_order_acquire) != readPosition; };
+
+        // When the other process may be running on another core, a short spin can catch
+        // a reply without the cost of going to sleep
+        static const auto numSpins = SystemStats::getNumCpus() > 1 ? 2000 : 0;
+
+        for (int i = 0; i <= numSpins; ++i)
+            if (hasData())
+                return true;
+
+        waitOnSignal (ring.readerIsWaiting, ring.dataAvailable, hasData, timeoutMs);
+        return hasData();
+    }
+
+    // The waiting flag and the position are checked in the opposite order by the two sides,
+    // with a fence in between, so at least one of them will always see the other's update
+    template <typename Condition>
+    bool waitOnSignal (std::atomic<uint32>& isWaiting, std::atomic<uint32>& signal,
+                       Condition&& condition, int timeoutMs)
+    {
+        const auto signalValue = signal.load();
+        isWaiting.store (1);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        const auto isReady = condition() || isClosed();
+
+        if (! isReady)
+            detail::Futex::wait (signal, signalValue, timeoutMs);
+
+        isWaiting.store (0);
+        return isReady;
+    }
+
+    static void wakeIfWaiting (std::atomic<uint32>& isWaiting, std::atomic<uint32>& signal)
+    {
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+
+        if (isWaiting.load (std::memory_order_relaxed) != 0)
+        {
+            ++signal;
+            detail::Futex::wake (signal);
+        }
+    }
+
+    //==============================================================================
+    const std::unique_ptr<detail::SharedMemoryRegion> region;
+    Header* const header;
+    const uint32 capacity;
+    const int end;
+
+    // These are kept locally, rather than read back from the shared memory, so that
+    // the other process can't change them
+    uint64 writePosition = 0, readPosition = 0;
+
+    CriticalSection writeLock;
+    MemoryBlock fragments;
+    std::atomic<bool> closedLocally { false };
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMemoryChannel)
+};
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedMemoryChannelTests final : public UnitTest
+{
+public:
+    SharedMemoryChannelTests()
+        : UnitTest ("SharedMemoryChannel", UnitTestCategories::native)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Messages arrive intact and in order, including ones that are split up");
+        {
+            const auto channelName = getUniqueName();
+            TestConnection creator, connector;
+
+            expect (creator.createSharedMemory (channelName, 1000, true, 4096));
+            expect (connector.connectToSharedMemory (channelName, 1000));
+            expect (creator.isConnected() && connector.isConnected());
+
+            Array<MemoryBlock> messages;
+
+            for (auto size : { 1, 100, 1024, 1025, 5000, 20000 })
+                messages.add (createRandomBlock (size));
+
+            for (auto& m : messages)
+                expect (creator.sendMessage (m));
+
+            expect (connector.waitForMessages (messages.size()));
+            expect (connector.getMessagesReceived() == messages);
+
+            for (auto& m : messages)
+                expect (connector.sendMessage (m));
+
+            expect (creator.waitForMessages (messages.size()));
+            expect (creator.getMessagesReceived() == messages);
+        }
+
+        beginTest ("Only one connection can be made to the shared memory");
+        {
+            const auto channelName = getUniqueName();
+            TestConnection creator, connector, other;
+
+            expect (creator.createSharedMemory (channelName, 1000, true));
+            expect (! TestConnection().createSharedMemory (channelName, 1000, true));
+            expect (connector.connectToSharedMemory (channelName, 1000));
+            expect (! other.connectToSharedMemory (channelName, 1000));
+        }
+
+        beginTest ("Sending times out if the receiver stops reading");
+        {
+            const auto channelName = getUniqueName();
+            TestConnection creator, connector;
+            WaitableEvent canReceive (true);
+            connector.onMessageReceived = [&] { canReceive.wait (10000); };
+
+            const int timeoutMs = 200;
+            expect (creator.createSharedMemory (channelName, timeoutMs, true, 4096));
+            expect (connector.connectToSharedMemory (channelName, 1000));
+
+            const auto message = createRandomBlock (500);
+            int numSent = 0;
+            auto sendTime = 0.0;
+
+            for (; numSent < 100; ++numSent)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+                const auto sent = creator.sendMessage (message);
+                sendTime = Time::getMillisecondCounterHiRes() - start;
+
+                if (! sent)
+                    break;
+            }
+
+            expect (numSent > 0 && numSent < 100);
+            expectGreaterOrEqual (sendTime, timeoutMs * 0.9);
+            expect (creator.isConnected());
+
+            canReceive.signal();
+            expect (connector.waitForMessages (numSent));
+            expect (creator.sendMessage (message));
+        }
+
+        beginTest ("The connection is lost when the other process dies");
+        {
+            const auto channelName = getUniqueName();
+            TestConnection creator;
+            expect (creator.createSharedMemory (channelName, -1, true, 4096));
+
+            const auto pid = fork();
+
+            if (pid == 0)
+            {
+                // The child connects, and then exits without closing its end
+                TestConnection connector;
+                _exit (connector.connectToSharedMemory (channelName, 1000) ? 0 : 1);
+            }
+
+            expect (pid > 0);
+
+            int status = 0;
+            expect (waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0);
+
+            expect (creator.connectionLostEvent.wait (5000));
+            expect (! creator.isConnected());
+            expect (! creator.sendMessage (createRandomBlock (100)));
+        }
+
+        beginTest ("A sender that's waiting for space gives up when the other process dies");
+        {
+            const auto channelName = getUniqueName();
+            TestConnection creator;
+            expect (creator.createSharedMemory (channelName, -1, true, 4096));
+
+            const auto pid = fork();
+
+            if (pid == 0)
+            {
+                // The child stops reading when the first message arrives, and dies shortly after
+                TestConnection connector;
+                connector.onMessageReceived = [] { Thread::sleep (300); _exit (0); };
+                connector.connectToSharedMemory (channelName, 1000);
+                Thread::sleep (10000);
+                _exit (1);
+            }
+
+            expect (pid > 0);
+            expect (creator.sendMessage (createRandomBlock (100)));
+
+            // With an infinite timeout, this would never return if the dead process wasn't noticed
+            expect (! creator.sendMessage (createRandomBlock (20000)));
+
+            int status = 0;
+            expect (waitpid (pid, &status, 0) == pid && WIFEXITED (status) && WEXITSTATUS (status) == 0);
+        }
+    }
+
+private:
+    struct TestConnection final : public InterprocessConnection
+    {
+        TestConnection()  : InterprocessConnection (false) {}
+        ~TestConnection() override  { disconnect(); }
+
+        void connectionMade() override  {}
+        void connectionLost() override  { connectionLostEvent.signal(); }
+
+        void messageReceived (const MemoryBlock& message) override
+        {
+            if (onMessageReceived != nullptr)
+                onMessageReceived();
+
+            const ScopedLock sl (lock);
+            messagesReceived.add (message);
+            messageArrived.signal();
+        }
+
+        bool waitForMessages (int numMessages)
+        {
+            const auto endTime = Time::getMillisecondCounter() + 5000;
+
+            for (;;)
+            {
+                {
+                    const ScopedLock sl (lock);
+
+                    if (messagesReceived.size() >= numMessages)
+                        return true;
+                }
+
+                const auto timeRemaining = (int) (endTime - Time::getMillisecondCounter());
+
+                if (timeRemaining <= 0 || ! messageArrived.wait (timeRemaining))
+                    return false;
+            }
+        }
+
+        Array<MemoryBlock> getMessagesReceived() const
+        {
+            const ScopedLock sl (lock);
+            return messagesReceived;
+        }
+
+        std::function<void()> onMessageReceived;
+        WaitableEvent connectionLostEvent;
+
+    private:
+        CriticalSection lock;
+        WaitableEvent messageArrived;
+        Array<MemoryBlock> messagesReceived;
+    };
+
+    static String getUniqueName()
+    {
+        return "juce_test_" + String::toHexString (Random::getSystemRandom().nextInt64());
+    }
+
+    MemoryBlock createRandomBlock (int size)
+    {
+        MemoryBlock block ((size_t) size);
+        getRandom().fillBitsRandomly (block.getData(), block.getSize());
+        return block;
+    }
+};
+
+static SharedMemoryChannelTests sharedMemoryChannelTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::detail
+{
+
+SharedMemoryRegion::SharedMemoryRegion (const String& n, void* d, size_t s, bool owner)
+    : name (n), data (d), size (s), ownsName (owner)
+{
+}
+
+SharedMemoryRegion::~SharedMemoryRegion()
+{
+    munmap (data, size);
+
+    if (ownsName)
+        removeName();
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::create (const String& name, size_t numBytes, bool mustNotExist)
+{
+    if (! mustNotExist)
+        shm_unlink (name.toRawUTF8());
+
+    const auto fd = shm_open (name.toRawUTF8(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+
+    if (fd < 0)
+        return {};
+
+    void* memory = MAP_FAILED;
+
+    if (ftruncate (fd, (off_t) numBytes) == 0)
+        memory = mmap (nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    ::close (fd);
+
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink (name.toRawUTF8());
+        return {};
+    }
+
+    return std::unique_ptr<SharedMemoryRegion> (new SharedMemoryRegion (name, memory, numBytes, true));
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::open (const String& name, size_t minimumSize)
+{
+    const auto fd = shm_open (name.toRawUTF8(), O_RDWR | O_CLOEXEC, 0);
+
+    if (fd < 0)
+        return {};
+
+    struct stat info {};
+    void* memory = MAP_FAILED;
+
+    if (fstat (fd, &info) == 0 && info.st_size > 0 && (size_t) info.st_size >= minimumSize)
+        memory = mmap (nullptr, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    ::close (fd);
+
+    if (memory == MAP_FAILED)
+        return {};
+
+    return std::unique_ptr<SharedMemoryRegion> (new SharedMemoryRegion (name, memory, (size_t) info.st_size, false));
+}
+
+void SharedMemoryRegion::removeName()
+{
+    ownsName = false;
+    shm_unlink (name.toRawUTF8());
+}
+
+//==============================================================================
+void Futex::wait (std::atomic<uint32>& value, uint32 expectedValue, double timeoutMs)
+{
+    const auto timeoutNs = (int64) (jmax (0.0, timeoutMs) * 1.0e6);
+    const timespec timeout { (time_t) (timeoutNs / 1000000000), (long) (timeoutNs % 1000000000) };
+
+    syscall (SYS_futex, reinterpret_cast<uint32*> (&value), FUTEX_WAIT, expectedValue, &timeout, nullptr, 0);
+}
+
+void Futex::wake (std::atomic<uint32>& value)
+{
+    syscall (SYS_futex, reinterpret_cast<uint32*> (&value), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+}
+
+} // namespace juce::detail
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace juce::detail
+{
+
+//==============================================================================
+/*  A block of POSIX shared memory that's mapped into this process.
+
+    The process that creates a block owns its name, and removes it when the block is
+    deleted unless removeName() or releaseName() has been called first.
+*/
+class SharedMemoryRegion
+{
+public:
+    ~SharedMemoryRegion();
+
+    /*  Creates a new block of shared memory. If mustNotExist is false, any existing block
+        with the same name is removed first, otherwise this fails if there is one.
+    */
+    static std::unique_ptr<SharedMemoryRegion> create (const String& name, size_t numBytes, bool mustNotExist);
+
+    /*  Maps a block of shared memory that another process has created, as long as it's at
+        least minimumSize bytes long.
+    */
+    static std::unique_ptr<SharedMemoryRegion> open (const String& name, size_t minimumSize);
+
+    /*  Removes the block's name, so that no other process can open it. The memory will be
+        freed once every process that has mapped it has finished with it.
+    */
+    void removeName();
+
+    /*  Stops this object removing the name when it's deleted, e.g. because another process
+        has already done so.
+    */
+    void releaseName() noexcept                 { ownsName = false; }
+
+    const String& getName() const noexcept      { return name; }
+    void* getData() const noexcept              { return data; }
+    size_t getSize() const noexcept             { return size; }
+
+private:
+    SharedMemoryRegion (const String&, void*, size_t, bool);
+
+    const String name;
+    void* const data;
+    const size_t size;
+    bool ownsName;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMemoryRegion)
+};
+
+//==============================================================================
+/*  Lets a thread sleep until a 32-bit value changes. This uses the shared (not private)
+    futex operations, so the value can be in memory that's mapped into more than one process.
+*/
+struct Futex
+{
+    Futex() = delete;
+
+    /*  Waits for up to timeoutMs for wake() to be called, returning immediately if the
+        value is no longer expectedValue. This may also return early for no reason, so the
+        caller needs to check whatever it was waiting for.
+    */
+    static void wait (std::atomic<uint32>& value, uint32 expectedValue, double timeoutMs);
+
+    /*  Wakes all the threads that are waiting on the value. */
+    static void wake (std::atomic<uint32>& value);
+};
+
+} // namespace juce::detail
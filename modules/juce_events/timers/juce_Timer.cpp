@@ -80,6 +80,257 @@ private:
     JUCE_DECLARE_SINGLETON_INLINE (ShutdownDetector, false)
 };
 
+//==============================================================================
+/*
+    Keeps track of when each running timer is next due, using a hierarchical timing wheel.
+
+    Each timer is kept in a list for the slot of the wheel that contains its due time. The
+    first level has a slot for each millisecond, and the slots in each level above it are 64
+    times longer than those in the level below, so adding, removing or rescheduling a timer
+    takes the same time however many timers are running. As time passes, the timers in each
+    slot of a higher level are moved down to the level below, and the timers in each slot of
+    the first level are moved to a list of timers that are due.
+
+    Timers are referred to by the index of the node that holds them, which stays the same
+    until the timer is removed.
+*/
+class TimerWheel
+{
+public:
+    static constexpr auto none = std::numeric_limits<size_t>::max();
+
+    explicit TimerWheel (int64 startTime) noexcept  : currentTime (startTime) {}
+
+    /** Adds a timer, returning the index that refers to it. */
+    size_t add (Timer* timer, int64 dueTime)
+    {
+        auto index = firstFreeNode;
+
+        if (index != none)
+        {
+            firstFreeNode = nodes[index].next;
+        }
+        else
+        {
+            index = nodes.size();
+            nodes.emplace_back();
+        }
+
+        nodes[index].timer = timer;
+        nodes[index].dueTime = dueTime;
+        insert (index);
+        ++numTimers;
+        return index;
+    }
+
+    void remove (size_t index) noexcept
+    {
+        unlink (index);
+        nodes[index].timer = nullptr;
+        nodes[index].next = std::exchange (firstFreeNode, index);
+        --numTimers;
+    }
+
+    void reschedule (size_t index, int64 dueTime) noexcept
+    {
+        unlink (index);
+        nodes[index].dueTime = dueTime;
+        insert (index);
+    }
+
+    /** Returns the timer that has been due for longest, or nullptr if none are due. */
+    Timer* getFirstDueTimer() const noexcept
+    {
+        const auto index = lists[dueList].head;
+        return index != none ? nodes[index].timer : nullptr;
+    }
+
+    bool contains (size_t index, const Timer* timer) const noexcept
+    {
+        return index < nodes.size() && nodes[index].timer == timer;
+    }
+
+    int64 getCurrentTime() const noexcept   { return currentTime; }
+
+    /** Moves the wheel forward, moving any timers that become due to the list of due timers. */
+    void advanceTo (int64 time) noexcept
+    {
+        while (currentTime < time)
+        {
+            if (numTimers == counts[dueLevel])
+            {
+                currentTime = time;
+                return;
+            }
+
+            if (counts[0] == 0)
+            {
+                // Nothing can become due before the wheel reaches the next slot in the second level
+                const auto endOfSlot = currentTime | (firstLevelSize - 1);
+
+                if (time <= endOfSlot)
+                {
+                    currentTime = time;
+                    return;
+                }
+
+                currentTime = endOfSlot;
+            }
+
+            ++currentTime;
+
+            if ((currentTime & (firstLevelSize - 1)) == 0)
+            {
+                for (int level = 1; level < numLevels; ++level)
+                {
+                    const auto slot = getSlot (level, currentTime);
+                    redistribute (getListIndex (level, slot));
+
+                    if (slot != 0)
+                        break;
+                }
+            }
+
+            redistribute (getListIndex (0, getSlot (0, currentTime)));
+        }
+    }
+
+    /** Returns the number of milliseconds before another timer might become due. */
+    int getTimeUntilNextDueTimer() const noexcept
+    {
+        if (counts[dueLevel] > 0)
+            return 0;
+
+        if (numTimers == 0)
+            return std::numeric_limits<int>::max();
+
+        const auto endOfSlot = currentTime | (firstLevelSize - 1);
+
+        if (counts[0] > 0)
+            for (auto time = currentTime + 1; time <= endOfSlot; ++time)
+                if (lists[getListIndex (0, getSlot (0, time))].head != none)
+                    return (int) (time - currentTime);
+
+        return (int) (endOfSlot + 1 - currentTime);
+    }
+
+private:
+    static constexpr int numLevels = 5;
+    static constexpr int dueLevel = numLevels;
+    static constexpr int64 firstLevelSize = 256;
+    static constexpr int64 otherLevelSize = 64;
+    static constexpr size_t dueList = (size_t) (firstLevelSize + (numLevels - 1) * otherLevelSize);
+
+    struct Node
+    {
+        Timer* timer = nullptr;
+        int64 dueTime = 0;
+        size_t previous = none, next = none, list = none;
+    };
+
+    struct List
+    {
+        size_t head = none, tail = none;
+    };
+
+    static constexpr int getShift (int level) noexcept
+    {
+        return level == 0 ? 0 : 8 + 6 * (level - 1);
+    }
+
+    static size_t getSlot (int level, int64 time) noexcept
+    {
+        return (size_t) ((time >> getShift (level)) & ((level == 0 ? firstLevelSize : otherLevelSize) - 1));
+    }
+
+    static size_t getListIndex (int level, size_t slot) noexcept
+    {
+        return level == 0 ? slot : (size_t) (firstLevelSize + (level - 1) * otherLevelSize) + slot;
+    }
+
+    static size_t getLevel (size_t list) noexcept
+    {
+        if (list == dueList)
+            return (size_t) dueLevel;
+
+        return list < (size_t) firstLevelSize ? 0 : 1 + (list - (size_t) firstLevelSize) / (size_t) otherLevelSize;
+    }
+
+    void insert (size_t index) noexcept
+    {
+        auto& node = nodes[index];
+        const auto delay = node.dueTime - currentTime;
+
+        auto list = dueList;
+
+        if (delay > 0)
+        {
+            int level = 0;
+
+            while (level < numLevels - 1 && delay >= ((int64) 1 << getShift (level + 1)))
+                ++level;
+
+            list = getListIndex (level, getSlot (level, node.dueTime));
+        }
+
+        auto& l = lists[list];
+        node.list = list;
+        node.previous = l.tail;
+        node.next = none;
+
+        if (l.tail != none)
+            nodes[l.tail].next = index;
+        else
+            l.head = index;
+
+        l.tail = index;
+        ++counts[getLevel (list)];
+    }
+
+    void unlink (size_t index) noexcept
+    {
+        auto& node = nodes[index];
+        auto& l = lists[node.list];
+
+        if (node.previous != none)
+            nodes[node.previous].next = node.next;
+        else
+            l.head = node.next;
+
+        if (node.next != none)
+            nodes[node.next].previous = node.previous;
+        else
+            l.tail = node.previous;
+
+        --counts[getLevel (node.list)];
+        node.list = node.previous = node.next = none;
+    }
+
+    // Re-inserts all the timers in a list, which moves them to a lower level or to the due list
+    void redistribute (size_t list) noexcept
+    {
+        auto index = std::exchange (lists[list].head, none);
+        lists[list].tail = none;
+
+        while (index != none)
+        {
+            const auto next = nodes[index].next;
+            --counts[getLevel (list)];
+            insert (index);
+            index = next;
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::array<List, dueList + 1> lists;
+    std::array<size_t, numLevels + 1> counts{};
+    size_t firstFreeNode = none, numTimers = 0;
+    int64 currentTime;
+
+    JUCE_DECLARE_NON_COPYABLE (TimerWheel)
+};
+
+//==============================================================================
 class Timer::TimerThread final : private Thread,
                                  private ShutdownDetector::Listener
 {
@@ -89,7 +340,6 @@ public:
     TimerThread()
         : Thread (SystemStats::getJUCEVersion() + ": Timer")
     {
-        timers.reserve (32);
         ShutdownDetector::addListener (this);
     }
 
@@ -105,17 +355,14 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         ReferenceCountedObjectPtr<CallTimersMessage> messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
+            // keeps the Time::getApproximateMillisecondCounter value up-to-date
+            Time::getMillisecondCounter();
 
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            auto timeUntilFirstTimer = advanceTimers();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -151,17 +398,9 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (! timers.empty())
+        while (auto* timer = wheel.getFirstDueTimer())
         {
-            auto& first = timers.front();
-
-            if (first.countdownMs > 0)
-                break;
-
-            auto* timer = first.timer;
-            first.countdownMs = timer->timerPeriodMs;
-            shuffleTimerBackInQueue (0);
-            notify();
+            schedule (*timer, wheel.getCurrentTime() + timer->timerPeriodMs);
 
             const LockType::ScopedUnlockType ul (lock);
 
@@ -193,71 +432,36 @@ public:
 
         // Trying to add a timer that's already here - shouldn't get to this point,
         // so if you get this assertion, let me know!
-        jassert (std::none_of (timers.begin(), timers.end(),
-                               [t] (TimerCountdown i) { return i.timer == t; }));
-
-        auto pos = timers.size();
+        jassert (! wheel.contains (t->positionInQueue, t));
 
-        timers.push_back ({ t, t->timerPeriodMs });
-        t->positionInQueue = pos;
-        shuffleTimerForwardInQueue (pos);
-        notify();
+        const auto dueTime = getCurrentTime() + t->timerPeriodMs;
+        t->positionInQueue = wheel.add (t, dueTime);
+        notifyIfDueBeforeWakeUp (dueTime);
     }
 
     void removeTimer (Timer* t)
     {
         const LockType::ScopedLockType sl (lock);
 
-        auto pos = t->positionInQueue;
-        auto lastIndex = timers.size() - 1;
-
-        jassert (pos <= lastIndex);
-        jassert (timers[pos].timer == t);
-
-        for (auto i = pos; i < lastIndex; ++i)
-        {
-            timers[i] = timers[i + 1];
-            timers[i].timer->positionInQueue = i;
-        }
+        jassert (wheel.contains (t->positionInQueue, t));
 
-        timers.pop_back();
+        wheel.remove (t->positionInQueue);
+        t->positionInQueue = TimerWheel::none;
     }
 
     void resetTimerCounter (Timer* t) noexcept
     {
         const LockType::ScopedLockType sl (lock);
 
-        auto pos = t->positionInQueue;
-
-        jassert (pos < timers.size());
-        jassert (timers[pos].timer == t);
+        jassert (wheel.contains (t->positionInQueue, t));
 
-        auto lastCountdown = timers[pos].countdownMs;
-        auto newCountdown = t->timerPeriodMs;
-
-        if (newCountdown != lastCountdown)
-        {
-            timers[pos].countdownMs = newCountdown;
-
-            if (newCountdown > lastCountdown)
-                shuffleTimerBackInQueue (pos);
-            else
-                shuffleTimerForwardInQueue (pos);
-
-            notify();
-        }
+        schedule (*t, getCurrentTime() + t->timerPeriodMs);
     }
 
 private:
     LockType lock;
-
-    struct TimerCountdown
-    {
-        Timer* timer;
-        int countdownMs;
-    };
-
-    std::vector<TimerCountdown> timers;
+    TimerWheel wheel { getCurrentTime() };
+    int64 nextWakeUpTime = 0;
 
     WaitableEvent callbackArrived;
 
@@ -273,67 +477,32 @@ private:
     };
 
     //==============================================================================
-    void shuffleTimerBackInQueue (size_t pos)
+    static int64 getCurrentTime() noexcept
     {
-        auto numTimers = timers.size();
-
-        if (pos < numTimers - 1)
-        {
-            auto t = timers[pos];
-
-            for (;;)
-            {
-                auto next = pos + 1;
-
-                if (next == numTimers || timers[next].countdownMs >= t.countdownMs)
-                    break;
-
-                timers[pos] = timers[next];
-                timers[pos].timer->positionInQueue = pos;
-
-                ++pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
+        return (int64) Time::getMillisecondCounterHiRes();
     }
 
-    void shuffleTimerForwardInQueue (size_t pos)
+    void schedule (Timer& t, int64 dueTime) noexcept
     {
-        if (pos > 0)
-        {
-            auto t = timers[pos];
-
-            while (pos > 0)
-            {
-                auto& prev = timers[(size_t) pos - 1];
-
-                if (prev.countdownMs <= t.countdownMs)
-                    break;
-
-                timers[pos] = prev;
-                timers[pos].timer->positionInQueue = pos;
-
-                --pos;
-            }
+        wheel.reschedule (t.positionInQueue, dueTime);
+        notifyIfDueBeforeWakeUp (dueTime);
+    }
 
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
+    void notifyIfDueBeforeWakeUp (int64 dueTime)
+    {
+        if (dueTime < nextWakeUpTime)
+            notify();
     }
 
-    int getTimeUntilFirstTimer (int numMillisecsElapsed)
+    int advanceTimers()
     {
         const LockType::ScopedLockType sl (lock);
 
-        if (timers.empty())
-            return 1000;
+        wheel.advanceTo (getCurrentTime());
 
-        for (auto& t : timers)
-            t.countdownMs -= numMillisecsElapsed;
-
-        return timers.front().countdownMs;
+        const auto timeUntilFirstTimer = jmin (wheel.getTimeUntilNextDueTimer(), 1000);
+        nextWakeUpTime = wheel.getCurrentTime() + jlimit (1, 100, timeUntilFirstTimer);
+        return timeUntilFirstTimer;
     }
 
     //==============================================================================
@@ -437,4 +606,317 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, std::move (f));
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerTests final : public UnitTest
+{
+public:
+    TimerTests()
+        : UnitTest ("Timer", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        // The boundaries at which timers move from one level of the wheel to the next
+        const int64 boundaries[] { 256, 256 * 64, 256 * 64 * 64 };
+
+        beginTest ("TimerWheel timers become due at exactly the right time, either side of each level boundary");
+        {
+            std::vector<int64> delays { 0, 1, 2, 100 };
+
+            for (auto boundary : boundaries)
+                for (auto offset : { -2, -1, 0, 1, 2 })
+                    delays.push_back (boundary + offset);
+
+            for (auto startTime : { (int64) 0, (int64) 1000, boundaries[1] - 1, boundaries[2] - 3, (int64) 123456789 })
+            {
+                for (auto stepEveryMillisecond : { true, false })
+                {
+                    Wheel wheel (startTime);
+
+                    for (auto delay : delays)
+                        wheel.add (startTime + delay);
+
+                    const auto fired = wheel.runUntil (startTime + boundaries[2] + 10, stepEveryMillisecond);
+
+                    expectEquals ((int) fired.size(), (int) delays.size());
+
+                    for (const auto& f : fired)
+                        expectEquals (f.time, wheel.getDueTime (f.timer));
+                }
+            }
+        }
+
+        beginTest ("TimerWheel timers from different levels that cascade into the same slot are all on time");
+        {
+            // Each timer is added at a time that puts it in a different level, and they all end
+            // up in the slot just after a boundary
+            const auto dueTime = 2 * boundaries[2] + 5;
+            Wheel wheel (dueTime - 1'100'000);
+
+            for (auto delay : { (int64) 1'100'000, (int64) 20'000, (int64) 1'000, (int64) 100 })
+            {
+                wheel.advanceTo (dueTime - delay);
+                wheel.add (dueTime);
+            }
+
+            const auto fired = wheel.runUntil (dueTime + 1, true);
+
+            expectEquals ((int) fired.size(), 4);
+
+            for (const auto& f : fired)
+                expectEquals (f.time, dueTime);
+        }
+
+        beginTest ("TimerWheel timers fire in order of due time across levels");
+        {
+            const int64 startTime = 777;
+            Wheel wheel (startTime);
+            Random random (getRandom().nextInt64());
+
+            for (int i = 0; i < 500; ++i)
+                wheel.add (startTime + random.nextInt ((int) (boundaries[2] + 1000)));
+
+            const auto fired = wheel.runUntil (startTime + boundaries[2] + 1000, false);
+
+            expectEquals ((int) fired.size(), 500);
+
+            for (size_t i = 1; i < fired.size(); ++i)
+                expect (fired[i - 1].time <= fired[i].time);
+
+            for (const auto& f : fired)
+                expectEquals (f.time, wheel.getDueTime (f.timer));
+        }
+
+        beginTest ("TimerWheel timers can be rescheduled or removed while they're in a higher level");
+        {
+            const int64 startTime = 5;
+            Wheel wheel (startTime);
+
+            const auto earlier = wheel.add (startTime + 100'000);
+            const auto later = wheel.add (startTime + 100'000);
+            const auto removed = wheel.add (startTime + 100'000);
+
+            wheel.advanceTo (startTime + 5'000);
+            wheel.reschedule (earlier, wheel.getCurrentTime() + 10);
+            wheel.reschedule (later, wheel.getCurrentTime() + 300'000);
+            wheel.remove (removed);
+
+            // The removed timer's node is reused
+            expectEquals ((int) wheel.add (startTime + 200'000), (int) removed);
+
+            const auto fired = wheel.runUntil (startTime + 500'000, false);
+
+            expectEquals ((int) fired.size(), 3);
+
+            if (fired.size() == 3)
+            {
+                expect (fired[0].timer == wheel.timers[0].get());
+                expectEquals (fired[0].time, startTime + 5'010);
+                expect (fired[1].timer == wheel.timers[3].get());
+                expectEquals (fired[1].time, startTime + 200'000);
+                expect (fired[2].timer == wheel.timers[1].get());
+                expectEquals (fired[2].time, startTime + 305'000);
+            }
+        }
+
+        beginTest ("TimerWheel handles very long intervals");
+        {
+            const int64 startTime = 1'000'000;
+            const int64 longest = std::numeric_limits<int>::max();
+
+            Wheel wheel (startTime);
+            wheel.add (startTime + longest);
+            wheel.add (startTime + longest - boundaries[2]);
+
+            wheel.advanceTo (startTime + longest - boundaries[2] - 1);
+            expect (wheel.getFirstDueTimer() == nullptr);
+            expect (wheel.getTimeUntilNextDueTimer() >= 1);
+
+            const auto fired = wheel.runUntil (startTime + longest + 10, false);
+
+            expectEquals ((int) fired.size(), 2);
+
+            for (const auto& f : fired)
+                expectEquals (f.time, wheel.getDueTime (f.timer));
+        }
+
+       #if ! (JUCE_MAC || JUCE_IOS || JUCE_ANDROID)
+        if (! MessageManager::getInstance()->isThisTheMessageThread())
+            return;
+
+        beginTest ("A timer can stop itself from its callback");
+        {
+            CallbackTimer timer;
+            timer.onCallback = [&] { timer.stopTimer(); };
+
+            timer.startTimer (5);
+            dispatchMessagesFor (100);
+
+            expectEquals (timer.numCallbacks, 1);
+            expect (! timer.isTimerRunning());
+        }
+
+        beginTest ("A timer can stop another timer that's due from its callback");
+        {
+            CallbackTimer first, second;
+            first.onCallback = [&] { first.stopTimer(); second.stopTimer(); };
+            second.onCallback = [&] { second.stopTimer(); first.stopTimer(); };
+
+            first.startTimer (10);
+            second.startTimer (10);
+            dispatchMessagesFor (100);
+
+            expectEquals (first.numCallbacks + second.numCallbacks, 1);
+        }
+
+        beginTest ("A timer can restart itself with a different interval from its callback");
+        {
+            CallbackTimer timer;
+            uint32 restartTime = 0;
+
+            timer.onCallback = [&]
+            {
+                if (timer.numCallbacks == 1)
+                {
+                    restartTime = Time::getMillisecondCounter();
+                    timer.startTimer (300);
+                }
+                else
+                {
+                    timer.stopTimer();
+                }
+            };
+
+            timer.startTimer (5);
+            dispatchMessagesFor (100);
+            expectEquals (timer.numCallbacks, 1);
+
+            dispatchMessagesFor (600);
+            expectEquals (timer.numCallbacks, 2);
+            expect (timer.lastCallbackTime - restartTime >= 290);
+        }
+
+        beginTest ("A timer can start another timer from its callback");
+        {
+            CallbackTimer first, second;
+            first.onCallback = [&] { first.stopTimer(); second.startTimer (5); };
+            second.onCallback = [&] { second.stopTimer(); };
+
+            first.startTimer (5);
+            dispatchMessagesFor (150);
+
+            expectEquals (first.numCallbacks, 1);
+            expectEquals (second.numCallbacks, 1);
+        }
+       #endif
+    }
+
+private:
+    struct CallbackTimer final : public Timer
+    {
+        ~CallbackTimer() override { stopTimer(); }
+
+        void timerCallback() override
+        {
+            ++numCallbacks;
+            lastCallbackTime = Time::getMillisecondCounter();
+            NullCheckedInvocation::invoke (onCallback);
+        }
+
+        int numCallbacks = 0;
+        uint32 lastCallbackTime = 0;
+        std::function<void()> onCallback;
+    };
+
+    // A TimerWheel with some timers that it can refer to, which are never started
+    struct Wheel final : public TimerWheel
+    {
+        using TimerWheel::TimerWheel;
+
+        struct Fired
+        {
+            const Timer* timer;
+            int64 time;
+        };
+
+        size_t add (int64 dueTime)
+        {
+            timers.push_back (std::make_unique<CallbackTimer>());
+            const auto index = TimerWheel::add (timers.back().get(), dueTime);
+
+            indices[timers.back().get()] = index;
+            dueTimes[timers.back().get()] = dueTime;
+            return index;
+        }
+
+        void reschedule (size_t index, int64 dueTime)
+        {
+            TimerWheel::reschedule (index, dueTime);
+            dueTimes[getTimer (index)] = dueTime;
+        }
+
+        void remove (size_t index)
+        {
+            TimerWheel::remove (index);
+            indices.erase (getTimer (index));
+        }
+
+        int64 getDueTime (const Timer* timer) const    { return dueTimes.at (timer); }
+
+        // Advances the wheel, either a millisecond at a time or by as much as the timer thread
+        // would, and removes each timer as it becomes due
+        std::vector<Fired> runUntil (int64 endTime, bool stepEveryMillisecond)
+        {
+            std::vector<Fired> fired;
+
+            for (;;)
+            {
+                while (auto* timer = getFirstDueTimer())
+                {
+                    fired.push_back ({ timer, getCurrentTime() });
+                    remove (indices.at (timer));
+                }
+
+                if (getCurrentTime() >= endTime)
+                    return fired;
+
+                const auto step = stepEveryMillisecond ? 1 : jmax (1, getTimeUntilNextDueTimer());
+                advanceTo (jmin (endTime, getCurrentTime() + step));
+            }
+        }
+
+        std::vector<std::unique_ptr<CallbackTimer>> timers;
+        std::map<const Timer*, size_t> indices;
+        std::map<const Timer*, int64> dueTimes;
+
+    private:
+        const Timer* getTimer (size_t index) const
+        {
+            for (const auto& [timer, i] : indices)
+                if (i == index)
+                    return timer;
+
+            jassertfalse;
+            return nullptr;
+        }
+    };
+
+   #if ! (JUCE_MAC || JUCE_IOS || JUCE_ANDROID)
+    static void dispatchMessagesFor (int milliseconds)
+    {
+        const auto endTime = Time::getMillisecondCounter() + (uint32) milliseconds;
+
+        while (Time::getMillisecondCounter() < endTime)
+            if (! detail::dispatchNextMessageOnSystemQueue (true))
+                Thread::sleep (1);
+    }
+   #endif
+};
+
+static TimerTests timerTests;
+
+#endif
+
 } // namespace juce
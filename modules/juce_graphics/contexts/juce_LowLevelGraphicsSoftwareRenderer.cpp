@@ -56,4 +56,274 @@ LowLevelGraphicsSoftwareRenderer::~LowLevelGraphicsSoftwareRenderer()
     JUCE_TRACE_LOG_PAINT_CALL (etw::endGDIFrame, getFrameId());
 }
 
+void LowLevelGraphicsSoftwareRenderer::setGlyphAtlasSizeLimit (size_t maxNumBytes)
+{
+    RenderingHelpers::GlyphAtlas::getInstance().setSizeLimit (maxNumBytes);
+}
+
+LowLevelGraphicsSoftwareRenderer::GlyphAtlasStatistics LowLevelGraphicsSoftwareRenderer::getGlyphAtlasStatistics()
+{
+    return RenderingHelpers::GlyphAtlas::getInstance().getStatistics();
+}
+
+void LowLevelGraphicsSoftwareRenderer::resetGlyphAtlasStatistics()
+{
+    RenderingHelpers::GlyphAtlas::getInstance().resetStatistics();
+}
+
+void LowLevelGraphicsSoftwareRenderer::setPathCacheSizeLimit (size_t maxNumBytes)
+{
+    RenderingHelpers::PathCache::getInstance().setSizeLimit (maxNumBytes);
+}
+
+LowLevelGraphicsSoftwareRenderer::PathCacheStatistics LowLevelGraphicsSoftwareRenderer::getPathCacheStatistics()
+{
+    return RenderingHelpers::PathCache::getInstance().getStatistics();
+}
+
+void LowLevelGraphicsSoftwareRenderer::resetPathCacheStatistics()
+{
+    RenderingHelpers::PathCache::getInstance().resetStatistics();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LowLevelGraphicsSoftwareRendererTests final : public UnitTest
+{
+public:
+    LowLevelGraphicsSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsSoftwareRenderer", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto originalLimit = Renderer::getGlyphAtlasStatistics().maxNumBytes;
+        const ScopeGuard restoreLimit { [&] { Renderer::setGlyphAtlasSizeLimit (originalLimit); } };
+
+        const auto font = FontOptions (15.0f);
+        GlyphArrangement arrangement;
+        arrangement.addLineOfText (font, "Sphinx of black quartz, judge my vow", 0.0f, 0.0f);
+
+        std::vector<uint16_t> glyphs;
+
+        for (auto& glyph : arrangement)
+            glyphs.push_back ((uint16_t) glyph.getGlyphIndex());
+
+        // Quarter-pixel positions are drawn in exactly the same place by the atlas and the edge-table fills
+        std::vector<Point<float>> positions;
+
+        for (size_t i = 0; i < glyphs.size(); ++i)
+            positions.emplace_back (3.0f + (float) i * 7.25f, 20.0f + (float) (i % 4) * 0.5f);
+
+        beginTest ("Glyphs drawn from the atlas match glyphs filled from their edge tables");
+        {
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                for (auto colour : { Colours::black, Colours::red.withAlpha (0.6f) })
+                {
+                    Renderer::setGlyphAtlasSizeLimit (originalLimit);
+                    const auto fromAtlas = renderGlyphs (format, font, colour, glyphs, positions);
+
+                    Renderer::setGlyphAtlasSizeLimit (0);
+                    const auto fromEdgeTables = renderGlyphs (format, font, colour, glyphs, positions);
+
+                    expect (imagesAreIdentical (fromAtlas, fromEdgeTables));
+                }
+            }
+        }
+
+        beginTest ("Statistics count hits and misses");
+        {
+            Renderer::setGlyphAtlasSizeLimit (originalLimit);
+            RenderingHelpers::GlyphAtlas::getInstance().reset();
+            Renderer::resetGlyphAtlasStatistics();
+
+            renderGlyphs (Image::ARGB, font, Colours::black, glyphs, positions);
+            const auto afterFirstDraw = Renderer::getGlyphAtlasStatistics();
+            expectGreaterThan (afterFirstDraw.numMisses, (int64) 0);
+            expectGreaterThan (afterFirstDraw.numPages, 0);
+
+            renderGlyphs (Image::ARGB, font, Colours::black, glyphs, positions);
+            const auto afterSecondDraw = Renderer::getGlyphAtlasStatistics();
+            expectEquals (afterSecondDraw.numMisses, afterFirstDraw.numMisses);
+            expectGreaterThan (afterSecondDraw.numHits, afterFirstDraw.numHits);
+            expectGreaterThan (afterSecondDraw.getHitRate(), 0.0);
+        }
+
+        beginTest ("Pages are evicted to stay within the size limit");
+        {
+            const auto pageBytes = (size_t) (RenderingHelpers::GlyphAtlas::pageSize * RenderingHelpers::GlyphAtlas::pageSize);
+            Renderer::setGlyphAtlasSizeLimit (pageBytes * 2);
+            Renderer::resetGlyphAtlasStatistics();
+
+            for (int size = 10; size < 30; ++size)
+                renderGlyphs (Image::ARGB, FontOptions ((float) size), Colours::black, glyphs, positions);
+
+            const auto stats = Renderer::getGlyphAtlasStatistics();
+            expectGreaterThan (stats.numEvictions, (int64) 0);
+            expect (stats.numBytes <= pageBytes * 2);
+
+            Renderer::setGlyphAtlasSizeLimit (0);
+            expectEquals (Renderer::getGlyphAtlasStatistics().numPages, 0);
+        }
+
+        const auto originalPathCacheLimit = Renderer::getPathCacheStatistics().maxNumBytes;
+        const ScopeGuard restorePathCacheLimit { [&] { Renderer::setPathCacheSizeLimit (originalPathCacheLimit); } };
+
+        const auto createKnob = []
+        {
+            Path p;
+            p.addCentredArc (30.0f, 30.0f, 20.0f, 20.0f, 0.0f, -2.4f, 1.7f, true);
+            return p;
+        };
+
+        const auto createDial = []
+        {
+            Path p;
+            p.addEllipse (10.0f, 10.0f, 50.5f, 50.5f);
+            p.addRoundedRectangle (28.0f, 12.0f, 4.0f, 20.0f, 2.0f);
+            return p;
+        };
+
+        beginTest ("Paths that are drawn repeatedly use the path cache");
+        {
+            Renderer::setPathCacheSizeLimit (0);
+            const auto uncachedFill = renderPath (createDial(), std::nullopt, {});
+            const auto uncachedStroke = renderPath (createKnob(), PathStrokeType (3.0f), {});
+
+            Renderer::setPathCacheSizeLimit (originalPathCacheLimit);
+            RenderingHelpers::PathCache::getInstance().reset();
+            Renderer::resetPathCacheStatistics();
+
+            for (int i = 0; i < 3; ++i)
+            {
+                expect (imagesAreSimilar (renderPath (createDial(), std::nullopt, {}), uncachedFill));
+                expect (imagesAreSimilar (renderPath (createKnob(), PathStrokeType (3.0f), {}), uncachedStroke));
+            }
+
+            // The results are only stored when a path is drawn for the second time
+            const auto stats = Renderer::getPathCacheStatistics();
+            expectEquals (stats.numMisses, (int64) 4);
+            expectEquals (stats.numHits, (int64) 2);
+            expectEquals (stats.numEntries, 2);
+            expect (stats.numBytes > 0);
+        }
+
+        beginTest ("The path cache is shared between translated copies of a path");
+        {
+            RenderingHelpers::PathCache::getInstance().reset();
+            Renderer::resetPathCacheStatistics();
+
+            const auto moved = AffineTransform::translation (7.25f, 3.0f);
+            const auto first = renderPath (createKnob(), PathStrokeType (3.0f), {});
+            renderPath (createKnob(), PathStrokeType (3.0f), {});
+            const auto translated = renderPath (createKnob(), PathStrokeType (3.0f), moved);
+
+            expectEquals (Renderer::getPathCacheStatistics().numHits, (int64) 1);
+
+            Renderer::setPathCacheSizeLimit (0);
+            expect (imagesAreSimilar (translated, renderPath (createKnob(), PathStrokeType (3.0f), moved)));
+            expect (! imagesAreSimilar (translated, first));
+            Renderer::setPathCacheSizeLimit (originalPathCacheLimit);
+        }
+
+        beginTest ("Changing a path stops it using the cached result for its old shape");
+        {
+            RenderingHelpers::PathCache::getInstance().reset();
+            Renderer::resetPathCacheStatistics();
+
+            auto knob = createKnob();
+            renderPath (knob, PathStrokeType (3.0f), {});
+            renderPath (knob, PathStrokeType (3.0f), {});
+
+            knob.lineTo (55.0f, 55.0f);
+            const auto changed = renderPath (knob, PathStrokeType (3.0f), {});
+
+            expectEquals (Renderer::getPathCacheStatistics().numHits, (int64) 0);
+            expect (changed.getPixelAt (54, 54).getAlpha() > 0);
+        }
+
+        beginTest ("The path cache stays within its size limit");
+        {
+            RenderingHelpers::PathCache::getInstance().reset();
+
+            const auto drawTwice = [&] (int i)
+            {
+                const auto t = AffineTransform::scale (1.0f + (float) i * 0.01f);
+                renderPath (createKnob(), PathStrokeType (3.0f), t);
+                renderPath (createKnob(), PathStrokeType (3.0f), t);
+            };
+
+            drawTwice (0);
+            const auto limit = Renderer::getPathCacheStatistics().numBytes * 3;
+            Renderer::setPathCacheSizeLimit (limit);
+            Renderer::resetPathCacheStatistics();
+
+            for (int i = 1; i < 20; ++i)
+                drawTwice (i);
+
+            const auto stats = Renderer::getPathCacheStatistics();
+            expect (stats.numBytes <= limit);
+            expectGreaterThan (stats.numEvictions, (int64) 0);
+        }
+    }
+
+private:
+    using Renderer = LowLevelGraphicsSoftwareRenderer;
+
+    static Image renderGlyphs (Image::PixelFormat format, const Font& font, Colour colour,
+                               const std::vector<uint16_t>& glyphs, const std::vector<Point<float>>& positions)
+    {
+        Image image (format, 300, 40, true, SoftwareImageType());
+        image.clear (image.getBounds(), Colours::lightgrey);
+
+        Renderer renderer (image);
+        renderer.setFont (font);
+        renderer.setFill (colour);
+        renderer.drawGlyphs (glyphs, positions, {});
+        return image;
+    }
+
+    static Image renderPath (const Path& path, std::optional<PathStrokeType> strokeType, const AffineTransform& transform)
+    {
+        Image image (Image::ARGB, 80, 80, true, SoftwareImageType());
+        Renderer renderer (image);
+        renderer.setFill (Colours::black);
+
+        if (strokeType.has_value())
+            renderer.strokePath (path, *strokeType, transform);
+        else
+            renderer.fillPath (path, transform);
+
+        return image;
+    }
+
+    // Allows for the tiny differences that come from applying a path's translation after flattening it
+    static bool imagesAreSimilar (const Image& a, const Image& b)
+    {
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (std::abs ((int) a.getPixelAt (x, y).getAlpha() - (int) b.getPixelAt (x, y).getAlpha()) > 2)
+                    return false;
+
+        return true;
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+};
+
+static LowLevelGraphicsSoftwareRendererTests lowLevelGraphicsSoftwareRendererTests;
+
+#endif
+
 } // namespace juce
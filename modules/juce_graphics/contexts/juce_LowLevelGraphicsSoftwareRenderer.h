@@ -64,6 +64,55 @@ public:
         return std::make_unique<SoftwareImageType>();
     }
 
+    //==============================================================================
+    /** Information about the cache of pre-rendered glyphs that software renderers share.
+
+        @see getGlyphAtlasStatistics
+    */
+    using GlyphAtlasStatistics = RenderingHelpers::GlyphAtlas::Statistics;
+
+    /** Sets the maximum amount of memory that the software renderers may use to hold
+        pre-rendered glyphs.
+
+        Text drawn in a solid colour is blended from these images rather than being
+        filled glyph by glyph, so a larger cache can speed up text-heavy interfaces that
+        use many fonts. Setting a limit of zero disables the cache. The default is 8MB.
+    */
+    static void setGlyphAtlasSizeLimit (size_t maxNumBytes);
+
+    /** Returns the current size of the pre-rendered glyph cache, and its hit rate.
+        @see setGlyphAtlasSizeLimit, resetGlyphAtlasStatistics
+    */
+    static GlyphAtlasStatistics getGlyphAtlasStatistics();
+
+    /** Resets the hit, miss and eviction counts returned by getGlyphAtlasStatistics(). */
+    static void resetGlyphAtlasStatistics();
+
+    //==============================================================================
+    /** Information about the cache of flattened and stroked paths that software renderers share.
+
+        @see getPathCacheStatistics
+    */
+    using PathCacheStatistics = RenderingHelpers::PathCache::Statistics;
+
+    /** Sets the maximum amount of memory that the software renderers may use to hold
+        flattened paths and stroke outlines.
+
+        Paths that are drawn again with the same contents, scale and rotation, even if
+        they've been rebuilt from scratch, can then skip flattening their curves and
+        creating their stroke outlines. Setting a limit of zero disables the cache. The
+        default is 4MB.
+    */
+    static void setPathCacheSizeLimit (size_t maxNumBytes);
+
+    /** Returns the current size of the path cache, and its hit rate.
+        @see setPathCacheSizeLimit, resetPathCacheStatistics
+    */
+    static PathCacheStatistics getPathCacheStatistics();
+
+    /** Resets the hit, miss and eviction counts returned by getPathCacheStatistics(). */
+    static void resetPathCacheStatistics();
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsSoftwareRenderer)
 };
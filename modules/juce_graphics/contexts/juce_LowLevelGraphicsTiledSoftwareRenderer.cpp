@@ -0,0 +1,499 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+class TiledSoftwareRendererThreadPool final : private DeletedAtShutdown
+{
+public:
+    TiledSoftwareRendererThreadPool()
+        : pool (ThreadPoolOptions{}.withThreadName ("Tiled renderer")
+                                   .withNumberOfThreads (jmax (1, SystemStats::getNumCpus() - 1)))
+    {
+    }
+
+    ~TiledSoftwareRendererThreadPool() override
+    {
+        clearSingletonInstance();
+    }
+
+    ThreadPool pool;
+
+    JUCE_DECLARE_SINGLETON_INLINE (TiledSoftwareRendererThreadPool, false)
+};
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto)
+    : LowLevelGraphicsTiledSoftwareRenderer (imageToRenderOnto, {}, imageToRenderOnto.getBounds())
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> o,
+                                                                              const RectangleList<int>& clip, int numThreads)
+    : shadow (imageToRenderOnto, o, clip),
+      image (imageToRenderOnto),
+      origin (o),
+      initialClip (clip),
+      maxNumThreads (numThreads > 0 ? numThreads : SystemStats::getNumCpus())
+{
+    commands.reserve (256);
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    // If this is hit, a transparency layer wasn't ended, so nothing after
+    // the start of the layer will have been rendered
+    jassert (transparencyLayerDepth == 0);
+
+    renderPendingCommands();
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::recordState (std::function<void (LowLevelGraphicsContext&)> apply)
+{
+    // Inside a transparency layer, everything is drawn directly by the shadow context,
+    // and the state will be restored when the layer ends
+    if (transparencyLayerDepth == 0)
+        commands.push_back ({ std::move (apply), false });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::recordDrawing (std::function<void (LowLevelGraphicsContext&)> apply)
+{
+    if (transparencyLayerDepth > 0)
+    {
+        apply (shadow);
+        return;
+    }
+
+    if (! shadow.isClipEmpty())
+    {
+        commands.push_back ({ std::move (apply), true });
+        ++numPendingDrawingCommands;
+    }
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderBand (Rectangle<int> band) const
+{
+    auto clip = initialClip;
+    clip.clipTo (band);
+
+    if (clip.isEmpty())
+        return;
+
+    LowLevelGraphicsSoftwareRenderer renderer (image, origin, clip);
+
+    for (auto& command : commands)
+        command.apply (renderer);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderPendingCommands()
+{
+    if (transparencyLayerDepth > 0 || numPendingDrawingCommands == 0)
+        return;
+
+    // The bands span the whole width of the clip region, so that every horizontal run of
+    // pixels is rasterised in exactly the same way as it would be by a single renderer
+    enum { minBandHeight = 16, bandsPerThread = 2, minPixelsForMultipleBands = 256 * 256 };
+
+    const auto area = initialClip.getBounds();
+
+    // Listeners to the image data can't be called from several threads at once
+    const auto canUseMultipleThreads = maxNumThreads > 1
+                                    && image.getPixelData()->listeners.isEmpty()
+                                    && area.getWidth() * area.getHeight() >= (int) minPixelsForMultipleBands;
+
+    const auto numBands = canUseMultipleThreads ? jmin (maxNumThreads * (int) bandsPerThread, area.getHeight() / (int) minBandHeight)
+                                                : 1;
+
+    if (numBands <= 1)
+    {
+        renderBand (area);
+    }
+    else
+    {
+        std::atomic<int> nextBand { 0 };
+
+        const auto renderNextBands = [&]
+        {
+            for (int i; (i = nextBand++) < numBands;)
+                renderBand (Rectangle<int>::leftTopRightBottom (area.getX(), area.getY() + area.getHeight() * i / numBands,
+                                                                area.getRight(), area.getY() + area.getHeight() * (i + 1) / numBands));
+        };
+
+        auto& pool = TiledSoftwareRendererThreadPool::getInstance()->pool;
+        const auto numExtraThreads = jmin (maxNumThreads - 1, pool.getNumThreads(), numBands - 1);
+
+        WaitableEvent allThreadsFinished;
+        std::atomic<int> numThreadsRunning { numExtraThreads };
+
+        for (int i = 0; i < numExtraThreads; ++i)
+        {
+            pool.addJob ([&]
+            {
+                renderNextBands();
+
+                if (--numThreadsRunning == 0)
+                    allThreadsFinished.signal();
+            });
+        }
+
+        renderNextBands();
+
+        if (numExtraThreads > 0)
+            allThreadsFinished.wait();
+    }
+
+    // Only the state changes are needed to render any further commands
+    commands.erase (std::remove_if (commands.begin(), commands.end(), [] (const Command& c) { return c.isDrawing; }),
+                    commands.end());
+    numPendingDrawingCommands = 0;
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    shadow.setOrigin (o);
+    recordState ([o] (auto& g) { g.setOrigin (o); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    shadow.addTransform (t);
+    recordState ([t] (auto& g) { g.addTransform (t); });
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    auto result = shadow.clipToRectangle (r);
+    recordState ([r] (auto& g) { g.clipToRectangle (r); });
+    return result;
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& r)
+{
+    auto result = shadow.clipToRectangleList (r);
+    recordState ([r] (auto& g) { g.clipToRectangleList (r); });
+    return result;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    shadow.excludeClipRectangle (r);
+    recordState ([r] (auto& g) { g.excludeClipRectangle (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    shadow.clipToPath (path, t);
+    recordState ([path, t] (auto& g) { g.clipToPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    shadow.clipToImageAlpha (im, t);
+    recordState ([im, t] (auto& g) { g.clipToImageAlpha (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    shadow.saveState();
+    recordState ([] (auto& g) { g.saveState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    shadow.restoreState();
+    recordState ([] (auto& g) { g.restoreState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    if (transparencyLayerDepth == 0)
+    {
+        // The layer is composited onto the image when it ends, so everything
+        // underneath it must be rendered first
+        renderPendingCommands();
+        recordState ([] (auto& g) { g.saveState(); });
+    }
+
+    ++transparencyLayerDepth;
+    shadow.beginTransparencyLayer (opacity);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    jassert (transparencyLayerDepth > 0);
+
+    shadow.endTransparencyLayer();
+
+    if (--transparencyLayerDepth == 0)
+        recordState ([] (auto& g) { g.restoreState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    shadow.setFill (fillType);
+    recordState ([fillType] (auto& g) { g.setFill (fillType); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float opacity)
+{
+    shadow.setOpacity (opacity);
+    recordState ([opacity] (auto& g) { g.setOpacity (opacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    shadow.setInterpolationQuality (quality);
+    recordState ([quality] (auto& g) { g.setInterpolationQuality (quality); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& font)
+{
+    shadow.setFont (font);
+    recordState ([font] (auto& g) { g.setFont (font); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    recordDrawing ([r, replaceExistingContents] (auto& g) { g.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    recordDrawing ([r] (auto& g) { g.fillRect (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    recordDrawing ([list] (auto& g) { g.fillRectList (list); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    recordDrawing ([path, t] (auto& g) { g.fillPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    recordDrawing ([im, t] (auto& g) { g.drawImage (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    recordDrawing ([line] (auto& g) { g.drawLine (line); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyphs (Span<const uint16_t> glyphs,
+                                                        Span<const Point<float>> positions,
+                                                        const AffineTransform& t)
+{
+    jassert (glyphs.size() == positions.size());
+
+    recordDrawing ([glyphList = std::vector<uint16_t> (glyphs.begin(), glyphs.end()),
+                    positionList = std::vector<Point<float>> (positions.begin(), positions.end()),
+                    t] (auto& g)
+    {
+        g.drawGlyphs (glyphList, positionList, t);
+    });
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TiledSoftwareRendererTests final : public UnitTest
+{
+public:
+    TiledSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsTiledSoftwareRenderer", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const RectangleList<int> fullClip (Rectangle<int> (0, 0, 613, 457));
+
+        RectangleList<int> complexClip;
+        complexClip.add ({ 10, 5, 300, 200 });
+        complexClip.add ({ 150, 180, 463, 260 });
+        complexClip.add ({ 500, 20, 90, 90 });
+
+        for (auto scale : { 1.0f, 1.5f, 2.0f })
+        {
+            beginTest ("Matches LowLevelGraphicsSoftwareRenderer, scale " + String (scale));
+
+            for (const auto* clip : { &fullClip, &std::as_const (complexClip) })
+                for (auto format : { Image::ARGB, Image::RGB })
+                    for (auto numThreads : { 2, 4, 7 })
+                        expectMatchesSoftwareRenderer (format, *clip, scale, numThreads);
+        }
+    }
+
+private:
+    static Image createSourceImage()
+    {
+        Image source (Image::ARGB, 37, 29, true);
+        Graphics g (source);
+        g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.6f), 0.0f, 0.0f,
+                                           Colours::blue, 37.0f, 29.0f, true));
+        g.fillEllipse (0.0f, 0.0f, 37.0f, 29.0f);
+        g.setColour (Colours::white);
+        g.drawLine (0.0f, 29.0f, 37.0f, 0.0f, 2.0f);
+        return source;
+    }
+
+    static void paintTestScene (Graphics& g, const Image& source)
+    {
+        g.fillAll (Colours::darkgrey);
+
+        Random rng (1234);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            auto x = rng.nextFloat() * 380.0f;
+            auto y = rng.nextFloat() * 280.0f;
+
+            g.setColour (Colour ((uint32) rng.nextInt()).withAlpha (rng.nextFloat()));
+            g.fillRoundedRectangle (x, y, rng.nextFloat() * 60.0f + 1.0f, rng.nextFloat() * 40.0f + 1.0f, 5.3f);
+            g.drawEllipse (y, x * 0.7f, 30.5f, 17.25f, 1.7f);
+        }
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 20.0f, 30.0f, Colours::transparentBlack, 350.0f, 250.0f, false));
+        g.fillRect (Rectangle<float> (15.3f, 120.7f, 290.1f, 20.6f));
+
+        g.setGradientFill (ColourGradient (Colours::cyan, 200.0f, 150.0f, Colours::purple, 260.0f, 210.0f, true));
+        g.fillEllipse (140.0f, 90.0f, 130.0f, 120.0f);
+
+        {
+            Graphics::ScopedSaveState s (g);
+            g.addTransform (AffineTransform::rotation (0.3f, 200.0f, 150.0f));
+            g.drawImageTransformed (source, AffineTransform::scale (3.3f).translated (100.0f, 40.0f));
+
+            g.setImageResamplingQuality (Graphics::lowResamplingQuality);
+            g.drawImageTransformed (source, AffineTransform::scale (2.1f, 1.7f).translated (250.0f, 150.0f));
+        }
+
+        g.drawImageAt (source, 7, 260);
+        g.setTiledImageFill (source, 3, 5, 0.8f);
+        g.fillRect (300, 230, 90, 60);
+
+        {
+            Graphics::ScopedSaveState s (g);
+            Path star;
+            star.addStar ({ 330.0f, 90.0f }, 7, 20.0f, 60.0f, 0.2f);
+            g.reduceClipRegion (star);
+            g.excludeClipRegion ({ 320, 80, 10, 10 });
+            g.setColour (Colours::orange);
+            g.fillAll();
+            g.setColour (Colours::black);
+
+            for (int i = 0; i < 10; ++i)
+                g.drawLine (270.0f, 30.0f + (float) i * 12.5f, 400.0f, 40.0f + (float) i * 9.0f, 1.5f);
+        }
+
+        {
+            Graphics::ScopedSaveState s (g);
+            g.reduceClipRegion (source, AffineTransform::scale (4.0f).translated (20.0f, 180.0f));
+            g.setColour (Colours::green);
+            g.fillAll();
+        }
+
+        g.setColour (Colours::white);
+        g.setFont (FontOptions (17.0f));
+        g.drawText ("The quick brown fox jumps over the lazy dog", 20, 10, 380, 24, Justification::centredLeft);
+        g.drawMultiLineText ("Some more lines of text\nwrapped across the middle of\nthe image", 50, 200, 200);
+
+        g.beginTransparencyLayer (0.6f);
+        g.setColour (Colours::blue);
+        g.fillEllipse (100.0f, 220.0f, 80.0f, 60.0f);
+        g.setColour (Colours::red);
+        g.fillRect (120, 230, 30, 80);
+        g.endTransparencyLayer();
+
+        Path wave;
+        wave.startNewSubPath (10.0f, 150.0f);
+
+        for (int i = 1; i < 40; ++i)
+            wave.lineTo (10.0f + (float) i * 9.7f, 150.0f + 40.0f * std::sin ((float) i * 0.4f));
+
+        g.setColour (Colours::magenta.withAlpha (0.5f));
+        g.strokePath (wave, PathStrokeType (2.5f, PathStrokeType::curved, PathStrokeType::rounded));
+        g.drawRect (Rectangle<float> (2.5f, 3.5f, 400.0f, 290.0f), 3.0f);
+    }
+
+    void expectMatchesSoftwareRenderer (Image::PixelFormat format, const RectangleList<int>& clip,
+                                        float scale, int numThreads)
+    {
+        const auto source = createSourceImage();
+        const auto bounds = clip.getBounds();
+
+        Image expected (format, bounds.getRight(), bounds.getBottom(), true);
+        Image actual (format, bounds.getRight(), bounds.getBottom(), true);
+
+        {
+            LowLevelGraphicsSoftwareRenderer context (expected, { 3, -2 }, clip);
+            context.addTransform (AffineTransform::scale (scale));
+            Graphics g (context);
+            paintTestScene (g, source);
+        }
+
+        {
+            LowLevelGraphicsTiledSoftwareRenderer context (actual, { 3, -2 }, clip, numThreads);
+            context.addTransform (AffineTransform::scale (scale));
+            Graphics g (context);
+            paintTestScene (g, source);
+        }
+
+        const Image::BitmapData expectedData (expected, Image::BitmapData::readOnly);
+        const Image::BitmapData actualData (actual, Image::BitmapData::readOnly);
+
+        int numDifferentPixels = 0;
+
+        for (int y = 0; y < expectedData.height; ++y)
+            for (int x = 0; x < expectedData.width; ++x)
+                if (expectedData.getPixelColour (x, y) != actualData.getPixelColour (x, y))
+                    ++numDifferentPixels;
+
+        expectEquals (numDifferentPixels, 0);
+    }
+};
+
+static TiledSoftwareRendererTests tiledSoftwareRendererTests;
+
+#endif
+
+} // namespace juce
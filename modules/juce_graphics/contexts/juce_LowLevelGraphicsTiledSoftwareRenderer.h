@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A software renderer that records drawing operations and then renders them
+    on multiple threads.
+
+    Instead of rasterising each operation as soon as it's called, this context
+    records the operations into a display list. When the context is destroyed, or
+    renderPendingCommands() is called, the clip region is split into horizontal bands,
+    and each band replays the display list into its own LowLevelGraphicsSoftwareRenderer
+    on a different thread, clipped to that band.
+
+    Each band is rendered using exactly the same arithmetic as a single
+    LowLevelGraphicsSoftwareRenderer would use for those rows, so the resulting image
+    is identical to the one that LowLevelGraphicsSoftwareRenderer would produce.
+
+    Any state queries, such as getClipBounds() or clipRegionIntersects(), are answered
+    immediately. Transparency layers are rendered immediately on the calling thread,
+    after rendering everything that was recorded before the layer began.
+
+    Because the display list keeps references to any images that are drawn rather than
+    copying them, an image that is drawn into this context must not be modified until
+    the context has rendered it.
+
+    User code is not supposed to create instances of this class directly - do all your
+    rendering via the Graphics class instead. The default LookAndFeel::createGraphicsContext()
+    will use this class if JUCE_USE_TILED_SOFTWARE_RENDERER is enabled.
+
+    @see LowLevelGraphicsSoftwareRenderer
+
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image. */
+    explicit LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto);
+
+    /** Creates a context to render into a clipped subsection of an image.
+
+        @param imageToRenderOnto    the image to draw into
+        @param origin               the position in the image of the context's origin
+        @param initialClip          the region of the image that may be drawn into
+        @param maxNumThreads        the maximum number of threads that may be used, including the
+                                    calling thread, or 0 to use one thread for each CPU core
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip,
+                                           int maxNumThreads = 0);
+
+    /** Destructor. Any drawing operations that haven't been rendered yet will be rendered
+        before this returns.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer() override;
+
+    //==============================================================================
+    /** Renders all the recorded drawing operations onto the image.
+        This is called automatically when the context is destroyed. It has no effect
+        while a transparency layer is active.
+    */
+    void renderPendingCommands();
+
+    //==============================================================================
+    bool isVectorDevice() const override                                      { return false; }
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() const override                        { return shadow.getPhysicalPixelScaleFactor(); }
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+    bool clipRegionIntersects (const Rectangle<int>& r) override              { return shadow.clipRegionIntersects (r); }
+    Rectangle<int> getClipBounds() const override                             { return shadow.getClipBounds(); }
+    bool isClipEmpty() const override                                         { return shadow.isClipEmpty(); }
+    void saveState() override;
+    void restoreState() override;
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+    void setFont (const Font&) override;
+    const Font& getFont() override                                            { return shadow.getFont(); }
+    void drawGlyphs (Span<const uint16_t>, Span<const Point<float>>, const AffineTransform&) override;
+    uint64_t getFrameId() const override                                      { return shadow.getFrameId(); }
+
+    std::unique_ptr<ImageType> getPreferredImageTypeForTemporaryImages() const override
+    {
+        return std::make_unique<SoftwareImageType>();
+    }
+
+private:
+    //==============================================================================
+    struct Command
+    {
+        std::function<void (LowLevelGraphicsContext&)> apply;
+        bool isDrawing;
+    };
+
+    // The shadow context tracks the state so that queries can be answered immediately,
+    // and is used to render transparency layers directly.
+    LowLevelGraphicsSoftwareRenderer shadow;
+    const Image image;
+    const Point<int> origin;
+    const RectangleList<int> initialClip;
+    const int maxNumThreads;
+    std::vector<Command> commands;
+    int numPendingDrawingCommands = 0, transparencyLayerDepth = 0;
+
+    void recordState (std::function<void (LowLevelGraphicsContext&)>);
+    void recordDrawing (std::function<void (LowLevelGraphicsContext&)>);
+    void renderBand (Rectangle<int> band) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+} // namespace juce
@@ -74,6 +74,11 @@ public:
         return text;
     }
 
+    auto& getOptions() const
+    {
+        return options;
+    }
+
     auto getTextRange (int64 glyphIndex) const
     {
         return simpleShapedText.getTextRange (glyphIndex);
@@ -155,9 +160,147 @@ ShapedText::ShapedText (String text) : ShapedText (std::move (text), {})
 {
 }
 
+//==============================================================================
+/*  Holds recently shaped texts, so that strings which are laid out repeatedly with the same
+    options, as labels and table cells are, only need to be shaped once.
+
+    The Impl objects are never modified after they've been created, so they can be shared
+    by any number of ShapedText objects on different threads.
+*/
+class ShapedText::Cache final : public DeletedAtShutdown
+{
+public:
+    Cache() = default;
+
+    ~Cache() override
+    {
+        clearSingletonInstance();
+    }
+
+    std::shared_ptr<Impl> get (String text, Options options)
+    {
+        // Long texts are usually being edited, so are unlikely to be shaped again unchanged
+        if (text.length() > maxTextLength)
+            return std::make_shared<Impl> (std::move (text), std::move (options));
+
+        const auto hash = getHash (text, options);
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto [item, end] = index.equal_range (hash); item != end; ++item)
+            {
+                const auto entry = item->second;
+
+                if (entry->impl->getText() == text && entry->impl->getOptions() == options)
+                {
+                    entries.splice (entries.begin(), entries, entry);
+                    ++stats.numHits;
+                    return entry->impl;
+                }
+            }
+
+            ++stats.numMisses;
+
+            if (maxNumEntries == 0)
+                return std::make_shared<Impl> (std::move (text), std::move (options));
+        }
+
+        // The shaping is done without holding the lock, so that other threads aren't held up
+        auto impl = std::make_shared<Impl> (std::move (text), std::move (options));
+
+        const ScopedLock sl (lock);
+        entries.push_front ({ hash, impl });
+        index.emplace (hash, entries.begin());
+        trim();
+        return impl;
+    }
+
+    void setMaxNumEntries (int newMaxNumEntries)
+    {
+        const ScopedLock sl (lock);
+        maxNumEntries = (size_t) jmax (0, newMaxNumEntries);
+        trim();
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+        entries.clear();
+        index.clear();
+    }
+
+    CacheStatistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+        auto result = stats;
+        result.numEntries = (int) entries.size();
+        return result;
+    }
+
+    JUCE_DECLARE_SINGLETON_INLINE (Cache, false)
+
+private:
+    struct Entry
+    {
+        size_t hash;
+        std::shared_ptr<Impl> impl;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    static size_t getHash (const String& text, const Options& options)
+    {
+        auto hash = (size_t) text.hashCode64();
+        hash = hash * 101 + (size_t) options.getJustification().getFlags();
+        hash = hash * 101 + std::hash<float>{} (options.getWordWrapWidth().value_or (-1.0f));
+        hash = hash * 101 + options.getFontsForRange().size();
+        return hash;
+    }
+
+    void trim()
+    {
+        while (entries.size() > maxNumEntries)
+        {
+            const auto oldest = std::prev (entries.end());
+            auto [item, end] = index.equal_range (oldest->hash);
+
+            while (item != end && item->second != oldest)
+                ++item;
+
+            jassert (item != end);
+            index.erase (item);
+            entries.erase (oldest);
+        }
+    }
+
+    static constexpr int maxTextLength = 1024;
+
+    EntryList entries; // most recently used first
+    std::unordered_multimap<size_t, EntryList::iterator> index;
+    size_t maxNumEntries = 256;
+    CacheStatistics stats;
+    CriticalSection lock;
+};
+
 ShapedText::ShapedText (String text, Options options)
+    : impl (Cache::getInstance()->get (std::move (text), std::move (options)))
+{
+}
+
+void ShapedText::setCacheSize (int maxNumEntries)
+{
+    Cache::getInstance()->setMaxNumEntries (maxNumEntries);
+}
+
+void ShapedText::clearCache()
 {
-    impl = std::make_shared<Impl> (std::move (text), std::move (options));
+    Cache::getInstance()->clear();
+}
+
+ShapedText::CacheStatistics ShapedText::getCacheStatistics()
+{
+    return Cache::getInstance()->getStatistics();
 }
 
 void ShapedText::draw (const Graphics& g, AffineTransform transform) const
@@ -229,4 +372,80 @@ const JustifiedText& ShapedText::getJustifiedText() const { return impl->getJust
 
 const SimpleShapedText& ShapedText::getSimpleShapedText() const { return impl->getSimpleShapedText(); }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ShapedTextCacheTests final : public UnitTest
+{
+public:
+    ShapedTextCacheTests()
+        : UnitTest ("ShapedTextCache", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        const auto options = ShapedText::Options{}.withFont (FontOptions { 17.0f })
+                                                  .withWordWrapWidth (120.0f);
+
+        beginTest ("Texts with the same string and options share their shaping");
+        {
+            const auto before = ShapedText::getCacheStatistics();
+
+            const ShapedText a { "Cached shaping test", options };
+            const ShapedText b { "Cached shaping test", options };
+
+            expect (a.getSimpleShapedText().getGlyphs().data() == b.getSimpleShapedText().getGlyphs().data());
+            expectEquals (ShapedText::getCacheStatistics().numHits, before.numHits + 1);
+        }
+
+        beginTest ("Different strings or options are shaped separately");
+        {
+            const ShapedText a { "Cached shaping test", options };
+            const ShapedText b { "Cached shaping test", options.withWordWrapWidth (60.0f) };
+            const ShapedText c { "Cached shaping text", options };
+
+            expect (a.getSimpleShapedText().getGlyphs().data() != b.getSimpleShapedText().getGlyphs().data());
+            expect (a.getSimpleShapedText().getGlyphs().data() != c.getSimpleShapedText().getGlyphs().data());
+            expect (a.getHeight() < b.getHeight());
+        }
+
+        beginTest ("GlyphArrangement reuses shaped text");
+        {
+            const auto before = ShapedText::getCacheStatistics();
+
+            GlyphArrangement first, second;
+            first.addLineOfText (FontOptions { 13.0f }, "Table cell", 0.0f, 0.0f);
+            second.addLineOfText (FontOptions { 13.0f }, "Table cell", 0.0f, 0.0f);
+
+            expectEquals (ShapedText::getCacheStatistics().numHits, before.numHits + 1);
+            expectEquals (first.getNumGlyphs(), second.getNumGlyphs());
+            expect (first.getBoundingBox (0, -1, true) == second.getBoundingBox (0, -1, true));
+        }
+
+        beginTest ("The cache size is limited");
+        {
+            const ScopeGuard restoreSize { [] { ShapedText::setCacheSize (256); } };
+
+            ShapedText::setCacheSize (4);
+
+            for (int i = 0; i < 10; ++i)
+                ShapedText { String (i), options };
+
+            expectEquals (ShapedText::getCacheStatistics().numEntries, 4);
+
+            ShapedText::setCacheSize (0);
+            expectEquals (ShapedText::getCacheStatistics().numEntries, 0);
+
+            const ShapedText a { "Uncached", options };
+            const ShapedText b { "Uncached", options };
+            expect (a.getSimpleShapedText().getGlyphs().data() != b.getSimpleShapedText().getGlyphs().data());
+        }
+    }
+};
+
+static ShapedTextCacheTests shapedTextCacheTests;
+
+#endif
+
 } // namespace juce::detail
@@ -108,8 +108,30 @@ public:
     /*  @internal */
     const SimpleShapedText& getSimpleShapedText() const;
 
+    //==============================================================================
+    struct CacheStatistics
+    {
+        int64 numHits = 0;
+        int64 numMisses = 0;
+        int numEntries = 0;
+    };
+
+    /*  Sets the maximum number of recently shaped texts that are kept for reuse.
+
+        A ShapedText that's created with the same string and options as a cached one shares
+        its glyphs and layout instead of shaping the text again. Setting a size of zero
+        disables the cache.
+    */
+    static void setCacheSize (int maxNumEntries);
+
+    /*  Discards all the cached shaped texts. */
+    static void clearCache();
+
+    static CacheStatistics getCacheStatistics();
+
 private:
     class Impl;
+    class Cache;
     std::shared_ptr<Impl> impl;
 };
 
@@ -59,6 +59,7 @@ private:
                          baselineAtZero,
                          allowBreakingInsideWord,
                          trailingWhitespacesShouldFit,
+                         drawLinesInFull,
                          maxNumLines,
                          ellipsis);
     }
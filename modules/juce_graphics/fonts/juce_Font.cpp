@@ -186,6 +186,7 @@ void Typeface::clearTypefaceCache()
     TypefaceCache::getInstance()->clear();
 
     RenderingHelpers::SoftwareRendererSavedState::clearGlyphCache();
+    detail::ShapedText::clearCache();
 
     NullCheckedInvocation::invoke (clearOpenGLGlyphCache);
 }
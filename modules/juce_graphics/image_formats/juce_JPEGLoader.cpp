@@ -332,6 +332,11 @@ bool JPEGImageFormat::canUnderstand (InputStream& in)
 #endif
 
 Image JPEGImageFormat::decodeImage (InputStream& in)
+{
+    return decodeImageForSize (in, 0, 0);
+}
+
+Image JPEGImageFormat::decodeImageForSize (InputStream& in, [[maybe_unused]] int targetWidth, [[maybe_unused]] int targetHeight)
 {
    #if JUCE_USING_COREIMAGE_LOADER
     return juce_loadWithCoreImage (in);
@@ -373,6 +378,27 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
 
         if (! hasFailed)
         {
+            // The decoder can scale the image down by 1/2, 1/4 or 1/8 as part of the IDCT,
+            // which is much quicker than decoding the whole image and resampling it
+            if (targetWidth > 0 || targetHeight > 0)
+            {
+                const auto coversTarget = [&] (unsigned int denominator)
+                {
+                    return (int) ((jpegDecompStruct.image_width  + denominator - 1) / denominator) >= targetWidth
+                        && (int) ((jpegDecompStruct.image_height + denominator - 1) / denominator) >= targetHeight;
+                };
+
+                for (unsigned int denominator = 8; denominator > 1; denominator /= 2)
+                {
+                    if (coversTarget (denominator))
+                    {
+                        jpegDecompStruct.scale_num = 1;
+                        jpegDecompStruct.scale_denom = denominator;
+                        break;
+                    }
+                }
+            }
+
             jpeg_calc_output_dimensions (&jpegDecompStruct);
 
             if (! hasFailed)
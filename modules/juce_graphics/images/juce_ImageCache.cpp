@@ -48,31 +48,94 @@ struct ImageCache::Pimpl     : private Timer,
 
     JUCE_DECLARE_SINGLETON_INLINE (ImageCache::Pimpl, false)
 
+    struct Item
+    {
+        Image image;
+        int64 hashCode;
+        uint32 lastUseTime;
+        size_t numBytes;
+        std::vector<Image> mipLevels;
+    };
+
     Image getFromHashCode (const int64 hashCode) noexcept
+    {
+        return getFromHashCodes ({ hashCode });
+    }
+
+    // Returns the first of these that's in the cache, counting a single hit or miss
+    Image getFromHashCodes (std::initializer_list<int64> hashCodes) noexcept
     {
         const ScopedLock sl (lock);
 
-        for (auto& item : images)
+        for (auto hashCode : hashCodes)
         {
-            if (item.hashCode == hashCode)
+            if (auto* item = findAndMarkAsUsed (hashCode))
             {
-                item.lastUseTime = Time::getApproximateMillisecondCounter();
-                return item.image;
+                ++stats.numHits;
+                return item->image;
             }
         }
 
+        ++stats.numMisses;
         return {};
-     }
+    }
 
     void addImageToCache (const Image& image, const int64 hashCode)
     {
         if (image.isValid())
         {
-            if (! isTimerRunning())
+            if (cacheTimeout > 0 && ! isTimerRunning())
                 startTimer (2000);
 
             const ScopedLock sl (lock);
-            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+
+            for (int i = images.size(); --i >= 0;)
+                if (images.getReference (i).hashCode == hashCode)
+                    removeItem (i);
+
+            const auto numBytes = getApproximateNumBytes (image);
+            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter(), numBytes, {} });
+            addBytes (numBytes);
+
+            releaseImagesOverLimit();
+        }
+    }
+
+    Image getMipLevelForScale (const Image& image, float scale)
+    {
+        if (! useMipLevels || scale > 0.5f || image.isNull())
+            return image;
+
+        const ScopedLock sl (lock);
+
+        auto* item = std::find_if (images.begin(), images.end(), [&] (const Item& i) { return i.image == image; });
+
+        if (item == images.end())
+            return image;
+
+        // Each level is half the size of the previous one, so pick the smallest one that
+        // still has at least as many pixels as the area it's going to be drawn into
+        auto level = image;
+
+        for (size_t i = 0;; ++i)
+        {
+            const auto width  = level.getWidth()  / 2;
+            const auto height = level.getHeight() / 2;
+
+            if (width < 1 || height < 1
+                 || (float) width  < (float) image.getWidth()  * scale
+                 || (float) height < (float) image.getHeight() * scale)
+                return level;
+
+            if (i == item->mipLevels.size())
+            {
+                auto next = level.rescaled (width, height, Graphics::highResamplingQuality);
+                item->mipLevels.push_back (next);
+                item->numBytes += getApproximateNumBytes (next);
+                addBytes (getApproximateNumBytes (next));
+            }
+
+            level = item->mipLevels[i];
         }
     }
 
@@ -88,8 +151,8 @@ struct ImageCache::Pimpl     : private Timer,
 
             if (item.image.getReferenceCount() <= 1)
             {
-                if (now > item.lastUseTime + cacheTimeout || now < item.lastUseTime - 1000)
-                    images.remove (i);
+                if (cacheTimeout > 0 && (now > item.lastUseTime + cacheTimeout || now < item.lastUseTime - 1000))
+                    removeItem (i);
             }
             else
             {
@@ -97,7 +160,7 @@ struct ImageCache::Pimpl     : private Timer,
             }
         }
 
-        if (images.isEmpty())
+        if (images.isEmpty() || cacheTimeout == 0)
             stopTimer();
     }
 
@@ -107,23 +170,249 @@ struct ImageCache::Pimpl     : private Timer,
 
         for (int i = images.size(); --i >= 0;)
             if (images.getReference (i).image.getReferenceCount() <= 1)
-                images.remove (i);
+                removeItem (i);
     }
 
-    struct Item
+    void releaseImagesOverLimit()
     {
-        Image image;
-        int64 hashCode;
-        uint32 lastUseTime;
-    };
+        const ScopedLock sl (lock);
+        releaseUnusedImagesUntilSizeIs (cacheSizeLimit);
+
+        // Only images that are used elsewhere are left, so the cache can't get back
+        // within its budget until their owners let go of some of them
+        if (totalBytes > cacheSizeLimit && ! isOverLimit)
+        {
+            isOverLimit = true;
+            MessageManager::callAsync ([] { ImageCache::Pimpl::callListeners (MemoryPressure::moderate); });
+        }
+    }
+
+    void releaseUnusedImagesUntilSizeIs (size_t maxNumBytes)
+    {
+        for (int i = 0; i < images.size() && totalBytes > maxNumBytes;)
+        {
+            if (images.getReference (i).image.getReferenceCount() <= 1)
+            {
+                removeItem (i);
+                ++stats.numEvictions;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    void handleMemoryPressure (MemoryPressure level)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            for (auto& item : images)
+                releaseMipLevels (item);
+
+            releaseUnusedImagesUntilSizeIs (level == MemoryPressure::critical ? 0 : cacheSizeLimit / 2);
+        }
+
+        callListeners (level);
+    }
+
+    static void callListeners (MemoryPressure level)
+    {
+        if (auto* instance = getInstanceWithoutCreating())
+            instance->listeners.call ([level] (Listener& l) { l.imageCacheMemoryPressure (level); });
+    }
+
+    void removeItem (int index)
+    {
+        totalBytes -= images.getReference (index).numBytes;
+        images.remove (index);
+
+        if (totalBytes <= cacheSizeLimit)
+            isOverLimit = false;
+    }
+
+    void releaseMipLevels (Item& item)
+    {
+        const auto mipBytes = item.numBytes - getApproximateNumBytes (item.image);
+        item.mipLevels.clear();
+        item.numBytes -= mipBytes;
+        totalBytes -= mipBytes;
+    }
+
+    void addBytes (size_t numBytes)
+    {
+        totalBytes += numBytes;
+        stats.peakNumBytes = jmax (stats.peakNumBytes, totalBytes);
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+
+        auto result = stats;
+        result.numBytes = totalBytes;
+        result.numImages = images.size();
+        return result;
+    }
+
+    static size_t getApproximateNumBytes (const Image& image)
+    {
+        const auto bytesPerPixel = [&]
+        {
+            switch (image.getFormat())
+            {
+                case Image::SingleChannel:  return 1;
+                case Image::RGB:            return 3;
+                case Image::ARGB:           return 4;
+                case Image::UnknownFormat:  break;
+            }
+
+            return 4;
+        }();
+
+        return (size_t) image.getWidth() * (size_t) image.getHeight() * (size_t) bytesPerPixel;
+    }
+
+    Item* findAndMarkAsUsed (int64 hashCode)
+    {
+        for (int i = images.size(); --i >= 0;)
+        {
+            if (images.getReference (i).hashCode == hashCode)
+            {
+                // Keep the items in order of use, so that the least recently used are evicted first
+                images.move (i, -1);
+
+                auto& item = images.getReference (images.size() - 1);
+                item.lastUseTime = Time::getApproximateMillisecondCounter();
+                return &item;
+            }
+        }
+
+        return nullptr;
+    }
 
     Array<Item> images;
     CriticalSection lock;
-    unsigned int cacheTimeout = 5000;
+    ListenerList<Listener, Array<Listener*, CriticalSection>> listeners;
+    Statistics stats;
+    size_t totalBytes = 0, cacheSizeLimit = 64 * 1024 * 1024;
+    unsigned int cacheTimeout = 0;
+    bool useMipLevels = false, isOverLimit = false;
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
+//==============================================================================
+// Decodes images for getFromFileAsync() and getFromMemoryAsync(), making sure that
+// each image is only decoded once when several requests for it arrive together.
+class ImageCacheLoader final : private DeletedAtShutdown
+{
+public:
+    ImageCacheLoader()
+        : pool (ThreadPoolOptions{}.withThreadName ("Image decoder")
+                                   .withNumberOfThreads (jlimit (1, 4, SystemStats::getNumCpus() - 1)))
+    {
+    }
+
+    ~ImageCacheLoader() override
+    {
+        pool.removeAllJobs (true, 10000);
+        clearSingletonInstance();
+    }
+
+    ImageCache::AsyncLoadResult load (int64 fullSizeHashCode,
+                                      std::function<std::unique_ptr<InputStream>()> createStream,
+                                      const ImageCache::AsyncLoadOptions& options)
+    {
+        const auto isFullSize = options.targetWidth <= 0 && options.targetHeight <= 0;
+        const auto hashCode = isFullSize ? fullSizeHashCode
+                                         : getHashCodeForSize (fullSizeHashCode, options.targetWidth, options.targetHeight);
+
+        // A full-sized image is just as good as a reduced-size one
+        if (auto cached = ImageCache::Pimpl::getInstance()->getFromHashCodes ({ fullSizeHashCode, hashCode }); cached.isValid())
+        {
+            if (options.callback != nullptr)
+                MessageManager::callAsync ([callback = options.callback, cached] { callback (cached); });
+
+            std::promise<Image> promise;
+            promise.set_value (cached);
+            return { cached, promise.get_future().share() };
+        }
+
+        const ScopedLock sl (lock);
+
+        if (auto existing = pendingLoads.find (hashCode); existing != pendingLoads.end())
+        {
+            if (options.callback != nullptr)
+                existing->second.callbacks.push_back (options.callback);
+
+            return { options.placeholder, existing->second.image };
+        }
+
+        auto promise = std::make_shared<std::promise<Image>>();
+        auto& pending = pendingLoads[hashCode];
+        pending.image = promise->get_future().share();
+
+        if (options.callback != nullptr)
+            pending.callbacks.push_back (options.callback);
+
+        pool.addJob ([this, hashCode, promise, createStream = std::move (createStream),
+                      targetWidth = jmax (0, options.targetWidth), targetHeight = jmax (0, options.targetHeight)]() mutable
+        {
+            Image image;
+
+            if (auto stream = createStream())
+                image = ImageFileFormat::loadFrom (*stream, targetWidth, targetHeight);
+
+            ImageCache::addImageToCache (image, hashCode);
+
+            std::vector<std::function<void (const Image&)>> callbacks;
+
+            {
+                const ScopedLock innerLock (lock);
+                auto pendingLoad = pendingLoads.find (hashCode);
+                callbacks = std::move (pendingLoad->second.callbacks);
+                pendingLoads.erase (pendingLoad);
+            }
+
+            promise->set_value (image);
+            promise.reset();
+
+            if (! callbacks.empty())
+            {
+                MessageManager::callAsync ([callbacks = std::move (callbacks), image]
+                {
+                    for (auto& callback : callbacks)
+                        callback (image);
+                });
+            }
+        });
+
+        return { options.placeholder, pending.image };
+    }
+
+    static int64 getHashCodeForSize (int64 hashCode, int width, int height) noexcept
+    {
+        return (hashCode * 101 + width) * 101 + height;
+    }
+
+    JUCE_DECLARE_SINGLETON_INLINE (ImageCacheLoader, false)
+
+private:
+    struct PendingLoad
+    {
+        std::shared_future<Image> image;
+        std::vector<std::function<void (const Image&)>> callbacks;
+    };
+
+    ThreadPool pool;
+    CriticalSection lock;
+    std::map<int64, PendingLoad> pendingLoads;
+
+    JUCE_DECLARE_NON_COPYABLE (ImageCacheLoader)
+};
+
 //==============================================================================
 Image ImageCache::getFromHashCode (const int64 hashCode)
 {
@@ -166,6 +455,127 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
     return image;
 }
 
+ImageCache::AsyncLoadResult ImageCache::getFromFileAsync (const File& file, const AsyncLoadOptions& options)
+{
+    // The cache must be created before the loader, so that it's deleted after it at shutdown
+    Pimpl::getInstance();
+
+    return ImageCacheLoader::getInstance()->load (file.hashCode64(), [file]() -> std::unique_ptr<InputStream>
+    {
+        auto stream = std::make_unique<FileInputStream> (file);
+
+        if (! stream->openedOk())
+            return {};
+
+        return std::make_unique<BufferedInputStream> (stream.release(), 8192, true);
+    }, options);
+}
+
+ImageCache::AsyncLoadResult ImageCache::getFromMemoryAsync (const void* imageData, int dataSize, const AsyncLoadOptions& options)
+{
+    Pimpl::getInstance();
+
+    return ImageCacheLoader::getInstance()->load ((int64) (pointer_sized_int) imageData, [imageData, dataSize]() -> std::unique_ptr<InputStream>
+    {
+        if (imageData == nullptr || dataSize <= 4)
+            return {};
+
+        return std::make_unique<MemoryInputStream> (imageData, (size_t) dataSize, false);
+    }, options);
+}
+
+ImageCache::AsyncLoadResult ImageCache::getFromFileAsync (const File& file)
+{
+    return getFromFileAsync (file, AsyncLoadOptions{});
+}
+
+ImageCache::AsyncLoadResult ImageCache::getFromMemoryAsync (const void* imageData, int dataSize)
+{
+    return getFromMemoryAsync (imageData, dataSize, AsyncLoadOptions{});
+}
+
+void ImageCache::setCacheSizeLimit (size_t maxNumBytes)
+{
+    auto* pimpl = Pimpl::getInstance();
+
+    {
+        const ScopedLock sl (pimpl->lock);
+        pimpl->cacheSizeLimit = maxNumBytes;
+    }
+
+    pimpl->releaseImagesOverLimit();
+}
+
+size_t ImageCache::getCacheSizeLimit()
+{
+    return Pimpl::getInstance()->cacheSizeLimit;
+}
+
+size_t ImageCache::getCacheSize()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+    {
+        const ScopedLock sl (pimpl->lock);
+        return pimpl->totalBytes;
+    }
+
+    return 0;
+}
+
+ImageCache::Statistics ImageCache::getStatistics()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->getStatistics();
+
+    return {};
+}
+
+void ImageCache::resetStatistics()
+{
+    auto* pimpl = Pimpl::getInstance();
+
+    const ScopedLock sl (pimpl->lock);
+    pimpl->stats = {};
+    pimpl->stats.peakNumBytes = pimpl->totalBytes;
+}
+
+void ImageCache::handleMemoryPressure (MemoryPressure level)
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        pimpl->handleMemoryPressure (level);
+}
+
+void ImageCache::addListener (Listener* listener)
+{
+    Pimpl::getInstance()->listeners.add (listener);
+}
+
+void ImageCache::removeListener (Listener* listener)
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        pimpl->listeners.remove (listener);
+}
+
+void ImageCache::setUseMipLevels (bool shouldUseMipLevels)
+{
+    auto* pimpl = Pimpl::getInstance();
+
+    const ScopedLock sl (pimpl->lock);
+    pimpl->useMipLevels = shouldUseMipLevels;
+
+    if (! shouldUseMipLevels)
+        for (auto& item : pimpl->images)
+            pimpl->releaseMipLevels (item);
+}
+
+Image ImageCache::getMipLevelForScale (const Image& image, float scale)
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->getMipLevelForScale (image, scale);
+
+    return image;
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
@@ -177,4 +587,207 @@ void ImageCache::releaseUnusedImages()
     Pimpl::getInstance()->releaseUnusedImages();
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests final : public UnitTest
+{
+public:
+    ImageCacheTests()
+        : UnitTest ("ImageCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+
+        beginTest ("Unused images are released least recently used first when over the size limit");
+        {
+            // Anything left in the cache now is in use, so it can't be released
+            ImageCache::releaseUnusedImages();
+            const auto oldLimit = ImageCache::getCacheSizeLimit();
+            const auto sizeInUse = ImageCache::getCacheSize();
+            ImageCache::setCacheSizeLimit (sizeInUse + 3 * 100 * 100 * 4);
+
+            for (int i = 0; i < 3; ++i)
+                ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true, SoftwareImageType()), firstHashCode + i);
+
+            // Using the first image makes the second one the least recently used
+            expect (ImageCache::getFromHashCode (firstHashCode).isValid());
+
+            ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true, SoftwareImageType()), firstHashCode + 3);
+
+            expect (ImageCache::getFromHashCode (firstHashCode).isValid());
+            expect (ImageCache::getFromHashCode (firstHashCode + 1).isNull());
+            expect (ImageCache::getFromHashCode (firstHashCode + 2).isValid());
+            expect (ImageCache::getFromHashCode (firstHashCode + 3).isValid());
+
+            // Images that are in use elsewhere can't be released
+            auto inUse = ImageCache::getFromHashCode (firstHashCode + 2);
+            ImageCache::setCacheSizeLimit (0);
+
+            expect (ImageCache::getFromHashCode (firstHashCode).isNull());
+            expectEquals (ImageCache::getCacheSize(), sizeInUse + 100 * 100 * 4);
+            expect (ImageCache::getFromHashCode (firstHashCode + 2) == inUse);
+
+            ImageCache::setCacheSizeLimit (oldLimit);
+        }
+
+        // The cache identifies in-memory images by their address, so these need to stay
+        // allocated until the end of the test
+        const auto jpegData = createJPEGData (640, 480);
+        const auto otherJpegData = createJPEGData (640, 480);
+
+        beginTest ("Async loading decodes images on a background thread and caches them");
+        {
+
+            auto result = ImageCache::getFromMemoryAsync (jpegData.getData(), (int) jpegData.getSize());
+            const auto image = result.image.get();
+
+            expect (image.isValid());
+            expectEquals (image.getWidth(), 640);
+            expectEquals (image.getHeight(), 480);
+
+            auto cached = ImageCache::getFromMemoryAsync (jpegData.getData(), (int) jpegData.getSize());
+            expect (cached.placeholder == image);
+            expect (cached.image.get() == image);
+        }
+
+        beginTest ("Async loading with a target size decodes a reduced-size JPEG");
+        {
+            const auto placeholder = Image (Image::ARGB, 1, 1, true);
+            const auto options = ImageCache::AsyncLoadOptions{}.withTargetSize (100, 100)
+                                                               .withPlaceholder (placeholder);
+
+            auto first  = ImageCache::getFromMemoryAsync (otherJpegData.getData(), (int) otherJpegData.getSize(), options);
+            auto second = ImageCache::getFromMemoryAsync (otherJpegData.getData(), (int) otherJpegData.getSize(), options);
+
+            expect (first.placeholder == placeholder);
+
+            const auto image = first.image.get();
+            expect (second.image.get() == image);
+
+            // 1/4 is the smallest scale that still covers the target height
+            expectEquals (image.getWidth(), 160);
+            expectEquals (image.getHeight(), 120);
+
+            // The full-sized image isn't cached, so it still needs loading separately
+            expect (ImageCache::getFromMemory (otherJpegData.getData(), (int) otherJpegData.getSize()).getWidth() == 640);
+        }
+
+        beginTest ("Async loading of invalid data gives an invalid image");
+        {
+            const char junk[] = "not an image file";
+            auto result = ImageCache::getFromMemoryAsync (junk, (int) sizeof (junk));
+            expect (result.image.get().isNull());
+        }
+
+        beginTest ("Statistics count hits, misses and evictions");
+        {
+            ImageCache::releaseUnusedImages();
+            ImageCache::resetStatistics();
+
+            expect (ImageCache::getFromHashCode (firstHashCode).isNull());
+            ImageCache::addImageToCache (Image (Image::ARGB, 10, 10, true, SoftwareImageType()), firstHashCode);
+            expect (ImageCache::getFromHashCode (firstHashCode).isValid());
+
+            auto stats = ImageCache::getStatistics();
+            expectEquals (stats.numHits, (int64) 1);
+            expectEquals (stats.numMisses, (int64) 1);
+            expectEquals (stats.numEvictions, (int64) 0);
+            expectEquals (stats.numBytes, ImageCache::getCacheSize());
+            expect (stats.peakNumBytes >= stats.numBytes);
+
+            const auto oldLimit = ImageCache::getCacheSizeLimit();
+            ImageCache::setCacheSizeLimit (0);
+            ImageCache::setCacheSizeLimit (oldLimit);
+
+            expectEquals (ImageCache::getStatistics().numEvictions, (int64) 1);
+        }
+
+        beginTest ("Memory pressure releases unused images and calls the listeners");
+        {
+            struct TestListener final : public ImageCache::Listener
+            {
+                void imageCacheMemoryPressure (ImageCache::MemoryPressure level) override  { levels.push_back (level); }
+
+                std::vector<ImageCache::MemoryPressure> levels;
+            };
+
+            ImageCache::releaseUnusedImages();
+            const auto sizeInUse = ImageCache::getCacheSize();
+
+            TestListener listener;
+            ImageCache::addListener (&listener);
+
+            for (int i = 0; i < 4; ++i)
+                ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true, SoftwareImageType()), firstHashCode + i);
+
+            const auto inUse = ImageCache::getFromHashCode (firstHashCode);
+
+            ImageCache::handleMemoryPressure (ImageCache::MemoryPressure::critical);
+
+            expect (listener.levels == std::vector<ImageCache::MemoryPressure> { ImageCache::MemoryPressure::critical });
+            expectEquals (ImageCache::getCacheSize(), sizeInUse + 100 * 100 * 4);
+            expect (ImageCache::getFromHashCode (firstHashCode) == inUse);
+            expect (ImageCache::getFromHashCode (firstHashCode + 1).isNull());
+
+            ImageCache::removeListener (&listener);
+        }
+
+        beginTest ("Mip levels are created on demand and released with the cache");
+        {
+            ImageCache::releaseUnusedImages();
+            ImageCache::setUseMipLevels (true);
+
+            ImageCache::addImageToCache (Image (Image::ARGB, 256, 256, true, SoftwareImageType()), firstHashCode);
+            const auto image = ImageCache::getFromHashCode (firstHashCode);
+            const auto sizeBefore = ImageCache::getCacheSize();
+
+            expect (ImageCache::getMipLevelForScale (image, 0.75f) == image);
+
+            const auto level1 = ImageCache::getMipLevelForScale (image, 0.3f);
+            expectEquals (level1.getWidth(), 128);
+
+            const auto level2 = ImageCache::getMipLevelForScale (image, 0.2f);
+            expectEquals (level2.getWidth(), 64);
+            expect (ImageCache::getMipLevelForScale (image, 0.3f) == level1);
+            expectEquals (ImageCache::getCacheSize(), sizeBefore + (128 * 128 + 64 * 64) * 4);
+
+            const auto uncached = Image (Image::ARGB, 256, 256, true, SoftwareImageType());
+            expect (ImageCache::getMipLevelForScale (uncached, 0.2f) == uncached);
+
+            ImageCache::handleMemoryPressure (ImageCache::MemoryPressure::moderate);
+            expectEquals (ImageCache::getCacheSize(), sizeBefore);
+
+            ImageCache::setUseMipLevels (false);
+            expect (ImageCache::getMipLevelForScale (image, 0.2f) == image);
+        }
+
+        ImageCache::releaseUnusedImages();
+    }
+
+private:
+    static constexpr int64 firstHashCode = 0x1a2b3c4d5e6f;
+
+    static MemoryBlock createJPEGData (int width, int height)
+    {
+        Image image (Image::RGB, width, height, true, SoftwareImageType());
+
+        {
+            Graphics g (image);
+            g.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::blue, (float) width, (float) height, false));
+            g.fillAll();
+        }
+
+        MemoryOutputStream out;
+        JPEGImageFormat().writeImageToStream (image, out);
+        return out.getMemoryBlock();
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
+
 } // namespace juce
@@ -44,9 +44,14 @@ namespace juce
     multiple copies into memory.
 
     Another advantage is that after images are released, they will be kept in
-    memory for a few seconds before it is actually deleted, so if you're repeatedly
+    memory until the cache grows beyond its size limit, so if you're repeatedly
     loading/deleting the same image, it'll reduce the chances of having to reload it
-    each time.
+    each time. When the limit is exceeded, the images that were least recently used
+    are released first.
+
+    Images can also be decoded on a pool of background threads with getFromFileAsync()
+    and getFromMemoryAsync(), so that loading a lot of large images doesn't block the
+    message thread.
 
     @see Image, ImageFileFormat
 
@@ -89,6 +94,85 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    //==============================================================================
+    /** Options for loading an image asynchronously.
+        @see getFromFileAsync, getFromMemoryAsync
+    */
+    struct AsyncLoadOptions
+    {
+        /** The size at which the image will be drawn.
+
+            If this is smaller than the image, formats that support it (such as JPEG) will
+            decode a reduced-size version that still covers this size, which is much quicker
+            than decoding the whole image. The default of 0 x 0 loads the full-sized image.
+        */
+        [[nodiscard]] AsyncLoadOptions withTargetSize (int newTargetWidth, int newTargetHeight) const
+        {
+            return withMember (withMember (*this, &AsyncLoadOptions::targetWidth, newTargetWidth),
+                               &AsyncLoadOptions::targetHeight, newTargetHeight);
+        }
+
+        /** An image to return as the placeholder while the image is loading. */
+        [[nodiscard]] AsyncLoadOptions withPlaceholder (const Image& newPlaceholder) const
+        {
+            return withMember (*this, &AsyncLoadOptions::placeholder, newPlaceholder);
+        }
+
+        /** A function to call on the message thread when the image has been loaded.
+            The image passed to the callback will be invalid if it couldn't be loaded.
+        */
+        [[nodiscard]] AsyncLoadOptions withCallback (std::function<void (const Image&)> newCallback) const
+        {
+            return withMember (*this, &AsyncLoadOptions::callback, std::move (newCallback));
+        }
+
+        int targetWidth = 0, targetHeight = 0;
+        Image placeholder;
+        std::function<void (const Image&)> callback;
+    };
+
+    /** The result of starting an asynchronous load.
+        @see getFromFileAsync, getFromMemoryAsync
+    */
+    struct AsyncLoadResult
+    {
+        /** If the image was already in the cache, this is the cached image. Otherwise,
+            it's the placeholder from the AsyncLoadOptions.
+        */
+        Image placeholder;
+
+        /** This becomes ready when the image has been decoded and added to the cache.
+            The image will be invalid if it couldn't be loaded.
+        */
+        std::shared_future<Image> image;
+    };
+
+    /** Starts loading an image from a file on a background thread, unless it's already cached.
+
+        Requests for an image that's already being loaded will share the same decoding job.
+        When a target size is given, the reduced-size image is cached separately from the
+        full-sized one, although a cached full-sized image will be used to satisfy it.
+
+        @see getFromFile, AsyncLoadOptions
+    */
+    static AsyncLoadResult getFromFileAsync (const File& file, const AsyncLoadOptions& options);
+
+    /** Starts loading an image from a file on a background thread, using the default options. */
+    static AsyncLoadResult getFromFileAsync (const File& file);
+
+    /** Starts loading an image from an in-memory image file on a background thread, unless
+        it's already cached.
+
+        The data is not copied, so it must remain valid until the image has been loaded.
+        This is intended for data that is never freed, such as BinaryData resources.
+
+        @see getFromMemory, AsyncLoadOptions
+    */
+    static AsyncLoadResult getFromMemoryAsync (const void* imageData, int dataSize, const AsyncLoadOptions& options);
+
+    /** Starts loading an image from an in-memory image file on a background thread, using the default options. */
+    static AsyncLoadResult getFromMemoryAsync (const void* imageData, int dataSize);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -112,8 +196,115 @@ public:
     */
     static void addImageToCache (const Image& image, int64 hashCode);
 
-    /** Changes the amount of time before an unused image will be removed from the cache.
-        By default this is about 5 seconds.
+    /** Sets the maximum number of bytes of image data that the cache will hold on to.
+
+        Images that are still being used elsewhere can't be released, so they're allowed to
+        take the cache beyond this limit, but unused images will be released, least recently
+        used first, until it's back within the limit. The default is 64 MB.
+    */
+    static void setCacheSizeLimit (size_t maxNumBytes);
+
+    /** Returns the limit set by setCacheSizeLimit(). */
+    static size_t getCacheSizeLimit();
+
+    /** Returns the approximate number of bytes of image data that the cache is holding on to,
+        including images that are still in use elsewhere.
+    */
+    static size_t getCacheSize();
+
+    //==============================================================================
+    /** Counters describing how the cache has been used, for tuning its size limit.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        int64 numHits = 0;          /**< The number of lookups that found an image in the cache. */
+        int64 numMisses = 0;        /**< The number of lookups that didn't find an image. */
+        int64 numEvictions = 0;     /**< The number of images released to keep within the size limit. */
+        size_t numBytes = 0;        /**< The current size of the cache, as returned by getCacheSize(). */
+        size_t peakNumBytes = 0;    /**< The largest size the cache has reached. */
+        int numImages = 0;          /**< The number of images currently in the cache. */
+    };
+
+    /** Returns the cache's current statistics.
+        The counters accumulate from when the cache is created, or resetStatistics() was last called.
+    */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counters, and the peak size. */
+    static void resetStatistics();
+
+    //==============================================================================
+    /** How urgently memory needs to be released.
+        @see handleMemoryPressure
+    */
+    enum class MemoryPressure
+    {
+        moderate,   /**< Unused images are released until the cache is within half its size limit. */
+        critical    /**< All unused images are released. */
+    };
+
+    /** Releases memory because the system, or the host, is running short of it.
+
+        Any mip levels are released, along with unused images according to the level of
+        pressure, and then the listeners are called so that they can drop any images they
+        don't need. On iOS this is called automatically when the app receives a memory warning.
+
+        @see Listener
+    */
+    static void handleMemoryPressure (MemoryPressure level);
+
+    /** Receives callbacks when the cache needs memory to be released. */
+    struct JUCE_API  Listener
+    {
+        virtual ~Listener() = default;
+
+        /** Called after handleMemoryPressure() has released what it can, and also on the message
+            thread when images that are still in use take the cache over its size limit.
+
+            Releasing images that aren't needed lets the cache release them too. This may be
+            called on whichever thread called handleMemoryPressure().
+        */
+        virtual void imageCacheMemoryPressure (MemoryPressure level) = 0;
+    };
+
+    /** Registers a listener to be told when the cache needs memory to be released. */
+    static void addListener (Listener* listener);
+
+    /** Removes a listener that was added with addListener(). */
+    static void removeListener (Listener* listener);
+
+    //==============================================================================
+    /** Enables mip levels for images in the cache.
+
+        When enabled, getMipLevelForScale() creates and caches versions of cached images
+        downsampled by powers of two, which are quicker to draw at small scales and alias
+        less than the full-sized image. They're counted in the cache's size, and released
+        along with their image, or under memory pressure. This is disabled by default.
+
+        @see getMipLevelForScale
+    */
+    static void setUseMipLevels (bool shouldUseMipLevels);
+
+    /** Returns the best version of a cached image to draw at the given scale.
+
+        If mip levels are enabled, and the scale is 0.5 or less, this returns the smallest
+        downsampled version of the image that's still at least as large as the image scaled
+        by this amount, creating it if needed. Otherwise, or if the image didn't come from
+        the cache, the image itself is returned.
+
+        @see setUseMipLevels
+    */
+    static Image getMipLevelForScale (const Image& image, float scale);
+
+    //==============================================================================
+    /** Makes images that aren't used elsewhere get removed from the cache after a timeout,
+        even when the cache is within its size limit.
+
+        By default there's no timeout, and unused images are only released when the cache
+        exceeds its size limit. A timeout of 0 restores this behaviour.
+
+        @see setCacheSizeLimit
     */
     static void setCacheTimeout (int millisecs);
 
@@ -126,6 +317,7 @@ private:
     //==============================================================================
     struct Pimpl;
     friend struct Pimpl;
+    friend class ImageCacheLoader;
 
     ImageCache();
     ~ImageCache();
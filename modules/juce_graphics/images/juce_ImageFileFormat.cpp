@@ -84,6 +84,11 @@ ImageFileFormat* ImageFileFormat::findImageFormatForFileExtension (const File& f
     return nullptr;
 }
 
+Image ImageFileFormat::decodeImageForSize (InputStream& input, int, int)
+{
+    return decodeImage (input);
+}
+
 //==============================================================================
 Image ImageFileFormat::loadFrom (InputStream& input)
 {
@@ -93,6 +98,14 @@ Image ImageFileFormat::loadFrom (InputStream& input)
     return Image();
 }
 
+Image ImageFileFormat::loadFrom (InputStream& input, int targetWidth, int targetHeight)
+{
+    if (ImageFileFormat* format = findImageFormatForStream (input))
+        return format->decodeImageForSize (input, targetWidth, targetHeight);
+
+    return Image();
+}
+
 Image ImageFileFormat::loadFrom (const File& file)
 {
     FileInputStream stream (file);
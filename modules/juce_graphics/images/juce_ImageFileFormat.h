@@ -93,6 +93,23 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    /** Tries to decode an image from the given stream, at a reduced size if that's quicker.
+
+        Formats that can decode a smaller version of an image directly, such as JPEG, will
+        return the smallest image that still covers the target size, keeping the original
+        aspect ratio. This can be much faster than decoding a large image and rescaling it.
+        Other formats return the full-sized image.
+
+        The default implementation just calls decodeImage().
+
+        @param input            the stream to read the data from
+        @param targetWidth      the width at which the image will be drawn, or 0 for the full size
+        @param targetHeight     the height at which the image will be drawn, or 0 for the full size
+        @returns                the image that was decoded, or an invalid image if it fails.
+        @see decodeImage
+    */
+    virtual Image decodeImageForSize (InputStream& input, int targetWidth, int targetHeight);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -146,6 +163,16 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Tries to load an image from a stream, at a reduced size if the format supports it.
+
+        This will use the findImageFormatForStream() method to locate a suitable
+        codec, and use its decodeImageForSize() method to load the image.
+
+        @returns        the image that was decoded, or an invalid image if it fails.
+        @see decodeImageForSize
+    */
+    static Image loadFrom (InputStream& input, int targetWidth, int targetHeight);
 };
 
 //==============================================================================
@@ -200,6 +227,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageForSize (InputStream&, int targetWidth, int targetHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
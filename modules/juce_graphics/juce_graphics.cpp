@@ -51,6 +51,14 @@
 
 #include "fonts/juce_FunctionPointerDestructor.h"
 
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_GRAPHICS_USE_SSE2_INTRINSICS 1
+ #include <immintrin.h>
+#elif JUCE_ARM && (defined (__aarch64__) || defined (_M_ARM64))
+ #define JUCE_GRAPHICS_USE_NEON_INTRINSICS 1
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 #if JUCE_MAC
  #import <QuartzCore/QuartzCore.h>
@@ -182,8 +190,10 @@ extern "C"
 #include "geometry/juce_PathIterator.cpp"
 #include "geometry/juce_PathStrokeType.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
+#include "native/juce_PixelSpanFunctions.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
@@ -128,12 +128,12 @@ namespace juce
 #include "geometry/juce_PathIterator.h"
 #include "geometry/juce_PathStrokeType.h"
 #include "placement/juce_RectanglePlacement.h"
-#include "images/juce_ImageCache.h"
 #include "images/juce_ImageConvolutionKernel.h"
 #include "images/juce_ImageFileFormat.h"
 #include "fonts/juce_GlyphArrangementOptions.h"
 #include "contexts/juce_GraphicsContext.h"
 #include "images/juce_Image.h"
+#include "images/juce_ImageCache.h"
 #include "colour/juce_FillType.h"
 #include "fonts/juce_FontFeatures.h"
 #include "fonts/juce_Typeface.h"
@@ -149,8 +149,10 @@ namespace juce
 #include "contexts/juce_LowLevelGraphicsContext.h"
 #include "images/juce_ScaledImage.h"
 #include "detail/juce_FontRendering.h"
+#include "native/juce_PixelSpanFunctions.h"
 #include "native/juce_RenderingHelpers.h"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.h"
 #include "effects/juce_ImageEffectFilter.h"
 #include "effects/juce_DropShadowEffect.h"
 #include "effects/juce_GlowEffect.h"
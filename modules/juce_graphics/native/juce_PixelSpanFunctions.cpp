@@ -0,0 +1,904 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::RenderingHelpers
+{
+
+#if JUCE_GRAPHICS_USE_SSE2_INTRINSICS && (defined (__GNUC__) || defined (__clang__))
+ #define JUCE_GRAPHICS_AVX2_FUNCTION __attribute__ ((target ("avx2")))
+#else
+ #define JUCE_GRAPHICS_AVX2_FUNCTION
+#endif
+
+//==============================================================================
+namespace PortableSpanFunctions
+{
+    static void blendColour (uint8* dest, PixelARGB colour, int numPixels, bool destHasAlpha) noexcept
+    {
+        if (destHasAlpha)
+        {
+            for (auto* d = reinterpret_cast<PixelARGB*> (dest); --numPixels >= 0; ++d)
+                d->blend (colour);
+        }
+        else
+        {
+            for (; --numPixels >= 0; dest += 4)
+                reinterpret_cast<PixelRGB*> (dest)->blend (colour);
+        }
+    }
+
+    // Multiplying the colour's alpha by m and blending it is the same as blending it with an
+    // extra alpha of m + 1, which is what this uses.
+    template <class DestPixelType>
+    static void blendColourWithMask (uint8* dest, PixelARGB colour, const uint8* mask, int numPixels) noexcept
+    {
+        for (; --numPixels >= 0; dest += 4)
+            reinterpret_cast<DestPixelType*> (dest)->blend (colour, (uint32) *mask++ + 1);
+    }
+
+    static void blendColourWithMask (uint8* dest, PixelARGB colour, const uint8* mask, int numPixels, bool destHasAlpha) noexcept
+    {
+        if (destHasAlpha)
+            blendColourWithMask<PixelARGB> (dest, colour, mask, numPixels);
+        else
+            blendColourWithMask<PixelRGB> (dest, colour, mask, numPixels);
+    }
+
+    template <class DestPixelType>
+    static void blendPixels (uint8* dest, const PixelARGB* source, int numPixels, uint32 extraAlpha) noexcept
+    {
+        if (extraAlpha >= 256)
+        {
+            for (; --numPixels >= 0; dest += 4)
+                reinterpret_cast<DestPixelType*> (dest)->blend (*source++);
+        }
+        else
+        {
+            for (; --numPixels >= 0; dest += 4)
+                reinterpret_cast<DestPixelType*> (dest)->blend (*source++, extraAlpha);
+        }
+    }
+
+    static void blendPixels (uint8* dest, const PixelARGB* source, int numPixels, uint32 extraAlpha, bool destHasAlpha) noexcept
+    {
+        if (destHasAlpha)
+            blendPixels<PixelARGB> (dest, source, numPixels, extraAlpha);
+        else
+            blendPixels<PixelRGB> (dest, source, numPixels, extraAlpha);
+    }
+
+    static void generateLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                        int x, int scale, int start, int numPixels) noexcept
+    {
+        while (--numPixels >= 0)
+            *dest++ = lookupTable[jlimit (0, numEntries, (x++ * scale - start) >> 12)];
+    }
+
+    static void generateRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                        double centreX, double dySquared, double maxDistSquared,
+                                        double invScale, int x, int numPixels) noexcept
+    {
+        while (--numPixels >= 0)
+        {
+            auto distSquared = x++ - centreX;
+            distSquared *= distSquared;
+            distSquared += dySquared;
+
+            *dest++ = lookupTable[distSquared >= maxDistSquared ? numEntries
+                                                                : roundToInt (std::sqrt (distSquared) * invScale)];
+        }
+    }
+
+    static void interpolatePixel (PixelARGB* dest, const PixelSpanFunctions::BilinearSample& sample, int lineStride) noexcept
+    {
+        const auto* src = sample.source;
+        const auto subPixelX = (uint32) sample.subPixelX;
+        const auto subPixelY = (uint32) sample.subPixelY;
+
+        uint32 c[4] = { 256 * 128, 256 * 128, 256 * 128, 256 * 128 };
+
+        const uint32 weights[] = { (256 - subPixelX) * (256 - subPixelY),
+                                   subPixelX * (256 - subPixelY),
+                                   subPixelX * subPixelY,
+                                   (256 - subPixelX) * subPixelY };
+
+        const uint8* const pixels[] = { src, src + 4, src + lineStride + 4, src + lineStride };
+
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                c[j] += weights[i] * pixels[i][j];
+
+        dest->setARGB ((uint8) (c[PixelARGB::indexA] >> 16),
+                       (uint8) (c[PixelARGB::indexR] >> 16),
+                       (uint8) (c[PixelARGB::indexG] >> 16),
+                       (uint8) (c[PixelARGB::indexB] >> 16));
+    }
+
+    static void interpolatePixels (PixelARGB* dest, const PixelSpanFunctions::BilinearSample* samples,
+                                   int numSamples, int lineStride) noexcept
+    {
+        while (--numSamples >= 0)
+            interpolatePixel (dest++, *samples++, lineStride);
+    }
+
+    static constexpr PixelSpanFunctions functions { blendColour, blendColourWithMask, blendPixels, generateLinearGradient,
+                                                    generateRadialGradient, interpolatePixels, "Portable" };
+}
+
+//==============================================================================
+#if JUCE_GRAPHICS_USE_SSE2_INTRINSICS
+namespace SSE2SpanFunctions
+{
+    // Each of these blends four pixels in the same way as PixelARGB::blend(), with
+    // 16-bit lanes for the multiplications and a saturating add for the clamping.
+    static forcedinline __m128i scalePixels (__m128i pixels, __m128i extraAlpha) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto lo = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (pixels, zero), extraAlpha), 8);
+        const auto hi = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (pixels, zero), extraAlpha), 8);
+        return _mm_packus_epi16 (lo, hi);
+    }
+
+    static forcedinline __m128i getInverseAlphas (__m128i pixels16) noexcept
+    {
+        constexpr auto alphaShuffle = _MM_SHUFFLE (PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA);
+        return _mm_sub_epi16 (_mm_set1_epi16 (256), _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (pixels16, alphaShuffle), alphaShuffle));
+    }
+
+    static forcedinline __m128i blend (__m128i dest, __m128i source, __m128i inverseAlphaLo, __m128i inverseAlphaHi, __m128i keepMask) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto lo = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (dest, zero), inverseAlphaLo), 8);
+        const auto hi = _mm_srli_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (dest, zero), inverseAlphaHi), 8);
+        const auto result = _mm_adds_epu8 (_mm_packus_epi16 (lo, hi), source);
+        return _mm_or_si128 (_mm_and_si128 (keepMask, result), _mm_andnot_si128 (keepMask, dest));
+    }
+
+    static forcedinline __m128i getKeepMask (bool destHasAlpha) noexcept
+    {
+        return _mm_set1_epi32 (destHasAlpha ? -1 : (int) ~(0xffu << (PixelARGB::indexA * 8)));
+    }
+
+    static void blendColour (uint8* dest, PixelARGB colour, int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto source = _mm_set1_epi32 ((int) colour.getNativeARGB());
+        const auto inverseAlpha = _mm_set1_epi16 ((short) (256 - colour.getAlpha()));
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16)
+        {
+            const auto d = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (dest));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), blend (d, source, inverseAlpha, inverseAlpha, keepMask));
+        }
+
+        PortableSpanFunctions::blendColour (dest, colour, numPixels, destHasAlpha);
+    }
+
+    static void blendColourWithMask (uint8* dest, PixelARGB colour, const uint8* mask, int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto colour16 = _mm_unpacklo_epi8 (_mm_set1_epi32 ((int) colour.getNativeARGB()), zero);
+        const auto one = _mm_set1_epi16 (1);
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16, mask += 4)
+        {
+            int32 maskValues;
+            memcpy (&maskValues, mask, sizeof (maskValues));
+
+            if (maskValues == 0)
+                continue;
+
+            // Spreads each pixel's mask value + 1 across the four 16-bit lanes of that pixel
+            const auto m = _mm_add_epi16 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (maskValues), zero), one);
+            const auto pairs = _mm_unpacklo_epi16 (m, m);
+            const auto sourceLo = _mm_srli_epi16 (_mm_mullo_epi16 (colour16, _mm_unpacklo_epi32 (pairs, pairs)), 8);
+            const auto sourceHi = _mm_srli_epi16 (_mm_mullo_epi16 (colour16, _mm_unpackhi_epi32 (pairs, pairs)), 8);
+
+            const auto d = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (dest));
+            const auto result = blend (d, _mm_packus_epi16 (sourceLo, sourceHi),
+                                       getInverseAlphas (sourceLo), getInverseAlphas (sourceHi), keepMask);
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), result);
+        }
+
+        PortableSpanFunctions::blendColourWithMask (dest, colour, mask, numPixels, destHasAlpha);
+    }
+
+    static void blendPixels (uint8* dest, const PixelARGB* source, int numPixels, uint32 extraAlpha, bool destHasAlpha) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto extra = _mm_set1_epi16 ((short) extraAlpha);
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16, source += 4)
+        {
+            auto s = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source));
+
+            if (extraAlpha < 256)
+                s = scalePixels (s, extra);
+
+            const auto d = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (dest));
+            const auto result = blend (d, s, getInverseAlphas (_mm_unpacklo_epi8 (s, zero)),
+                                             getInverseAlphas (_mm_unpackhi_epi8 (s, zero)), keepMask);
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), result);
+        }
+
+        PortableSpanFunctions::blendPixels (dest, source, numPixels, extraAlpha, destHasAlpha);
+    }
+
+    static void generateLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                        int x, int scale, int start, int numPixels) noexcept
+    {
+        // The positions are stepped with wrapping integer arithmetic, matching the portable version
+        const auto firstPos = (uint32) x * (uint32) scale - (uint32) start;
+        auto positions = _mm_setr_epi32 ((int) firstPos, (int) (firstPos + (uint32) scale),
+                                    (int) (firstPos + (uint32) scale * 2), (int) (firstPos + (uint32) scale * 3));
+        const auto step = _mm_set1_epi32 ((int) ((uint32) scale * 4));
+        const auto maxIndex = _mm_set1_epi32 (numEntries);
+        const auto zero = _mm_setzero_si128();
+
+        for (; numPixels >= 4; numPixels -= 4, x += 4, dest += 4)
+        {
+            auto index = _mm_srai_epi32 (positions, 12);
+            index = _mm_and_si128 (index, _mm_cmpgt_epi32 (index, zero));
+
+            const auto tooHigh = _mm_cmpgt_epi32 (index, maxIndex);
+            index = _mm_or_si128 (_mm_and_si128 (tooHigh, maxIndex), _mm_andnot_si128 (tooHigh, index));
+
+            alignas (16) int32 indexes[4];
+            _mm_store_si128 (reinterpret_cast<__m128i*> (indexes), index);
+
+            dest[0] = lookupTable[indexes[0]];
+            dest[1] = lookupTable[indexes[1]];
+            dest[2] = lookupTable[indexes[2]];
+            dest[3] = lookupTable[indexes[3]];
+
+            positions = _mm_add_epi32 (positions, step);
+        }
+
+        PortableSpanFunctions::generateLinearGradient (dest, lookupTable, numEntries, x, scale, start, numPixels);
+    }
+
+    static void generateRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                        double centreX, double dySquared, double maxDistSquared,
+                                        double invScale, int x, int numPixels) noexcept
+    {
+        const auto centre = _mm_set1_pd (centreX);
+        const auto dy2 = _mm_set1_pd (dySquared);
+        const auto maxDist = _mm_set1_pd (maxDistSquared);
+        const auto scale = _mm_set1_pd (invScale);
+        const auto roundingOffset = _mm_set1_pd (6755399441055744.0); // the same trick as roundToInt()
+
+        for (; numPixels >= 2; numPixels -= 2, x += 2, dest += 2)
+        {
+            auto dist = _mm_sub_pd (_mm_cvtepi32_pd (_mm_setr_epi32 (x, x + 1, 0, 0)), centre);
+            dist = _mm_add_pd (_mm_mul_pd (dist, dist), dy2);
+
+            const auto outside = _mm_movemask_pd (_mm_cmpge_pd (dist, maxDist));
+            const auto rounded = _mm_castpd_si128 (_mm_add_pd (_mm_mul_pd (_mm_sqrt_pd (dist), scale), roundingOffset));
+
+            alignas (16) int32 lanes[4];
+            _mm_store_si128 (reinterpret_cast<__m128i*> (lanes), rounded);
+
+            dest[0] = lookupTable[(outside & 1) != 0 ? numEntries : lanes[0]];
+            dest[1] = lookupTable[(outside & 2) != 0 ? numEntries : lanes[2]];
+        }
+
+        PortableSpanFunctions::generateRadialGradient (dest, lookupTable, numEntries, centreX, dySquared,
+                                                       maxDistSquared, invScale, x, numPixels);
+    }
+
+    static void interpolatePixels (PixelARGB* dest, const PixelSpanFunctions::BilinearSample* samples,
+                                   int numSamples, int lineStride) noexcept
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto rounding = _mm_set1_ps (256.0f * 128.0f);
+
+        for (; --numSamples >= 0; ++samples, ++dest)
+        {
+            const auto* src = samples->source;
+            const auto subPixelX = samples->subPixelX;
+            const auto subPixelY = samples->subPixelY;
+
+            // Each row is interpolated horizontally with pairs of 16-bit multiplies, then the rows
+            // are combined using floats, which hold every intermediate value exactly.
+            auto top    = _mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src)), zero);
+            auto bottom = _mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src + lineStride)), zero);
+            top    = _mm_unpacklo_epi16 (top,    _mm_srli_si128 (top, 8));
+            bottom = _mm_unpacklo_epi16 (bottom, _mm_srli_si128 (bottom, 8));
+
+            const auto weightsX = _mm_set1_epi32 ((subPixelX << 16) | (256 - subPixelX));
+            const auto topRow    = _mm_cvtepi32_ps (_mm_madd_epi16 (top, weightsX));
+            const auto bottomRow = _mm_cvtepi32_ps (_mm_madd_epi16 (bottom, weightsX));
+
+            const auto sum = _mm_add_ps (_mm_add_ps (_mm_mul_ps (topRow, _mm_set1_ps ((float) (256 - subPixelY))),
+                                                     _mm_mul_ps (bottomRow, _mm_set1_ps ((float) subPixelY))),
+                                         rounding);
+
+            auto result = _mm_srli_epi32 (_mm_cvttps_epi32 (sum), 16);
+            result = _mm_packs_epi32 (result, result);
+            result = _mm_packus_epi16 (result, result);
+
+            const auto pixel = (uint32) _mm_cvtsi128_si32 (result);
+            memcpy ((void*) dest, &pixel, sizeof (pixel));
+        }
+    }
+
+    static constexpr PixelSpanFunctions functions { blendColour, blendColourWithMask, blendPixels, generateLinearGradient,
+                                                    generateRadialGradient, interpolatePixels, "SSE2" };
+}
+
+//==============================================================================
+namespace AVX2SpanFunctions
+{
+    JUCE_GRAPHICS_AVX2_FUNCTION static forcedinline __m256i scalePixels (__m256i pixels, __m256i extraAlpha) noexcept
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto lo = _mm256_srli_epi16 (_mm256_mullo_epi16 (_mm256_unpacklo_epi8 (pixels, zero), extraAlpha), 8);
+        const auto hi = _mm256_srli_epi16 (_mm256_mullo_epi16 (_mm256_unpackhi_epi8 (pixels, zero), extraAlpha), 8);
+        return _mm256_packus_epi16 (lo, hi);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static forcedinline __m256i getInverseAlphas (__m256i pixels16) noexcept
+    {
+        constexpr auto alphaShuffle = _MM_SHUFFLE (PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA);
+        return _mm256_sub_epi16 (_mm256_set1_epi16 (256), _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (pixels16, alphaShuffle), alphaShuffle));
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static forcedinline __m256i blend (__m256i dest, __m256i source, __m256i inverseAlphaLo,
+                                                                    __m256i inverseAlphaHi, __m256i keepMask) noexcept
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto lo = _mm256_srli_epi16 (_mm256_mullo_epi16 (_mm256_unpacklo_epi8 (dest, zero), inverseAlphaLo), 8);
+        const auto hi = _mm256_srli_epi16 (_mm256_mullo_epi16 (_mm256_unpackhi_epi8 (dest, zero), inverseAlphaHi), 8);
+        const auto result = _mm256_adds_epu8 (_mm256_packus_epi16 (lo, hi), source);
+        return _mm256_blendv_epi8 (dest, result, keepMask);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static forcedinline __m256i getKeepMask (bool destHasAlpha) noexcept
+    {
+        return _mm256_set1_epi32 (destHasAlpha ? -1 : (int) ~(0xffu << (PixelARGB::indexA * 8)));
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static void blendColour (uint8* dest, PixelARGB colour, int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto source = _mm256_set1_epi32 ((int) colour.getNativeARGB());
+        const auto inverseAlpha = _mm256_set1_epi16 ((short) (256 - colour.getAlpha()));
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 8; numPixels -= 8, dest += 32)
+        {
+            const auto d = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (dest));
+            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest), blend (d, source, inverseAlpha, inverseAlpha, keepMask));
+        }
+
+        SSE2SpanFunctions::blendColour (dest, colour, numPixels, destHasAlpha);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static void blendColourWithMask (uint8* dest, PixelARGB colour, const uint8* mask,
+                                                                 int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto colour16 = _mm256_unpacklo_epi8 (_mm256_set1_epi32 ((int) colour.getNativeARGB()), _mm256_setzero_si256());
+        const auto spread = _mm256_set1_epi32 (0x00010001);
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 8; numPixels -= 8, dest += 32, mask += 8)
+        {
+            const auto maskValues = _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (mask));
+
+            if (_mm_movemask_epi8 (_mm_cmpeq_epi8 (maskValues, _mm_setzero_si128())) == 0xffff)
+                continue;
+
+            // Each 32-bit lane holds two copies of its pixel's mask value + 1, which are then
+            // paired up to match the pixel order that unpacklo and unpackhi produce
+            const auto m = _mm256_add_epi32 (_mm256_mullo_epi32 (_mm256_cvtepu8_epi32 (maskValues), spread), spread);
+            const auto sourceLo = _mm256_srli_epi16 (_mm256_mullo_epi16 (colour16, _mm256_unpacklo_epi32 (m, m)), 8);
+            const auto sourceHi = _mm256_srli_epi16 (_mm256_mullo_epi16 (colour16, _mm256_unpackhi_epi32 (m, m)), 8);
+
+            const auto d = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (dest));
+            const auto result = blend (d, _mm256_packus_epi16 (sourceLo, sourceHi),
+                                       getInverseAlphas (sourceLo), getInverseAlphas (sourceHi), keepMask);
+            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest), result);
+        }
+
+        SSE2SpanFunctions::blendColourWithMask (dest, colour, mask, numPixels, destHasAlpha);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static void blendPixels (uint8* dest, const PixelARGB* source, int numPixels,
+                                                         uint32 extraAlpha, bool destHasAlpha) noexcept
+    {
+        const auto zero = _mm256_setzero_si256();
+        const auto extra = _mm256_set1_epi16 ((short) extraAlpha);
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 8; numPixels -= 8, dest += 32, source += 8)
+        {
+            auto s = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (source));
+
+            if (extraAlpha < 256)
+                s = scalePixels (s, extra);
+
+            const auto d = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (dest));
+            const auto result = blend (d, s, getInverseAlphas (_mm256_unpacklo_epi8 (s, zero)),
+                                             getInverseAlphas (_mm256_unpackhi_epi8 (s, zero)), keepMask);
+            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest), result);
+        }
+
+        SSE2SpanFunctions::blendPixels (dest, source, numPixels, extraAlpha, destHasAlpha);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static void generateLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                                                    int x, int scale, int start, int numPixels) noexcept
+    {
+        const auto firstPos = (int) ((uint32) x * (uint32) scale - (uint32) start);
+        auto positions = _mm256_add_epi32 (_mm256_set1_epi32 (firstPos),
+                                           _mm256_mullo_epi32 (_mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32 (scale)));
+        const auto step = _mm256_set1_epi32 ((int) ((uint32) scale * 8));
+        const auto maxIndex = _mm256_set1_epi32 (numEntries);
+        const auto zero = _mm256_setzero_si256();
+        const void* tableData = lookupTable;
+        const auto* table = static_cast<const int*> (tableData);
+
+        for (; numPixels >= 8; numPixels -= 8, x += 8, dest += 8)
+        {
+            const auto index = _mm256_min_epi32 (_mm256_max_epi32 (_mm256_srai_epi32 (positions, 12), zero), maxIndex);
+            const auto colours = _mm256_i32gather_epi32 (table, index, 4);
+            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest), colours);
+
+            positions = _mm256_add_epi32 (positions, step);
+        }
+
+        PortableSpanFunctions::generateLinearGradient (dest, lookupTable, numEntries, x, scale, start, numPixels);
+    }
+
+    JUCE_GRAPHICS_AVX2_FUNCTION static void generateRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                                                    double centreX, double dySquared, double maxDistSquared,
+                                                                    double invScale, int x, int numPixels) noexcept
+    {
+        const auto centre = _mm256_set1_pd (centreX);
+        const auto dy2 = _mm256_set1_pd (dySquared);
+        const auto maxDist = _mm256_set1_pd (maxDistSquared);
+        const auto scale = _mm256_set1_pd (invScale);
+        const auto roundingOffset = _mm256_set1_pd (6755399441055744.0);
+        const auto lowHalves = _mm256_setr_epi32 (0, 2, 4, 6, 0, 2, 4, 6);
+        const void* tableData = lookupTable;
+        const auto* table = static_cast<const int*> (tableData);
+
+        for (; numPixels >= 4; numPixels -= 4, x += 4, dest += 4)
+        {
+            auto dist = _mm256_sub_pd (_mm256_cvtepi32_pd (_mm_setr_epi32 (x, x + 1, x + 2, x + 3)), centre);
+            dist = _mm256_add_pd (_mm256_mul_pd (dist, dist), dy2);
+
+            const auto outside = _mm256_castpd_si256 (_mm256_cmp_pd (dist, maxDist, _CMP_GE_OQ));
+            const auto rounded = _mm256_castpd_si256 (_mm256_add_pd (_mm256_mul_pd (_mm256_sqrt_pd (dist), scale), roundingOffset));
+
+            auto index = _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (rounded, lowHalves));
+            const auto outsideMask = _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (outside, lowHalves));
+            index = _mm_blendv_epi8 (index, _mm_set1_epi32 (numEntries), outsideMask);
+
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest),
+                              _mm_i32gather_epi32 (table, index, 4));
+        }
+
+        PortableSpanFunctions::generateRadialGradient (dest, lookupTable, numEntries, centreX, dySquared,
+                                                       maxDistSquared, invScale, x, numPixels);
+    }
+
+    static constexpr PixelSpanFunctions functions { blendColour, blendColourWithMask, blendPixels, generateLinearGradient,
+                                                    generateRadialGradient, SSE2SpanFunctions::interpolatePixels, "AVX2" };
+}
+#endif
+
+//==============================================================================
+#if JUCE_GRAPHICS_USE_NEON_INTRINSICS
+namespace NeonSpanFunctions
+{
+    static forcedinline uint8x16_t scalePixels (uint8x16_t pixels, uint16x8_t extraAlpha) noexcept
+    {
+        return vcombine_u8 (vshrn_n_u16 (vmulq_u16 (vmovl_u8 (vget_low_u8  (pixels)), extraAlpha), 8),
+                            vshrn_n_u16 (vmulq_u16 (vmovl_u8 (vget_high_u8 (pixels)), extraAlpha), 8));
+    }
+
+    static forcedinline uint8x16_t blend (uint8x16_t dest, uint8x16_t source, uint16x8_t inverseAlphaLo,
+                                          uint16x8_t inverseAlphaHi, uint8x16_t keepMask) noexcept
+    {
+        const auto scaled = vcombine_u8 (vshrn_n_u16 (vmulq_u16 (vmovl_u8 (vget_low_u8  (dest)), inverseAlphaLo), 8),
+                                         vshrn_n_u16 (vmulq_u16 (vmovl_u8 (vget_high_u8 (dest)), inverseAlphaHi), 8));
+        return vbslq_u8 (keepMask, vqaddq_u8 (scaled, source), dest);
+    }
+
+    static forcedinline uint8x16_t getKeepMask (bool destHasAlpha) noexcept
+    {
+        return vreinterpretq_u8_u32 (vdupq_n_u32 (destHasAlpha ? 0xffffffffu : ~(0xffu << (PixelARGB::indexA * 8))));
+    }
+
+    static void blendColour (uint8* dest, PixelARGB colour, int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto source = vreinterpretq_u8_u32 (vdupq_n_u32 (colour.getNativeARGB()));
+        const auto inverseAlpha = vdupq_n_u16 ((uint16) (256 - colour.getAlpha()));
+        const auto keepMask = getKeepMask (destHasAlpha);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16)
+            vst1q_u8 (dest, blend (vld1q_u8 (dest), source, inverseAlpha, inverseAlpha, keepMask));
+
+        PortableSpanFunctions::blendColour (dest, colour, numPixels, destHasAlpha);
+    }
+
+    static void blendColourWithMask (uint8* dest, PixelARGB colour, const uint8* mask, int numPixels, bool destHasAlpha) noexcept
+    {
+        const auto colour16 = vmovl_u8 (vreinterpret_u8_u32 (vdup_n_u32 (colour.getNativeARGB())));
+        const auto keepMask = getKeepMask (destHasAlpha);
+        const uint8 spreadIndexes[] = { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3 };
+        const auto spreadTable = vld1q_u8 (spreadIndexes);
+        const uint8 laneOffsets[] = { 0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12 };
+        const auto alphaTable = vaddq_u8 (vld1q_u8 (laneOffsets), vdupq_n_u8 ((uint8) PixelARGB::indexA));
+        const auto one = vdupq_n_u16 (1);
+        const auto c256 = vdupq_n_u16 (256);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16, mask += 4)
+        {
+            uint32 maskValues;
+            memcpy (&maskValues, mask, sizeof (maskValues));
+
+            if (maskValues == 0)
+                continue;
+
+            const auto m = vqtbl1q_u8 (vreinterpretq_u8_u32 (vdupq_n_u32 (maskValues)), spreadTable);
+            const auto s = vcombine_u8 (vshrn_n_u16 (vmulq_u16 (colour16, vaddq_u16 (vmovl_u8 (vget_low_u8  (m)), one)), 8),
+                                        vshrn_n_u16 (vmulq_u16 (colour16, vaddq_u16 (vmovl_u8 (vget_high_u8 (m)), one)), 8));
+
+            const auto alphas = vqtbl1q_u8 (s, alphaTable);
+            vst1q_u8 (dest, blend (vld1q_u8 (dest), s,
+                                   vsubq_u16 (c256, vmovl_u8 (vget_low_u8  (alphas))),
+                                   vsubq_u16 (c256, vmovl_u8 (vget_high_u8 (alphas))),
+                                   keepMask));
+        }
+
+        PortableSpanFunctions::blendColourWithMask (dest, colour, mask, numPixels, destHasAlpha);
+    }
+
+    static void blendPixels (uint8* dest, const PixelARGB* source, int numPixels, uint32 extraAlpha, bool destHasAlpha) noexcept
+    {
+        const auto extra = vdupq_n_u16 ((uint16) extraAlpha);
+        const auto keepMask = getKeepMask (destHasAlpha);
+        const uint8 laneOffsets[] = { 0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12 };
+        const auto alphaTable = vaddq_u8 (vld1q_u8 (laneOffsets), vdupq_n_u8 ((uint8) PixelARGB::indexA));
+        const auto c256 = vdupq_n_u16 (256);
+
+        for (; numPixels >= 4; numPixels -= 4, dest += 16, source += 4)
+        {
+            auto s = vld1q_u8 (reinterpret_cast<const uint8*> (source));
+
+            if (extraAlpha < 256)
+                s = scalePixels (s, extra);
+
+            const auto alphas = vqtbl1q_u8 (s, alphaTable);
+            vst1q_u8 (dest, blend (vld1q_u8 (dest), s,
+                                   vsubq_u16 (c256, vmovl_u8 (vget_low_u8  (alphas))),
+                                   vsubq_u16 (c256, vmovl_u8 (vget_high_u8 (alphas))),
+                                   keepMask));
+        }
+
+        PortableSpanFunctions::blendPixels (dest, source, numPixels, extraAlpha, destHasAlpha);
+    }
+
+    static void interpolatePixels (PixelARGB* dest, const PixelSpanFunctions::BilinearSample* samples,
+                                   int numSamples, int lineStride) noexcept
+    {
+        for (; --numSamples >= 0; ++samples, ++dest)
+        {
+            const auto* src = samples->source;
+            const auto subPixelX = (uint16) samples->subPixelX;
+            const auto subPixelY = (uint16) samples->subPixelY;
+
+            const auto top    = vmovl_u8 (vld1_u8 (src));
+            const auto bottom = vmovl_u8 (vld1_u8 (src + lineStride));
+
+            const auto topRow    = vmla_n_u16 (vmul_n_u16 (vget_low_u16 (top),    (uint16) (256 - subPixelX)), vget_high_u16 (top),    subPixelX);
+            const auto bottomRow = vmla_n_u16 (vmul_n_u16 (vget_low_u16 (bottom), (uint16) (256 - subPixelX)), vget_high_u16 (bottom), subPixelX);
+
+            auto sum = vmlal_n_u16 (vmull_n_u16 (topRow, (uint16) (256 - subPixelY)), bottomRow, subPixelY);
+            sum = vaddq_u32 (sum, vdupq_n_u32 (256 * 128));
+
+            const auto result16 = vshrn_n_u32 (sum, 16);
+            const auto result8 = vmovn_u16 (vcombine_u16 (result16, result16));
+            vst1_lane_u32 (reinterpret_cast<uint32*> (dest), vreinterpret_u32_u8 (result8), 0);
+        }
+    }
+
+    static constexpr PixelSpanFunctions functions { blendColour, blendColourWithMask, blendPixels,
+                                                    PortableSpanFunctions::generateLinearGradient,
+                                                    PortableSpanFunctions::generateRadialGradient,
+                                                    interpolatePixels, "NEON" };
+}
+#endif
+
+//==============================================================================
+const PixelSpanFunctions& PixelSpanFunctions::get() noexcept
+{
+    static const auto& functions = []() -> const PixelSpanFunctions&
+    {
+       #if JUCE_GRAPHICS_USE_SSE2_INTRINSICS
+        if (SystemStats::hasAVX2())
+            return AVX2SpanFunctions::functions;
+
+        return SSE2SpanFunctions::functions;
+       #elif JUCE_GRAPHICS_USE_NEON_INTRINSICS
+        return NeonSpanFunctions::functions;
+       #else
+        return PortableSpanFunctions::functions;
+       #endif
+    }();
+
+    return functions;
+}
+
+const PixelSpanFunctions& PixelSpanFunctions::getPortable() noexcept
+{
+    return PortableSpanFunctions::functions;
+}
+
+Array<const PixelSpanFunctions*> PixelSpanFunctions::getAllAvailable()
+{
+    Array<const PixelSpanFunctions*> result { &PortableSpanFunctions::functions };
+
+   #if JUCE_GRAPHICS_USE_SSE2_INTRINSICS
+    result.add (&SSE2SpanFunctions::functions);
+
+    if (SystemStats::hasAVX2())
+        result.add (&AVX2SpanFunctions::functions);
+   #elif JUCE_GRAPHICS_USE_NEON_INTRINSICS
+    result.add (&NeonSpanFunctions::functions);
+   #endif
+
+    return result;
+}
+
+#undef JUCE_GRAPHICS_AVX2_FUNCTION
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PixelSpanFunctionsTests final : public UnitTest
+{
+public:
+    PixelSpanFunctionsTests()
+        : UnitTest ("PixelSpanFunctions", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto& portable = PixelSpanFunctions::getPortable();
+
+        for (auto* functions : PixelSpanFunctions::getAllAvailable())
+        {
+            if (functions == &portable)
+                continue;
+
+            beginTest (String ("blendColour matches the portable version: ") + functions->name);
+            {
+                auto r = getRandom();
+
+                for (int i = 0; i < 500; ++i)
+                {
+                    const auto colour = createRandomPixel (r);
+                    const auto numPixels = getRandomLength (r);
+                    const auto destHasAlpha = r.nextBool();
+
+                    auto expected = createRandomBytes (r, numPixels * 4);
+                    auto actual = expected;
+
+                    portable.blendColour (expected.data(), colour, numPixels, destHasAlpha);
+                    functions->blendColour (actual.data(), colour, numPixels, destHasAlpha);
+                    expect (actual == expected);
+                }
+            }
+
+            beginTest (String ("blendColourWithMask matches the portable version: ") + functions->name);
+            {
+                auto r = getRandom();
+
+                for (int i = 0; i < 500; ++i)
+                {
+                    const auto colour = createRandomPixel (r);
+                    const auto numPixels = getRandomLength (r);
+                    const auto destHasAlpha = r.nextBool();
+
+                    auto mask = createRandomBytes (r, numPixels);
+
+                    // Include some runs of empty and full coverage, as glyph masks have
+                    for (auto& m : mask)
+                        if (r.nextInt (4) == 0)
+                            m = r.nextBool() ? 0 : 255;
+
+                    auto expected = createRandomBytes (r, numPixels * 4);
+                    auto actual = expected;
+
+                    portable.blendColourWithMask (expected.data(), colour, mask.data(), numPixels, destHasAlpha);
+                    functions->blendColourWithMask (actual.data(), colour, mask.data(), numPixels, destHasAlpha);
+                    expect (actual == expected);
+                }
+            }
+
+            beginTest (String ("blendPixels matches the portable version: ") + functions->name);
+            {
+                auto r = getRandom();
+
+                for (int i = 0; i < 500; ++i)
+                {
+                    const auto numPixels = getRandomLength (r);
+                    const auto extraAlpha = r.nextBool() ? 256u : (uint32) r.nextInt (256);
+                    const auto destHasAlpha = r.nextBool();
+
+                    std::vector<PixelARGB> source;
+
+                    for (int j = 0; j < numPixels; ++j)
+                        source.push_back (createRandomPixel (r));
+
+                    auto expected = createRandomBytes (r, numPixels * 4);
+                    auto actual = expected;
+
+                    portable.blendPixels (expected.data(), source.data(), numPixels, extraAlpha, destHasAlpha);
+                    functions->blendPixels (actual.data(), source.data(), numPixels, extraAlpha, destHasAlpha);
+                    expect (actual == expected);
+                }
+            }
+
+            beginTest (String ("Gradients match the portable version: ") + functions->name);
+            {
+                auto r = getRandom();
+
+                for (int i = 0; i < 500; ++i)
+                {
+                    const auto numEntries = 1 + r.nextInt (1000);
+                    std::vector<PixelARGB> table;
+
+                    for (int j = 0; j <= numEntries; ++j)
+                        table.push_back (createRandomPixel (r));
+
+                    const auto numPixels = getRandomLength (r);
+                    const auto x = r.nextInt ({ -2000, 2000 });
+                    std::vector<PixelARGB> expected ((size_t) numPixels), actual ((size_t) numPixels);
+
+                    const auto scale = r.nextInt ({ -100000, 100000 });
+                    const auto start = r.nextInt ({ -10000000, 10000000 });
+                    portable.generateLinearGradient (expected.data(), table.data(), numEntries, x, scale, start, numPixels);
+                    functions->generateLinearGradient (actual.data(), table.data(), numEntries, x, scale, start, numPixels);
+                    expect (std::equal (actual.begin(), actual.end(), expected.begin(), isSamePixel));
+
+                    const auto centreX = r.nextDouble() * 2000.0 - 1000.0;
+                    const auto dy = r.nextDouble() * 200.0;
+                    const auto maxDist = r.nextDouble() * 500.0 + 1.0;
+                    const auto invScale = numEntries / maxDist;
+                    portable.generateRadialGradient (expected.data(), table.data(), numEntries, centreX, dy * dy,
+                                                     maxDist * maxDist, invScale, x, numPixels);
+                    functions->generateRadialGradient (actual.data(), table.data(), numEntries, centreX, dy * dy,
+                                                       maxDist * maxDist, invScale, x, numPixels);
+                    expect (std::equal (actual.begin(), actual.end(), expected.begin(), isSamePixel));
+                }
+            }
+
+            beginTest (String ("interpolatePixels matches the portable version: ") + functions->name);
+            {
+                auto r = getRandom();
+                constexpr int width = 32, height = 32, lineStride = width * 4;
+                const auto image = createRandomBytes (r, width * height * 4);
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    const auto numSamples = getRandomLength (r);
+                    std::vector<PixelSpanFunctions::BilinearSample> samples;
+
+                    for (int j = 0; j < numSamples; ++j)
+                        samples.push_back ({ image.data() + r.nextInt (height - 1) * lineStride + r.nextInt (width - 1) * 4,
+                                             r.nextInt (256), r.nextInt (256) });
+
+                    std::vector<PixelARGB> expected ((size_t) numSamples), actual ((size_t) numSamples);
+                    portable.interpolatePixels (expected.data(), samples.data(), numSamples, lineStride);
+                    functions->interpolatePixels (actual.data(), samples.data(), numSamples, lineStride);
+                    expect (std::equal (actual.begin(), actual.end(), expected.begin(), isSamePixel));
+                }
+            }
+        }
+
+        beginTest ("Portable functions match the pixel classes");
+        {
+            auto r = getRandom();
+            const auto colour = createRandomPixel (r);
+            auto source = createRandomPixel (r);
+
+            PixelARGB argb[2];
+            argb[0].setARGB (200, 10, 100, 150);
+            argb[1] = argb[0];
+
+            portable.blendColour ((uint8*) argb, colour, 1, true);
+            argb[1].blend (colour);
+            expect (isSamePixel (argb[0], argb[1]));
+
+            portable.blendPixels ((uint8*) argb, &source, 1, 100, true);
+            argb[1].blend (source, 100);
+            expect (isSamePixel (argb[0], argb[1]));
+
+            for (const uint8 maskValue : { (uint8) 0, (uint8) 1, (uint8) 77, (uint8) 254, (uint8) 255 })
+            {
+                portable.blendColourWithMask ((uint8*) argb, colour, &maskValue, 1, true);
+                auto scaled = colour;
+                scaled.multiplyAlpha ((int) maskValue);
+                argb[1].blend (scaled);
+                expect (isSamePixel (argb[0], argb[1]));
+            }
+
+            uint8 rgb[] = { 10, 20, 30, 0x55 };
+            PixelRGB expectedRGB;
+            expectedRGB.setARGB (0xff, rgb[PixelRGB::indexR], rgb[PixelRGB::indexG], rgb[PixelRGB::indexB]);
+
+            portable.blendColour (rgb, colour, 1, false);
+            expectedRGB.blend (colour);
+            expect (rgb[PixelRGB::indexR] == expectedRGB.getRed()
+                     && rgb[PixelRGB::indexG] == expectedRGB.getGreen()
+                     && rgb[PixelRGB::indexB] == expectedRGB.getBlue());
+            expectEquals ((int) rgb[3], 0x55);
+        }
+    }
+
+private:
+    static PixelARGB createRandomPixel (Random& r)
+    {
+        return Colour ((uint32) r.nextInt()).getPixelARGB();
+    }
+
+    static int getRandomLength (Random& r)
+    {
+        return r.nextInt (10) == 0 ? r.nextInt (2000) : r.nextInt (40);
+    }
+
+    static std::vector<uint8> createRandomBytes (Random& r, int numBytes)
+    {
+        std::vector<uint8> result ((size_t) numBytes);
+        r.fillBitsRandomly (result.data(), result.size());
+        return result;
+    }
+
+    static bool isSamePixel (const PixelARGB& a, const PixelARGB& b)
+    {
+        return a.getNativeARGB() == b.getNativeARGB();
+    }
+};
+
+static PixelSpanFunctionsTests pixelSpanFunctionsTests;
+
+#endif
+
+} // namespace juce::RenderingHelpers
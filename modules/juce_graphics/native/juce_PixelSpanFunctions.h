@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::RenderingHelpers
+{
+
+//==============================================================================
+/**
+    A table of functions that process runs of 32-bit pixels for the software renderer.
+
+    Each function produces exactly the same output as the equivalent per-pixel
+    operation in PixelARGB and PixelRGB, so the edge-table fillers can use them
+    interchangeably. The table returned by get() is picked when it's first used,
+    to suit the instruction sets that the current CPU supports.
+
+    The destination pixels must be contiguous 4-byte pixels. When destHasAlpha is
+    false, they're treated as PixelRGB values with an unused padding byte, which is
+    left unchanged.
+
+    @tags{Graphics}
+*/
+struct PixelSpanFunctions
+{
+    /** Describes one pixel to be produced by interpolatePixels(). */
+    struct BilinearSample
+    {
+        const uint8* source;        /**< The top-left of the 2x2 block of ARGB pixels to use. */
+        int subPixelX, subPixelY;   /**< The position within the block, in the range 0 to 255. */
+    };
+
+    /** Blends a premultiplied colour over each pixel, like PixelARGB::blend (colour). */
+    void (*blendColour) (uint8* dest, PixelARGB colour, int numPixels, bool destHasAlpha) noexcept;
+
+    /** Blends a premultiplied colour over each pixel after scaling its opacity by the
+        corresponding mask value, like calling PixelARGB::multiplyAlpha (mask[i]) on the
+        colour and then PixelARGB::blend(). A mask value of 255 leaves the opacity unchanged.
+    */
+    void (*blendColourWithMask) (uint8* dest, PixelARGB colour, const uint8* mask, int numPixels, bool destHasAlpha) noexcept;
+
+    /** Blends each source pixel over its destination, like PixelARGB::blend (source, extraAlpha).
+        An extraAlpha of 256 leaves the source opacity unchanged.
+    */
+    void (*blendPixels) (uint8* dest, const PixelARGB* source, int numPixels, uint32 extraAlpha, bool destHasAlpha) noexcept;
+
+    /** Fills a span with colours from a gradient lookup table, using the index
+        (x * scale - start) >> 12, clipped to the range 0 to numEntries.
+    */
+    void (*generateLinearGradient) (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                    int x, int scale, int start, int numPixels) noexcept;
+
+    /** Fills a span with colours from a radial gradient lookup table, where each entry is
+        found from the distance between the pixel and the gradient's centre.
+    */
+    void (*generateRadialGradient) (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                    double centreX, double dySquared, double maxDistSquared,
+                                    double invScale, int x, int numPixels) noexcept;
+
+    /** Produces each destination pixel as a bilinear interpolation of four source pixels. */
+    void (*interpolatePixels) (PixelARGB* dest, const BilinearSample* samples, int numSamples, int lineStride) noexcept;
+
+    /** A short description of the instruction set that the functions use. */
+    const char* name;
+
+    //==============================================================================
+    /** Returns the fastest set of functions that the current CPU can run. */
+    static const PixelSpanFunctions& get() noexcept;
+
+    /** Returns the portable implementation, which is used as a reference. */
+    static const PixelSpanFunctions& getPortable() noexcept;
+
+    /** Returns every implementation that the current CPU can run, starting with the portable one. */
+    static Array<const PixelSpanFunctions*> getAllAvailable();
+};
+
+//==============================================================================
+/** Returns true if the destination pixels can be processed with the PixelSpanFunctions. */
+inline bool canUsePixelSpanFunctions (const PixelARGB*, const Image::BitmapData& data) noexcept
+{
+   #if JUCE_BIG_ENDIAN
+    ignoreUnused (data);
+    return false;
+   #else
+    return data.pixelStride == 4;
+   #endif
+}
+
+inline bool canUsePixelSpanFunctions (const PixelRGB*, const Image::BitmapData& data) noexcept
+{
+   #if JUCE_BIG_ENDIAN
+    ignoreUnused (data);
+    return false;
+   #else
+    return data.pixelStride == 4;
+   #endif
+}
+
+inline bool canUsePixelSpanFunctions (const PixelAlpha*, const Image::BitmapData&) noexcept
+{
+    return false;
+}
+
+/** Blends a run of ARGB pixels over the destination if the PixelSpanFunctions can handle
+    this combination of pixel formats, returning false if it couldn't.
+*/
+template <class DestPixelType>
+bool blendPixelSpan (DestPixelType* dest, const Image::BitmapData& destData,
+                     const PixelARGB* source, int numPixels, uint32 extraAlpha) noexcept
+{
+    if (! canUsePixelSpanFunctions (dest, destData))
+        return false;
+
+    PixelSpanFunctions::get().blendPixels ((uint8*) dest, source, numPixels, extraAlpha,
+                                           std::is_same_v<DestPixelType, PixelARGB>);
+    return true;
+}
+
+template <class DestPixelType, class SrcPixelType>
+bool blendPixelSpan (DestPixelType*, const Image::BitmapData&, const SrcPixelType*, int, uint32) noexcept
+{
+    return false;
+}
+
+} // namespace juce::RenderingHelpers
@@ -185,6 +185,7 @@ public:
 
     static GlyphCache& getInstance()
     {
+        const SpinLock::ScopedLockType sl (getCreationLock());
         auto& g = getSingletonPointer();
 
         if (g == nullptr)
@@ -193,23 +194,68 @@ public:
         return *g;
     }
 
+    //==============================================================================
+    /** The layers for a glyph, which are never modified once they're in the cache, so they
+        can be shared by several renderers on different threads.
+    */
+    struct CachedGlyph  : public ReferenceCountedObject
+    {
+        using Ptr = ReferenceCountedObjectPtr<CachedGlyph>;
+
+        explicit CachedGlyph (std::vector<GlyphLayer> l)  : layers (std::move (l)) {}
+
+        const std::vector<GlyphLayer> layers;
+        std::atomic<uint64> lastUsed { 0 };
+    };
+
     //==============================================================================
     void reset()
     {
+        const ScopedWriteLock sl (lock);
         cache.clear();
     }
 
-    const auto& get (const Font& font, const int glyphNumber)
+    CachedGlyph::Ptr get (const Font& font, const int glyphNumber)
     {
-        return cache.get (Key { font, glyphNumber }, [] (const auto& key)
+        Key key { font, glyphNumber };
+
         {
-            auto fontHeight = detail::FontRendering::getEffectiveHeight (key.font);
-            auto typeface = key.font.getTypefacePtr();
-            return typeface->getLayersForGlyph (key.font.getMetricsKind(),
-                                                key.glyph,
-                                                AffineTransform::scale (fontHeight * key.font.getHorizontalScale(),
-                                                                        fontHeight));
-        });
+            const ScopedReadLock sl (lock);
+
+            if (const auto iter = cache.find (key); iter != cache.end())
+            {
+                iter->second->lastUsed.store (nextUseCount(), std::memory_order_relaxed);
+                return iter->second;
+            }
+        }
+
+        // The layers are created without holding the lock, as this is slow, and may need to use
+        // the cache itself
+        const auto fontHeight = detail::FontRendering::getEffectiveHeight (font);
+        CachedGlyph::Ptr glyph (new CachedGlyph (font.getTypefacePtr()->getLayersForGlyph (font.getMetricsKind(),
+                                                                                          glyphNumber,
+                                                                                          AffineTransform::scale (fontHeight * font.getHorizontalScale(),
+                                                                                                                  fontHeight))));
+        glyph->lastUsed = nextUseCount();
+
+        const ScopedWriteLock sl (lock);
+
+        // Another thread may have added the same glyph in the meantime
+        if (const auto iter = cache.find (key); iter != cache.end())
+            return iter->second;
+
+        if (cache.size() >= maxNumGlyphs)
+        {
+            const auto oldest = std::min_element (cache.begin(), cache.end(), [] (const auto& a, const auto& b)
+            {
+                return a.second->lastUsed.load (std::memory_order_relaxed) < b.second->lastUsed.load (std::memory_order_relaxed);
+            });
+
+            cache.erase (oldest);
+        }
+
+        cache.emplace (std::move (key), glyph);
+        return glyph;
     }
 
 private:
@@ -230,7 +276,16 @@ private:
         }
     };
 
-    LruCache<Key, std::vector<GlyphLayer>> cache;
+    static constexpr size_t maxNumGlyphs = 128;
+
+    std::map<Key, CachedGlyph::Ptr> cache;
+    std::atomic<uint64> counter { 0 };
+    ReadWriteLock lock;
+
+    uint64 nextUseCount() noexcept
+    {
+        return counter.fetch_add (1, std::memory_order_relaxed) + 1;
+    }
 
     static GlyphCache*& getSingletonPointer() noexcept
     {
@@ -238,9 +293,720 @@ private:
         return g;
     }
 
+    static SpinLock& getCreationLock() noexcept
+    {
+        static SpinLock creationLock;
+        return creationLock;
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphCache)
 };
 
+//==============================================================================
+/** Holds pre-rendered images of glyphs, which the software renderer can blend
+    straight into its destination instead of filling an edge table for each glyph.
+
+    Each glyph is rendered into an 8-bit mask at one of several horizontal sub-pixel
+    positions, and the masks for each font are packed into shared pages. When the
+    atlas needs more memory than its size limit allows, the least-recently-used
+    pages are discarded.
+
+    Only glyphs that are drawn as a single edge table in the current fill colour
+    can be stored, so colour glyphs and very large glyphs are always drawn from
+    their layers instead.
+
+    @tags{Graphics}
+*/
+class GlyphAtlas  : private DeletedAtShutdown
+{
+public:
+    /** The number of horizontal positions within each pixel that glyphs are rendered at. */
+    static constexpr int numSubPixelPositions = 4;
+
+    /** The width and height of each page. */
+    static constexpr int pageSize = 256;
+
+    /** Glyphs that are wider or taller than this are never stored in the atlas. */
+    static constexpr int maxGlyphSize = 64;
+
+    //==============================================================================
+    /** Holds information about the atlas's contents and how well it's working. */
+    struct Statistics
+    {
+        int64 numHits = 0;          /**< The number of glyphs that were drawn using an existing mask. */
+        int64 numMisses = 0;        /**< The number of glyphs that had to be rendered into the atlas. */
+        int64 numEvictions = 0;     /**< The number of pages discarded to stay within the size limit. */
+        int numPages = 0;           /**< The number of pages that are currently allocated. */
+        size_t numBytes = 0;        /**< The memory used by the current pages. */
+        size_t maxNumBytes = 0;     /**< The size limit, as set by setSizeLimit(). */
+
+        /** Returns the proportion of lookups that were hits, in the range 0 to 1. */
+        double getHitRate() const noexcept
+        {
+            const auto numLookups = numHits + numMisses;
+            return numLookups > 0 ? (double) numHits / (double) numLookups : 0.0;
+        }
+    };
+
+    //==============================================================================
+    /** A page of glyph masks. */
+    struct Page
+    {
+        Page() : pixels ((size_t) (pageSize * pageSize), true) {}
+
+        uint8* getLinePointer (int y) noexcept                 { return pixels + y * pageSize; }
+        const uint8* getLinePointer (int y) const noexcept     { return pixels + y * pageSize; }
+
+        /** Finds space for a mask, filling the page in rows that are as tall as their tallest mask. */
+        std::optional<Point<int>> allocate (int width, int height) noexcept
+        {
+            if (rowX + width > pageSize)
+            {
+                rowY += rowHeight;
+                rowX = 0;
+                rowHeight = 0;
+            }
+
+            if (rowY + height > pageSize)
+                return {};
+
+            const Point position (rowX, rowY);
+            rowX += width;
+            rowHeight = jmax (rowHeight, height);
+            return position;
+        }
+
+        HeapBlock<uint8> pixels;
+        int rowX = 0, rowY = 0, rowHeight = 0;
+        mutable uint64 lastUsed = 0; // only used while the atlas is locked
+
+        JUCE_DECLARE_NON_COPYABLE (Page)
+    };
+
+    /** The mask for a glyph at one sub-pixel position.
+
+        Each mask value is applied to the fill colour with PixelARGB::multiplyAlpha(),
+        which reproduces the result of filling the glyph's edge table. A mask with
+        an empty area is a glyph that has nothing to draw.
+    */
+    struct Mask
+    {
+        const uint8* getLinePointer (int y) const noexcept
+        {
+            return page->getLinePointer (area.getY() + y) + area.getX();
+        }
+
+        std::shared_ptr<const Page> page;
+        Rectangle<int> area;        /**< The mask's position within its page. */
+        Point<int> offset;          /**< The position of the mask's top-left corner, relative to the glyph origin. */
+    };
+
+    //==============================================================================
+    GlyphAtlas() = default;
+
+    ~GlyphAtlas() override
+    {
+        getSingletonPointer() = nullptr;
+    }
+
+    static GlyphAtlas& getInstance()
+    {
+        const SpinLock::ScopedLockType sl (getCreationLock());
+        auto& g = getSingletonPointer();
+
+        if (g == nullptr)
+            g = new GlyphAtlas();
+
+        return *g;
+    }
+
+    //==============================================================================
+    /** Returns the mask for a glyph, rendering it into the atlas if it isn't already there.
+
+        This returns nullopt if the glyph can't be drawn from the atlas, in which case
+        it should be drawn from its layers.
+    */
+    std::optional<Mask> get (const Font& font, int glyphNumber, int subPixelPosition)
+    {
+        jassert (isPositiveAndBelow (subPixelPosition, numSubPixelPositions));
+
+        const ScopedLock sl (lock);
+
+        if (maxNumBytes < pageBytes)
+            return {};
+
+        auto group = fonts.find (font);
+
+        if (group == fonts.end())
+        {
+            if (fonts.size() >= maxNumFonts)
+                removeLeastRecentlyUsedFont();
+
+            group = fonts.emplace (font, FontGlyphs{}).first;
+        }
+
+        auto& glyphs = group->second;
+        glyphs.lastUsed = ++counter;
+
+        const auto key = glyphNumber * numSubPixelPositions + subPixelPosition;
+
+        if (const auto existing = glyphs.masks.find (key); existing != glyphs.masks.end())
+        {
+            if (auto& mask = existing->second)
+            {
+                ++stats.numHits;
+
+                if (mask->page != nullptr)
+                    mask->page->lastUsed = counter;
+            }
+
+            return existing->second;
+        }
+
+        auto mask = createMask (glyphs, font, glyphNumber, subPixelPosition);
+        glyphs.masks[key] = mask;
+        return mask;
+    }
+
+    /** Sets the maximum amount of memory that the pages may use, discarding pages if necessary. */
+    void setSizeLimit (size_t newMaxNumBytes)
+    {
+        const ScopedLock sl (lock);
+        maxNumBytes = newMaxNumBytes;
+
+        while (numBytes > maxNumBytes && removeLeastRecentlyUsedPage())
+        {}
+    }
+
+    /** Discards all the stored glyphs. */
+    void reset()
+    {
+        const ScopedLock sl (lock);
+        fonts.clear();
+        numBytes = 0;
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+        auto result = stats;
+        result.numPages = (int) (numBytes / pageBytes);
+        result.numBytes = numBytes;
+        result.maxNumBytes = maxNumBytes;
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        stats = {};
+    }
+
+private:
+    //==============================================================================
+    struct FontGlyphs
+    {
+        // A key of (glyph * numSubPixelPositions + subPixelPosition), with nullopt
+        // for glyphs that can't be drawn from the atlas
+        std::map<int, std::optional<Mask>> masks;
+        std::vector<std::shared_ptr<Page>> pages;
+        uint64 lastUsed = 0;
+    };
+
+    struct FontComparator
+    {
+        bool operator() (const Font& a, const Font& b) const  { return GraphicsFontHelpers::compareFont (a, b); }
+    };
+
+    // Writes the levels that EdgeTable::iterate() produces into a mask. The edge-table fillers draw
+    // single pixels with PixelARGB::blend (colour, alpha), which is the same as multiplying the
+    // colour's alpha by (alpha - 1), and runs of pixels with PixelARGB::multiplyAlpha (level).
+    struct MaskRenderer
+    {
+        void setEdgeTableYPos (int y) noexcept                           { line = pixels + y * lineStride; }
+        void handleEdgeTablePixel (int x, int alphaLevel) const noexcept { line[x] = (uint8) (alphaLevel - 1); }
+        void handleEdgeTablePixelFull (int x) const noexcept             { line[x] = 255; }
+        void handleEdgeTableLine (int x, int width, int level) const noexcept  { memset (line + x, level, (size_t) width); }
+        void handleEdgeTableLineFull (int x, int width) const noexcept   { memset (line + x, 255, (size_t) width); }
+
+        uint8* pixels;
+        int lineStride;
+        uint8* line = nullptr;
+    };
+
+    static constexpr size_t pageBytes = (size_t) (pageSize * pageSize);
+    static constexpr size_t maxNumFonts = 64;
+
+    std::map<Font, FontGlyphs, FontComparator> fonts;
+    size_t numBytes = 0, maxNumBytes = 8 * 1024 * 1024;
+    uint64 counter = 0;
+    Statistics stats;
+    CriticalSection lock;
+
+    std::optional<Mask> createMask (FontGlyphs& glyphs, const Font& font, int glyphNumber, int subPixelPosition)
+    {
+        const auto glyph = GlyphCache::getInstance().get (font, glyphNumber);
+        const auto& layers = glyph->layers;
+
+        if (layers.size() != 1)
+            return {};
+
+        const auto* colourLayer = std::get_if<ColourLayer> (&layers.front().layer);
+
+        if (colourLayer == nullptr || colourLayer->colour.has_value())
+            return {};
+
+        const auto bounds = colourLayer->clip.getMaximumBounds();
+
+        if (bounds.isEmpty())
+            return Mask{};
+
+        if (bounds.getWidth() > maxGlyphSize || bounds.getHeight() > maxGlyphSize)
+            return {};
+
+        const auto [page, position] = allocate (glyphs, bounds.getWidth(), bounds.getHeight());
+
+        if (page == nullptr)
+            return {};
+
+        ++stats.numMisses;
+
+        // The table is moved so that its coordinates aren't negative, because EdgeTable::iterate()
+        // only finds the right pixels for positive positions, as they will be when it's drawn.
+        auto edgeTable = colourLayer->clip;
+        edgeTable.translate ((float) -bounds.getX() + (float) subPixelPosition / (float) numSubPixelPositions, -bounds.getY());
+
+        MaskRenderer renderer { page->getLinePointer (position.y) + position.x, pageSize };
+        edgeTable.iterate (renderer);
+
+        return Mask { page, { position.x, position.y, bounds.getWidth(), bounds.getHeight() }, bounds.getPosition() };
+    }
+
+    std::tuple<std::shared_ptr<Page>, Point<int>> allocate (FontGlyphs& glyphs, int width, int height)
+    {
+        if (! glyphs.pages.empty())
+            if (auto position = glyphs.pages.back()->allocate (width, height))
+                return { glyphs.pages.back(), *position };
+
+        while (numBytes + pageBytes > maxNumBytes && removeLeastRecentlyUsedPage())
+        {}
+
+        if (numBytes + pageBytes > maxNumBytes)
+            return {};
+
+        auto page = std::make_shared<Page>();
+        page->lastUsed = counter;
+        numBytes += pageBytes;
+        glyphs.pages.push_back (page);
+
+        return { page, *page->allocate (width, height) };
+    }
+
+    bool removeLeastRecentlyUsedPage()
+    {
+        FontGlyphs* oldestGroup = nullptr;
+        size_t oldestIndex = 0;
+
+        for (auto& [font, glyphs] : fonts)
+        {
+            for (size_t i = 0; i < glyphs.pages.size(); ++i)
+            {
+                if (oldestGroup == nullptr || glyphs.pages[i]->lastUsed < oldestGroup->pages[oldestIndex]->lastUsed)
+                {
+                    oldestGroup = &glyphs;
+                    oldestIndex = i;
+                }
+            }
+        }
+
+        if (oldestGroup == nullptr)
+            return false;
+
+        const auto page = oldestGroup->pages[oldestIndex];
+        oldestGroup->pages.erase (oldestGroup->pages.begin() + (ptrdiff_t) oldestIndex);
+
+        for (auto iter = oldestGroup->masks.begin(); iter != oldestGroup->masks.end();)
+        {
+            if (iter->second.has_value() && iter->second->page == page)
+                iter = oldestGroup->masks.erase (iter);
+            else
+                ++iter;
+        }
+
+        numBytes -= pageBytes;
+        ++stats.numEvictions;
+        return true;
+    }
+
+    void removeLeastRecentlyUsedFont()
+    {
+        const auto oldest = std::min_element (fonts.begin(), fonts.end(), [] (const auto& a, const auto& b)
+        {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+
+        if (oldest == fonts.end())
+            return;
+
+        numBytes -= oldest->second.pages.size() * pageBytes;
+        stats.numEvictions += (int64) oldest->second.pages.size();
+        fonts.erase (oldest);
+    }
+
+    static GlyphAtlas*& getSingletonPointer() noexcept
+    {
+        static GlyphAtlas* g = nullptr;
+        return g;
+    }
+
+    static SpinLock& getCreationLock() noexcept
+    {
+        static SpinLock creationLock;
+        return creationLock;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphAtlas)
+};
+
+//==============================================================================
+/**
+    Keeps the results of flattening and stroking paths that are drawn repeatedly,
+    such as the shapes of meters and knobs that get rebuilt on every repaint.
+
+    Entries are found by comparing the paths' contents, so a path that's rebuilt
+    identically on each repaint still finds its entry, and a path that's been changed
+    can never be given the result for its old shape. The results are stored without
+    the translation part of their transform, so a shape that moves without being
+    scaled or rotated can carry on using the same entry.
+
+    A result is only stored once the same path has been seen twice, so that paths
+    which change on every repaint don't push other entries out of the cache.
+
+    @tags{Graphics}
+*/
+class PathCache  : private DeletedAtShutdown
+{
+public:
+    //==============================================================================
+    /** Holds information about the cache's contents and how well it's working. */
+    struct Statistics
+    {
+        int64 numHits = 0;          /**< The number of paths that were drawn using a stored result. */
+        int64 numMisses = 0;        /**< The number of paths that had to be flattened or stroked. */
+        int64 numEvictions = 0;     /**< The number of entries discarded to stay within the size limit. */
+        int numEntries = 0;         /**< The number of results that are currently stored. */
+        size_t numBytes = 0;        /**< The approximate memory used by the current entries. */
+        size_t maxNumBytes = 0;     /**< The size limit, as set by setSizeLimit(). */
+
+        /** Returns the proportion of lookups that were hits, in the range 0 to 1. */
+        double getHitRate() const noexcept
+        {
+            const auto numLookups = numHits + numMisses;
+            return numLookups > 0 ? (double) numHits / (double) numLookups : 0.0;
+        }
+    };
+
+    //==============================================================================
+    PathCache() = default;
+
+    ~PathCache() override
+    {
+        getSingletonPointer() = nullptr;
+    }
+
+    static PathCache& getInstance()
+    {
+        const SpinLock::ScopedLockType sl (getCreationLock());
+        auto& c = getSingletonPointer();
+
+        if (c == nullptr)
+            c = new PathCache();
+
+        return *c;
+    }
+
+    //==============================================================================
+    /** Returns a copy of a path that contains only straight lines, with the curves flattened
+        to suit a transform that has no translation.
+
+        This returns nullptr if the path doesn't contain any curves, or if the cache is
+        disabled, in which case the original path should be drawn.
+    */
+    std::shared_ptr<const Path> getFlattened (const Path& path, const AffineTransform& linearTransform)
+    {
+        const auto summary = summarise (path);
+
+        if (! summary.hasCurves || getSizeLimit() == 0)
+            return {};
+
+        return find ({ path, linearTransform, nullptr, 1.0f }, summary, [&]
+        {
+            return flatten (path, linearTransform, Path::defaultToleranceForMeasurement);
+        });
+    }
+
+    /** Returns the outline that PathStrokeType::createStrokedPath() creates for a stroke
+        with a transform that has no translation, flattened into straight lines.
+    */
+    std::shared_ptr<const Path> getStroke (const Path& path, const PathStrokeType& strokeType,
+                                           const AffineTransform& linearTransform, float extraAccuracy)
+    {
+        return find ({ path, linearTransform, &strokeType, extraAccuracy }, summarise (path), [&]
+        {
+            Path outline;
+            strokeType.createStrokedPath (outline, path, linearTransform, extraAccuracy);
+            return flatten (outline, {}, Path::defaultToleranceForMeasurement / extraAccuracy);
+        });
+    }
+
+    /** Sets the maximum amount of memory that the stored paths may use, discarding entries if necessary. */
+    void setSizeLimit (size_t newMaxNumBytes)
+    {
+        const ScopedLock sl (lock);
+        maxNumBytes = newMaxNumBytes;
+        trim();
+    }
+
+    size_t getSizeLimit() const
+    {
+        const ScopedLock sl (lock);
+        return maxNumBytes;
+    }
+
+    /** Discards all the stored paths. */
+    void reset()
+    {
+        const ScopedLock sl (lock);
+        entries.clear();
+        index.clear();
+        seenOnce.clear();
+        numBytes = 0;
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+        auto result = stats;
+        result.numEntries = (int) entries.size();
+        result.numBytes = numBytes;
+        result.maxNumBytes = maxNumBytes;
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        stats = {};
+    }
+
+private:
+    //==============================================================================
+    struct Summary
+    {
+        size_t hash = 0;
+        size_t numCoordinates = 0;
+        bool hasCurves = false;
+    };
+
+    struct Query
+    {
+        const Path& path;
+        const AffineTransform& transform;
+        const PathStrokeType* strokeType;
+        float extraAccuracy;
+    };
+
+    struct Entry
+    {
+        bool matches (const Query& q) const
+        {
+            const auto isStroke = q.strokeType != nullptr;
+
+            return transform == q.transform
+                && strokeType.has_value() == isStroke
+                && (! isStroke || (*strokeType == *q.strokeType && exactlyEqual (extraAccuracy, q.extraAccuracy)))
+                && source == q.path;
+        }
+
+        size_t hash;
+        Path source;
+        AffineTransform transform;
+        std::optional<PathStrokeType> strokeType;
+        float extraAccuracy;
+        std::shared_ptr<const Path> result;
+        size_t numBytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    // Hashes the path's contents, and finds out whether it has any curves, in a single pass
+    static Summary summarise (const Path& path)
+    {
+        Summary summary;
+        uint64 hash = path.isUsingNonZeroWinding() ? 1 : 2;
+
+        const auto add = [&] (std::initializer_list<float> coords)
+        {
+            for (auto c : coords)
+                hash = (hash ^ (uint64) readUnaligned<uint32> (&c)) * 0x100000001b3ull;
+
+            summary.numCoordinates += coords.size();
+        };
+
+        for (Path::Iterator i (path); i.next();)
+        {
+            hash = (hash ^ (uint64) i.elementType) * 0x100000001b3ull;
+
+            switch (i.elementType)
+            {
+                case Path::Iterator::startNewSubPath:
+                case Path::Iterator::lineTo:        add ({ i.x1, i.y1 }); break;
+                case Path::Iterator::quadraticTo:   add ({ i.x1, i.y1, i.x2, i.y2 }); summary.hasCurves = true; break;
+                case Path::Iterator::cubicTo:       add ({ i.x1, i.y1, i.x2, i.y2, i.x3, i.y3 }); summary.hasCurves = true; break;
+                case Path::Iterator::closePath:     break;
+            }
+        }
+
+        summary.hash = (size_t) hash;
+        return summary;
+    }
+
+    static size_t getKeyHash (const Query& q, size_t pathHash)
+    {
+        auto hash = pathHash;
+
+        for (auto v : { q.transform.mat00, q.transform.mat01, q.transform.mat10, q.transform.mat11 })
+            hash = hash * 101 + std::hash<float>{} (v);
+
+        if (q.strokeType != nullptr)
+        {
+            hash = hash * 101 + std::hash<float>{} (q.strokeType->getStrokeThickness());
+            hash = hash * 101 + (size_t) q.strokeType->getJointStyle();
+            hash = hash * 101 + (size_t) q.strokeType->getEndStyle();
+            hash = hash * 101 + std::hash<float>{} (q.extraAccuracy);
+        }
+
+        return hash;
+    }
+
+    static Path flatten (const Path& path, const AffineTransform& transform, float tolerance)
+    {
+        Path result;
+        result.setUsingNonZeroWinding (path.isUsingNonZeroWinding());
+
+        for (PathFlatteningIterator i (path, transform, tolerance); i.next();)
+        {
+            if (i.subPathIndex == 0)
+                result.startNewSubPath (i.x1, i.y1);
+
+            if (i.closesSubPath)
+                result.closeSubPath();
+            else
+                result.lineTo (i.x2, i.y2);
+        }
+
+        return result;
+    }
+
+    template <typename CreateResult>
+    std::shared_ptr<const Path> find (const Query& query, const Summary& summary, CreateResult&& createResult)
+    {
+        const auto hash = getKeyHash (query, summary.hash);
+        bool shouldStore = false;
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto [item, end] = index.equal_range (hash); item != end; ++item)
+            {
+                const auto entry = item->second;
+
+                if (entry->matches (query))
+                {
+                    entries.splice (entries.begin(), entries, entry);
+                    ++stats.numHits;
+                    return entry->result;
+                }
+            }
+
+            ++stats.numMisses;
+
+            if (maxNumBytes > 0)
+            {
+                if (seenOnce.size() >= maxNumSeenOnce)
+                    seenOnce.clear();
+
+                shouldStore = ! seenOnce.insert (hash).second;
+            }
+        }
+
+        // The result is created without holding the lock, so that other threads aren't held up
+        auto result = std::make_shared<const Path> (createResult());
+
+        if (shouldStore)
+        {
+            const auto numResultCoordinates = summarise (*result).numCoordinates;
+            const auto entryBytes = sizeof (Entry) + (summary.numCoordinates + numResultCoordinates) * 2 * sizeof (float);
+
+            const ScopedLock sl (lock);
+
+            if (entryBytes <= maxNumBytes)
+            {
+                entries.push_front ({ hash, query.path, query.transform,
+                                      query.strokeType != nullptr ? std::optional (*query.strokeType) : std::nullopt,
+                                      query.extraAccuracy, result, entryBytes });
+                index.emplace (hash, entries.begin());
+                seenOnce.erase (hash);
+                numBytes += entryBytes;
+                trim();
+            }
+        }
+
+        return result;
+    }
+
+    void trim()
+    {
+        while (numBytes > maxNumBytes && ! entries.empty())
+        {
+            const auto oldest = std::prev (entries.end());
+            auto [item, end] = index.equal_range (oldest->hash);
+
+            while (item != end && item->second != oldest)
+                ++item;
+
+            jassert (item != end);
+            index.erase (item);
+            numBytes -= oldest->numBytes;
+            entries.erase (oldest);
+            ++stats.numEvictions;
+        }
+    }
+
+    static PathCache*& getSingletonPointer() noexcept
+    {
+        static PathCache* c = nullptr;
+        return c;
+    }
+
+    static SpinLock& getCreationLock() noexcept
+    {
+        static SpinLock creationLock;
+        return creationLock;
+    }
+
+    static constexpr size_t maxNumSeenOnce = 1024;
+
+    EntryList entries; // most recently used first
+    std::unordered_multimap<size_t, EntryList::iterator> index;
+    std::unordered_set<size_t> seenOnce;
+    size_t numBytes = 0, maxNumBytes = 4 * 1024 * 1024;
+    Statistics stats;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PathCache)
+};
+
 //==============================================================================
 /** Calculates the alpha values and positions for rendering the edges of a
     non-pixel-aligned rectangle.
@@ -403,6 +1169,16 @@ namespace GradientPixelIterators
                             : lookupTable[jlimit (0, numEntries, (x * scale - start) >> (int) numScaleBits)];
         }
 
+        void generate (PixelARGB* dest, int x, int numPixels) const noexcept
+        {
+            static_assert (numScaleBits == 12, "The span functions assume this scale");
+
+            if (vertical)
+                std::fill (dest, dest + numPixels, linePix);
+            else
+                PixelSpanFunctions::get().generateLinearGradient (dest, lookupTable, numEntries, x, scale, start, numPixels);
+        }
+
         const PixelARGB* const lookupTable;
         const int numEntries;
         PixelARGB linePix;
@@ -447,6 +1223,12 @@ namespace GradientPixelIterators
             return lookupTable[x >= maxDist ? numEntries : roundToInt (std::sqrt (x) * invScale)];
         }
 
+        void generate (PixelARGB* dest, int x, int numPixels) const noexcept
+        {
+            PixelSpanFunctions::get().generateRadialGradient (dest, lookupTable, numEntries, gx1, dy,
+                                                              maxDist, invScale, x, numPixels);
+        }
+
         const PixelARGB* const lookupTable;
         const int numEntries;
         const double gx1, gy1;
@@ -489,6 +1271,12 @@ namespace GradientPixelIterators
             return lookupTable[jmin (numEntries, roundToInt (std::sqrt (x) * invScale))];
         }
 
+        void generate (PixelARGB* dest, int x, int numPixels) const noexcept
+        {
+            while (--numPixels >= 0)
+                *dest++ = getPixel (x++);
+        }
+
     private:
         double tM10, tM00, lineYM01, lineYM11;
         const AffineTransform inverseTransform;
@@ -609,7 +1397,10 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (canUsePixelSpanFunctions (dest, destData))
+                PixelSpanFunctions::get().blendColour ((uint8*) dest, colour, width, std::is_same_v<PixelType, PixelARGB>);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, PixelARGB colour, int width) const noexcept
@@ -668,7 +1459,9 @@ namespace EdgeTableFillers
         {
             auto* dest = getPixel (x);
 
-            if (alphaLevel < 0xff)
+            if (canUsePixelSpanFunctions (dest, destData))
+                blendSpan (dest, x, width, alphaLevel < 0xff ? (uint32) alphaLevel : 256);
+            else if (alphaLevel < 0xff)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
             else
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
@@ -677,7 +1470,11 @@ namespace EdgeTableFillers
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
             auto* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+
+            if (canUsePixelSpanFunctions (dest, destData))
+                blendSpan (dest, x, width, 256);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
         }
 
         void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
@@ -707,6 +1504,22 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        void blendSpan (PixelType* dest, int x, int width, uint32 alphaLevel) const noexcept
+        {
+            PixelARGB colours[128];
+
+            while (width > 0)
+            {
+                auto numPixels = jmin (width, (int) numElementsInArray (colours));
+                GradientType::generate (colours, x, numPixels);
+                blendPixelSpan (dest, destData, colours, numPixels, alphaLevel);
+
+                dest = addBytesToPointer (dest, numPixels * destData.pixelStride);
+                x += numPixels;
+                width -= numPixels;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
@@ -756,6 +1569,9 @@ namespace EdgeTableFillers
             alphaLevel = (alphaLevel * extraAlpha) >> 8;
             x -= xOffset;
 
+            if (blendSpan (dest, x, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256))
+                return;
+
             if (repeatPattern)
             {
                 if (alphaLevel < 0xfe)
@@ -779,6 +1595,9 @@ namespace EdgeTableFillers
             auto* dest = getDestPixel (x);
             x -= xOffset;
 
+            if (blendSpan (dest, x, width, extraAlpha < 0xfe ? (uint32) extraAlpha : 256))
+                return;
+
             if (repeatPattern)
             {
                 if (extraAlpha < 0xfe)
@@ -844,6 +1663,27 @@ namespace EdgeTableFillers
             return addBytesToPointer (sourceLineStart, x * srcData.pixelStride);
         }
 
+        bool blendSpan (DestPixelType* dest, int x, int width, uint32 alphaLevel) const noexcept
+        {
+            if (! (std::is_same_v<SrcPixelType, PixelARGB> && srcData.pixelStride == 4 && canUsePixelSpanFunctions (dest, destData)))
+                return false;
+
+            jassert (repeatPattern || (x >= 0 && x + width <= srcData.width));
+
+            while (width > 0)
+            {
+                const auto srcX = repeatPattern ? x % srcData.width : x;
+                const auto numPixels = repeatPattern ? jmin (width, srcData.width - srcX) : width;
+                blendPixelSpan (dest, destData, getSrcPixel (srcX), numPixels, alphaLevel);
+
+                dest = addBytesToPointer (dest, numPixels * destData.pixelStride);
+                x += numPixels;
+                width -= numPixels;
+            }
+
+            return true;
+        }
+
         forcedinline void copyRow (DestPixelType* dest, SrcPixelType const* src, int width) const noexcept
         {
             auto destStride = destData.pixelStride;
@@ -926,6 +1766,9 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
+            if (blendPixelSpan (dest, destData, span, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256))
+                return;
+
             if (alphaLevel < 0xfe)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
             else
@@ -1004,8 +1847,8 @@ namespace EdgeTableFillers
                         if (isPositiveAndBelow (loResY, maxY))
                         {
                             // in the centre of the image
-                            render4PixelAverage (dest, this->srcData.getPixelPointer (loResX, loResY),
-                                                 hiResX & 255, hiResY & 255);
+                            addBilinearSample (dest, this->srcData.getPixelPointer (loResX, loResY),
+                                               hiResX & 255, hiResY & 255);
                             ++dest;
                             continue;
                         }
@@ -1050,6 +1893,46 @@ namespace EdgeTableFillers
                 ++dest;
 
             } while (--numPixels > 0);
+
+            flushBilinearSamples();
+        }
+
+        //==============================================================================
+        // ARGB pixels from the centre of the image are collected into runs, so that
+        // they can be interpolated together by the PixelSpanFunctions.
+        template <class PixelType>
+        void addBilinearSample (PixelType* dest, const uint8* src, int subPixelX, int subPixelY) noexcept
+        {
+            render4PixelAverage (dest, src, (uint32) subPixelX, (uint32) subPixelY);
+        }
+
+        void addBilinearSample (PixelARGB* dest, const uint8* src, int subPixelX, int subPixelY) noexcept
+        {
+            if (this->srcData.pixelStride != 4)
+            {
+                render4PixelAverage (dest, src, subPixelX, subPixelY);
+                return;
+            }
+
+            if (numBilinearSamples > 0
+                 && (bilinearSampleDest + numBilinearSamples != dest
+                      || numBilinearSamples == (int) numElementsInArray (bilinearSamples)))
+                flushBilinearSamples();
+
+            if (numBilinearSamples == 0)
+                bilinearSampleDest = dest;
+
+            bilinearSamples[numBilinearSamples++] = { src, subPixelX, subPixelY };
+        }
+
+        void flushBilinearSamples() noexcept
+        {
+            if (numBilinearSamples > 0)
+            {
+                PixelSpanFunctions::get().interpolatePixels (bilinearSampleDest, bilinearSamples,
+                                                             numBilinearSamples, this->srcData.lineStride);
+                numBilinearSamples = 0;
+            }
         }
 
         //==============================================================================
@@ -1341,6 +2224,9 @@ namespace EdgeTableFillers
         DestPixelType* linePixels;
         HeapBlock<SrcPixelType> scratchBuffer;
         size_t scratchSize = 2048;
+        PixelSpanFunctions::BilinearSample bilinearSamples[64];
+        PixelARGB* bilinearSampleDest = nullptr;
+        int numBilinearSamples = 0;
 
         JUCE_DECLARE_NON_COPYABLE (TransformedImageFill)
     };
@@ -2255,14 +3141,33 @@ public:
     {
         if (clip != nullptr)
         {
-            auto trans = transform.getTransformWith (t);
-            auto clipRect = clip->getClipBounds();
+            const auto trans = transform.getTransformWith (t);
 
-            if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            if (auto flattened = PathCache::getInstance().getFlattened (path, withoutTranslation (trans)))
+                fillPathWithTransform (*flattened, getTranslation (trans));
+            else
+                fillPathWithTransform (path, trans);
+        }
+    }
+
+    void strokePath (const Path& path, const PathStrokeType& strokeType, const AffineTransform& t)
+    {
+        if (clip != nullptr)
+        {
+            const auto outline = PathCache::getInstance().getStroke (path, strokeType, withoutTranslation (t),
+                                                                     transform.getPhysicalPixelScaleFactor());
+            fillPathWithTransform (*outline, transform.getTransformWith (getTranslation (t)));
         }
     }
 
+    void fillPathWithTransform (const Path& path, const AffineTransform& trans)
+    {
+        auto clipRect = clip->getClipBounds();
+
+        if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
+            fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+    }
+
     void fillEdgeTable (const EdgeTable& edgeTable, float x, int y)
     {
         if (clip != nullptr)
@@ -2274,6 +3179,13 @@ public:
         }
     }
 
+    // Renderers that can draw glyphs from a GlyphAtlas override this. It returns
+    // false if the glyph needs to be drawn from its layers instead.
+    bool drawGlyphFromAtlas (const Font&, int, Point<float>)
+    {
+        return false;
+    }
+
     void drawLine (Line<float> line)
     {
         Path p;
@@ -2287,6 +3199,16 @@ public:
             renderImage (sourceImage, trans, {});
     }
 
+    static AffineTransform withoutTranslation (const AffineTransform& t) noexcept
+    {
+        return { t.mat00, t.mat01, 0.0f, t.mat10, t.mat11, 0.0f };
+    }
+
+    static AffineTransform getTranslation (const AffineTransform& t) noexcept
+    {
+        return AffineTransform::translation (t.getTranslationX(), t.getTranslationY());
+    }
+
     static bool isOnlyTranslationAllowingError (const AffineTransform& t, float tolerance) noexcept
     {
         return std::abs (t.mat01) < tolerance
@@ -2458,6 +3380,46 @@ public:
     static void clearGlyphCache()
     {
         GlyphCache::getInstance().reset();
+        GlyphAtlas::getInstance().reset();
+    }
+
+    bool drawGlyphFromAtlas (const Font& f, int glyphNumber, Point<float> position)
+    {
+        // The atlas is only used for solid colours, clipped to rectangles in a
+        // destination format that the masks can be blended into.
+        if (! fillType.isColour() || (image.getFormat() != Image::ARGB && image.getFormat() != Image::RGB))
+            return false;
+
+        const auto* rectangleListClip = dynamic_cast<const RectangleListRegionType*> (clip.get());
+
+        if (rectangleListClip == nullptr)
+            return false;
+
+        // The x position is rounded to the nearest sub-pixel position, and y is rounded
+        // to a whole pixel, as it is when filling the glyph's edge table.
+        const auto subPixelX = roundToInt (position.x * (float) GlyphAtlas::numSubPixelPositions);
+        const auto subPixelPosition = subPixelX & (GlyphAtlas::numSubPixelPositions - 1);
+        const Point origin ((subPixelX - subPixelPosition) / GlyphAtlas::numSubPixelPositions, roundToInt (position.y));
+
+        const auto mask = GlyphAtlas::getInstance().get (f, glyphNumber, subPixelPosition);
+
+        if (! mask.has_value())
+            return false;
+
+        const auto maskBounds = mask->area.withPosition (origin + mask->offset);
+
+        if (mask->area.isEmpty() || fillType.colour.isTransparent() || ! rectangleListClip->clip.intersects (maskBounds))
+            return true;
+
+        Image::BitmapData destData (image, Image::BitmapData::readWrite);
+        const auto colour = fillType.colour.getPixelARGB();
+
+        if (destData.pixelFormat == Image::ARGB)
+            blendGlyphMask ((PixelARGB*) nullptr, destData, *mask, maskBounds, rectangleListClip->clip, colour);
+        else
+            blendGlyphMask ((PixelRGB*) nullptr, destData, *mask, maskBounds, rectangleListClip->clip, colour);
+
+        return true;
     }
 
     //==============================================================================
@@ -2519,6 +3481,35 @@ public:
     Font font { FontOptions{} };
 
 private:
+    template <class DestPixelType>
+    static void blendGlyphMask (DestPixelType*, const Image::BitmapData& destData, const GlyphAtlas::Mask& mask,
+                                Rectangle<int> maskBounds, const RectangleList<int>& clipList, PixelARGB colour) noexcept
+    {
+        const auto useSpanFunctions = canUsePixelSpanFunctions ((DestPixelType*) nullptr, destData);
+
+        for (const auto& clipRect : clipList)
+        {
+            const auto area = clipRect.getIntersection (maskBounds);
+
+            for (int y = area.getY(); y < area.getBottom(); ++y)
+            {
+                auto* dest = destData.getPixelPointer (area.getX(), y);
+                auto* src = mask.getLinePointer (y - maskBounds.getY()) + (area.getX() - maskBounds.getX());
+
+                if (useSpanFunctions)
+                {
+                    PixelSpanFunctions::get().blendColourWithMask (dest, colour, src, area.getWidth(),
+                                                                   std::is_same_v<DestPixelType, PixelARGB>);
+                }
+                else
+                {
+                    for (int i = area.getWidth(); --i >= 0; dest += destData.pixelStride)
+                        reinterpret_cast<DestPixelType*> (dest)->blend (colour, (uint32) *src++ + 1);
+                }
+            }
+        }
+    }
+
     SoftwareRendererSavedState& operator= (const SoftwareRendererSavedState&) = delete;
 };
 
@@ -2613,6 +3604,7 @@ public:
     void fillRect (const Rectangle<float>& r)                                override { stack->fillRect (r); }
     void fillRectList (const RectangleList<float>& list)                     override { stack->fillRectList (list); }
     void fillPath (const Path& path, const AffineTransform& t)               override { stack->fillPath (path, t); }
+    void strokePath (const Path& path, const PathStrokeType& strokeType, const AffineTransform& t) override { stack->strokePath (path, strokeType, t); }
     void drawImage (const Image& im, const AffineTransform& t)               override { stack->drawImage (im, t); }
     void drawLine (const Line<float>& line)                                  override { stack->drawLine (line); }
     void setFont (const Font& newFont)                                       override { stack->font = newFont; }
@@ -2635,38 +3627,43 @@ protected:
         if (stack->clip == nullptr)
             return;
 
-        const auto [layers, drawPosition] = [&]
+        if (t.isOnlyTranslation() && ! stack->transform.isRotated)
         {
-            if (t.isOnlyTranslation() && ! stack->transform.isRotated)
+            const Point pos (t.getTranslationX(), t.getTranslationY());
+
+            if (this->stack->transform.isOnlyTranslated)
             {
-                auto& cache = RenderingHelpers::GlyphCache::getInstance();
-                const Point pos (t.getTranslationX(), t.getTranslationY());
+                drawCachedGlyph (stack->font, i, pos + stack->transform.offset.toFloat());
+                return;
+            }
 
-                if (this->stack->transform.isOnlyTranslated)
-                {
-                    const auto drawPos = pos + stack->transform.offset.toFloat();
-                    return std::tuple (cache.get (stack->font, i), drawPos);
-                }
+            auto f = stack->font;
+            f.setHeight (f.getHeight() * stack->transform.complexTransform.mat11);
 
-                auto f = stack->font;
-                f.setHeight (f.getHeight() * stack->transform.complexTransform.mat11);
+            auto xScale = stack->transform.complexTransform.mat00 / stack->transform.complexTransform.mat11;
 
-                auto xScale = stack->transform.complexTransform.mat00 / stack->transform.complexTransform.mat11;
+            if (std::abs (xScale - 1.0f) > 0.01f)
+                f.setHorizontalScale (xScale);
 
-                if (std::abs (xScale - 1.0f) > 0.01f)
-                    f.setHorizontalScale (xScale);
+            drawCachedGlyph (f, i, stack->transform.transformed (pos));
+            return;
+        }
 
-                const auto drawPos = stack->transform.transformed (pos);
-                return std::tuple (cache.get (f, i), drawPos);
-            }
+        const auto fontHeight = detail::FontRendering::getEffectiveHeight (stack->font);
+        const auto fontTransform = AffineTransform::scale (fontHeight * stack->font.getHorizontalScale(),
+                                                           fontHeight).followedBy (t);
+        const auto fullTransform = stack->transform.getTransformWith (fontTransform);
+        drawGlyphLayers (stack->font.getTypefacePtr()->getLayersForGlyph (stack->font.getMetricsKind(), i, fullTransform), {});
+    }
 
-            const auto fontHeight = detail::FontRendering::getEffectiveHeight (stack->font);
-            const auto fontTransform = AffineTransform::scale (fontHeight * stack->font.getHorizontalScale(),
-                                                               fontHeight).followedBy (t);
-            const auto fullTransform = stack->transform.getTransformWith (fontTransform);
-            return std::tuple (stack->font.getTypefacePtr()->getLayersForGlyph (stack->font.getMetricsKind(), i, fullTransform), Point<float>{});
-        }();
+    void drawCachedGlyph (const Font& f, uint16_t i, Point<float> drawPosition)
+    {
+        if (! stack->drawGlyphFromAtlas (f, i, drawPosition))
+            drawGlyphLayers (RenderingHelpers::GlyphCache::getInstance().get (f, i)->layers, drawPosition);
+    }
 
+    void drawGlyphLayers (const std::vector<GlyphLayer>& layers, Point<float> drawPosition)
+    {
         const auto initialFill = stack->fillType;
         const ScopeGuard scope { [&] { this->stack->setFillType (initialFill); } };
 
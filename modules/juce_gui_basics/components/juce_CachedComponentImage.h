@@ -76,6 +76,14 @@ public:
         any cached data should be released if possible.
     */
     virtual void releaseResources() = 0;
+
+    /** Returns true if the cached data remains valid when the component's alpha or
+        transform changes, so that the component can be drawn again at its new opacity
+        or position without being invalidated and repainted.
+
+        The default implementation returns false.
+    */
+    virtual bool canBeRecomposited() const      { return false; }
 };
 
 } // namespace juce
@@ -618,6 +618,33 @@ void Component::setBufferedToImage (bool shouldBeBuffered)
     }
 }
 
+void Component::setLayerMode (LayerMode newMode)
+{
+    // This assertion means that this component is already using a custom CachedComponentImage,
+    // which would be deleted here. If you really do want to replace it, call
+    // setCachedComponentImage (nullptr) before setLayerMode().
+    jassert (cachedImage == nullptr || dynamic_cast<detail::StandardCachedComponentImage*> (cachedImage.get()) != nullptr);
+
+    if (newMode == LayerMode::none)
+    {
+        cachedImage.reset();
+        return;
+    }
+
+    if (auto* layer = dynamic_cast<detail::StandardCachedComponentImage*> (cachedImage.get()))
+        layer->setMode (newMode);
+    else
+        cachedImage = std::make_unique<detail::StandardCachedComponentImage> (*this, newMode);
+}
+
+Component::LayerMode Component::getLayerMode() const noexcept
+{
+    if (auto* layer = dynamic_cast<detail::StandardCachedComponentImage*> (cachedImage.get()))
+        return layer->getMode();
+
+    return LayerMode::none;
+}
+
 void Component::invalidateCachedImageResources()
 {
     if (cachedImage != nullptr)
@@ -875,7 +902,7 @@ void Component::setBounds (int x, int y, int w, int h)
             else if (! flags.hasHeavyweightPeerFlag)
                 repaintParent();
         }
-        else if (cachedImage != nullptr)
+        else if (cachedImage != nullptr && (wasResized || ! cachedImage->canBeRecomposited()))
         {
             cachedImage->invalidateAll();
         }
@@ -1041,24 +1068,24 @@ void Component::setTransform (const AffineTransform& newTransform)
     {
         if (affineTransform != nullptr)
         {
-            repaint();
+            repaintForCompositingChange();
             affineTransform.reset();
-            repaint();
+            repaintForCompositingChange();
             sendMovedResizedMessages (false, false);
         }
     }
     else if (affineTransform == nullptr)
     {
-        repaint();
+        repaintForCompositingChange();
         affineTransform.reset (new AffineTransform (newTransform));
-        repaint();
+        repaintForCompositingChange();
         sendMovedResizedMessages (false, false);
     }
     else if (*affineTransform != newTransform)
     {
-        repaint();
+        repaintForCompositingChange();
         *affineTransform = newTransform;
-        repaint();
+        repaintForCompositingChange();
         sendMovedResizedMessages (false, false);
     }
 }
@@ -1617,7 +1644,7 @@ void Component::alphaChanged()
     }
     else
     {
-        repaint();
+        repaintForCompositingChange();
     }
 }
 
@@ -1643,6 +1670,21 @@ void Component::repaintParent()
         parentComponent->internalRepaint (detail::ComponentHelpers::convertToParentSpace (*this, getLocalBounds()));
 }
 
+// When only the way that the component is drawn into its parent has changed, a layer
+// can be redrawn without invalidating it, so only the parent needs to be repainted.
+void Component::repaintForCompositingChange()
+{
+    if (cachedImage != nullptr && cachedImage->canBeRecomposited() && ! flags.hasHeavyweightPeerFlag)
+    {
+        if (flags.visibleFlag)
+            repaintParent();
+    }
+    else
+    {
+        repaint();
+    }
+}
+
 void Component::internalRepaint (Rectangle<int> area)
 {
     area = area.getIntersection (getLocalBounds());
@@ -3522,6 +3564,101 @@ struct ComponentTests  : public UnitTest
             expectEquals (child1->numPaintCalls, 0);
             expectEquals (child2->numPaintCalls, 1);
         }
+
+        beginTest ("Moving, fading or transforming a layer doesn't repaint it");
+        {
+            const auto parent = std::make_unique<TestComponent>();
+            const auto child = std::make_unique<TestComponent>();
+
+            Rectangle<int> bounds { 0, 0, 100, 100 };
+            parent->setBounds (bounds);
+
+            child->setBounds (bounds.reduced (25));
+            child->setLayerMode (Component::LayerMode::always);
+            parent->addAndMakeVisible (*child);
+
+            expect (child->getLayerMode() == Component::LayerMode::always);
+
+            paintComponentBounds (*parent);
+            expectEquals (child->numPaintCalls, 1);
+
+            child->setTopLeftPosition (10, 10);
+            child->setAlpha (0.5f);
+            child->setTransform (AffineTransform::rotation (degreesToRadians (30.0f)));
+
+            paintComponentBounds (*parent);
+            expectEquals (parent->numPaintCalls, 2);
+            expectEquals (child->numPaintCalls, 1);
+
+            child->repaint();
+
+            paintComponentBounds (*parent);
+            expectEquals (child->numPaintCalls, 2);
+
+            child->setLayerMode (Component::LayerMode::none);
+            expect (child->getLayerMode() == Component::LayerMode::none);
+            expect (child->getCachedComponentImage() == nullptr);
+        }
+
+        beginTest ("Automatic layers are kept for components whose content doesn't change");
+        {
+            const auto parent = std::make_unique<TestComponent>();
+            const auto child = std::make_unique<TestComponent>();
+
+            Rectangle<int> bounds { 0, 0, 100, 100 };
+            parent->setBounds (bounds);
+
+            child->setBounds (bounds.reduced (25));
+            child->setLayerMode (Component::LayerMode::automatic);
+            parent->addAndMakeVisible (*child);
+
+            constexpr auto numFrames = 50;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                child->setTopLeftPosition (i % 10, 0);
+                paintComponentBounds (*parent);
+            }
+
+            expectEquals (parent->numPaintCalls, numFrames);
+            expect (child->numPaintCalls < 20);
+
+            // Once the content starts changing on every frame, the layer is dropped
+            const auto numPaintCallsBeforeAnimating = child->numPaintCalls;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                child->repaint();
+                paintComponentBounds (*parent);
+            }
+
+            expectEquals (child->numPaintCalls, numPaintCallsBeforeAnimating + numFrames);
+            expect (child->getLayerMode() == Component::LayerMode::automatic);
+        }
+
+        beginTest ("Automatic layers aren't created for components that are always repainted");
+        {
+            const auto parent = std::make_unique<TestComponent>();
+            const auto child = std::make_unique<TestComponent>();
+
+            Rectangle<int> bounds { 0, 0, 100, 100 };
+            parent->setBounds (bounds);
+
+            child->setBounds (bounds.reduced (25));
+            child->setLayerMode (Component::LayerMode::automatic);
+            parent->addAndMakeVisible (*child);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                child->repaint();
+                paintComponentBounds (*parent);
+            }
+
+            expectEquals (child->numPaintCalls, 50);
+
+            auto* layer = dynamic_cast<detail::StandardCachedComponentImage*> (child->getCachedComponentImage());
+            expect (layer != nullptr && ! layer->isPromoted());
+        }
     }
 };
 
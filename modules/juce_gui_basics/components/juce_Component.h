@@ -1141,10 +1141,45 @@ public:
         Parts of the buffer are invalidated when repaint() is called on this component
         or its children. The buffer is then repainted at the next paint() callback.
 
-        @see repaint, paint, createComponentSnapshot
+        This is equivalent to calling setLayerMode (LayerMode::always) or setLayerMode (LayerMode::none).
+
+        @see setLayerMode, repaint, paint, createComponentSnapshot
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
+    /** The ways in which a component can be given its own compositing layer.
+        @see setLayerMode
+    */
+    enum class LayerMode
+    {
+        none,       /**< The component is painted directly into its parent. */
+        automatic,  /**< The component keeps a layer only while it's being redrawn more often than its content changes. */
+        always      /**< The component always keeps a layer, as if setBufferedToImage (true) had been called. */
+    };
+
+    /** Gives the component a retained layer: an image containing the component and its
+        children, which is drawn into the parent in place of calling paint().
+
+        Moving the component, or changing its alpha or transform, only redraws the layer
+        at its new position or opacity, without calling paint() again. Repainting part of
+        the component or one of its children only repaints that part of the layer.
+
+        In automatic mode, the layer is only kept while it's saving work, which is when the
+        component is being redrawn repeatedly while its content stays the same, such as
+        the contents of a scrolling Viewport or an animated overlay. A component that
+        repaints itself on almost every frame is painted directly, so that it doesn't spend
+        memory and time on an image that is always out of date.
+
+        @see getLayerMode, setBufferedToImage
+    */
+    void setLayerMode (LayerMode newMode);
+
+    /** Returns the mode set by setLayerMode().
+        If the component has a custom CachedComponentImage, this returns LayerMode::none.
+        @see setLayerMode
+    */
+    LayerMode getLayerMode() const noexcept;
+
     /** Generates a snapshot of part of this component.
 
         This will return a new Image of type imageType, the size of the rectangle specified,
@@ -2738,6 +2773,7 @@ private:
     void sendMovedResizedMessages (bool wasMoved, bool wasResized);
     void sendMovedResizedMessagesIfPending();
     void repaintParent();
+    void repaintForCompositingChange();
     void sendFakeMouseMove() const;
     void takeKeyboardFocus (FocusChangeType, FocusChangeDirection);
     void grabKeyboardFocusInternal (FocusChangeType, bool canTryParent, FocusChangeDirection);
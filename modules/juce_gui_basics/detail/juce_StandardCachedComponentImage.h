@@ -37,13 +37,28 @@ namespace juce::detail
 
 struct StandardCachedComponentImage : public CachedComponentImage
 {
+    StandardCachedComponentImage (Component& c, Component::LayerMode m) noexcept
+        : owner (c), mode (m)
+    {
+        jassert (mode != Component::LayerMode::none);
+    }
+
     explicit StandardCachedComponentImage (Component& c) noexcept
-        : owner (c)
+        : StandardCachedComponentImage (c, Component::LayerMode::always)
     {
     }
 
     void paint (Graphics& g) override
     {
+        recordComposite();
+
+        if (! isPromoted())
+        {
+            image = Image();
+            owner.paintEntireComponent (g, false);
+            return;
+        }
+
         scale = g.getInternalContext().getPhysicalPixelScaleFactor();
         auto compBounds = owner.getLocalBounds();
         auto imageBounds = compBounds * scale;
@@ -96,16 +111,66 @@ struct StandardCachedComponentImage : public CachedComponentImage
                                                                (float) compBounds.getHeight() / (float) imageBounds.getHeight()), false);
     }
 
-    bool invalidateAll() override                            { validArea.clear(); return true; }
-    bool invalidate (const Rectangle<int>& area) override    { validArea.subtract (area); return true; }
+    bool invalidateAll() override                            { validArea.clear(); contentChanged = true; return true; }
+    bool invalidate (const Rectangle<int>& area) override    { validArea.subtract (area); contentChanged = true; return true; }
     void releaseResources() override                         { image = Image(); }
+    bool canBeRecomposited() const override                  { return true; }
+
+    //==============================================================================
+    Component::LayerMode getMode() const noexcept            { return mode; }
+
+    void setMode (Component::LayerMode newMode) noexcept
+    {
+        jassert (newMode != Component::LayerMode::none);
+        mode = newMode;
+    }
+
+    /*  In automatic mode, the image is only kept while it's saving work. That's the case
+        when the component keeps being drawn while its content stays the same, e.g. because
+        it's moving, fading, or its parent is being repainted around it. A component that
+        repaints itself almost every time it's drawn gains nothing from a layer, so its image
+        is released and it's painted directly.
+    */
+    bool isPromoted() const noexcept
+    {
+        return mode == Component::LayerMode::always || promoted;
+    }
 
 private:
+    static constexpr int historyLength = 16;
+    static constexpr int maxChangesForPromotion = 2;
+    static constexpr int minChangesForDemotion = 6;
+
+    void recordComposite() noexcept
+    {
+        changeHistory = (uint32) ((changeHistory << 1) | (contentChanged ? 1u : 0u)) & ((1u << historyLength) - 1);
+        numComposites = jmin (numComposites + 1, historyLength);
+        contentChanged = false;
+
+        if (mode != Component::LayerMode::automatic)
+            return;
+
+        // The demotion check only looks at the recent half of the history, so that a layer
+        // whose component starts animating its content is dropped quickly
+        const auto numChanges = countNumberOfBits (changeHistory);
+        const auto numRecentChanges = countNumberOfBits (changeHistory & ((1u << (historyLength / 2)) - 1));
+
+        if (promoted)
+            promoted = numRecentChanges < minChangesForDemotion;
+        else
+            promoted = numComposites == historyLength && numChanges <= maxChangesForPromotion;
+    }
+
     Image image;
     RectangleList<int> validArea;
     Component& owner;
+    Component::LayerMode mode;
     float scale = 1.0f;
 
+    uint32 changeHistory = 0;
+    int numComposites = 0;
+    bool contentChanged = true, promoted = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StandardCachedComponentImage)
 };
 
@@ -78,6 +78,16 @@
  #define JUCE_ENABLE_REPAINT_DEBUGGING 0
 #endif
 
+/** Config: JUCE_USE_TILED_SOFTWARE_RENDERER
+    If this option is turned on, the default LookAndFeel::createGraphicsContext() returns
+    a LowLevelGraphicsTiledSoftwareRenderer, which records each paint operation and then
+    renders it on several threads at once. The output is identical to the normal software
+    renderer, but large repaints will be faster on machines with multiple cores.
+*/
+#ifndef JUCE_USE_TILED_SOFTWARE_RENDERER
+ #define JUCE_USE_TILED_SOFTWARE_RENDERER 0
+#endif
+
 /** Config: JUCE_USE_XRANDR
     Enables Xrandr multi-monitor support (Linux only).
     Unless you specifically want to disable this, it's best to leave this option turned on.
@@ -180,7 +180,11 @@ std::unique_ptr<LowLevelGraphicsContext> LookAndFeel::createGraphicsContext (con
                                                                              Point<int> origin,
                                                                              const RectangleList<int>& initialClip)
 {
+   #if JUCE_USE_TILED_SOFTWARE_RENDERER
+    return std::make_unique<LowLevelGraphicsTiledSoftwareRenderer> (imageToRenderOn, origin, initialClip);
+   #else
     return std::make_unique<LowLevelGraphicsSoftwareRenderer> (imageToRenderOn, origin, initialClip);
+   #endif
 }
 
 //==============================================================================
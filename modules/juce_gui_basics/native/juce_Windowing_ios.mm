@@ -338,6 +338,8 @@ API_AVAILABLE (ios (13.0))
 {
     ignoreUnused (application);
 
+    ImageCache::handleMemoryPressure (ImageCache::MemoryPressure::critical);
+
     if (auto* app = JUCEApplicationBase::getInstance())
         app->memoryWarningReceived();
 }
@@ -35,9 +35,286 @@
 namespace juce
 {
 
+//==============================================================================
+/*
+    Decides which windows take part in each frame, and runs the frames.
+
+    This doesn't start any frames by itself, so that its timing can be tested without a
+    display. LinuxFrameScheduler calls runFrame() from a timer.
+*/
+class LinuxFrameSchedule
+{
+public:
+    LinuxFrameSchedule() = default;
+
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        /** Called at the start of each frame, before any of the windows are painted. */
+        virtual void updateForFrame (double timestampSec) = 0;
+
+        /** Called after all the clients have been updated, to paint the frame. */
+        virtual void paintFrame() = 0;
+    };
+
+    void setFrameRate (Client& client, int frequencyHz)
+    {
+        jassert (frequencyHz > 0);
+
+        const auto intervalMs = 1000.0 / frequencyHz;
+
+        if (auto* entry = findEntry (&client))
+            entry->intervalMs = intervalMs;
+        else
+            entries.push_back ({ &client, intervalMs, 0.0 });
+
+        updateTickInterval();
+    }
+
+    void removeClient (Client& client)
+    {
+        if (auto* entry = findEntry (&client))
+        {
+            // Entries are only erased between frames, so that a frame can carry on safely if
+            // one of its callbacks deletes a window
+            entry->client = nullptr;
+
+            if (! isRunningFrame)
+                removeDeletedEntries();
+        }
+
+        updateTickInterval();
+    }
+
+    /** Returns the rate at which runFrame() should be called, which is the frame rate of the
+        fastest client, or 0 if there aren't any clients.
+    */
+    int getTickFrequencyHz() const noexcept     { return tickFrequencyHz; }
+
+    /** Updates and then paints all the clients whose next frame is due at the given time. */
+    void runFrame (double nowMs)
+    {
+        const ScopedValueSetter<bool> frameScope (isRunningFrame, true);
+
+       #if JUCE_LINUX_REPAINT_METRICS
+        const auto frameStart = metrics.getTimes();
+       #endif
+
+        clientsToPaint.clear();
+
+        // The vector can grow while the callbacks run, so the entries are accessed by index
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            auto& entry = entries[i];
+
+            // A client is due if its next frame starts nearer to this tick than the next one
+            if (entry.client == nullptr || entry.nextFrameTimeMs > nowMs + tickIntervalMs * 0.5)
+                continue;
+
+            // Keep to the client's own frame rate, unless it has fallen more than a frame behind
+            entry.nextFrameTimeMs = nowMs - entry.nextFrameTimeMs > entry.intervalMs ? nowMs + entry.intervalMs
+                                                                                     : entry.nextFrameTimeMs + entry.intervalMs;
+
+            auto* client = entry.client;
+            clientsToPaint.push_back (client);
+            client->updateForFrame (nowMs / 1000.0);
+        }
+
+       #if JUCE_LINUX_REPAINT_METRICS
+        const auto paintStart = metrics.getTimes();
+       #endif
+
+        for (auto* client : clientsToPaint)
+            if (findEntry (client) != nullptr)
+                client->paintFrame();
+
+        removeDeletedEntries();
+
+       #if JUCE_LINUX_REPAINT_METRICS
+        metrics.addFrame (frameStart, paintStart, tickIntervalMs);
+       #endif
+    }
+
+private:
+    struct Entry
+    {
+        Client* client;
+        double intervalMs, nextFrameTimeMs;
+    };
+
+    Entry* findEntry (const Client* client)
+    {
+        const auto iter = std::find_if (entries.begin(), entries.end(), [client] (const auto& e) { return e.client == client; });
+        return iter != entries.end() ? &*iter : nullptr;
+    }
+
+    void removeDeletedEntries()
+    {
+        entries.erase (std::remove_if (entries.begin(), entries.end(), [] (const auto& e) { return e.client == nullptr; }),
+                       entries.end());
+    }
+
+    void updateTickInterval()
+    {
+        tickFrequencyHz = 0;
+
+        for (const auto& e : entries)
+            if (e.client != nullptr)
+                tickFrequencyHz = jmax (tickFrequencyHz, roundToInt (1000.0 / e.intervalMs));
+
+        if (tickFrequencyHz > 0)
+            tickIntervalMs = 1000.0 / tickFrequencyHz;
+    }
+
+   #if JUCE_LINUX_REPAINT_METRICS
+    // Build with JUCE_LINUX_REPAINT_METRICS=1 to log a summary of the time spent in each frame
+    struct Metrics
+    {
+        struct Times
+        {
+            double wallMs, cpuMs;
+        };
+
+        static Times getTimes()
+        {
+            timespec cpuTime{};
+            clock_gettime (CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+
+            return { Time::getMillisecondCounterHiRes(),
+                     (double) cpuTime.tv_sec * 1000.0 + (double) cpuTime.tv_nsec / 1.0e6 };
+        }
+
+        void addFrame (Times frameStart, Times paintStart, double budgetMs)
+        {
+            const auto frameEnd = getTimes();
+
+            updateDuration.addValue (paintStart.wallMs - frameStart.wallMs);
+            paintDuration.addValue (frameEnd.wallMs - paintStart.wallMs);
+            cpuDuration.addValue (frameEnd.cpuMs - frameStart.cpuMs);
+
+            if (frameEnd.wallMs - frameStart.wallMs > budgetMs)
+                ++numFramesOverBudget;
+
+            if (cpuDuration.getCount() >= 200)
+            {
+                Logger::writeToLog ("Linux frame metrics: "
+                                      "budget " + String (budgetMs, 2) + "ms"
+                                    + ", update " + toString (updateDuration)
+                                    + ", paint " + toString (paintDuration)
+                                    + ", CPU " + toString (cpuDuration)
+                                    + ", frames over budget " + String (numFramesOverBudget)
+                                    + "/" + String (cpuDuration.getCount()));
+
+                *this = {};
+            }
+        }
+
+        static String toString (const StatisticsAccumulator<double>& s)
+        {
+            return String (s.getAverage(), 2) + "ms (max " + String (s.getMaxValue(), 2) + "ms)";
+        }
+
+        StatisticsAccumulator<double> updateDuration, paintDuration, cpuDuration;
+        int numFramesOverBudget = 0;
+    };
+
+    Metrics metrics;
+   #endif
+
+    std::vector<Entry> entries;
+    std::vector<Client*> clientsToPaint;
+    double tickIntervalMs = 0.0;
+    int tickFrequencyHz = 0;
+    bool isRunningFrame = false;
+
+    JUCE_DECLARE_NON_COPYABLE (LinuxFrameSchedule)
+};
+
+//==============================================================================
+/*
+    Drives the frames of all the windows from a single timer.
+
+    There's no vblank notification on Linux that we can use, so frames are started by a timer
+    running at the refresh rate of the fastest display that has a window on it. Each frame calls
+    the vblank listeners (e.g. animators and VBlankAttachments) of all the windows that are due,
+    and then repaints those windows, so that any changes that the listeners make to other windows
+    are painted in the same frame, rather than each window painting on its own schedule.
+*/
+class LinuxFrameScheduler final : public DeletedAtShutdown
+{
+public:
+    using Client = LinuxFrameSchedule::Client;
+
+    void setFrameRate (Client& client, int frequencyHz)
+    {
+        schedule.setFrameRate (client, frequencyHz);
+        updateTimer();
+    }
+
+    void removeClient (Client& client)
+    {
+        schedule.removeClient (client);
+        updateTimer();
+    }
+
+    JUCE_DECLARE_SINGLETON_SINGLETHREADED_INLINE (LinuxFrameScheduler, false)
+
+private:
+    LinuxFrameScheduler() = default;
+
+    ~LinuxFrameScheduler() override
+    {
+        clearSingletonInstance();
+    }
+
+    void updateTimer()
+    {
+        const auto frequencyHz = schedule.getTickFrequencyHz();
+
+        if (frequencyHz == 0)
+            clock.stopTimer();
+        else if (clock.getTimerInterval() != 1000 / frequencyHz)
+            clock.startTimerHz (frequencyHz);
+    }
+
+    LinuxFrameSchedule schedule;
+    TimedCallback clock { [this] { schedule.runFrame (Time::getMillisecondCounterHiRes()); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinuxFrameScheduler)
+    JUCE_DECLARE_NON_MOVEABLE (LinuxFrameScheduler)
+};
+
+//==============================================================================
+namespace LinuxRepaintHelpers
+{
+    static constexpr int maxRectanglesPerFrame = 16;
+
+    // Merges the pending areas into a short list of rectangles. If they cover most of their
+    // bounds, it's cheaper to paint and send the bounding box as a single rectangle.
+    static RectangleList<int> getAreaToRepaint (RectangleList<int> region, Rectangle<int> windowArea)
+    {
+        region.clipTo (windowArea);
+        region.consolidate();
+
+        const auto bounds = region.getBounds();
+        int64 coveredArea = 0;
+
+        for (auto& r : region)
+            coveredArea += (int64) r.getWidth() * r.getHeight();
+
+        if (region.getNumRectangles() > maxRectanglesPerFrame
+             || coveredArea * 4 >= (int64) bounds.getWidth() * bounds.getHeight() * 3)
+            return RectangleList<int> (bounds);
+
+        return region;
+    }
+}
+
 //==============================================================================
 class LinuxComponentPeer final : public ComponentPeer,
-                                 private XWindowSystemUtilities::XSettings::Listener
+                                 private XWindowSystemUtilities::XSettings::Listener,
+                                 private LinuxFrameScheduler::Client
 {
 public:
     LinuxComponentPeer (Component& comp, int windowStyleFlags, ::Window parentToAddTo)
@@ -67,7 +344,7 @@ public:
 
         getNativeRealtimeModifiers = []() -> ModifierKeys { return XWindowSystem::getInstance()->getNativeRealtimeModifiers(); };
 
-        updateVBlankTimer();
+        updateFrameRate();
     }
 
     ~LinuxComponentPeer() override
@@ -75,6 +352,9 @@ public:
         // it's dangerous to delete a window on a thread other than the message thread
         JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
 
+        if (auto* scheduler = LinuxFrameScheduler::getInstanceWithoutCreating())
+            scheduler->removeClient (*this);
+
         auto* instance = XWindowSystem::getInstance();
 
         repainter = nullptr;
@@ -388,7 +668,7 @@ public:
         bounds = parentWindow == 0 ? Desktop::getInstance().getDisplays().physicalToLogical (physicalBounds)
                                    : physicalBounds / currentScaleFactor;
 
-        updateVBlankTimer();
+        updateFrameRate();
     }
 
     void updateBorderSize()
@@ -444,13 +724,8 @@ private:
         {
             XWindowSystem::getInstance()->processPendingPaintsForWindow (peer.windowH);
 
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
-                return;
-
             if (! regionsNeedingRepaint.isEmpty())
                 performAnyPendingRepaintsNow();
-            else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
-                image = Image();
         }
 
         void repaint (Rectangle<int> area)
@@ -460,68 +735,163 @@ private:
 
         void performAnyPendingRepaintsNow()
         {
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
+            // With shared memory, the server reads from a back buffer until it sends a completion
+            // event, so we can only start a frame while there's a buffer that isn't in use.
+            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) >= numBackBuffers)
+            {
+               #if JUCE_LINUX_REPAINT_METRICS
+                ++metrics.numDeferredFrames;
+               #endif
+
                 return;
+            }
 
-            auto originalRepaintRegion = regionsNeedingRepaint;
-            regionsNeedingRepaint.clear();
-            auto totalArea = originalRepaintRegion.getBounds();
+            const auto windowArea = peer.bounds.withZeroOrigin() * peer.currentScaleFactor;
+            auto region = LinuxRepaintHelpers::getAreaToRepaint (std::exchange (regionsNeedingRepaint, {}), windowArea);
+
+            if (region.isEmpty())
+                return;
+
+           #if JUCE_LINUX_REPAINT_METRICS
+            const auto frameStartTicks = Time::getHighResolutionTicks();
+           #endif
+
+            auto& image = getBackBuffer (windowArea.getUnion (region.getBounds()));
+
+            if (XWindowSystem::getInstance()->canUseARGBImages())
+                for (auto& i : region)
+                    image.clear (i);
 
-            if (! totalArea.isEmpty())
             {
-                const auto wasImageNull = image.isNull();
+                auto context = peer.getComponent().getLookAndFeel()
+                                 .createGraphicsContext (image, {}, region);
 
-                if (wasImageNull || image.getWidth() < totalArea.getWidth()
-                     || image.getHeight() < totalArea.getHeight())
-                {
-                    image = XWindowSystem::getInstance()->createImage (isSemiTransparentWindow,
-                                                                       totalArea.getWidth(), totalArea.getHeight(),
+                context->addTransform (AffineTransform::scale ((float) peer.currentScaleFactor));
+                peer.handlePaint (*context);
+            }
+
+           #if JUCE_LINUX_REPAINT_METRICS
+            const auto blitStartTicks = Time::getHighResolutionTicks();
+           #endif
+
+            XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, region);
+            nextBackBuffer = (nextBackBuffer + 1) % numBackBuffers;
+
+           #if JUCE_LINUX_REPAINT_METRICS
+            metrics.addFrame (frameStartTicks, blitStartTicks, region);
+           #endif
+        }
+
+    private:
+        // The back buffers cover the whole window, in physical pixels, so they only need to be
+        // reallocated when the window grows, or when it becomes much smaller than the buffers.
+        Image& getBackBuffer (Rectangle<int> windowArea)
+        {
+            auto* image = &backBuffers[(size_t) nextBackBuffer];
+
+            if (image->isValid()
+                 && image->getWidth() >= windowArea.getRight() && image->getHeight() >= windowArea.getBottom()
+                 && (int64) image->getWidth() * image->getHeight() <= (int64) windowArea.getRight() * windowArea.getBottom() * 4)
+            {
+                return *image;
+            }
+
+            auto newImage = XWindowSystem::getInstance()->createImage (isSemiTransparentWindow,
+                                                                       windowArea.getRight(), windowArea.getBottom(),
                                                                        useARGBImagesForRendering);
-                    if (wasImageNull)
-                    {
-                        // After calling createImage() XWindowSystem::getWindowBounds() will return
-                        // changed coordinates that look like the result of some position
-                        // defaulting mechanism. If we handle a configureNotifyEvent after
-                        // createImage() and before we would issue new, valid coordinates, we will
-                        // apply these default, unwanted coordinates to our window. To avoid that
-                        // we immediately send another positioning message to guarantee that the
-                        // next configureNotifyEvent will read valid values.
-                        //
-                        // This issue only occurs right after peer creation, when the image is
-                        // null. Updating when only the width or height is changed would lead to
-                        // incorrect behaviour.
-                        peer.forceSetBounds (detail::ScalingHelpers::scaledScreenPosToUnscaled (peer.component, peer.component.getBoundsInParent()),
-                                             peer.isFullScreen());
-                    }
-                }
 
-                RectangleList<int> adjustedList (originalRepaintRegion);
-                adjustedList.offsetAll (-totalArea.getX(), -totalArea.getY());
+           #if JUCE_LINUX_REPAINT_METRICS
+            ++metrics.numBufferAllocations;
+           #endif
 
-                if (XWindowSystem::getInstance()->canUseARGBImages())
-                    for (auto& i : originalRepaintRegion)
-                        image.clear (i - totalArea.getPosition());
+            // Only double-buffer when the server reads the image asynchronously
+            numBackBuffers = XWindowSystem::getInstance()->isSharedMemoryImage (newImage) ? 2 : 1;
 
-                {
-                    auto context = peer.getComponent().getLookAndFeel()
-                                     .createGraphicsContext (image, -totalArea.getPosition(), adjustedList);
+            if (nextBackBuffer >= numBackBuffers)
+            {
+                *image = {};
+                nextBackBuffer = 0;
+                image = &backBuffers[0];
+            }
 
-                    context->addTransform (AffineTransform::scale ((float) peer.currentScaleFactor));
-                    peer.handlePaint (*context);
-                }
+            *image = std::move (newImage);
 
-                for (auto& i : originalRepaintRegion)
-                   XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, i, totalArea);
+            if (! hasCreatedBackBuffer)
+            {
+                hasCreatedBackBuffer = true;
+
+                // After calling createImage() XWindowSystem::getWindowBounds() will return
+                // changed coordinates that look like the result of some position
+                // defaulting mechanism. If we handle a configureNotifyEvent after
+                // createImage() and before we would issue new, valid coordinates, we will
+                // apply these default, unwanted coordinates to our window. To avoid that
+                // we immediately send another positioning message to guarantee that the
+                // next configureNotifyEvent will read valid values.
+                //
+                // This issue only occurs right after peer creation, when the image is
+                // null. Updating when only the width or height is changed would lead to
+                // incorrect behaviour.
+                peer.forceSetBounds (detail::ScalingHelpers::scaledScreenPosToUnscaled (peer.component, peer.component.getBoundsInParent()),
+                                     peer.isFullScreen());
             }
 
-            lastTimeImageUsed = Time::getApproximateMillisecondCounter();
+            return *image;
         }
 
-    private:
+       #if JUCE_LINUX_REPAINT_METRICS
+        // Build with JUCE_LINUX_REPAINT_METRICS=1 to log a summary of the frame times for each window
+        struct Metrics
+        {
+            void addFrame (int64 frameStartTicks, int64 blitStartTicks, const RectangleList<int>& region)
+            {
+                const auto now = Time::getHighResolutionTicks();
+
+                if (lastFrameStartTicks != 0)
+                    frameInterval.addValue (ticksToMs (frameStartTicks - lastFrameStartTicks));
+
+                lastFrameStartTicks = frameStartTicks;
+                paintDuration.addValue (ticksToMs (blitStartTicks - frameStartTicks));
+                blitDuration.addValue (ticksToMs (now - blitStartTicks));
+                numRectangles.addValue (region.getNumRectangles());
+
+                for (auto& r : region)
+                    numPixels += (int64) r.getWidth() * r.getHeight();
+
+                if (paintDuration.getCount() >= 200)
+                {
+                    Logger::writeToLog ("Linux repaint metrics: "
+                                          "frame interval " + toString (frameInterval)
+                                        + ", paint " + toString (paintDuration)
+                                        + ", blit " + toString (blitDuration)
+                                        + ", rectangles/frame " + String (numRectangles.getAverage(), 1)
+                                        + ", Mpixels/frame " + String ((double) numPixels / 1.0e6 / (double) paintDuration.getCount(), 2)
+                                        + ", deferred frames " + String (numDeferredFrames)
+                                        + ", buffer allocations " + String (numBufferAllocations));
+
+                    *this = {};
+                }
+            }
+
+            static double ticksToMs (int64 ticks)       { return Time::highResolutionTicksToSeconds (ticks) * 1000.0; }
+
+            static String toString (const StatisticsAccumulator<double>& s)
+            {
+                return String (s.getAverage(), 2) + "ms (max " + String (s.getMaxValue(), 2) + "ms)";
+            }
+
+            StatisticsAccumulator<double> frameInterval, paintDuration, blitDuration, numRectangles;
+            int64 lastFrameStartTicks = 0, numPixels = 0;
+            int numDeferredFrames = 0, numBufferAllocations = 0;
+        };
+
+        Metrics metrics;
+       #endif
+
         LinuxComponentPeer& peer;
         const bool isSemiTransparentWindow;
-        Image image;
-        uint32 lastTimeImageUsed = 0;
+        std::array<Image, 2> backBuffers;
+        int numBackBuffers = 1, nextBackBuffer = 0;
+        bool hasCreatedBackBuffer = false;
         RectangleList<int> regionsNeedingRepaint;
 
         bool useARGBImagesForRendering = XWindowSystem::getInstance()->canUseARGBImages();
@@ -571,32 +941,32 @@ private:
         }
     }
 
-    void onVBlank()
+    void updateForFrame (double timestampSec) override
     {
-        const auto timestampSec = Time::getMillisecondCounterHiRes() / 1000.0;
         callVBlankListeners (timestampSec);
+    }
 
+    void paintFrame() override
+    {
         if (repainter != nullptr)
             repainter->dispatchDeferredRepaints();
     }
 
-    void updateVBlankTimer()
+    void updateFrameRate()
     {
         if (auto* display = Desktop::getInstance().getDisplays().getDisplayForRect (bounds))
         {
             // Some systems fail to set an explicit refresh rate, or ask for a refresh rate of 0
             // (observed on Raspbian Bullseye over VNC). In these situations, use a fallback value.
             const auto newIntFrequencyHz = roundToInt (display->verticalFrequencyHz.value_or (0.0));
-            const auto frequencyToUse = newIntFrequencyHz != 0 ? newIntFrequencyHz : 100;
+            const auto frequencyToUse = newIntFrequencyHz > 0 ? newIntFrequencyHz : 100;
 
-            if (vBlankManager.getTimerInterval() != frequencyToUse)
-                vBlankManager.startTimerHz (frequencyToUse);
+            LinuxFrameScheduler::getInstance()->setFrameRate (*this, frequencyToUse);
         }
     }
 
     //==============================================================================
     std::unique_ptr<LinuxRepaintManager> repainter;
-    TimedCallback vBlankManager { [this]() { onVBlank(); } };
 
     ::Window windowH = {}, parentWindow = {};
     Rectangle<int> bounds;
@@ -873,4 +1243,289 @@ void juce_LinuxRemoveRepaintListener (ComponentPeer* peer, Component* dummy)
         linuxPeer->removeOpenGLRepaintListener (dummy);
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LinuxFrameScheduleTests final : public UnitTest
+{
+public:
+    LinuxFrameScheduleTests()
+        : UnitTest ("LinuxFrameSchedule", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("The schedule ticks at the rate of the fastest client");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient a { log, "a" }, b { log, "b" };
+
+            expectEquals (schedule.getTickFrequencyHz(), 0);
+
+            schedule.setFrameRate (a, 60);
+            expectEquals (schedule.getTickFrequencyHz(), 60);
+
+            schedule.setFrameRate (b, 144);
+            expectEquals (schedule.getTickFrequencyHz(), 144);
+
+            schedule.setFrameRate (b, 30);
+            expectEquals (schedule.getTickFrequencyHz(), 60);
+
+            schedule.removeClient (a);
+            expectEquals (schedule.getTickFrequencyHz(), 30);
+
+            schedule.removeClient (b);
+            expectEquals (schedule.getTickFrequencyHz(), 0);
+        }
+
+        beginTest ("Each client keeps to its own frame rate on a shared tick");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient fast { log, "fast" }, slow { log, "slow" };
+            schedule.setFrameRate (fast, 120);
+            schedule.setFrameRate (slow, 60);
+
+            auto random = getRandom();
+
+            // Timer callbacks are never exactly on time, so each tick is up to 2ms early or late
+            for (int tick = 0; tick < 120; ++tick)
+                schedule.runFrame (1000.0 + tick * 1000.0 / 120.0 + (random.nextDouble() - 0.5) * 4.0);
+
+            expectEquals (fast.numFrames, 120);
+            expectEquals (slow.numFrames, 60);
+        }
+
+        beginTest ("A client that falls behind skips the missed frames instead of catching up");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient a { log, "a" };
+            schedule.setFrameRate (a, 60);
+
+            schedule.runFrame (1000.0);
+            expectEquals (a.numFrames, 1);
+
+            // A stall of several frames is followed by ticks in quick succession
+            for (auto nowMs : { 1100.0, 1101.0, 1102.0, 1105.0 })
+                schedule.runFrame (nowMs);
+
+            expectEquals (a.numFrames, 2);
+
+            // The client's frames carry on from the end of the stall
+            schedule.runFrame (1100.0 + 1000.0 / 60.0);
+            expectEquals (a.numFrames, 3);
+            expectEquals (a.lastTimestampSec, (1100.0 + 1000.0 / 60.0) / 1000.0);
+        }
+
+        beginTest ("All the clients are updated before any of them are painted");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient a { log, "a" }, b { log, "b" };
+            schedule.setFrameRate (a, 60);
+            schedule.setFrameRate (b, 60);
+
+            // A change that a's update makes to b is painted in the same frame
+            a.onUpdate = [&] { b.repaint(); };
+
+            schedule.runFrame (1000.0);
+            expect (log == Log { "update a", "update b", "paint a (0)", "paint b (1)" });
+        }
+
+        beginTest ("Only the clients that are due take part in a frame");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient fast { log, "fast" }, slow { log, "slow" };
+            schedule.setFrameRate (fast, 120);
+            schedule.setFrameRate (slow, 60);
+
+            schedule.runFrame (1000.0);
+            log.clear();
+
+            schedule.runFrame (1000.0 + 1000.0 / 120.0);
+            expect (log == Log { "update fast", "paint fast (0)" });
+        }
+
+        beginTest ("A client that's removed during a frame isn't updated or painted");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient a { log, "a" }, b { log, "b" }, c { log, "c" };
+            schedule.setFrameRate (a, 60);
+            schedule.setFrameRate (b, 60);
+            schedule.setFrameRate (c, 60);
+
+            // b removes a client that has already been updated, and one that hasn't
+            b.onUpdate = [&] { schedule.removeClient (a); schedule.removeClient (c); };
+
+            schedule.runFrame (1000.0);
+            expect (log == Log { "update a", "update b", "paint b (0)" });
+            expectEquals (schedule.getTickFrequencyHz(), 60);
+
+            log.clear();
+            schedule.runFrame (1000.0 + 1000.0 / 60.0);
+            expect (log == Log { "update b", "paint b (0)" });
+        }
+
+        beginTest ("A client that's added during a frame takes part straight away");
+        {
+            LinuxFrameSchedule schedule;
+            Log log;
+            TestClient a { log, "a" }, b { log, "b" };
+            schedule.setFrameRate (a, 60);
+
+            a.onUpdate = [&] { schedule.setFrameRate (b, 60); };
+
+            schedule.runFrame (1000.0);
+            expect (log == Log { "update a", "update b", "paint a (0)", "paint b (0)" });
+        }
+    }
+
+private:
+    using Log = std::vector<String>;
+
+    struct TestClient final : public LinuxFrameSchedule::Client
+    {
+        TestClient (Log& l, const String& n)  : log (l), name (n) {}
+
+        void updateForFrame (double timestampSec) override
+        {
+            ++numFrames;
+            lastTimestampSec = timestampSec;
+            log.push_back ("update " + name);
+            NullCheckedInvocation::invoke (onUpdate);
+        }
+
+        void paintFrame() override
+        {
+            log.push_back ("paint " + name + " (" + String (std::exchange (numRepaints, 0)) + ")");
+        }
+
+        void repaint()  { ++numRepaints; }
+
+        Log& log;
+        const String name;
+        std::function<void()> onUpdate;
+        int numFrames = 0, numRepaints = 0;
+        double lastTimestampSec = 0.0;
+    };
+};
+
+static LinuxFrameScheduleTests linuxFrameScheduleTests;
+
+//==============================================================================
+class LinuxRepaintRegionTests final : public UnitTest
+{
+public:
+    LinuxRepaintRegionTests()
+        : UnitTest ("Linux repaint region", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        using namespace LinuxRepaintHelpers;
+
+        const Rectangle<int> windowArea { 0, 0, 200, 100 };
+
+        beginTest ("Nothing is painted when there's nothing to repaint");
+        {
+            expect (getAreaToRepaint ({}, windowArea).isEmpty());
+            expect (getAreaToRepaint (createRegion ({ { 300, 0, 10, 10 } }), windowArea).isEmpty());
+        }
+
+        beginTest ("Areas are clipped to the window");
+        {
+            const auto result = getAreaToRepaint (createRegion ({ { -10, -10, 30, 30 }, { 190, 90, 30, 30 } }), windowArea);
+            expect (haveSameRectangles (result, createRegion ({ { 0, 0, 20, 20 }, { 190, 90, 10, 10 } })));
+        }
+
+        beginTest ("Areas that are far apart are painted separately");
+        {
+            const auto areas = createRegion ({ { 0, 0, 10, 10 }, { 100, 50, 10, 10 }, { 190, 90, 10, 10 } });
+            const auto result = getAreaToRepaint (areas, windowArea);
+            expect (haveSameRectangles (result, areas));
+        }
+
+        beginTest ("Areas that touch are merged");
+        {
+            const auto result = getAreaToRepaint (createRegion ({ { 0, 0, 10, 10 }, { 10, 0, 10, 10 }, { 0, 10, 20, 10 } }), windowArea);
+            expectEquals (result.getNumRectangles(), 1);
+            expect (result.getBounds() == Rectangle<int> (0, 0, 20, 20));
+        }
+
+        beginTest ("Areas that cover most of their bounds are painted as the bounds");
+        {
+            // These cover 89% of their bounds
+            const auto result = getAreaToRepaint (createRegion ({ { 0, 0, 100, 40 }, { 0, 50, 100, 40 } }), windowArea);
+            expect (haveSameRectangles (result, createRegion ({ { 0, 0, 100, 90 } })));
+
+            // These cover 70% of their bounds
+            const auto areas = createRegion ({ { 0, 0, 100, 35 }, { 0, 65, 100, 35 } });
+            expect (haveSameRectangles (getAreaToRepaint (areas, windowArea), areas));
+        }
+
+        beginTest ("Too many separate areas are painted as their bounds");
+        {
+            RectangleList<int> areas;
+
+            for (int i = 0; i < maxRectanglesPerFrame; ++i)
+                areas.add ({ i * 12, (i % 2) * 50, 10, 10 });
+
+            expect (haveSameRectangles (getAreaToRepaint (areas, windowArea), areas));
+
+            areas.add ({ 195, 95, 5, 5 });
+            expect (haveSameRectangles (getAreaToRepaint (areas, windowArea), createRegion ({ areas.getBounds() })));
+        }
+
+        beginTest ("The result always covers everything that needs repainting");
+        {
+            auto random = getRandom();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                RectangleList<int> areas;
+
+                for (int j = random.nextInt (30); --j >= 0;)
+                    areas.add ({ random.nextInt (250) - 25, random.nextInt (150) - 25, random.nextInt (40) + 1, random.nextInt (40) + 1 });
+
+                const auto result = getAreaToRepaint (areas, windowArea);
+
+                expect (result.getNumRectangles() <= maxRectanglesPerFrame);
+                expect (windowArea.contains (result.getBounds()) || result.isEmpty());
+
+                auto clipped = areas;
+                clipped.clipTo (windowArea);
+                clipped.subtract (result);
+                expect (clipped.isEmpty());
+            }
+        }
+    }
+
+private:
+    static bool haveSameRectangles (const RectangleList<int>& a, const RectangleList<int>& b)
+    {
+        return a.getNumRectangles() == b.getNumRectangles()
+                && std::all_of (a.begin(), a.end(), [&b] (const auto& r) { return std::find (b.begin(), b.end(), r) != b.end(); });
+    }
+
+    static RectangleList<int> createRegion (std::initializer_list<Rectangle<int>> rectangles)
+    {
+        RectangleList<int> result;
+
+        for (auto& r : rectangles)
+            result.add (r);
+
+        return result;
+    }
+};
+
+static LinuxRepaintRegionTests linuxRepaintRegionTests;
+
+#endif
+
 } // namespace juce
@@ -1022,8 +1022,16 @@ public:
 
     std::unique_ptr<ImageType> createType() const override     { return std::make_unique<NativeImageType>(); }
 
-    void blitToWindow (::Window window, int dx, int dy, unsigned int dw, unsigned int dh, int sx, int sy)
+    // Sends all of the areas in a single batch. When using shared memory, only the last request
+    // asks for a completion event, so the whole batch counts as a single pending paint.
+    void blitToWindow (::Window window, const RectangleList<int>& areas)
     {
+        auto clippedAreas = areas;
+        clippedAreas.clipTo (Rectangle<int> (width, height));
+
+        if (clippedAreas.isEmpty())
+            return;
+
         XWindowSystemUtilities::ScopedXLock xLock;
 
        #if JUCE_USE_XSHM
@@ -1046,44 +1054,26 @@ public:
                                                        &gcvalues);
         }
 
-        if (imageDepth == 16)
-        {
-            auto rMask   = (uint32) xImage->red_mask;
-            auto gMask   = (uint32) xImage->green_mask;
-            auto bMask   = (uint32) xImage->blue_mask;
-            auto rShiftL = (uint32) jmax (0,  getShiftNeeded (rMask));
-            auto rShiftR = (uint32) jmax (0, -getShiftNeeded (rMask));
-            auto gShiftL = (uint32) jmax (0,  getShiftNeeded (gMask));
-            auto gShiftR = (uint32) jmax (0, -getShiftNeeded (gMask));
-            auto bShiftL = (uint32) jmax (0,  getShiftNeeded (bMask));
-            auto bShiftR = (uint32) jmax (0, -getShiftNeeded (bMask));
+        const auto numAreas = clippedAreas.getNumRectangles();
 
-            Image::BitmapData srcData (Image (this), Image::BitmapData::readOnly);
+        for (int i = 0; i < numAreas; ++i)
+        {
+            const auto area = clippedAreas.getRectangle (i);
 
-            for (int y = sy; y < sy + (int) dh; ++y)
-            {
-                auto* p = srcData.getPixelPointer (sx, y);
+            if (imageDepth == 16)
+                convertTo16Bit (area);
 
-                for (int x = sx; x < sx + (int) dw; ++x)
-                {
-                    auto* pixel = (PixelRGB*) p;
-                    p += srcData.pixelStride;
+            const auto x = area.getX(), y = area.getY();
+            const auto w = (unsigned int) area.getWidth(), h = (unsigned int) area.getHeight();
 
-                    X11Symbols::getInstance()->xPutPixel (xImage.get(), x, y,
-                                                              (((((uint32) pixel->getRed())   << rShiftL) >> rShiftR) & rMask)
-                                                            | (((((uint32) pixel->getGreen()) << gShiftL) >> gShiftR) & gMask)
-                                                            | (((((uint32) pixel->getBlue())  << bShiftL) >> bShiftR) & bMask));
-                }
-            }
+            // blit results to screen
+           #if JUCE_USE_XSHM
+            if (isUsingXShm())
+                X11Symbols::getInstance()->xShmPutImage (display, (::Drawable) window, gc, xImage.get(), x, y, x, y, w, h, i == numAreas - 1);
+            else
+           #endif
+                X11Symbols::getInstance()->xPutImage (display, (::Drawable) window, gc, xImage.get(), x, y, x, y, w, h);
         }
-
-        // blit results to screen
-       #if JUCE_USE_XSHM
-        if (isUsingXShm())
-            X11Symbols::getInstance()->xShmPutImage (display, (::Drawable) window, gc, xImage.get(), sx, sy, dx, dy, dw, dh, True);
-        else
-       #endif
-            X11Symbols::getInstance()->xPutImage (display, (::Drawable) window, gc, xImage.get(), sx, sy, dx, dy, dw, dh);
     }
 
     #if JUCE_USE_XSHM
@@ -1091,6 +1081,38 @@ public:
     #endif
 
 private:
+    //==============================================================================
+    void convertTo16Bit (Rectangle<int> area)
+    {
+        auto rMask   = (uint32) xImage->red_mask;
+        auto gMask   = (uint32) xImage->green_mask;
+        auto bMask   = (uint32) xImage->blue_mask;
+        auto rShiftL = (uint32) jmax (0,  getShiftNeeded (rMask));
+        auto rShiftR = (uint32) jmax (0, -getShiftNeeded (rMask));
+        auto gShiftL = (uint32) jmax (0,  getShiftNeeded (gMask));
+        auto gShiftR = (uint32) jmax (0, -getShiftNeeded (gMask));
+        auto bShiftL = (uint32) jmax (0,  getShiftNeeded (bMask));
+        auto bShiftR = (uint32) jmax (0, -getShiftNeeded (bMask));
+
+        Image::BitmapData srcData (Image (this), Image::BitmapData::readOnly);
+
+        for (int y = area.getY(); y < area.getBottom(); ++y)
+        {
+            auto* p = srcData.getPixelPointer (area.getX(), y);
+
+            for (int x = area.getX(); x < area.getRight(); ++x)
+            {
+                auto* pixel = (PixelRGB*) p;
+                p += srcData.pixelStride;
+
+                X11Symbols::getInstance()->xPutPixel (xImage.get(), x, y,
+                                                          (((((uint32) pixel->getRed())   << rShiftL) >> rShiftR) & rMask)
+                                                        | (((((uint32) pixel->getGreen()) << gShiftL) >> gShiftR) & gMask)
+                                                        | (((((uint32) pixel->getBlue())  << bShiftL) >> bShiftR) & bMask));
+            }
+        }
+    }
+
     //==============================================================================
     struct Deleter
     {
@@ -2205,17 +2227,22 @@ Image XWindowSystem::createImage (bool isSemiTransparent, int width, int height,
                                     false, (unsigned int) visualAndDepth.depth, visualAndDepth.visual));
 }
 
-void XWindowSystem::blitToWindow (::Window windowH, Image image, Rectangle<int> destinationRect, Rectangle<int> totalRect) const
+void XWindowSystem::blitToWindow (::Window windowH, Image image, const RectangleList<int>& areas) const
 {
     jassert (windowH != 0);
 
     auto* xbitmap = static_cast<XBitmapImage*> (image.getPixelData().get());
+    xbitmap->blitToWindow (windowH, areas);
+}
+
+bool XWindowSystem::isSharedMemoryImage ([[maybe_unused]] const Image& image) const
+{
+   #if JUCE_USE_XSHM
+    if (auto* xbitmap = dynamic_cast<XBitmapImage*> (image.getPixelData().get()))
+        return xbitmap->isUsingXShm();
+   #endif
 
-    xbitmap->blitToWindow (windowH,
-                           destinationRect.getX(), destinationRect.getY(),
-                           (unsigned int) destinationRect.getWidth(),
-                           (unsigned int) destinationRect.getHeight(),
-                           destinationRect.getX() - totalRect.getX(), destinationRect.getY() - totalRect.getY());
+    return false;
 }
 
 void XWindowSystem::processPendingPaintsForWindow (::Window windowH)
@@ -217,7 +217,8 @@ public:
     void removePendingPaintForWindow (::Window);
 
     Image createImage (bool isSemiTransparentWindow, int width, int height, bool argb) const;
-    void blitToWindow (::Window, Image, Rectangle<int> destinationRect, Rectangle<int> totalRect) const;
+    void blitToWindow (::Window, Image, const RectangleList<int>& areas) const;
+    bool isSharedMemoryImage (const Image&) const;
 
     void setScreenSaverEnabled (bool enabled) const;
 